@@ -191,6 +191,64 @@ namespace llarp
           m_workerThreads = arg;
         });
 
+    conf.defineOption<int>(
+        "router",
+        "introset-storage-limit",
+        RelayOnly,
+        Hidden,
+        Default{64},
+        Comment{
+            "Maximum number of megabytes of introsets this relay will store for the network.",
+            "When the limit is reached the introsets closest to expiry are dropped first.",
+        },
+        [this](int arg) {
+          if (arg < 1)
+            throw std::invalid_argument("introset-storage-limit must be >= 1");
+
+          m_IntroSetStorageLimit = static_cast<size_t>(arg) * 1024 * 1024;
+        });
+
+    conf.defineOption<bool>(
+        "router",
+        "loop-profiling",
+        Default{false},
+        AssignmentAcceptor(m_LoopProfiling),
+        Comment{
+            "Time every callback the event loop runs, by where in the code it came from, and warn",
+            "about those that run longer than loop-stall-threshold.  The sites we spend the most",
+            "time in can be fetched with the loop_profile rpc call.",
+        });
+
+    conf.defineOption<int>(
+        "router",
+        "loop-stall-threshold",
+        Default{50},
+        Comment{
+            "How long (in milliseconds) an event loop callback may run before loop-profiling warns",
+            "about it.",
+        },
+        [this](int arg) {
+          if (arg <= 0)
+            throw std::invalid_argument{"[router]:loop-stall-threshold must be positive"};
+          m_LoopStallThreshold = std::chrono::milliseconds{arg};
+        });
+
+    conf.defineOption<int>(
+        "router",
+        "data-plane-threads",
+        Default{0},
+        Comment{
+            "Number of threads to read, decrypt and write packets for our inbound links on, each",
+            "with a socket of its own sharing the link's port; the kernel spreads the routers we",
+            "talk to across them.  Sessions and relaying stay on the main event loop.  Only",
+            "supported where SO_REUSEPORT is.  0 does it all on the main event loop.",
+        },
+        [this](int arg) {
+          if (arg < 0)
+            throw std::invalid_argument{"[router]:data-plane-threads cannot be negative"};
+          m_DataPlaneThreads = arg;
+        });
+
     // Hidden option because this isn't something that should ever be turned off occasionally when
     // doing dev/testing work.
     conf.defineOption<bool>(
@@ -443,6 +501,40 @@ namespace llarp
           m_Paths = arg;
         });
 
+    conf.defineOption<int>(
+        "network",
+        "spare-paths",
+        ClientOnly,
+        Default{2},
+        Comment{
+            "Most paths to keep built ahead of time for new outbound sessions, so that a session",
+            "to a remote which has an introduction on the last hop of a spare path can start",
+            "without waiting on a path build. How many are kept follows how many new sessions we",
+            "make. 0 disables spare paths.",
+        },
+        [this](int arg) {
+          if (arg < 0 or arg > 8)
+            throw std::invalid_argument("[network]:spare-paths must be >= 0 and <= 8");
+          m_SparePaths = arg;
+        });
+
+    conf.defineOption<int>(
+        "network",
+        "multipath",
+        ClientOnly,
+        Default{1},
+        Comment{
+            "Number of paths, each to a different introduction of the remote, that we spread the",
+            "traffic of a single outbound session over. Traffic is split in proportion to how fast",
+            "each path is and put back in order by the receiving end. 1 sends all traffic of a",
+            "session over one path.",
+        },
+        [this](int arg) {
+          if (arg < 1 or arg > 4)
+            throw std::invalid_argument("[network]:multipath must be >= 1 and <= 4");
+          m_MultipathLanes = arg;
+        });
+
     conf.defineOption<bool>(
         "network",
         "exit",
@@ -604,6 +696,19 @@ namespace llarp
             "handled in the exit configuration.  Enabled by default."},
         AssignmentAcceptor(m_BlackholeRoutes));
 
+    conf.defineOption<bool>(
+        "network",
+        "tun-offload",
+        ClientOnly,
+        Default{false},
+        Comment{
+            "Enable / disable segmentation and checksum offload on our network interface.",
+            "When enabled the kernel hands lokinet bursts of tcp data as one large packet, which",
+            "lokinet cuts into packets that fit its frames, and lokinet joins bursts it writes",
+            "back the same way, which cuts the per packet cost of bulk tcp transfers.",
+            "Linux only."},
+        AssignmentAcceptor(m_TunOffload));
+
     conf.defineOption<std::string>(
         "network",
         "ifname",
@@ -880,6 +985,34 @@ namespace llarp
           m_hostfiles.emplace_back(std::move(path));
         });
 
+    conf.defineOption<int>(
+        "dns",
+        "cache-size",
+        Default{1024},
+        Comment{
+            "Maximum number of dns answers to cache, both for upstream answers and for .loki and",
+            ".snode answers.  Set to 0 to disable the cache.",
+        },
+        [this](int val) {
+          if (val < 0)
+            throw std::invalid_argument{"dns cache-size cannot be negative"};
+          m_CacheSize = val;
+        });
+
+    conf.defineOption<int>(
+        "dns",
+        "cache-serve-stale",
+        Default{3600},
+        Comment{
+            "How long (in seconds) past their expiry we keep answering from cached dns answers",
+            "while they are refreshed in the background.  Set to 0 to never serve stale answers.",
+        },
+        [this](int val) {
+          if (val < 0)
+            throw std::invalid_argument{"dns cache-serve-stale cannot be negative"};
+          m_CacheServeStale = std::chrono::seconds{val};
+        });
+
     // Ignored option (used by the systemd service file to disable resolvconf configuration).
     conf.defineOption<bool>(
         "dns",
@@ -1152,6 +1285,34 @@ namespace llarp
             "Recommend localhost-only for security purposes.",
         });
 
+    conf.defineOption<int>(
+        "api",
+        "status-interval",
+        Default{1},
+        Comment{
+            "How long (in seconds) we keep serving a snapshot of each part of our status before",
+            "building it again.  Status requests more frequent than this get the snapshot.",
+        },
+        [this](int val) {
+          if (val < 0)
+            throw std::invalid_argument{"[api]:status-interval cannot be negative"};
+          m_statusInterval = std::chrono::seconds{val};
+        });
+
+    conf.defineOption<int>(
+        "api",
+        "status-push-interval",
+        Default{5},
+        Comment{
+            "How often (in seconds) we push status updates to clients subscribed to",
+            "llarp.status_subscribe.",
+        },
+        [this](int val) {
+          if (val <= 0)
+            throw std::invalid_argument{"[api]:status-push-interval must be positive"};
+          m_statusPushInterval = std::chrono::seconds{val};
+        });
+
     conf.defineOption<std::string>("api", "authkey", Deprecated);
 
     // TODO: this was from pre-refactor:
@@ -1286,6 +1447,17 @@ namespace llarp
         Comment{
             "When using type=file this is the output filename.",
         });
+
+    conf.defineOption<bool>(
+        "logging",
+        "async",
+        Default{true},
+        AssignmentAcceptor(m_logAsync),
+        Comment{
+            "Write print and file logs from a thread of their own so logging never holds up",
+            "traffic. Messages are dropped, and the drop noted in the log, if the output cannot",
+            "keep up. Set to false to write every message before carrying on.",
+        });
   }
 
   void
@@ -1335,15 +1507,15 @@ namespace llarp
   }
 
   bool
-  PeerSelectionConfig::Acceptable(const std::set<RouterContact>& rcs) const
+  PeerSelectionConfig::Acceptable(const std::vector<const RouterContact*>& rcs) const
   {
     if (m_UniqueHopsNetmaskSize == 0)
       return true;
     const auto netmask = netmask_ipv6_bits(96 + m_UniqueHopsNetmaskSize);
     std::set<IPRange> seenRanges;
-    for (const auto& hop : rcs)
+    for (const auto* hop : rcs)
     {
-      for (const auto& addr : hop.addrs)
+      for (const auto& addr : hop->addrs)
       {
         const auto network_addr = net::In6ToHUInt(addr.ip) & netmask;
         if (auto [it, inserted] = seenRanges.emplace(network_addr, netmask); not inserted)
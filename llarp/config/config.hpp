@@ -76,6 +76,17 @@ namespace llarp
     std::string m_transportKeyFile;
 
     bool m_isRelay = false;
+
+    /// cap on the bytes of introsets we store for the network as a relay
+    size_t m_IntroSetStorageLimit = 0;
+
+    /// time every event loop callback and warn about the ones that take longer than the threshold
+    bool m_LoopProfiling = false;
+    llarp_time_t m_LoopStallThreshold = 50ms;
+
+    /// threads to read and write inbound link packets on, 0 to do it on the event loop
+    size_t m_DataPlaneThreads = 0;
+
     /// deprecated
     std::optional<net::ipaddr_t> PublicIP;
     /// deprecated
@@ -101,7 +112,7 @@ namespace llarp
 
     /// return true if this set of router contacts is acceptable against this config
     bool
-    Acceptable(const std::set<RouterContact>& hops) const;
+    Acceptable(const std::vector<const RouterContact*>& hops) const;
   };
 
   struct NetworkConfig
@@ -117,6 +128,8 @@ namespace llarp
     bool m_reachable = false;
     std::optional<int> m_Hops;
     std::optional<int> m_Paths;
+    size_t m_SparePaths = 2;
+    size_t m_MultipathLanes = 1;
     bool m_AllowExit = false;
     std::set<RouterID> m_snodeBlacklist;
     net::IPRangeMap<service::Address> m_ExitMap;
@@ -148,6 +161,7 @@ namespace llarp
 
     bool m_EnableRoutePoker;
     bool m_BlackholeRoutes;
+    bool m_TunOffload = false;
 
     void
     defineConfigOptions(ConfigDefinition& conf, const ConfigGenParameters& params);
@@ -160,6 +174,8 @@ namespace llarp
     std::vector<SockAddr> m_upstreamDNS;
     std::vector<fs::path> m_hostfiles;
     std::optional<SockAddr> m_QueryBind;
+    size_t m_CacheSize = 1024;
+    llarp_time_t m_CacheServeStale = 1h;
 
     std::unordered_multimap<std::string, std::string> m_ExtraOpts;
 
@@ -190,6 +206,8 @@ namespace llarp
   {
     bool m_enableRPCServer = false;
     std::vector<oxenmq::address> m_rpcBindAddresses;
+    llarp_time_t m_statusInterval = 1s;
+    llarp_time_t m_statusPushInterval = 5s;
 
     void
     defineConfigOptions(ConfigDefinition& conf, const ConfigGenParameters& params);
@@ -219,6 +237,7 @@ namespace llarp
     log::Type m_logType = log::Type::Print;
     log::Level m_logLevel = log::Level::off;
     std::string m_logFile;
+    bool m_logAsync = true;
 
     void
     defineConfigOptions(ConfigDefinition& conf, const ConfigGenParameters& params);
@@ -36,6 +36,10 @@ namespace llarp
 
     /// measure latency every this interval ms
     constexpr auto latency_interval = 20s;
+    /// measure latency every this interval ms on paths that carry traffic
+    constexpr auto busy_latency_interval = 5s;
+    /// a latency probe that got no reply in this long is counted as lost
+    constexpr auto latency_timeout = 5s;
     /// if a path is inactive for this amount of time it's dead
     constexpr auto alive_timeout = latency_interval * 1.5;
 
@@ -0,0 +1,101 @@
+#include "keypair_pool.hpp"
+#include "crypto.hpp"
+
+#include <optional>
+
+namespace llarp
+{
+  EncryptionKeyPool::EncryptionKeyPool(size_t capacity) : m_Capacity{capacity}
+  {
+    m_Keys.reserve(m_Capacity);
+  }
+
+  void
+  EncryptionKeyPool::Start(WorkerFunc_t work)
+  {
+    {
+      util::Lock lock{m_Access};
+      m_Work = work;
+      if (m_Refilling)
+        return;
+      m_Refilling = true;
+    }
+    work([self = weak_from_this()] {
+      if (auto ptr = self.lock())
+        ptr->Fill();
+    });
+  }
+
+  SecretKey
+  EncryptionKeyPool::Take()
+  {
+    std::optional<SecretKey> key;
+    WorkerFunc_t work;
+    {
+      util::Lock lock{m_Access};
+      if (not m_Keys.empty())
+      {
+        key = m_Keys.back();
+        m_Keys.pop_back();
+      }
+      if (m_Work and not m_Refilling and m_Keys.size() <= m_Capacity / 2)
+      {
+        m_Refilling = true;
+        work = m_Work;
+      }
+    }
+    ++m_Taken;
+    if (work)
+    {
+      work([self = weak_from_this()] {
+        if (auto ptr = self.lock())
+          ptr->Fill();
+      });
+    }
+    if (not key)
+    {
+      ++m_Exhausted;
+      ++m_Generated;
+      key.emplace();
+      CryptoManager::instance()->encryption_keygen(*key);
+    }
+    return *key;
+  }
+
+  void
+  EncryptionKeyPool::Fill()
+  {
+    auto crypto = CryptoManager::instance();
+    while (size() < m_Capacity)
+    {
+      // generate outside of the lock so takers are never held up by us
+      SecretKey key;
+      crypto->encryption_keygen(key);
+      ++m_Generated;
+      util::Lock lock{m_Access};
+      if (m_Keys.size() >= m_Capacity)
+        break;
+      m_Keys.push_back(std::move(key));
+    }
+    util::Lock lock{m_Access};
+    m_Refilling = false;
+  }
+
+  size_t
+  EncryptionKeyPool::size() const
+  {
+    util::Lock lock{m_Access};
+    return m_Keys.size();
+  }
+
+  util::StatusObject
+  EncryptionKeyPool::ExtractStatus() const
+  {
+    return {
+        {"available", size()},
+        {"capacity", m_Capacity},
+        {"taken", m_Taken.load()},
+        {"exhausted", m_Exhausted.load()},
+        {"generated", m_Generated.load()}};
+  }
+}  // namespace llarp
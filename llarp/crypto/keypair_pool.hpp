@@ -0,0 +1,67 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <llarp/util/status.hpp>
+#include <llarp/util/thread/threading.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace llarp
+{
+  /// pool of pregenerated x25519 keypairs for the single use keys of path builds (hop commit
+  /// keys and the ephemeral keys our commit records are encrypted with).
+  /// keys are handed out from any thread and the pool is refilled in the background by the worker
+  /// it was started with, so a path build only pays for its dh and never for key generation.
+  class EncryptionKeyPool : public std::enable_shared_from_this<EncryptionKeyPool>
+  {
+   public:
+    using WorkFunc_t = std::function<void(void)>;
+    using WorkerFunc_t = std::function<void(WorkFunc_t)>;
+
+    /// enough for 16 hops worth of path builds before we dip into a refill
+    static constexpr size_t DefaultCapacity = 128;
+
+    explicit EncryptionKeyPool(size_t capacity = DefaultCapacity);
+
+    /// set the worker refills are queued on and queue an initial fill
+    void
+    Start(WorkerFunc_t work);
+
+    /// take a fresh keypair, generating one inline if the pool ran dry.
+    /// queues a refill once the pool is down to half its capacity.
+    SecretKey
+    Take();
+
+    /// generate keypairs until the pool is full, blocks the calling thread
+    void
+    Fill();
+
+    size_t
+    size() const;
+
+    size_t
+    Capacity() const
+    {
+      return m_Capacity;
+    }
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    const size_t m_Capacity;
+
+    mutable util::Mutex m_Access;
+    std::vector<SecretKey> m_Keys GUARDED_BY(m_Access);
+    WorkerFunc_t m_Work GUARDED_BY(m_Access);
+    bool m_Refilling GUARDED_BY(m_Access) = false;
+
+    std::atomic<uint64_t> m_Taken{0};
+    std::atomic<uint64_t> m_Exhausted{0};
+    std::atomic<uint64_t> m_Generated{0};
+  };
+}  // namespace llarp
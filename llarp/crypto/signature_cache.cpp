@@ -0,0 +1,67 @@
+#include "signature_cache.hpp"
+
+namespace llarp
+{
+  SignatureCache::SignatureCache(size_t capacity) : m_Capacity{capacity}
+  {}
+
+  bool
+  SignatureCache::Has(const ShortHash& h, const Signature& sig)
+  {
+    bool found;
+    {
+      util::Lock lock{m_Access};
+      const auto itr = m_Verified.find(h);
+      found = itr != m_Verified.end() and itr->second == sig;
+    }
+    ++(found ? m_Hits : m_Misses);
+    return found;
+  }
+
+  void
+  SignatureCache::Put(const ShortHash& h, const Signature& sig)
+  {
+    util::Lock lock{m_Access};
+    if (auto [itr, inserted] = m_Verified.try_emplace(h, sig); not inserted)
+    {
+      itr->second = sig;
+      return;
+    }
+    m_Order.push_back(h);
+    while (m_Order.size() > m_Capacity)
+    {
+      m_Verified.erase(m_Order.front());
+      m_Order.pop_front();
+    }
+  }
+
+  void
+  SignatureCache::Verified(std::chrono::microseconds took, bool valid)
+  {
+    m_VerifyMicros += took.count();
+    if (not valid)
+      ++m_Failures;
+  }
+
+  size_t
+  SignatureCache::size() const
+  {
+    util::Lock lock{m_Access};
+    return m_Verified.size();
+  }
+
+  util::StatusObject
+  SignatureCache::ExtractStatus() const
+  {
+    const uint64_t hits = Hits();
+    const uint64_t misses = Misses();
+    const uint64_t micros = m_VerifyMicros.load();
+    return util::StatusObject{
+        {"cached", size()},
+        {"hits", hits},
+        {"misses", misses},
+        {"failures", Failures()},
+        {"hitRate", (hits + misses) ? double(hits) / double(hits + misses) : 0.0},
+        {"verifyMicrosAvg", misses ? micros / misses : 0}};
+  }
+}  // namespace llarp
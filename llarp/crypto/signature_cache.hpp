@@ -0,0 +1,80 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <llarp/util/status.hpp>
+#include <llarp/util/thread/threading.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+
+namespace llarp
+{
+  /// signatures we have verified before, keyed by the hash of the content they sign, so that the
+  /// same signed content arriving again does not cost another ed25519 verify.
+  /// entries are dropped oldest first once we hold the capacity we were made with.
+  class SignatureCache
+  {
+   public:
+    static constexpr size_t DefaultCapacity = 16384;
+
+    explicit SignatureCache(size_t capacity = DefaultCapacity);
+
+    /// true if sig was verified before over content hashing to h, counts a hit or a miss
+    bool
+    Has(const ShortHash& h, const Signature& sig);
+
+    /// remember that sig verified over content hashing to h
+    void
+    Put(const ShortHash& h, const Signature& sig);
+
+    /// record a verify we had to do, and whether it failed
+    void
+    Verified(std::chrono::microseconds took, bool valid);
+
+    size_t
+    size() const;
+
+    size_t
+    Capacity() const
+    {
+      return m_Capacity;
+    }
+
+    uint64_t
+    Hits() const
+    {
+      return m_Hits.load();
+    }
+
+    uint64_t
+    Misses() const
+    {
+      return m_Misses.load();
+    }
+
+    uint64_t
+    Failures() const
+    {
+      return m_Failures.load();
+    }
+
+    /// hit rate and verify cost
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    const size_t m_Capacity;
+
+    mutable util::Mutex m_Access;
+    std::unordered_map<ShortHash, Signature> m_Verified GUARDED_BY(m_Access);
+    std::deque<ShortHash> m_Order GUARDED_BY(m_Access);
+
+    std::atomic<uint64_t> m_Hits{0};
+    std::atomic<uint64_t> m_Misses{0};
+    std::atomic<uint64_t> m_Failures{0};
+    std::atomic<uint64_t> m_VerifyMicros{0};
+  };
+}  // namespace llarp
@@ -171,12 +171,12 @@ namespace llarp
       std::unique_ptr<Bucket<RCNode>> _nodes;
 
       // for introduction sets
-      std::unique_ptr<Bucket<ISNode>> _services;
+      IntroSetStore _services;
 
-      Bucket<ISNode>*
+      IntroSetStore&
       services() override
       {
-        return _services.get();
+        return _services;
       }
 
       bool allowTransit{false};
@@ -222,15 +222,10 @@ namespace llarp
         return router;
       }
 
-      bool
-      GetRCFromNodeDB(const Key_t& k, llarp::RouterContact& rc) const override
+      RouterContact_ptr
+      GetRCFromNodeDB(const Key_t& k) const override
       {
-        if (const auto maybe = router->nodedb()->Get(k.as_array()); maybe.has_value())
-        {
-          rc = *maybe;
-          return true;
-        }
-        return false;
+        return router->nodedb()->Get(k.as_array());
       }
 
       PendingIntrosetLookups _pendingIntrosetLookups;
@@ -342,7 +337,7 @@ namespace llarp
         auto itr = nodes.begin();
         while (itr != nodes.end())
         {
-          if (itr->second.rc.IsExpired(now))
+          if (itr->second.rc->IsExpired(now))
           {
             itr = nodes.erase(itr);
           }
@@ -351,21 +346,8 @@ namespace llarp
         }
       }
 
-      if (_services)
-      {
-        // expire intro sets
-        auto& nodes = _services->nodes;
-        auto itr = nodes.begin();
-        while (itr != nodes.end())
-        {
-          if (itr->second.introset.IsExpired(now))
-          {
-            itr = nodes.erase(itr);
-          }
-          else
-            ++itr;
-        }
-      }
+      // expire intro sets
+      _services.ExpireStale(now);
     }
 
     void
@@ -389,20 +371,23 @@ namespace llarp
         return;
       }
       const auto rc = GetRouter()->nodedb()->FindClosestTo(target);
-      const Key_t next(rc.pubkey);
+      const Key_t next = rc ? Key_t{rc->pubkey} : Key_t{};
       {
-        if (next == target)
+        if (rc and next == target)
         {
           // we know the target
-          if (rc.ExpiresSoon(llarp::time_now_ms()))
+          if (rc->ExpiresSoon(llarp::time_now_ms()))
           {
             // ask target for their rc to keep it updated
             LookupRouterRecursive(target.as_array(), requester, txid, next);
           }
           else
           {
-            // send reply with rc we know of
-            replies.emplace_back(new GotRouterMessage(requester, txid, {rc}, false));
+            // send reply with rc we know of, as it was encoded when we got it
+            auto reply = std::make_unique<GotRouterMessage>(requester, false);
+            reply->txid = txid;
+            reply->sharedRCs.push_back(rc);
+            replies.push_back(std::move(reply));
           }
         }
         else if (recursive)  // are we doing a recursive lookup?
@@ -431,10 +416,7 @@ namespace llarp
     std::optional<llarp::service::EncryptedIntroSet>
     Context::GetIntroSetByLocation(const Key_t& key) const
     {
-      auto itr = _services->nodes.find(key);
-      if (itr == _services->nodes.end())
-        return {};
-      return itr->second.introset;
+      return _services.GetNode(key);
     }
 
     void
@@ -456,7 +438,8 @@ namespace llarp
           {"pendingIntrosetLookups", _pendingIntrosetLookups.ExtractStatus()},
           {"pendingExploreLookups", pendingExploreLookups().ExtractStatus()},
           {"nodes", _nodes->ExtractStatus()},
-          {"services", _services->ExtractStatus()},
+          {"services", _services.ExtractStatus()},
+          {"serviceStore", _services.ExtractStats()},
           {"ourKey", ourKey.ToHex()}};
       return obj;
     }
@@ -467,7 +450,6 @@ namespace llarp
       router = r;
       ourKey = us;
       _nodes = std::make_unique<Bucket<RCNode>>(ourKey, llarp::randint);
-      _services = std::make_unique<Bucket<ISNode>>(ourKey, llarp::randint);
       llarp::LogDebug("initialize dht with key ", ourKey);
       // start cleanup timer
       _timer_keepalive = std::make_shared<int>(0);
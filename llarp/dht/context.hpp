@@ -3,6 +3,7 @@
 
 #include "bucket.hpp"
 #include "dht.h"
+#include "introset_store.hpp"
 #include "key.hpp"
 #include "message.hpp"
 #include <llarp/dht/messages/findintro.hpp>
@@ -144,8 +145,9 @@ namespace llarp
       virtual llarp::AbstractRouter*
       GetRouter() const = 0;
 
-      virtual bool
-      GetRCFromNodeDB(const Key_t& k, llarp::RouterContact& rc) const = 0;
+      /// the nodedb's rc for k, shared with it, or null if it has none
+      virtual RouterContact_ptr
+      GetRCFromNodeDB(const Key_t& k) const = 0;
 
       virtual const Key_t&
       OurKey() const = 0;
@@ -168,7 +170,7 @@ namespace llarp
       virtual const PendingExploreLookups&
       pendingExploreLookups() const = 0;
 
-      virtual Bucket<ISNode>*
+      virtual IntroSetStore&
       services() = 0;
 
       virtual bool&
@@ -0,0 +1,164 @@
+#include "introset_store.hpp"
+
+#include <llarp/constants/path.hpp>
+
+namespace llarp::dht
+{
+  static llarp_time_t
+  ExpiresAt(const service::EncryptedIntroSet& introset)
+  {
+    return introset.signedAt + path::default_lifetime;
+  }
+
+  size_t
+  IntroSetStore::EntrySize(const service::EncryptedIntroSet& introset)
+  {
+    return sizeof(Entry) + sizeof(ExpiryEntry) + introset.introsetPayload.size();
+  }
+
+  bool
+  IntroSetStore::PutNode(service::EncryptedIntroSet introset)
+  {
+    const Key_t location{introset.derivedSigningKey.as_array()};
+    const auto sz = EntrySize(introset);
+    const ExpiryEntry expiry{ExpiresAt(introset), introset.signedAt, location};
+
+    if (auto itr = m_IntroSets.find(location); itr != m_IntroSets.end())
+    {
+      auto& ent = itr->second;
+      if (not ent.introset.OtherIsNewer(introset))
+        return false;
+      // replace in place, the old heap entry goes stale and is skipped later
+      m_Bytes -= ent.size;
+      ent.introset = std::move(introset);
+      ent.size = sz;
+      ++m_Replaced;
+    }
+    else
+      m_IntroSets.emplace(location, Entry{std::move(introset), sz});
+
+    m_Bytes += sz;
+    m_Expiry.push(expiry);
+    EnforceCap();
+    MaybeCompactHeap();
+    return m_IntroSets.count(location) != 0;
+  }
+
+  std::optional<service::EncryptedIntroSet>
+  IntroSetStore::GetNode(const Key_t& location) const
+  {
+    const auto itr = m_IntroSets.find(location);
+    if (itr == m_IntroSets.end())
+      return std::nullopt;
+    return itr->second.introset;
+  }
+
+  bool
+  IntroSetStore::HasNode(const Key_t& location) const
+  {
+    return m_IntroSets.count(location) != 0;
+  }
+
+  void
+  IntroSetStore::DelNode(const Key_t& location)
+  {
+    Erase(location);
+    MaybeCompactHeap();
+  }
+
+  size_t
+  IntroSetStore::ExpireStale(llarp_time_t now)
+  {
+    size_t removed = 0;
+    while (not m_Expiry.empty() and m_Expiry.top().expiresAt <= now)
+    {
+      const auto ent = m_Expiry.top();
+      m_Expiry.pop();
+      if (not IsLive(ent))
+        continue;
+      Erase(ent.location);
+      ++removed;
+    }
+    m_Expired += removed;
+    return removed;
+  }
+
+  void
+  IntroSetStore::SetMaxBytes(size_t maxBytes)
+  {
+    m_MaxBytes = maxBytes;
+    EnforceCap();
+  }
+
+  void
+  IntroSetStore::Clear()
+  {
+    m_IntroSets.clear();
+    m_Expiry = decltype(m_Expiry){};
+    m_Bytes = 0;
+  }
+
+  util::StatusObject
+  IntroSetStore::ExtractStatus() const
+  {
+    util::StatusObject obj{};
+    for (const auto& [location, ent] : m_IntroSets)
+      obj[location.ToString()] = ent.introset.ExtractStatus();
+    return obj;
+  }
+
+  util::StatusObject
+  IntroSetStore::ExtractStats() const
+  {
+    return {
+        {"count", m_IntroSets.size()},
+        {"bytes", m_Bytes},
+        {"maxBytes", m_MaxBytes},
+        {"evicted", m_Evicted},
+        {"expired", m_Expired},
+        {"replaced", m_Replaced}};
+  }
+
+  bool
+  IntroSetStore::IsLive(const ExpiryEntry& ent) const
+  {
+    const auto itr = m_IntroSets.find(ent.location);
+    return itr != m_IntroSets.end() and itr->second.introset.signedAt == ent.signedAt;
+  }
+
+  void
+  IntroSetStore::Erase(const Key_t& location)
+  {
+    const auto itr = m_IntroSets.find(location);
+    if (itr == m_IntroSets.end())
+      return;
+    m_Bytes -= itr->second.size;
+    m_IntroSets.erase(itr);
+  }
+
+  void
+  IntroSetStore::EnforceCap()
+  {
+    while (m_Bytes > m_MaxBytes and not m_Expiry.empty())
+    {
+      const auto ent = m_Expiry.top();
+      m_Expiry.pop();
+      if (not IsLive(ent))
+        continue;
+      Erase(ent.location);
+      ++m_Evicted;
+    }
+  }
+
+  void
+  IntroSetStore::MaybeCompactHeap()
+  {
+    // each live introset has exactly one live heap entry, rebuild once stale ones dominate
+    if (m_Expiry.size() <= 2 * m_IntroSets.size() + 64)
+      return;
+    decltype(m_Expiry) fresh{};
+    for (const auto& [location, ent] : m_IntroSets)
+      fresh.push(ExpiryEntry{ExpiresAt(ent.introset), ent.introset.signedAt, location});
+    m_Expiry = std::move(fresh);
+  }
+}  // namespace llarp::dht
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "key.hpp"
+#include <llarp/service/intro_set.hpp>
+#include <llarp/util/priority_queue.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <optional>
+#include <unordered_map>
+
+namespace llarp::dht
+{
+  /// storage for the encrypted introsets a relay holds on behalf of the network.
+  /// introsets are indexed by dht location in a hash table and by expiry time in a min heap so
+  /// that expiring old entries only costs as much as the number of entries that actually expired.
+  /// memory use is bounded by a byte cap, once it is reached the introsets closest to expiry are
+  /// evicted first.
+  struct IntroSetStore
+  {
+    /// default cap on the bytes of introset data we hold
+    static constexpr size_t DefaultMaxBytes = 64 * 1024 * 1024;
+
+    /// put an introset into the store if it is newer than the one we have for its location.
+    /// returns false if it was not newer or was evicted straight away to stay within our cap.
+    bool
+    PutNode(service::EncryptedIntroSet introset);
+
+    /// get the introset we hold at a dht location
+    std::optional<service::EncryptedIntroSet>
+    GetNode(const Key_t& location) const;
+
+    bool
+    HasNode(const Key_t& location) const;
+
+    void
+    DelNode(const Key_t& location);
+
+    /// remove every introset that is expired at time now, returns how many were removed
+    size_t
+    ExpireStale(llarp_time_t now);
+
+    /// set the byte cap, evicting entries as needed to fit in the new cap
+    void
+    SetMaxBytes(size_t maxBytes);
+
+    size_t
+    MaxBytes() const
+    {
+      return m_MaxBytes;
+    }
+
+    /// number of introsets we hold
+    size_t
+    size() const
+    {
+      return m_IntroSets.size();
+    }
+
+    /// approximate number of bytes used by the introsets we hold
+    size_t
+    Bytes() const
+    {
+      return m_Bytes;
+    }
+
+    void
+    Clear();
+
+    /// status object of every introset we hold
+    util::StatusObject
+    ExtractStatus() const;
+
+    /// summary counters about the store itself
+    util::StatusObject
+    ExtractStats() const;
+
+    /// the approximate memory an introset costs us to store
+    static size_t
+    EntrySize(const service::EncryptedIntroSet& introset);
+
+   private:
+    struct Entry
+    {
+      service::EncryptedIntroSet introset;
+      size_t size;
+    };
+
+    /// expiry heap entry, stale heap entries are skipped lazily when the introset they refer to
+    /// was replaced or removed
+    struct ExpiryEntry
+    {
+      llarp_time_t expiresAt;
+      llarp_time_t signedAt;
+      Key_t location;
+
+      bool
+      operator>(const ExpiryEntry& other) const
+      {
+        return expiresAt > other.expiresAt;
+      }
+    };
+
+    /// true if the heap entry still refers to the introset we have stored
+    bool
+    IsLive(const ExpiryEntry& ent) const;
+
+    /// remove the entry at location and account for it
+    void
+    Erase(const Key_t& location);
+
+    /// evict soonest expiring introsets until we are within our cap
+    void
+    EnforceCap();
+
+    /// drop stale heap entries when they make up most of the heap
+    void
+    MaybeCompactHeap();
+
+    std::unordered_map<Key_t, Entry, std::hash<AlignedBuffer<Key_t::SIZE>>> m_IntroSets;
+    util::ascending_priority_queue<ExpiryEntry> m_Expiry;
+    size_t m_Bytes = 0;
+    size_t m_MaxBytes = DefaultMaxBytes;
+    uint64_t m_Evicted = 0;
+    uint64_t m_Expired = 0;
+    uint64_t m_Replaced = 0;
+  };
+}  // namespace llarp::dht
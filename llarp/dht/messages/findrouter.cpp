@@ -42,12 +42,15 @@ namespace llarp
       }
       // check netdb
       const auto rc = dht.GetRouter()->nodedb()->FindClosestTo(k);
-      if (rc.pubkey == targetKey)
+      if (rc and rc->pubkey == targetKey)
       {
-        replies.emplace_back(new GotRouterMessage(k, txid, {rc}, false));
+        auto reply = std::make_unique<GotRouterMessage>(k, false);
+        reply->txid = txid;
+        reply->sharedRCs.push_back(rc);
+        replies.push_back(std::move(reply));
         return true;
       }
-      peer = Key_t(rc.pubkey);
+      peer = rc ? Key_t{rc->pubkey} : Key_t{};
       // lookup if we don't have it in our nodedb
       dht.LookupRouterForPath(targetKey, txid, pathID, peer);
       return true;
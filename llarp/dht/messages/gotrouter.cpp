@@ -36,7 +36,19 @@ namespace llarp
           return false;
       }
 
-      if (not BEncodeWriteDictList("R", foundRCs, buf))
+      if (not bencode_write_bytestring(buf, "R", 1) or not bencode_start_list(buf))
+        return false;
+      for (const auto& rc : foundRCs)
+      {
+        if (not rc.BEncode(buf))
+          return false;
+      }
+      for (const auto& rc : sharedRCs)
+      {
+        if (not rc->BEncode(buf))
+          return false;
+      }
+      if (not bencode_end(buf))
         return false;
 
       // txid
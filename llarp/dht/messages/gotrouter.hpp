@@ -36,6 +36,7 @@ namespace llarp
       GotRouterMessage(const GotRouterMessage& other)
           : IMessage(other.From)
           , foundRCs(other.foundRCs)
+          , sharedRCs(other.sharedRCs)
           , nearKeys(other.nearKeys)
           , closerTarget(copy_or_nullptr(other.closerTarget))
           , txid(other.txid)
@@ -57,6 +58,9 @@ namespace llarp
           llarp_dht_context* ctx, std::vector<std::unique_ptr<IMessage>>& replies) const override;
 
       std::vector<RouterContact> foundRCs;
+      /// rcs we send from what we hold, written out after foundRCs as they were encoded when we
+      /// got them.  only ever set on messages we send.
+      std::vector<RouterContact_ptr> sharedRCs;
       std::vector<RouterID> nearKeys;
       std::unique_ptr<Key_t> closerTarget;
       uint64_t txid = 0;
@@ -2,7 +2,6 @@
 
 #include "key.hpp"
 #include <llarp/router_contact.hpp>
-#include <llarp/service/intro_set.hpp>
 #include <utility>
 
 namespace llarp
@@ -11,7 +10,8 @@ namespace llarp
   {
     struct RCNode
     {
-      RouterContact rc;
+      /// shared with the nodedb and whoever else holds it
+      RouterContact_ptr rc;
       Key_t ID;
 
       RCNode()
@@ -19,48 +19,23 @@ namespace llarp
         ID.Zero();
       }
 
-      RCNode(const RouterContact& other) : rc(other), ID(other.pubkey)
+      RCNode(const RouterContact& other)
+          : RCNode(std::make_shared<const EncodedRouterContact>(other))
       {}
 
-      util::StatusObject
-      ExtractStatus() const
-      {
-        return rc.ExtractStatus();
-      }
-
-      bool
-      operator<(const RCNode& other) const
-      {
-        return rc.last_updated < other.rc.last_updated;
-      }
-    };
-
-    struct ISNode
-    {
-      service::EncryptedIntroSet introset;
-
-      Key_t ID;
-
-      ISNode()
-      {
-        ID.Zero();
-      }
-
-      ISNode(service::EncryptedIntroSet other) : introset(std::move(other))
-      {
-        ID = Key_t(introset.derivedSigningKey.as_array());
-      }
+      RCNode(RouterContact_ptr other) : rc(std::move(other)), ID(rc->pubkey)
+      {}
 
       util::StatusObject
       ExtractStatus() const
       {
-        return introset.ExtractStatus();
+        return rc->ExtractStatus();
       }
 
       bool
-      operator<(const ISNode& other) const
+      operator<(const RCNode& other) const
       {
-        return introset.signedAt < other.introset.signedAt;
+        return rc->last_updated < other.rc->last_updated;
       }
     };
   }  // namespace dht
@@ -0,0 +1,318 @@
+#include "cache.hpp"
+#include "dns.hpp"
+#include <llarp/util/metrics.hpp>
+#include <llarp/util/str.hpp>
+
+#include <oxenc/endian.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace llarp::dns
+{
+  namespace
+  {
+    struct ParsedReply
+    {
+      std::vector<std::pair<size_t, RR_TTL_t>> ttls;
+      RR_TTL_t ttl;
+      bool negative;
+    };
+
+    /// advance pos past a possibly compressed name in a wire format message
+    bool
+    SkipName(const byte_t* data, size_t sz, size_t& pos)
+    {
+      while (pos < sz)
+      {
+        const auto len = data[pos];
+        if (len == 0)
+        {
+          ++pos;
+          return true;
+        }
+        // a compression pointer ends the name
+        if ((len & 0xc0) == 0xc0)
+        {
+          pos += 2;
+          return pos <= sz;
+        }
+        if (len & 0xc0)
+          return false;
+        pos += 1 + len;
+      }
+      return false;
+    }
+
+    /// walk a raw reply to find the ttl of every record and how long the reply may be cached for
+    std::optional<ParsedReply>
+    ParseReply(const byte_t* data, size_t sz)
+    {
+      if (sz < MessageHeader::Size)
+        return std::nullopt;
+      const auto fields = oxenc::load_big_to_host<uint16_t>(data + 2);
+      if (not(fields & flags_QR) or (fields & flags_TC))
+        return std::nullopt;
+      const auto rcode = fields & 0x0f;
+      if (rcode != flags_RCODENoError and rcode != flags_RCODENameError)
+        return std::nullopt;
+      if (oxenc::load_big_to_host<uint16_t>(data + 4) != 1)
+        return std::nullopt;
+      const size_t an_count = oxenc::load_big_to_host<uint16_t>(data + 6);
+      const size_t ns_count = oxenc::load_big_to_host<uint16_t>(data + 8);
+      const size_t ar_count = oxenc::load_big_to_host<uint16_t>(data + 10);
+
+      size_t pos = MessageHeader::Size;
+      if (not SkipName(data, sz, pos) or sz - pos < 4)
+        return std::nullopt;
+      pos += 4;
+
+      ParsedReply parsed{};
+      parsed.negative = rcode == flags_RCODENameError or an_count == 0;
+      std::optional<RR_TTL_t> answer_ttl, soa_ttl;
+      for (size_t idx = 0; idx < an_count + ns_count + ar_count; ++idx)
+      {
+        if (not SkipName(data, sz, pos) or sz - pos < 10)
+          return std::nullopt;
+        const auto type = oxenc::load_big_to_host<uint16_t>(data + pos);
+        const auto ttl = oxenc::load_big_to_host<uint32_t>(data + pos + 4);
+        const size_t rdlen = oxenc::load_big_to_host<uint16_t>(data + pos + 8);
+        if (sz - pos - 10 < rdlen)
+          return std::nullopt;
+        // the ttl field of an edns opt record holds flags
+        if (type != qTypeOPT)
+        {
+          parsed.ttls.emplace_back(pos + 4, ttl);
+          if (idx < an_count)
+            answer_ttl = std::min(answer_ttl.value_or(ttl), ttl);
+          else if (type == qTypeSOA and idx < an_count + ns_count and rdlen >= 20)
+          {
+            // negative ttl is the smaller of the soa ttl and its minimum field (rfc 2308)
+            const auto minimum = oxenc::load_big_to_host<uint32_t>(data + pos + 10 + rdlen - 4);
+            soa_ttl = std::min(ttl, minimum);
+          }
+        }
+        pos += 10 + rdlen;
+      }
+
+      if (parsed.negative)
+        parsed.ttl = std::min(
+            soa_ttl.value_or(AnswerCache::DefaultNegativeTTL), AnswerCache::MaxNegativeTTL);
+      else
+        parsed.ttl = std::min(*answer_ttl, AnswerCache::MaxTTL);
+      return parsed;
+    }
+
+    /// make the question name of a reply use the same case as the name in the query, clients may
+    /// randomize the case of their queries and check it in the reply (dns 0x20)
+    void
+    CopyNameCase(byte_t* data, size_t sz, std::string_view qname)
+    {
+      size_t pos = MessageHeader::Size;
+      size_t qpos = 0;
+      while (pos < sz and qpos < qname.size())
+      {
+        const auto len = data[pos++];
+        if (len == 0 or (len & 0xc0))
+          return;
+        for (size_t idx = 0; idx < len and pos < sz and qpos < qname.size(); ++idx, ++pos, ++qpos)
+        {
+          const auto ch = static_cast<byte_t>(qname[qpos]);
+          if (std::tolower(data[pos]) == std::tolower(ch))
+            data[pos] = ch;
+        }
+        // skip the dot
+        ++qpos;
+      }
+    }
+
+    /// edns udp sizes that get the same replies from a resolver as far as we can cache them, we
+    /// never cache truncated replies
+    char
+    EDNSSizeBucket(uint16_t udpSize)
+    {
+      if (udpSize <= 512)
+        return '0';
+      if (udpSize < 1232)
+        return '1';
+      if (udpSize < 4096)
+        return '2';
+      return '3';
+    }
+  }  // namespace
+
+  AnswerCache::AnswerCache(size_t maxEntries, llarp_time_t serveStale)
+      : m_MaxEntries{maxEntries}, m_ServeStale{serveStale}
+  {}
+
+  std::optional<std::string>
+  AnswerCache::KeyFor(const Message& query)
+  {
+    if (query.questions.size() != 1)
+      return std::nullopt;
+    const auto& q = query.questions[0];
+    auto key = lowercase_ascii_string(q.qname);
+    key += '\0';
+    key += std::to_string(q.qtype);
+    key += '/';
+    key += std::to_string(q.qclass);
+    // what a resolver puts in a reply also depends on whether the client checks dnssec itself,
+    // wants dnssec records, and how big a reply it takes
+    key += '/';
+    key += query.hdr_fields & flags_CD ? 'c' : '-';
+    if (query.edns)
+    {
+      key += query.edns->dnssecOK ? 'd' : 'e';
+      key += EDNSSizeBucket(query.edns->udpSize);
+    }
+    return key;
+  }
+
+  std::optional<AnswerCache::Hit>
+  AnswerCache::Get(const Message& query, llarp_time_t now)
+  {
+    const auto key = KeyFor(query);
+    const auto found = key ? m_Entries.find(*key) : m_Entries.end();
+    if (found == m_Entries.end())
+    {
+      ++m_Misses;
+      return std::nullopt;
+    }
+    const auto itr = found->second;
+    auto& ent = *itr;
+    const bool stale = now >= ent.expiresAt;
+    if (stale and (ent.negative or now >= ent.expiresAt + m_ServeStale))
+    {
+      Erase(itr);
+      ++m_Misses;
+      return std::nullopt;
+    }
+    m_LRU.splice(m_LRU.begin(), m_LRU, itr);
+
+    bool refresh = stale or (ent.expiresAt - now) * 10 <= ent.expiresAt - ent.storedAt;
+    if (refresh and ent.refreshingSince and now - *ent.refreshingSince < RefreshTimeout)
+      refresh = false;
+    if (refresh)
+    {
+      ent.refreshingSince = now;
+      ++m_Refreshes;
+    }
+
+    OwnedBuffer reply{ent.reply.data(), ent.reply.size()};
+    auto* data = reply.buf.get();
+    oxenc::write_host_as_big(query.hdr_id, data);
+    // recursion desired is echoed from the query
+    auto fields = oxenc::load_big_to_host<uint16_t>(data + 2);
+    fields = (fields & ~flags_RD) | (query.hdr_fields & flags_RD);
+    oxenc::write_host_as_big(fields, data + 2);
+    CopyNameCase(data, reply.sz, query.questions[0].qname);
+
+    const auto age = static_cast<RR_TTL_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(now - ent.storedAt).count());
+    for (const auto& [offset, ttl] : ent.ttls)
+    {
+      RR_TTL_t remaining = StaleTTL;
+      if (not stale)
+        remaining = ttl > age ? ttl - age : 1;
+      oxenc::write_host_as_big(remaining, data + offset);
+    }
+
+    ++m_Hits;
+    if (stale)
+      ++m_StaleHits;
+    if (ent.negative)
+      ++m_NegativeHits;
+    return Hit{std::move(reply), stale, refresh};
+  }
+
+  bool
+  AnswerCache::Put(const Message& query, const llarp_buffer_t& reply, llarp_time_t now)
+  {
+    if (m_MaxEntries == 0)
+      return false;
+    auto key = KeyFor(query);
+    if (not key)
+      return false;
+    auto parsed = ParseReply(reply.base, reply.sz);
+    if (not parsed or parsed->ttl == 0)
+    {
+      ++m_Uncacheable;
+      return false;
+    }
+
+    if (auto itr = m_Entries.find(*key); itr != m_Entries.end())
+      Erase(itr->second);
+
+    m_LRU.push_front(Entry{
+        std::move(*key),
+        std::vector<byte_t>{reply.base, reply.base + reply.sz},
+        std::move(parsed->ttls),
+        now,
+        now + std::chrono::seconds{parsed->ttl},
+        parsed->negative,
+        std::nullopt});
+    m_Entries.emplace(m_LRU.front().key, m_LRU.begin());
+    ++m_Inserts;
+
+    while (m_Entries.size() > m_MaxEntries)
+    {
+      Erase(std::prev(m_LRU.end()));
+      ++m_Evicted;
+    }
+    return true;
+  }
+
+  void
+  AnswerCache::Clear()
+  {
+    m_Entries.clear();
+    m_LRU.clear();
+  }
+
+  void
+  AnswerCache::RecordLatency(bool hit, std::chrono::microseconds latency)
+  {
+    static auto& hitTime = metrics::registry().GetHistogram(
+        "lokinet_dns_cache_hit_seconds", "time to answer dns queries from our cache");
+    static auto& resolveTime = metrics::registry().GetHistogram(
+        "lokinet_dns_resolve_seconds", "time to resolve dns queries we had no cached answer for");
+    (hit ? hitTime : resolveTime).Observe(latency);
+    if (hit)
+    {
+      m_HitLatency += latency;
+      ++m_HitsTimed;
+    }
+    else
+    {
+      m_MissLatency += latency;
+      ++m_MissesTimed;
+    }
+  }
+
+  util::StatusObject
+  AnswerCache::ExtractStatus() const
+  {
+    const auto lookups = m_Hits + m_Misses;
+    return {
+        {"entries", m_Entries.size()},
+        {"maxEntries", m_MaxEntries},
+        {"hits", m_Hits},
+        {"staleHits", m_StaleHits},
+        {"negativeHits", m_NegativeHits},
+        {"misses", m_Misses},
+        {"hitRate", lookups ? double(m_Hits) / lookups : 0.0},
+        {"refreshes", m_Refreshes},
+        {"inserts", m_Inserts},
+        {"uncacheable", m_Uncacheable},
+        {"evicted", m_Evicted},
+        {"hitLatencyUS", m_HitsTimed ? m_HitLatency.count() / m_HitsTimed : 0},
+        {"missLatencyUS", m_MissesTimed ? m_MissLatency.count() / m_MissesTimed : 0}};
+  }
+
+  void
+  AnswerCache::Erase(LRU_t::iterator itr)
+  {
+    m_Entries.erase(itr->key);
+    m_LRU.erase(itr);
+  }
+}  // namespace llarp::dns
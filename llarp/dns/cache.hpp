@@ -0,0 +1,119 @@
+#pragma once
+
+#include "message.hpp"
+#include <llarp/util/buffer.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <chrono>
+#include <list>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp::dns
+{
+  /// size bounded lru cache of dns replies keyed by question.
+  /// replies are kept as the raw wire bytes we got from the resolver so that nothing is lost in a
+  /// decode/encode round trip; on a hit the message id, question case and per record ttls are
+  /// patched in place to match the query and the time the reply spent in the cache.
+  /// positive replies are cached for their smallest record ttl, nxdomain and nodata replies for the
+  /// negative ttl from their soa record (rfc 2308) or DefaultNegativeTTL if they have none.
+  class AnswerCache
+  {
+   public:
+    static constexpr size_t DefaultMaxEntries = 1024;
+    /// how long we keep serving a positive reply past its expiry while it is refreshed (rfc 8767)
+    static constexpr auto DefaultServeStale = 1h;
+    /// negative ttl for nxdomain/nodata replies that carry no soa record
+    static constexpr RR_TTL_t DefaultNegativeTTL = 5;
+    static constexpr RR_TTL_t MaxNegativeTTL = 300;
+    static constexpr RR_TTL_t MaxTTL = 86400;
+    /// ttl we put on records of a stale reply
+    static constexpr RR_TTL_t StaleTTL = 30;
+    /// how long we wait on a refresh before we allow another one to be started
+    static constexpr auto RefreshTimeout = 5s;
+
+    struct Hit
+    {
+      OwnedBuffer reply;
+      /// true if the reply was past its ttl and served stale
+      bool stale;
+      /// true if the caller should resolve the question again in the background to refresh the
+      /// entry, set for stale replies and replies in the last tenth of their ttl
+      bool refresh;
+    };
+
+    explicit AnswerCache(
+        size_t maxEntries = DefaultMaxEntries, llarp_time_t serveStale = DefaultServeStale);
+
+    /// look up a cached reply for a query at time now
+    std::optional<Hit>
+    Get(const Message& query, llarp_time_t now);
+
+    /// cache the raw reply to a query that we got at time now.
+    /// returns false if the reply is not cacheable (servfail, truncated, malformed, zero ttl).
+    bool
+    Put(const Message& query, const llarp_buffer_t& reply, llarp_time_t now);
+
+    /// drop every cached reply
+    void
+    Clear();
+
+    size_t
+    size() const
+    {
+      return m_Entries.size();
+    }
+
+    /// account for how long serving a query took, for status
+    void
+    RecordLatency(bool hit, std::chrono::microseconds latency);
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    struct Entry
+    {
+      std::string key;
+      std::vector<byte_t> reply;
+      /// offsets and original values of the ttl of every record, except edns opt pseudo records
+      std::vector<std::pair<size_t, RR_TTL_t>> ttls;
+      llarp_time_t storedAt;
+      llarp_time_t expiresAt;
+      bool negative;
+      /// when we last handed out a refresh for this entry, if one is in flight
+      std::optional<llarp_time_t> refreshingSince;
+    };
+
+    using LRU_t = std::list<Entry>;
+
+    static std::optional<std::string>
+    KeyFor(const Message& query);
+
+    void
+    Erase(LRU_t::iterator itr);
+
+    size_t m_MaxEntries;
+    llarp_time_t m_ServeStale;
+
+    /// most recently used first
+    LRU_t m_LRU;
+    std::unordered_map<std::string_view, LRU_t::iterator> m_Entries;
+
+    uint64_t m_Hits = 0;
+    uint64_t m_StaleHits = 0;
+    uint64_t m_NegativeHits = 0;
+    uint64_t m_Misses = 0;
+    uint64_t m_Refreshes = 0;
+    uint64_t m_Inserts = 0;
+    uint64_t m_Uncacheable = 0;
+    uint64_t m_Evicted = 0;
+    std::chrono::microseconds m_HitLatency{0};
+    std::chrono::microseconds m_MissLatency{0};
+    uint64_t m_HitsTimed = 0;
+    uint64_t m_MissesTimed = 0;
+  };
+}  // namespace llarp::dns
@@ -6,11 +6,13 @@ namespace llarp
 {
   namespace dns
   {
+    constexpr uint16_t qTypeOPT = 41;
     constexpr uint16_t qTypeSRV = 33;
     constexpr uint16_t qTypeAAAA = 28;
     constexpr uint16_t qTypeTXT = 16;
     constexpr uint16_t qTypeMX = 15;
     constexpr uint16_t qTypePTR = 12;
+    constexpr uint16_t qTypeSOA = 6;
     constexpr uint16_t qTypeCNAME = 5;
     constexpr uint16_t qTypeNS = 2;
     constexpr uint16_t qTypeA = 1;
@@ -22,6 +24,7 @@ namespace llarp
     constexpr uint16_t flags_TC = (1 << 9);
     constexpr uint16_t flags_RD = (1 << 8);
     constexpr uint16_t flags_RA = (1 << 7);
+    constexpr uint16_t flags_CD = (1 << 4);
     constexpr uint16_t flags_RCODENameError = (3);
     constexpr uint16_t flags_RCODEServFail = (2);
     constexpr uint16_t flags_RCODENoError = (0);
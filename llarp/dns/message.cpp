@@ -15,6 +15,44 @@ namespace llarp
   {
     static auto logcat = log::Cat("dns");
 
+    /// find the opt record among the next records records of buf without decoding the others
+    static std::optional<Message::EDNS>
+    DecodeEDNS(llarp_buffer_t buf, size_t records)
+    {
+      for (size_t idx = 0; idx < records; ++idx)
+      {
+        // skip the name, which can end in a compression pointer
+        while (true)
+        {
+          if (buf.size_left() < 1)
+            return std::nullopt;
+          const size_t len = *buf.cur;
+          if ((len & 0xc0) == 0xc0)
+          {
+            if (buf.size_left() < 2)
+              return std::nullopt;
+            buf.cur += 2;
+            break;
+          }
+          if ((len & 0xc0) or buf.size_left() < 1 + len)
+            return std::nullopt;
+          buf.cur += 1 + len;
+          if (len == 0)
+            break;
+        }
+        uint16_t type, rrclass, rdlen;
+        uint32_t ttl;
+        if (not buf.read_uint16(type) or not buf.read_uint16(rrclass) or not buf.read_uint32(ttl)
+            or not buf.read_uint16(rdlen) or buf.size_left() < rdlen)
+          return std::nullopt;
+        // the class of an opt record is the udp size and the top flag bit of its ttl is dnssec ok
+        if (type == qTypeOPT)
+          return Message::EDNS{rrclass, (ttl & 0x8000) != 0};
+        buf.cur += rdlen;
+      }
+      return std::nullopt;
+    }
+
     bool
     MessageHeader::Encode(llarp_buffer_t* buf) const
     {
@@ -62,6 +100,7 @@ namespace llarp
         , answers(std::move(other.answers))
         , authorities(std::move(other.authorities))
         , additional(std::move(other.additional))
+        , edns(other.edns)
     {}
 
     Message::Message(const Message& other)
@@ -71,6 +110,7 @@ namespace llarp
         , answers(other.answers)
         , authorities(other.authorities)
         , additional(other.additional)
+        , edns(other.edns)
     {}
 
     Message::Message(const MessageHeader& hdr) : hdr_id(hdr.id), hdr_fields(hdr.fields)
@@ -131,6 +171,8 @@ namespace llarp
           return false;
         }
       }
+      // we do not decode the other sections, just look for edns options in them
+      edns = DecodeEDNS(*buf, authorities.size() + additional.size());
       return true;
     }
 
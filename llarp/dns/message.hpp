@@ -4,6 +4,8 @@
 #include "rr.hpp"
 #include "question.hpp"
 
+#include <optional>
+
 namespace llarp
 {
   namespace dns
@@ -96,12 +98,23 @@ namespace llarp
       std::string
       ToString() const;
 
+      /// what the edns opt pseudo record of a message says (rfc 6891)
+      struct EDNS
+      {
+        /// the biggest udp reply the sender takes
+        uint16_t udpSize;
+        /// the sender wants dnssec records
+        bool dnssecOK;
+      };
+
       MsgID_t hdr_id;
       Fields_t hdr_fields;
       std::vector<Question> questions;
       std::vector<ResourceRecord> answers;
       std::vector<ResourceRecord> authorities;
       std::vector<ResourceRecord> additional;
+      /// set when decoding a message that has an opt record
+      std::optional<EDNS> edns;
     };
 
     std::optional<Message>
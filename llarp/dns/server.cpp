@@ -5,6 +5,7 @@
 #include <iterator>
 #include <llarp/crypto/crypto.hpp>
 #include <array>
+#include <chrono>
 #include <stdexcept>
 #include <utility>
 #include <llarp/ev/udp_handle.hpp>
@@ -82,6 +83,56 @@ namespace llarp::dns
     }
   };
 
+  /// passes replies to a hook before handing them to the packet source the query came in on, if
+  /// there is one.  used to fill the answer cache and to run background refreshes.
+  class CachingPacketSource : public PacketSource_Base
+  {
+    std::shared_ptr<PacketSource_Base> m_Wrapped;
+    std::function<void(llarp_buffer_t)> m_OnReply;
+
+   public:
+    explicit CachingPacketSource(
+        std::shared_ptr<PacketSource_Base> wrapped, std::function<void(llarp_buffer_t)> on_reply)
+        : m_Wrapped{std::move(wrapped)}, m_OnReply{std::move(on_reply)}
+    {}
+
+    bool
+    WouldLoop(const SockAddr& to, const SockAddr& from) const override
+    {
+      return m_Wrapped and m_Wrapped->WouldLoop(to, from);
+    }
+
+    void
+    SendTo(const SockAddr& to, const SockAddr& from, OwnedBuffer buf) const override
+    {
+      m_OnReply(buf);
+      if (m_Wrapped)
+        m_Wrapped->SendTo(to, from, std::move(buf));
+    }
+
+    /// the packet source replies go to without being cached, null for a background refresh
+    const std::shared_ptr<PacketSource_Base>&
+    Wrapped() const
+    {
+      return m_Wrapped;
+    }
+
+    void
+    Stop() override
+    {
+      if (m_Wrapped)
+        m_Wrapped->Stop();
+    }
+
+    std::optional<SockAddr>
+    BoundOn() const override
+    {
+      if (m_Wrapped)
+        return m_Wrapped->BoundOn();
+      return std::nullopt;
+    }
+  };
+
   namespace libunbound
   {
     class Resolver;
@@ -443,6 +494,12 @@ namespace llarp::dns
         return 10;
       }
 
+      bool
+      AnswersCacheable() const override
+      {
+        return true;
+      }
+
       void
       ResetResolver(std::optional<std::vector<SockAddr>> replace_upstream) override
       {
@@ -454,10 +511,10 @@ namespace llarp::dns
 
       template <typename Callable>
       void
-      call(Callable&& f)
+      call(Callable&& f, CallSite site = CallSite::current())
       {
         if (auto loop = m_Loop.lock())
-          loop->call(std::forward<Callable>(f));
+          loop->call(std::forward<Callable>(f), site);
         else
           log::critical(logcat, "no mainloop?");
       }
@@ -579,6 +636,7 @@ namespace llarp::dns
       , m_Config{std::move(conf)}
       , m_Platform{CreatePlatform()}
       , m_NetIfIndex{std::move(netif)}
+      , m_Cache{m_Config.m_CacheSize, m_Config.m_CacheServeStale}
   {}
 
   std::vector<std::weak_ptr<Resolver_Base>>
@@ -699,6 +757,8 @@ namespace llarp::dns
   void
   Server::Reset()
   {
+    // upstreams may have changed under us
+    m_Cache.Clear();
     for (const auto& resolver : m_Resolvers)
     {
       if (auto ptr = resolver.lock())
@@ -753,13 +813,69 @@ namespace llarp::dns
       }
     }
 
+    const auto started = std::chrono::steady_clock::now();
+    if (auto hit = m_Cache.Get(msg, m_Loop->time_now()))
+    {
+      log::trace(logcat, "dns from {} to {} answered from cache (stale={})", from, to, hit->stale);
+      ptr->SendTo(from, to, std::move(hit->reply));
+      m_Cache.RecordLatency(
+          true,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - started));
+      if (hit->refresh)
+        Refresh(msg, to, from);
+      return true;
+    }
+
+    auto caching = std::make_shared<CachingPacketSource>(
+        std::move(ptr), [self = weak_from_this(), query = msg, started](llarp_buffer_t buf) {
+          auto server = self.lock();
+          if (not server)
+            return;
+          server->m_Cache.Put(query, buf, server->m_Loop->time_now());
+          server->m_Cache.RecordLatency(
+              false,
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - started));
+        });
+    return Resolve(std::move(caching), msg, to, from);
+  }
+
+  void
+  Server::Refresh(const Message& query, const SockAddr& to, const SockAddr& from)
+  {
+    log::debug(logcat, "refreshing cached dns answer for {}", query.questions[0].qname);
+    auto refresh = std::make_shared<CachingPacketSource>(
+        nullptr, [self = weak_from_this(), query](llarp_buffer_t buf) {
+          if (auto server = self.lock())
+            server->m_Cache.Put(query, buf, server->m_Loop->time_now());
+        });
+    Resolve(std::move(refresh), query, to, from);
+  }
+
+  bool
+  Server::Resolve(
+      std::shared_ptr<PacketSource_Base> ptr,
+      const Message& msg,
+      const SockAddr& to,
+      const SockAddr& from)
+  {
     for (const auto& resolver : m_Resolvers)
     {
       if (auto res_ptr = resolver.lock())
       {
         log::trace(
             logcat, "check resolver {} for dns from {} to {}", res_ptr->ResolverName(), from, to);
-        if (res_ptr->MaybeHookDNS(ptr, msg, to, from))
+        auto src = ptr;
+        if (not res_ptr->AnswersCacheable())
+        {
+          // answers we make up ourselves go straight back and never into the cache
+          if (auto caching = std::dynamic_pointer_cast<CachingPacketSource>(ptr))
+            src = caching->Wrapped();
+          if (not src)
+            continue;
+        }
+        if (res_ptr->MaybeHookDNS(std::move(src), msg, to, from))
         {
           log::trace(
               logcat, "resolver {} handling dns from {} to {}", res_ptr->ResolverName(), from, to);
@@ -770,4 +886,10 @@ namespace llarp::dns
     return false;
   }
 
+  util::StatusObject
+  Server::ExtractStatus() const
+  {
+    return {{"cache", m_Cache.ExtractStatus()}};
+  }
+
 }  // namespace llarp::dns
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cache.hpp"
 #include "message.hpp"
 #include "platform.hpp"
 #include <llarp/config/config.hpp>
@@ -189,6 +190,15 @@ namespace llarp::dns
     Down()
     {}
 
+    /// true if the server may cache what this resolver answers and serve it again, or stale.
+    /// answers lokinet makes up itself for .loki, .snode and our own ranges track state that
+    /// changes under them so by default they are not cached.
+    virtual bool
+    AnswersCacheable() const
+    {
+      return false;
+    }
+
     /// attempt to handle a dns message
     /// returns true if we consumed this query and it should not be processed again
     virtual bool
@@ -272,13 +282,31 @@ namespace llarp::dns
     void
     SetDNSMode(bool all_queries);
 
+    /// status of our answer cache
+    util::StatusObject
+    ExtractStatus() const;
+
    protected:
     EventLoop_ptr m_Loop;
     llarp::DnsConfig m_Config;
     std::shared_ptr<I_Platform> m_Platform;
 
    private:
+    /// pass a query to the first resolver that will take it
+    bool
+    Resolve(
+        std::shared_ptr<PacketSource_Base> pktsource,
+        const Message& query,
+        const SockAddr& resolver,
+        const SockAddr& from);
+
+    /// resolve a cached question again in the background so that its entry is replaced before it
+    /// expires, or so that a stale entry is brought up to date
+    void
+    Refresh(const Message& query, const SockAddr& resolver, const SockAddr& from);
+
     const unsigned int m_NetIfIndex;
+    AnswerCache m_Cache;
     std::set<std::shared_ptr<Resolver_Base>, ComparePtr<std::shared_ptr<Resolver_Base>>>
         m_OwnedResolvers;
     std::set<std::weak_ptr<Resolver_Base>, CompareWeakPtr<Resolver_Base>> m_Resolvers;
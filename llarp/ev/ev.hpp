@@ -5,6 +5,7 @@
 #include <llarp/util/thread/threading.hpp>
 #include <llarp/constants/evloop.hpp>
 #include <llarp/net/interface_info.hpp>
+#include "loop_profiler.hpp"
 #include <algorithm>
 #include <deque>
 #include <list>
@@ -59,9 +60,10 @@ namespace llarp
     // destruction only initiates removal of the periodic task.
     virtual ~EventLoopRepeater() = default;
 
-    // Starts the repeater to call `task` every `every` period.
+    // Starts the repeater to call `task` every `every` period.  `site` is where the task is
+    // profiled as coming from.
     virtual void
-    start(llarp_time_t every, std::function<void()> task) = 0;
+    start(llarp_time_t every, std::function<void()> task, CallSite site) = 0;
   };
 
   // this (nearly!) abstract base class
@@ -86,9 +88,13 @@ namespace llarp
     // Calls a function/lambda/etc.  If invoked from within the event loop itself this calls the
     // given lambda immediately; otherwise it passes it to `call_soon()` to be queued to run at the
     // next event loop iteration.
+    //
+    // Every method here that takes a callback also takes the `site` the loop profiler files it
+    // under, which defaults to the caller.  Code that only hands a callback along should pass its
+    // own caller's site on, or every callback it hands over ends up filed under it.
     template <typename Callable>
     void
-    call(Callable&& f)
+    call(Callable&& f, CallSite site = CallSite::current())
     {
       if (inEventLoop())
       {
@@ -96,7 +102,7 @@ namespace llarp
         wakeup();
       }
       else
-        call_soon(std::forward<Callable>(f));
+        call_soon(std::forward<Callable>(f), site);
     }
 
     // Queues a function to be called on the next event loop cycle and triggers it to be called as
@@ -104,11 +110,14 @@ namespace llarp
     // job even if called from the event loop thread itself and so you *usually* want to use
     // `call()` instead.
     virtual void
-    call_soon(std::function<void(void)> f) = 0;
+    call_soon(std::function<void(void)> f, CallSite site = CallSite::current()) = 0;
 
     // Adds a timer to the event loop to invoke the given callback after a delay.
     virtual void
-    call_later(llarp_time_t delay_ms, std::function<void(void)> callback) = 0;
+    call_later(
+        llarp_time_t delay_ms,
+        std::function<void(void)> callback,
+        CallSite site = CallSite::current()) = 0;
 
     // Created a repeated timer that fires ever `repeat` time unit.  Lifetime of the event
     // is tied to `owner`: callbacks will be invoked so long as `owner` remains alive, but
@@ -127,7 +136,11 @@ namespace llarp
     //
     template <typename Callable>  // Templated so that the compiler can inline the call
     void
-    call_every(llarp_time_t repeat, std::weak_ptr<void> owner, Callable f)
+    call_every(
+        llarp_time_t repeat,
+        std::weak_ptr<void> owner,
+        Callable f,
+        CallSite site = CallSite::current())
     {
       auto repeater = make_repeater();
       auto& r = *repeater;  // reference *before* we pass ownership into the lambda below
@@ -140,7 +153,8 @@ namespace llarp
               repeater.reset();  // Trigger timer removal on tied object destruction (we should be
                                  // the only thing holding the repeater; ideally it would be a
                                  // unique_ptr, but std::function says nuh-uh).
-          });
+          },
+          site);
     }
 
     // Wraps a lambda with a lambda that triggers it to be called via loop->call()
@@ -154,9 +168,9 @@ namespace llarp
     // Arguments are forwarded to the inner lambda (allowing moving arguments into it).
     template <typename Callable>
     auto
-    make_caller(Callable f)
+    make_caller(Callable f, CallSite site = CallSite::current())
     {
-      return [this, f = std::move(f)](auto&&... args) {
+      return [this, f = std::move(f), site](auto&&... args) {
         if (inEventLoop())
           return f(std::forward<decltype(args)>(args)...);
 
@@ -166,20 +180,24 @@ namespace llarp
         // arguments aren't copyable (because of std::function).  Dammit.
         auto args_tuple_ptr = std::make_shared<std::tuple<std::decay_t<decltype(args)>...>>(
             std::forward<decltype(args)>(args)...);
-        call_soon([f, args = std::move(args_tuple_ptr)]() mutable {
-          // Moving away the tuple args here is okay because this lambda will only be invoked once
-          std::apply(f, std::move(*args));
-        });
+        call_soon(
+            [f, args = std::move(args_tuple_ptr)]() mutable {
+              // Moving away the tuple args here is okay because this lambda will only be invoked
+              // once
+              std::apply(f, std::move(*args));
+            },
+            site);
       };
     }
 
     virtual bool
     add_network_interface(
         std::shared_ptr<vpn::NetworkInterface> netif,
-        std::function<void(net::IPPacket)> packetHandler) = 0;
+        std::function<void(net::IPPacket)> packetHandler,
+        CallSite site = CallSite::current()) = 0;
 
     virtual bool
-    add_ticker(std::function<void(void)> ticker) = 0;
+    add_ticker(std::function<void(void)> ticker, CallSite site = CallSite::current()) = 0;
 
     virtual void
     stop() = 0;
@@ -193,14 +211,14 @@ namespace llarp
 
     // Constructs a UDP socket that can be used for sending and/or receiving
     virtual std::shared_ptr<UDPHandle>
-    make_udp(UDPReceiveFunc on_recv) = 0;
+    make_udp(UDPReceiveFunc on_recv, CallSite site = CallSite::current()) = 0;
 
     /// Make a thread-safe event loop waker (an "async" in libuv terminology) on this event loop;
     /// you can call `->Trigger()` on the returned shared pointer to fire the callback at the next
     /// available event loop iteration.  (Multiple Trigger calls invoked before the call is actually
     /// made are coalesced into one call).
     virtual std::shared_ptr<EventLoopWakeup>
-    make_waker(std::function<void()> callback) = 0;
+    make_waker(std::function<void()> callback, CallSite site = CallSite::current()) = 0;
 
     // Initializes a new repeated task object. Note that the task is not actually added to the event
     // loop until you call start() on the returned object.  Typically invoked via call_every.
@@ -228,6 +246,18 @@ namespace llarp
     // Idempotent and thread-safe.
     virtual void
     wakeup() = 0;
+
+    // Returns the profiler that times the callbacks this loop runs.  It does nothing until it is
+    // enabled, and should only be read from within the event loop.
+    LoopProfiler&
+    profiler()
+    {
+      return *m_Profiler;
+    }
+
+   protected:
+    // Shared with the handles the loop makes, which can outlive it
+    const std::shared_ptr<LoopProfiler> m_Profiler = std::make_shared<LoopProfiler>();
   };
 
   using EventLoop_ptr = std::shared_ptr<EventLoop>;
@@ -3,8 +3,15 @@
 #include <thread>
 #include <type_traits>
 #include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 #include <llarp/util/exceptions.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/util/thread/queue.hpp>
 #include <llarp/vpn/platform.hpp>
 
@@ -23,10 +30,17 @@ namespace llarp::uv
     std::shared_ptr<uvw::AsyncHandle> async;
 
    public:
-    UVWakeup(uvw::Loop& loop, std::function<void()> callback)
+    UVWakeup(
+        uvw::Loop& loop,
+        std::function<void()> callback,
+        std::shared_ptr<LoopProfiler> profiler,
+        CallSite site)
         : async{loop.resource<uvw::AsyncHandle>()}
     {
-      async->on<uvw::AsyncEvent>([f = std::move(callback)](auto&, auto&) { f(); });
+      async->on<uvw::AsyncEvent>(
+          [f = std::move(callback), profiler = std::move(profiler), site](auto&, auto&) {
+            profiler->Run(site, f);
+          });
     }
 
     void
@@ -44,16 +58,21 @@ namespace llarp::uv
   class UVRepeater final : public EventLoopRepeater
   {
     std::shared_ptr<uvw::TimerHandle> timer;
+    std::shared_ptr<LoopProfiler> profiler;
 
    public:
-    UVRepeater(uvw::Loop& loop) : timer{loop.resource<uvw::TimerHandle>()}
+    UVRepeater(uvw::Loop& loop, std::shared_ptr<LoopProfiler> profiler)
+        : timer{loop.resource<uvw::TimerHandle>()}, profiler{std::move(profiler)}
     {}
 
     void
-    start(llarp_time_t every, std::function<void()> task) override
+    start(llarp_time_t every, std::function<void()> task, CallSite site) override
     {
       timer->start(every, every);
-      timer->on<uvw::TimerEvent>([task = std::move(task)](auto&, auto&) { task(); });
+      timer->on<uvw::TimerEvent>(
+          [task = std::move(task), profiler = profiler, site](auto&, auto&) {
+            profiler->Run(site, task);
+          });
     }
 
     ~UVRepeater() override
@@ -64,11 +83,15 @@ namespace llarp::uv
 
   struct UDPHandle final : llarp::UDPHandle
   {
-    UDPHandle(uvw::Loop& loop, ReceiveFunc rf);
+    UDPHandle(
+        uvw::Loop& loop, ReceiveFunc rf, std::shared_ptr<LoopProfiler> profiler, CallSite site);
 
     bool
     listen(const SockAddr& addr) override;
 
+    bool
+    listen_shared(const SockAddr& addr) override;
+
     bool
     send(const SockAddr& dest, const llarp_buffer_t& buf) override;
 
@@ -99,6 +122,8 @@ namespace llarp::uv
 
    private:
     std::shared_ptr<uvw::UDPHandle> handle;
+    const std::shared_ptr<LoopProfiler> profiler;
+    const CallSite site;
 
     void
     reset_handle(uvw::Loop& loop);
@@ -107,19 +132,22 @@ namespace llarp::uv
   void
   Loop::FlushLogic()
   {
-    llarp::LogTrace("Loop::FlushLogic() start");
+    LogTraceHot("Loop::FlushLogic() start");
+    static auto& callTime = metrics::registry().GetHistogram(
+        "lokinet_loop_call_seconds", "time spent running each call queued onto the event loop");
     while (not m_LogicCalls.empty())
     {
-      auto f = m_LogicCalls.popFront();
-      f();
+      auto [f, site] = m_LogicCalls.popFront();
+      metrics::Timer timer{callTime};
+      m_Profiler->Run(site, f);
     }
-    llarp::LogTrace("Loop::FlushLogic() end");
+    LogTraceHot("Loop::FlushLogic() end");
   }
 
   void
   Loop::tick_event_loop()
   {
-    llarp::LogTrace("ticking event loop.");
+    LogTraceHot("ticking event loop.");
     FlushLogic();
   }
 
@@ -168,18 +196,24 @@ namespace llarp::uv
   }
 
   std::shared_ptr<llarp::UDPHandle>
-  Loop::make_udp(UDPReceiveFunc on_recv)
+  Loop::make_udp(UDPReceiveFunc on_recv, CallSite site)
   {
     return std::static_pointer_cast<llarp::UDPHandle>(
-        std::make_shared<llarp::uv::UDPHandle>(*m_Impl, std::move(on_recv)));
+        std::make_shared<llarp::uv::UDPHandle>(*m_Impl, std::move(on_recv), m_Profiler, site));
   }
 
   static void
-  setup_oneshot_timer(uvw::Loop& loop, llarp_time_t delay, std::function<void()> callback)
+  setup_oneshot_timer(
+      uvw::Loop& loop,
+      llarp_time_t delay,
+      std::function<void()> callback,
+      std::shared_ptr<LoopProfiler> profiler,
+      CallSite site)
   {
     auto timer = loop.resource<uvw::TimerHandle>();
-    timer->on<uvw::TimerEvent>([f = std::move(callback)](const auto&, auto& timer) {
-      f();
+    timer->on<uvw::TimerEvent>([f = std::move(callback), profiler = std::move(profiler), site](
+                                   const auto&, auto& timer) {
+      profiler->Run(site, f);
       timer.stop();
       timer.close();
     });
@@ -187,7 +221,7 @@ namespace llarp::uv
   }
 
   void
-  Loop::call_later(llarp_time_t delay_ms, std::function<void(void)> callback)
+  Loop::call_later(llarp_time_t delay_ms, std::function<void(void)> callback, CallSite site)
   {
     llarp::LogTrace("Loop::call_after_delay()");
 #ifdef TESTNET_SPEED
@@ -195,18 +229,20 @@ namespace llarp::uv
 #endif
 
     if (inEventLoop())
-      setup_oneshot_timer(*m_Impl, delay_ms, std::move(callback));
+      setup_oneshot_timer(*m_Impl, delay_ms, std::move(callback), m_Profiler, site);
     else
     {
-      call_soon([this, f = std::move(callback), target_time = time_now() + delay_ms] {
-        // Recalculate delay because it may have taken some time to get ourselves into the logic
-        // thread
-        auto updated_delay = target_time - time_now();
-        if (updated_delay <= 0ms)
-          f();  // Timer already expired!
-        else
-          setup_oneshot_timer(*m_Impl, updated_delay, std::move(f));
-      });
+      call_soon(
+          [this, f = std::move(callback), target_time = time_now() + delay_ms, site] {
+            // Recalculate delay because it may have taken some time to get ourselves into the
+            // logic thread
+            auto updated_delay = target_time - time_now();
+            if (updated_delay <= 0ms)
+              f();  // Timer already expired!
+            else
+              setup_oneshot_timer(*m_Impl, updated_delay, std::move(f), m_Profiler, site);
+          },
+          site);
     }
   }
 
@@ -231,10 +267,12 @@ namespace llarp::uv
   }
 
   bool
-  Loop::add_ticker(std::function<void(void)> func)
+  Loop::add_ticker(std::function<void(void)> func, CallSite site)
   {
     auto check = m_Impl->resource<uvw::CheckHandle>();
-    check->on<uvw::CheckEvent>([f = std::move(func)](auto&, auto&) { f(); });
+    check->on<uvw::CheckEvent>([f = std::move(func), profiler = m_Profiler, site](auto&, auto&) {
+      profiler->Run(site, f);
+    });
     check->start();
     return true;
   }
@@ -242,7 +280,8 @@ namespace llarp::uv
   bool
   Loop::add_network_interface(
       std::shared_ptr<llarp::vpn::NetworkInterface> netif,
-      std::function<void(llarp::net::IPPacket)> handler)
+      std::function<void(llarp::net::IPPacket)> handler,
+      CallSite site)
   {
 #ifdef __linux__
     using event_t = uvw::PollEvent;
@@ -258,14 +297,22 @@ namespace llarp::uv
     if (!handle)
       return false;
 
-    handle->on<event_t>([netif = std::move(netif), handler = std::move(handler)](
-                            const event_t&, [[maybe_unused]] auto& handle) {
+    handle->on<event_t>([netif = std::move(netif),
+                         handler = std::move(handler),
+                         profiler = m_Profiler,
+                         site](const event_t&, [[maybe_unused]] auto& handle) {
+      static auto& packets = metrics::registry().GetCounter(
+          "lokinet_tun_read_packets_total", "packets read off our network interface");
+      static auto& bytes = metrics::registry().GetCounter(
+          "lokinet_tun_read_bytes_total", "bytes read off our network interface");
       for (auto pkt = netif->ReadNextPacket(); true; pkt = netif->ReadNextPacket())
       {
         if (pkt.empty())
           return;
+        packets.Add();
+        bytes.Add(pkt.size());
         if (handler)
-          handler(std::move(pkt));
+          profiler->Run(site, [&]() { handler(std::move(pkt)); });
         // on windows/apple, vpn packet io does not happen as an io action that wakes up the event
         // loop thus, we must manually wake up the event loop when we get a packet on our interface.
         // on linux/android this is a nop
@@ -283,11 +330,11 @@ namespace llarp::uv
   }
 
   void
-  Loop::call_soon(std::function<void(void)> f)
+  Loop::call_soon(std::function<void(void)> f, CallSite site)
   {
     if (not m_EventLoopThreadID.has_value())
     {
-      m_LogicCalls.tryPushBack(f);
+      m_LogicCalls.tryPushBack(std::make_pair(std::move(f), site));
       m_WakeUp->send();
       return;
     }
@@ -296,7 +343,7 @@ namespace llarp::uv
     {
       FlushLogic();
     }
-    m_LogicCalls.pushBack(f);
+    m_LogicCalls.pushBack(std::make_pair(std::move(f), site));
     m_WakeUp->send();
   }
 
@@ -309,14 +356,24 @@ namespace llarp::uv
       handle->close();
     handle = loop.resource<uvw::UDPHandle>();
     handle->on<uvw::UDPDataEvent>([this](auto& event, auto& /*handle*/) {
-      on_recv(
-          *this,
-          SockAddr{event.sender.ip, huint16_t{static_cast<uint16_t>(event.sender.port)}},
-          OwnedBuffer{std::move(event.data), event.length});
+      static auto& packets = metrics::registry().GetCounter(
+          "lokinet_udp_recv_packets_total", "udp packets read off our sockets");
+      static auto& bytes = metrics::registry().GetCounter(
+          "lokinet_udp_recv_bytes_total", "udp payload bytes read off our sockets");
+      packets.Add();
+      bytes.Add(event.length);
+      profiler->Run(site, [&]() {
+        on_recv(
+            *this,
+            SockAddr{event.sender.ip, huint16_t{static_cast<uint16_t>(event.sender.port)}},
+            OwnedBuffer{std::move(event.data), event.length});
+      });
     });
   }
 
-  llarp::uv::UDPHandle::UDPHandle(uvw::Loop& loop, ReceiveFunc rf) : llarp::UDPHandle{std::move(rf)}
+  llarp::uv::UDPHandle::UDPHandle(
+      uvw::Loop& loop, ReceiveFunc rf, std::shared_ptr<LoopProfiler> profiler, CallSite site)
+      : llarp::UDPHandle{std::move(rf)}, profiler{std::move(profiler)}, site{site}
   {
     reset_handle(loop);
   }
@@ -337,6 +394,34 @@ namespace llarp::uv
     return true;
   }
 
+  bool
+  UDPHandle::listen_shared(const SockAddr& addr)
+  {
+#ifdef SO_REUSEPORT
+    // libuv only gives us SO_REUSEADDR, which does not balance unicast packets on linux, so we
+    // make and bind the socket ourselves and hand it over
+    const int fd = ::socket(addr.isIPv6() ? AF_INET6 : AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+      return false;
+    const int on = 1;
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0
+        or ::bind(fd, static_cast<const sockaddr*>(addr), addr.sockaddr_len()) < 0)
+    {
+      const auto err = errno;
+      ::close(fd);
+      throw llarp::util::bind_socket_error{
+          fmt::format("failed to bind shared udp socket on {}: {}", addr, strerror(err))};
+    }
+    if (handle->active())
+      reset_handle(handle->loop());
+    handle->open(fd);
+    handle->recv();
+    return true;
+#else
+    return false;
+#endif
+  }
+
   bool
   UDPHandle::send(const SockAddr& to, const llarp_buffer_t& buf)
   {
@@ -360,16 +445,17 @@ namespace llarp::uv
   }
 
   std::shared_ptr<llarp::EventLoopWakeup>
-  Loop::make_waker(std::function<void()> callback)
+  Loop::make_waker(std::function<void()> callback, CallSite site)
   {
     return std::static_pointer_cast<llarp::EventLoopWakeup>(
-        std::make_shared<UVWakeup>(*m_Impl, std::move(callback)));
+        std::make_shared<UVWakeup>(*m_Impl, std::move(callback), m_Profiler, site));
   }
 
   std::shared_ptr<EventLoopRepeater>
   Loop::make_repeater()
   {
-    return std::static_pointer_cast<EventLoopRepeater>(std::make_shared<UVRepeater>(*m_Impl));
+    return std::static_pointer_cast<EventLoopRepeater>(
+        std::make_shared<UVRepeater>(*m_Impl, m_Profiler));
   }
 
   bool
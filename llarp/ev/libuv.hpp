@@ -38,7 +38,10 @@ namespace llarp::uv
     }
 
     void
-    call_later(llarp_time_t delay_ms, std::function<void(void)> callback) override;
+    call_later(
+        llarp_time_t delay_ms,
+        std::function<void(void)> callback,
+        CallSite site = CallSite::current()) override;
 
     void
     tick_event_loop();
@@ -47,24 +50,25 @@ namespace llarp::uv
     stop() override;
 
     bool
-    add_ticker(std::function<void(void)> ticker) override;
+    add_ticker(std::function<void(void)> ticker, CallSite site = CallSite::current()) override;
 
     bool
     add_network_interface(
         std::shared_ptr<llarp::vpn::NetworkInterface> netif,
-        std::function<void(llarp::net::IPPacket)> handler) override;
+        std::function<void(llarp::net::IPPacket)> handler,
+        CallSite site = CallSite::current()) override;
 
     void
-    call_soon(std::function<void(void)> f) override;
+    call_soon(std::function<void(void)> f, CallSite site = CallSite::current()) override;
 
     std::shared_ptr<llarp::EventLoopWakeup>
-    make_waker(std::function<void()> callback) override;
+    make_waker(std::function<void()> callback, CallSite site = CallSite::current()) override;
 
     std::shared_ptr<EventLoopRepeater>
     make_repeater() override;
 
     virtual std::shared_ptr<llarp::UDPHandle>
-    make_udp(UDPReceiveFunc on_recv) override;
+    make_udp(UDPReceiveFunc on_recv, CallSite site = CallSite::current()) override;
 
     void
     FlushLogic();
@@ -82,7 +86,7 @@ namespace llarp::uv
    private:
     std::shared_ptr<uvw::AsyncHandle> m_WakeUp;
     std::atomic<bool> m_Run;
-    using AtomicQueue_t = llarp::thread::Queue<std::function<void(void)>>;
+    using AtomicQueue_t = llarp::thread::Queue<std::pair<std::function<void(void)>, CallSite>>;
     AtomicQueue_t m_LogicCalls;
 
 #ifdef LOKINET_DEBUG
@@ -0,0 +1,122 @@
+#include "loop_profiler.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace llarp
+{
+  static auto logcat = log::Cat("ev-profile");
+
+  void
+  LoopProfiler::Enable(Clock::duration stallThreshold)
+  {
+    m_StallThreshold = stallThreshold.count();
+    m_Enabled = true;
+  }
+
+  void
+  LoopProfiler::Disable()
+  {
+    m_Enabled = false;
+  }
+
+  void
+  LoopProfiler::Record(const CallSite& where, Clock::duration took)
+  {
+    auto& site = m_Sites.try_emplace(SiteKey{where.file_name(), where.line()}, Site{where})
+                     .first->second;
+    site.calls++;
+    site.total += took;
+    site.max = std::max(site.max, took);
+    const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(took).count();
+    size_t bucket = 0;
+    while (bucket + 1 < site.buckets.size() and (usec >> bucket) > 0)
+      bucket++;
+    site.buckets[bucket]++;
+
+    if (took < Clock::duration{m_StallThreshold.load(std::memory_order_relaxed)})
+      return;
+    site.stalls++;
+    site.unwarnedStalls++;
+    const auto now = Clock::now();
+    if (now - site.lastWarned < StallWarnInterval)
+      return;
+    log::warning(
+        logcat,
+        "event loop stalled for {:.1f}ms in {} ({} stalls there since the last warning)",
+        std::chrono::duration<double, std::milli>{took}.count(),
+        SiteName(where),
+        site.unwarnedStalls);
+    site.lastWarned = now;
+    site.unwarnedStalls = 0;
+  }
+
+  std::chrono::microseconds
+  LoopProfiler::Site::Quantile(double q) const
+  {
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(q * calls));
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < buckets.size(); ++idx)
+    {
+      seen += buckets[idx];
+      if (seen >= target)
+        return std::chrono::microseconds{idx ? (int64_t{1} << idx) - 1 : 0};
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(max);
+  }
+
+  util::StatusObject
+  LoopProfiler::TopN(size_t n) const
+  {
+    std::vector<const Site*> sites;
+    sites.reserve(m_Sites.size());
+    for (const auto& [key, site] : m_Sites)
+      sites.push_back(&site);
+    n = std::min(n, sites.size());
+    std::partial_sort(sites.begin(), sites.begin() + n, sites.end(), [](auto a, auto b) {
+      return a->total > b->total;
+    });
+
+    const auto usec = [](auto dur) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(dur).count();
+    };
+    util::StatusObject top = util::StatusObject::array();
+    for (size_t idx = 0; idx < n; ++idx)
+    {
+      const auto* site = sites[idx];
+      top.push_back(util::StatusObject{
+          {"site", SiteName(site->where)},
+          {"calls", site->calls},
+          {"totalUs", usec(site->total)},
+          {"meanUs", usec(site->total) / std::max<uint64_t>(site->calls, 1)},
+          {"p50Us", site->Quantile(0.5).count()},
+          {"p99Us", site->Quantile(0.99).count()},
+          {"maxUs", usec(site->max)},
+          {"stalls", site->stalls}});
+    }
+    return util::StatusObject{
+        {"enabled", Enabled()},
+        {"stallThresholdUs", usec(Clock::duration{m_StallThreshold.load()})},
+        {"seconds", std::chrono::duration<double>{Clock::now() - m_Since}.count()},
+        {"sites", m_Sites.size()},
+        {"top", std::move(top)}};
+  }
+
+  void
+  LoopProfiler::Reset()
+  {
+    m_Sites.clear();
+    m_Since = Clock::now();
+  }
+
+  std::string
+  LoopProfiler::SiteName(const CallSite& site)
+  {
+    // the path the build gave the compiler is of no use to anyone reading this
+    std::string_view file{site.file_name()};
+    if (auto pos = file.rfind("llarp/"); pos != std::string_view::npos)
+      file.remove_prefix(pos);
+    return fmt::format("{}:{} ({})", file, site.line(), site.function_name());
+  }
+}  // namespace llarp
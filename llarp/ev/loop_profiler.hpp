@@ -0,0 +1,112 @@
+#pragma once
+
+#include <llarp/util/logging.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace llarp
+{
+  /// where a callback was handed to the event loop. the loop methods that take callbacks default
+  /// it to their caller, so it only needs passing on by code that hands callbacks along for others.
+  using CallSite = log::slns::source_location;
+
+  /// times every callback the event loop runs, keyed by where the callback came from, so that
+  /// when traffic stalls we can tell whose fault it is.
+  ///
+  /// all of this is only touched on the event loop thread, except for turning it on and off.
+  class LoopProfiler
+  {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    /// how long a callback can run before we warn about it
+    static constexpr auto DefaultStallThreshold = 50ms;
+    /// we warn about stalls from the same site at most this often
+    static constexpr auto StallWarnInterval = 10s;
+
+    bool
+    Enabled() const
+    {
+      return m_Enabled.load(std::memory_order_relaxed);
+    }
+
+    void
+    Enable(Clock::duration stallThreshold);
+
+    void
+    Disable();
+
+    /// run f, timing it against site if we are enabled
+    template <typename Func>
+    void
+    Run(const CallSite& site, Func&& f)
+    {
+      if (not Enabled())
+      {
+        f();
+        return;
+      }
+      const auto start = Clock::now();
+      f();
+      Record(site, Clock::now() - start);
+    }
+
+    void
+    Record(const CallSite& site, Clock::duration took);
+
+    /// the n sites we spent the most time in, with their call counts and latency distribution
+    util::StatusObject
+    TopN(size_t n) const;
+
+    /// forget everything we recorded
+    void
+    Reset();
+
+    /// a readable name for a site
+    static std::string
+    SiteName(const CallSite& site);
+
+   private:
+    struct Site
+    {
+      CallSite where;
+      uint64_t calls = 0;
+      Clock::duration total{0};
+      Clock::duration max{0};
+      uint64_t stalls = 0;
+      /// calls by how many microseconds they took, in powers of two
+      std::array<uint64_t, 24> buckets{};
+      Clock::time_point lastWarned{};
+      uint64_t unwarnedStalls = 0;
+
+      std::chrono::microseconds
+      Quantile(double q) const;
+    };
+
+    std::atomic<bool> m_Enabled = false;
+    std::atomic<Clock::rep> m_StallThreshold = 0;
+    Clock::time_point m_Since = Clock::now();
+    /// a site by the address of its file name and its line, which is cheaper to hash than the name.
+    /// a header can give its file name a different address in every translation unit, so a site
+    /// in a header can show up more than once.
+    using SiteKey = std::pair<const char*, uint_least32_t>;
+
+    struct SiteKeyHash
+    {
+      size_t
+      operator()(const SiteKey& key) const
+      {
+        return std::hash<const char*>{}(key.first) ^ (size_t{key.second} << 1);
+      }
+    };
+
+    std::unordered_map<SiteKey, Site, SiteKeyHash> m_Sites;
+  };
+}  // namespace llarp
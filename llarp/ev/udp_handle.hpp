@@ -14,6 +14,15 @@ namespace llarp
     virtual bool
     listen(const SockAddr& addr) = 0;
 
+    // Like listen(), but sets SO_REUSEPORT on the socket first so that several sockets (each
+    // usually on an event loop of its own) can be bound to the same address, with the kernel
+    // spreading incoming packets over them by sender.  Returns false where this is not supported.
+    virtual bool
+    listen_shared([[maybe_unused]] const SockAddr& addr)
+    {
+      return false;
+    }
+
     // Sends a packet to the given recipient, immediately.  Returns true if the send succeeded,
     // false it could not be performed (either because of error, or because it would have blocked).
     // If listen hasn't been called then a random IP/port will be used.
@@ -73,13 +73,13 @@ namespace llarp
       m_SnodeBlacklist.insert(std::move(snode));
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     BaseSession::GetHopsForBuild()
     {
       if (numHops == 1)
       {
         if (auto maybe = m_router->nodedb()->Get(m_ExitRouter))
-          return std::vector<RouterContact>{*maybe};
+          return std::vector<RouterContact_ptr>{std::move(maybe)};
         return std::nullopt;
       }
       else
@@ -311,12 +311,12 @@ namespace llarp
         if (numHops == 1)
         {
           auto r = m_router;
-          if (const auto maybe = r->nodedb()->Get(m_ExitRouter); maybe.has_value())
-            r->TryConnectAsync(*maybe, 5);
+          if (auto maybe = r->nodedb()->Get(m_ExitRouter))
+            r->TryConnectAsync(std::move(maybe), 5);
           else
             r->LookupRouter(m_ExitRouter, [r](const std::vector<RouterContact>& results) {
               if (results.size())
-                r->TryConnectAsync(results[0], 5);
+                r->TryConnectAsync(std::make_shared<const EncodedRouterContact>(results[0]), 5);
             });
         }
         else if (UrgentBuild(now))
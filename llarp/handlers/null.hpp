@@ -9,8 +9,8 @@
 
 namespace llarp::handlers
 {
-  struct NullEndpoint final : public llarp::service::Endpoint,
-                              public std::enable_shared_from_this<NullEndpoint>
+  struct NullEndpoint : public llarp::service::Endpoint,
+                        public std::enable_shared_from_this<NullEndpoint>
   {
     NullEndpoint(AbstractRouter* r, llarp::service::Context* parent)
         : llarp::service::Endpoint{r, parent}
@@ -20,6 +20,7 @@
 #include <llarp/service/name.hpp>
 #include <llarp/service/protocol_type.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/nodedb.hpp>
 #include <llarp/quic/tunnel.hpp>
 #include <llarp/rpc/endpoint_rpc.hpp>
@@ -37,6 +38,16 @@ namespace llarp
   {
     static auto logcat = log::Cat("tun");
 
+    /// write a packet to the user through the network interface, timing the write
+    static void
+    WriteToUser(vpn::NetworkInterface& netif, net::IPPacket pkt)
+    {
+      static auto& writeTime = metrics::registry().GetHistogram(
+          "lokinet_tun_write_seconds", "time to write a packet to our network interface");
+      metrics::Timer timer{writeTime};
+      netif.WritePacket(std::move(pkt));
+    }
+
     bool
     TunEndpoint::MaybeHookDNS(
         std::shared_ptr<dns::PacketSource_Base> source,
@@ -234,6 +245,9 @@ namespace llarp
       if (not m_DnsConfig.m_bind.empty())
         obj["localResolver"] = localRes[0];
 
+      if (m_DNS)
+        obj["dns"] = m_DNS->ExtractStatus();
+
       util::StatusObject ips{};
       for (const auto& item : m_IPActivity)
       {
@@ -317,6 +331,7 @@ namespace llarp
       m_OwnedRanges = conf.m_OwnedRanges;
 
       m_BaseV6Address = conf.m_baseV6Address;
+      m_TunOffload = conf.m_TunOffload;
 
       if (conf.m_PathAlignmentTimeout)
       {
@@ -479,9 +494,11 @@ namespace llarp
       // flush network to user
       while (not m_NetworkToUserPktQueue.empty())
       {
-        m_NetIf->WritePacket(m_NetworkToUserPktQueue.top().pkt);
+        WriteToUser(*m_NetIf, m_NetworkToUserPktQueue.top().pkt);
         m_NetworkToUserPktQueue.pop();
       }
+      if (m_NetIf)
+        m_NetIf->FlushWrites();
 
       service::Endpoint::Pump(now);
     }
@@ -786,7 +803,7 @@ namespace llarp
               {
                 m_ExitMap.ForEachEntry(
                     [&msg](const auto&, const auto& exit) { msg.AddCNAMEReply(exit.ToString()); });
-                msg.AddINReply(ip, isV6);
+                msg.AddINReply(ip, isV6, MappedAddressTTL);
               }
               else
               {
@@ -795,8 +812,8 @@ namespace llarp
             }
             else
             {
-              msg.AddCNAMEReply(m_Identity.pub.Name(), 1);
-              msg.AddINReply(ip, isV6);
+              msg.AddCNAMEReply(m_Identity.pub.Name(), MappedAddressTTL);
+              msg.AddINReply(ip, isV6, MappedAddressTTL);
             }
           }
           else
@@ -860,7 +877,9 @@ namespace llarp
         {
           if (auto maybe = ObtainAddrForIP(*ip))
           {
-            var::visit([&msg](auto&& result) { msg.AddAReply(result.ToString()); }, *maybe);
+            var::visit(
+                [&msg](auto&& result) { msg.AddAReply(result.ToString(), MappedAddressTTL); },
+                *maybe);
             reply(msg);
             return true;
           }
@@ -1019,6 +1038,7 @@ namespace llarp
       }
 
       info.ifname = m_IfName;
+      info.offload = m_TunOffload;
 
       LogInfo(Name(), " setting up network...");
 
@@ -1036,7 +1056,10 @@ namespace llarp
       LogInfo(Name(), " got network interface ", m_IfName);
 
       auto handle_packet = [netif = m_NetIf, pkt_router = m_PacketRouter](auto pkt) {
-        pkt.reply = [netif](auto pkt) { netif->WritePacket(std::move(pkt)); };
+        pkt.reply = [netif](auto pkt) {
+          WriteToUser(*netif, std::move(pkt));
+          netif->FlushWrites();
+        };
         pkt_router->HandleIPPacket(std::move(pkt));
       };
 
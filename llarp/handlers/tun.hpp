@@ -261,6 +261,10 @@ namespace llarp
           std::function<service::Address(std::unordered_set<service::Address>)> exitSelectionStrat =
               nullptr);
 
+      /// ttl of dns answers for remotes we mapped into our range.  a mapping is only given away
+      /// once the range is exhausted, so clients need not come back every second to re-check it.
+      static constexpr dns::RR_TTL_t MappedAddressTTL = 60;
+
       template <typename Addr_t, typename Endpoint_t>
       void
       SendDNSReply(
@@ -274,7 +278,7 @@ namespace llarp
         {
           huint128_t ip = ObtainIPForAddr(addr);
           query->answers.clear();
-          query->AddINReply(ip, sendIPv6);
+          query->AddINReply(ip, sendIPv6, MappedAddressTTL);
         }
         else
           query->AddNXReply();
@@ -306,6 +310,8 @@ namespace llarp
       std::string m_IfName;
 
       std::optional<huint128_t> m_BaseV6Address;
+      /// ask for gso/gro and checksum offload on our interface
+      bool m_TunOffload = false;
 
       std::shared_ptr<vpn::NetworkInterface> m_NetIf;
 
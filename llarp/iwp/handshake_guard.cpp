@@ -0,0 +1,120 @@
+#include "handshake_guard.hpp"
+
+#include <llarp/crypto/crypto.hpp>
+
+#include <oxenc/endian.h>
+
+#include <array>
+
+namespace llarp::iwp
+{
+  HandshakeGuard::HandshakeGuard()
+  {
+    m_Secret.Randomize();
+    m_LastSecret.Randomize();
+  }
+
+  HandshakeGuard::Verdict
+  HandshakeGuard::Admit(
+      const SockAddr& from,
+      const std::optional<HandshakeCookie>& cookie,
+      size_t inFlight,
+      llarp_time_t now)
+  {
+    if (inFlight >= MaxInFlight)
+    {
+      m_Overloaded++;
+      return Verdict::Drop;
+    }
+    const bool gotCookie = cookie and CheckCookie(from, *cookie);
+    if (not gotCookie and inFlight >= CookieThreshold)
+    {
+      m_CookiesSent++;
+      return Verdict::SendCookie;
+    }
+    SockAddr source{from};
+    source.setPort(0);
+    auto& budget = m_Budgets.try_emplace(source, Budget{now + RateInterval}).first->second;
+    if (budget.resetAt <= now)
+      budget = Budget{now + RateInterval};
+    if (budget.intros >= MaxIntrosPerSource)
+    {
+      m_RateLimited++;
+      return Verdict::Drop;
+    }
+    budget.intros++;
+    if (gotCookie)
+      m_CookiesAccepted++;
+    m_Accepted++;
+    return Verdict::Accept;
+  }
+
+  HandshakeCookie
+  HandshakeGuard::MakeCookie(const SockAddr& from) const
+  {
+    return MakeCookie(from, m_Secret);
+  }
+
+  HandshakeCookie
+  HandshakeGuard::MakeCookie(const SockAddr& from, const SharedSecret& secret) const
+  {
+    std::array<byte_t, 18> addr;
+    const auto ip = from.asIPv6();
+    oxenc::write_host_as_big(ip.h.upper, addr.data());
+    oxenc::write_host_as_big(ip.h.lower, addr.data() + 8);
+    oxenc::write_host_as_big(from.getPort(), addr.data() + 16);
+    ShortHash digest;
+    CryptoManager::instance()->hmac(
+        digest.data(), llarp_buffer_t{addr.data(), addr.size()}, secret);
+    HandshakeCookie cookie;
+    std::copy_n(digest.begin(), cookie.size(), cookie.begin());
+    return cookie;
+  }
+
+  bool
+  HandshakeGuard::CheckCookie(const SockAddr& from, const HandshakeCookie& cookie) const
+  {
+    return cookie == MakeCookie(from, m_Secret) or cookie == MakeCookie(from, m_LastSecret);
+  }
+
+  void
+  HandshakeGuard::HandshakeVerified(bool success)
+  {
+    if (success)
+      m_Verified++;
+    else
+      m_VerifyFailed++;
+  }
+
+  void
+  HandshakeGuard::Decay(llarp_time_t now)
+  {
+    if (now >= m_RotateAt)
+    {
+      m_LastSecret = m_Secret;
+      m_Secret.Randomize();
+      m_RotateAt = now + CookieInterval;
+    }
+    for (auto itr = m_Budgets.begin(); itr != m_Budgets.end();)
+    {
+      if (itr->second.resetAt <= now)
+        itr = m_Budgets.erase(itr);
+      else
+        ++itr;
+    }
+  }
+
+  util::StatusObject
+  HandshakeGuard::ExtractStatus() const
+  {
+    return {
+        {"accepted", m_Accepted},
+        {"cookiesSent", m_CookiesSent},
+        {"cookiesAccepted", m_CookiesAccepted},
+        {"rateLimited", m_RateLimited},
+        {"overloaded", m_Overloaded},
+        {"verified", m_Verified},
+        {"verifyFailed", m_VerifyFailed},
+        {"sources", uint64_t{m_Budgets.size()}}};
+  }
+}  // namespace llarp::iwp
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <llarp/crypto/types.hpp>
+#include <llarp/net/sock_addr.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <optional>
+#include <unordered_map>
+
+namespace llarp::iwp
+{
+  /// a stateless handshake cookie, a keyed hash of the address an intro came from
+  using HandshakeCookie = AlignedBuffer<24>;
+
+  /// decides which intros from unknown addresses an inbound link spends public key crypto on.
+  ///
+  /// while the link is not busy every intro is taken, limited per source ip. once it has many
+  /// handshakes in flight it only takes intros that echo a cookie we sent to their address, so a
+  /// flood of spoofed intros costs us a reply each and no state at all.
+  class HandshakeGuard
+  {
+   public:
+    enum class Verdict
+    {
+      /// verify the intro and make a session
+      Accept,
+      /// reply with a cookie and forget about it
+      SendCookie,
+      /// forget about it
+      Drop
+    };
+
+    /// how long we hand out cookies under a secret, a cookie is good for up to twice this long
+    static constexpr auto CookieInterval = 10s;
+    /// how long a source gets to use its intro budget
+    static constexpr auto RateInterval = 1s;
+    /// how many intros we take from one ip per rate interval
+    static constexpr size_t MaxIntrosPerSource = 8;
+    /// how many handshakes we take in flight before we demand cookies
+    static constexpr size_t CookieThreshold = 64;
+    /// how many handshakes we ever have in flight, we drop intros past that
+    static constexpr size_t MaxInFlight = 512;
+
+    HandshakeGuard();
+
+    /// decide what to do with an intro from an unknown address, given the cookie it carried and
+    /// how many handshakes we have in flight
+    Verdict
+    Admit(
+        const SockAddr& from,
+        const std::optional<HandshakeCookie>& cookie,
+        size_t inFlight,
+        llarp_time_t now);
+
+    /// make the cookie we hand out to from
+    HandshakeCookie
+    MakeCookie(const SockAddr& from) const;
+
+    /// return true if cookie is one we handed out to from recently
+    bool
+    CheckCookie(const SockAddr& from, const HandshakeCookie& cookie) const;
+
+    /// an accepted intro was verified on the worker pool, or was not
+    void
+    HandshakeVerified(bool success);
+
+    /// rotate the cookie secret and forget sources whose rate interval is over
+    void
+    Decay(llarp_time_t now);
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    HandshakeCookie
+    MakeCookie(const SockAddr& from, const SharedSecret& secret) const;
+
+    struct Budget
+    {
+      llarp_time_t resetAt;
+      size_t intros = 0;
+    };
+
+    SharedSecret m_Secret;
+    SharedSecret m_LastSecret;
+    llarp_time_t m_RotateAt = 0s;
+    /// keyed by source ip with the port zeroed
+    std::unordered_map<SockAddr, Budget> m_Budgets;
+
+    uint64_t m_Accepted = 0;
+    uint64_t m_CookiesSent = 0;
+    uint64_t m_CookiesAccepted = 0;
+    uint64_t m_RateLimited = 0;
+    uint64_t m_Overloaded = 0;
+    uint64_t m_Verified = 0;
+    uint64_t m_VerifyFailed = 0;
+  };
+}  // namespace llarp::iwp
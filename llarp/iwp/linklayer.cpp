@@ -26,6 +26,12 @@ namespace llarp::iwp
       , m_Inbound{allowInbound}
   {}
 
+  LinkLayer::~LinkLayer()
+  {
+    if (m_DataPlane)
+      m_DataPlane->Stop();
+  }
+
   std::string_view
   LinkLayer::Name() const
   {
@@ -52,19 +58,11 @@ namespace llarp::iwp
   {
     std::shared_ptr<ILinkSession> session;
     auto itr = m_AuthedAddrs.find(from);
-    bool isNewSession = false;
     if (itr == m_AuthedAddrs.end())
     {
       Lock_t lock{m_PendingMutex};
-      auto it = m_Pending.find(from);
-      if (it == m_Pending.end())
-      {
-        if (not m_Inbound)
-          return;
-        isNewSession = true;
-        it = m_Pending.emplace(from, std::make_shared<Session>(this, from)).first;
-      }
-      session = it->second;
+      if (auto it = m_Pending.find(from); it != m_Pending.end())
+        session = it->second;
     }
     else
     {
@@ -73,22 +71,164 @@ namespace llarp::iwp
     }
     if (session)
     {
-      bool success = session->Recv_LL(std::move(pkt));
-      if (not success and isNewSession)
-      {
-        LogDebug("Brand new session failed; removing from pending sessions list");
-        m_Pending.erase(from);
-      }
+      session->Recv_LL(std::move(pkt));
       WakeupPlaintext();
     }
+    else if (m_Inbound and itr == m_AuthedAddrs.end())
+      HandleIntro(from, std::move(pkt));
+  }
+
+  bool
+  LinkLayer::PrepareOnShard(size_t shard, const SockAddr& from, ILinkSession::Packet_t& pkt)
+  {
+    const auto& sessions = m_ShardSessions[shard];
+    const auto itr = sessions.find(from);
+    // the keyed hash is checked before anything is decrypted, so whatever does not check out
+    // against the session key (a new handshake from the same address, say) goes on untouched
+    if (itr == sessions.end() or not DecryptPacket(pkt, itr->second->SessionKey()))
+      return false;
+    itr->second->RecvDecrypted(shard, std::move(pkt));
+    return true;
+  }
+
+  void
+  LinkLayer::CallOnShard(size_t shard, std::function<void()> f)
+  {
+    if (m_DataPlane)
+      m_DataPlane->CallOnShard(shard, std::move(f));
+  }
+
+  void
+  LinkLayer::SetupShards(size_t count)
+  {
+    m_ShardSessions.resize(count);
+  }
+
+  bool
+  LinkLayer::MapAddr(const RouterID& pk, ILinkSession* s)
+  {
+    if (not ILinkLayer::MapAddr(pk, s))
+      return false;
+    if (m_DataPlane)
+    {
+      m_DataPlane->CallOnShards(
+          [this,
+           addr = s->GetRemoteEndpoint(),
+           session = static_cast<Session*>(s)->shared_from_this()](size_t shard) {
+            m_ShardSessions[shard][addr] = session;
+          });
+    }
+    return true;
+  }
+
+  void
+  LinkLayer::UnmapAddr(const SockAddr& addr)
+  {
+    ILinkLayer::UnmapAddr(addr);
+    if (m_DataPlane)
+      m_DataPlane->CallOnShards([this, addr](size_t shard) { m_ShardSessions[shard].erase(addr); });
+  }
+
+  void
+  LinkLayer::HandleIntro(const SockAddr& from, ILinkSession::Packet_t pkt)
+  {
+    // one intro per address at a time, the initiator does not resend it anyways
+    if (m_Verifying.count(from))
+      return;
+    const PubKey pk = GetOurRC().pubkey;
+    if (pk != m_IntroKeyFor)
+    {
+      CryptoManager::instance()->shorthash(m_IntroKey, llarp_buffer_t(pk));
+      m_IntroKeyFor = pk;
+    }
+    if (not DecryptPacket(pkt, m_IntroKey) or pkt.size() < Introduction::SIZE + PacketOverhead)
+    {
+      LogDebug("bad intro from ", from);
+      return;
+    }
+    std::optional<HandshakeCookie> cookie;
+    if (pkt.size() >= Introduction::SIZE + PacketOverhead + HandshakeCookie::SIZE)
+    {
+      cookie.emplace();
+      std::copy_n(
+          pkt.data() + PacketOverhead + Introduction::SIZE, HandshakeCookie::SIZE, cookie->data());
+    }
+    const auto inFlight = m_Verifying.size() + NumberOfPendingSessions();
+    switch (m_Handshakes.Admit(from, cookie, inFlight, Now()))
+    {
+      case HandshakeGuard::Verdict::Accept:
+        break;
+      case HandshakeGuard::Verdict::SendCookie:
+        SendCookie(from);
+        return;
+      case HandshakeGuard::Verdict::Drop:
+        LogDebug("dropping intro from ", from);
+        return;
+    }
+    // the signature check and key exchange are what a flood of intros would stall the event loop
+    // on, so they go to the worker pool and the session is only made once they pass
+    m_Verifying.emplace(from);
+    QueueWork([this, from, pkt = std::move(pkt)]() {
+      auto intro = Session::VerifyIntro(pkt, TransportSecretKey());
+      m_Router->loop()->call(
+          [this, from, intro = std::move(intro)]() { HandleVerifiedIntro(from, intro); });
+    });
+  }
+
+  void
+  LinkLayer::HandleVerifiedIntro(const SockAddr& from, const std::optional<VerifiedIntro>& intro)
+  {
+    m_Verifying.erase(from);
+    m_Handshakes.HandshakeVerified(intro.has_value());
+    if (not intro)
+    {
+      LogDebug("intro verify failed from ", from);
+      return;
+    }
+    if (m_AuthedAddrs.count(from))
+      return;
+    auto session = std::make_shared<Session>(this, from, *intro);
+    {
+      Lock_t lock{m_PendingMutex};
+      if (not m_Pending.emplace(from, session).second)
+        return;
+    }
+    session->Start();
+  }
+
+  void
+  LinkLayer::SendCookie(const SockAddr& to)
+  {
+    const auto cookie = m_Handshakes.MakeCookie(to);
+    ILinkSession::Packet_t reply(cookie.size() + PacketOverhead);
+    CryptoManager::instance()->randbytes(reply.data() + HMACSIZE, TUNNONCESIZE);
+    std::copy_n(cookie.data(), cookie.size(), reply.data() + PacketOverhead);
+    EncryptPacket(reply, m_IntroKey);
+    SendTo_LL(to, llarp_buffer_t{reply});
+  }
+
+  void
+  LinkLayer::Tick(llarp_time_t now)
+  {
+    ILinkLayer::Tick(now);
+    m_Handshakes.Decay(now);
+  }
+
+  util::StatusObject
+  LinkLayer::ExtractStatus() const
+  {
+    auto status = ILinkLayer::ExtractStatus();
+    if (m_Inbound)
+      status["handshakes"] = m_Handshakes.ExtractStatus();
+    return status;
   }
 
   std::shared_ptr<ILinkSession>
-  LinkLayer::NewOutboundSession(const RouterContact& rc, const AddressInfo& ai)
+  LinkLayer::NewOutboundSession(RouterContact_ptr rc, const AddressInfo& ai)
   {
     if (m_Inbound)
       throw std::logic_error{"inbound link cannot make outbound sessions"};
-    return std::make_shared<Session>(this, rc, ai);
+    return std::make_shared<Session>(this, std::move(rc), ai);
   }
 
   void
@@ -6,14 +6,20 @@
 #include <llarp/crypto/types.hpp>
 #include <llarp/link/server.hpp>
 #include <llarp/config/key_manager.hpp>
+#include "handshake_guard.hpp"
 
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <llarp/ev/ev.hpp>
 
 namespace llarp::iwp
 {
   struct Session;
+  struct VerifiedIntro;
 
   struct LinkLayer final : public ILinkLayer
   {
@@ -32,8 +38,11 @@ namespace llarp::iwp
         WorkerFunc_t dowork,
         bool permitInbound);
 
+    /// stops the data plane first, its threads use our shard sessions
+    ~LinkLayer() override;
+
     std::shared_ptr<ILinkSession>
-    NewOutboundSession(const RouterContact& rc, const AddressInfo& ai) override;
+    NewOutboundSession(RouterContact_ptr rc, const AddressInfo& ai) override;
 
     std::string_view
     Name() const override;
@@ -44,19 +53,66 @@ namespace llarp::iwp
     void
     RecvFrom(const SockAddr& from, ILinkSession::Packet_t pkt) override;
 
+    /// hands packets of established sessions to their session on the data plane thread that
+    /// read them, which decrypts and handles them right there
+    bool
+    PrepareOnShard(size_t shard, const SockAddr& from, ILinkSession::Packet_t& pkt) override;
+
+    /// run f on the thread of data plane shard, see DataPlane::CallOnShard
+    void
+    CallOnShard(size_t shard, std::function<void()> f);
+
+    bool
+    MapAddr(const RouterID& pk, ILinkSession* s) override;
+
+    void
+    UnmapAddr(const SockAddr& addr) override;
+
+    void
+    Tick(llarp_time_t now) override;
+
+    util::StatusObject
+    ExtractStatus() const override;
+
     void
     WakeupPlaintext();
 
     std::string
     PrintableName() const;
 
+   protected:
+    void
+    SetupShards(size_t count) override;
+
    private:
     void
     HandleWakeupPlaintext();
 
+    /// handle a packet from an address we have no session with, which should be an intro
+    void
+    HandleIntro(const SockAddr& from, ILinkSession::Packet_t pkt);
+
+    /// called on the event loop once the worker pool checked an intro we accepted
+    void
+    HandleVerifiedIntro(const SockAddr& from, const std::optional<VerifiedIntro>& intro);
+
+    void
+    SendCookie(const SockAddr& to);
+
     const std::shared_ptr<EventLoopWakeup> m_Wakeup;
     std::vector<ILinkSession*> m_WakingUp;
     const bool m_Inbound;
+
+    HandshakeGuard m_Handshakes;
+    /// addresses whose intros are being verified on the worker pool
+    std::unordered_set<SockAddr> m_Verifying;
+    /// key intros to us are encrypted with, a hash of our identity key
+    SharedSecret m_IntroKey;
+    PubKey m_IntroKeyFor;
+    /// per data plane shard, our established sessions by remote address.  each is only touched
+    /// on its shard's thread, the main loop keeps them up to date through
+    /// DataPlane::CallOnShards.
+    std::vector<std::unordered_map<SockAddr, std::shared_ptr<Session>>> m_ShardSessions;
   };
 
   using LinkLayer_ptr = std::shared_ptr<LinkLayer>;
@@ -131,7 +131,7 @@ namespace llarp
       byte_t* dst = m_Data.data() + idx;
       std::copy_n(buf.base, buf.sz, dst);
       m_Acks.set(idx / FragmentSize);
-      LogTrace("got fragment ", idx / FragmentSize);
+      LogTraceHot("got fragment ", idx / FragmentSize);
       m_LastActiveAt = now;
     }
 
@@ -3,6 +3,7 @@
 #include <llarp/messages/link_intro.hpp>
 #include <llarp/messages/discard.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/router/abstractrouter.hpp>
 
 #include <queue>
@@ -29,43 +30,85 @@ namespace llarp
       return pkt;
     }
 
+    void
+    EncryptPacket(ILinkSession::Packet_t& pkt, const SharedSecret& key)
+    {
+      llarp_buffer_t pktbuf{pkt};
+      const TunnelNonce nonce_ptr{pkt.data() + HMACSIZE};
+      pktbuf.base += PacketOverhead;
+      pktbuf.cur = pktbuf.base;
+      pktbuf.sz -= PacketOverhead;
+      CryptoManager::instance()->xchacha20(pktbuf, key, nonce_ptr);
+      pktbuf.base = pkt.data() + HMACSIZE;
+      pktbuf.sz = pkt.size() - HMACSIZE;
+      CryptoManager::instance()->hmac(pkt.data(), pktbuf, key);
+    }
+
+    bool
+    DecryptPacket(ILinkSession::Packet_t& pkt, const SharedSecret& key)
+    {
+      if (pkt.size() <= PacketOverhead)
+        return false;
+      ShortHash H;
+      llarp_buffer_t curbuf(pkt.data() + ShortHash::SIZE, pkt.size() - ShortHash::SIZE);
+      if (not CryptoManager::instance()->hmac(H.data(), curbuf, key))
+        return false;
+      if (H != ShortHash{pkt.data()})
+        return false;
+      const TunnelNonce N{curbuf.base};
+      curbuf.base += TunnelNonce::SIZE;
+      curbuf.sz -= TunnelNonce::SIZE;
+      return CryptoManager::instance()->xchacha20(curbuf, key, N);
+    }
+
     constexpr size_t PlaintextQueueSize = 512;
 
-    Session::Session(LinkLayer* p, const RouterContact& rc, const AddressInfo& ai)
+    /// what inbound sessions hold for the remote rc until their intro arrives
+    static const RouterContact_ptr&
+    UnknownRC()
+    {
+      static const auto none = std::make_shared<const EncodedRouterContact>(RouterContact{});
+      return none;
+    }
+
+    Session::Session(LinkLayer* p, RouterContact_ptr rc, const AddressInfo& ai)
         : m_State{State::Initial}
         , m_Inbound{false}
         , m_Parent(p)
         , m_CreatedAt{p->Now()}
         , m_RemoteAddr{ai}
         , m_ChosenAI(ai)
-        , m_RemoteRC(rc)
+        , m_RemoteRC(std::move(rc))
         , m_PlaintextRecv{PlaintextQueueSize}
     {
       token.Zero();
       m_PlaintextEmpty.test_and_set();
       GotLIM = util::memFn(&Session::GotOutboundLIM, this);
-      CryptoManager::instance()->shorthash(m_SessionKey, llarp_buffer_t(rc.pubkey));
+      CryptoManager::instance()->shorthash(m_IntroKey, llarp_buffer_t(m_RemoteRC->pubkey));
+      m_SessionKey = m_IntroKey;
     }
 
-    Session::Session(LinkLayer* p, const SockAddr& from)
+    Session::Session(LinkLayer* p, const SockAddr& from, const VerifiedIntro& intro)
         : m_State{State::Initial}
         , m_Inbound{true}
         , m_Parent(p)
         , m_CreatedAt{p->Now()}
         , m_RemoteAddr{from}
+        , m_RemoteRC{UnknownRC()}
+        , m_SessionKey{intro.sessionKey}
+        , m_ExpectedIdent{intro.ident}
+        , m_RemoteOnionKey{intro.onionKey}
         , m_PlaintextRecv{PlaintextQueueSize}
     {
       token.Randomize();
       m_PlaintextEmpty.test_and_set();
       GotLIM = util::memFn(&Session::GotInboundLIM, this);
-      const PubKey pk = m_Parent->GetOurRC().pubkey;
-      CryptoManager::instance()->shorthash(m_SessionKey, llarp_buffer_t(pk));
     }
 
     void
     Session::Send_LL(const byte_t* buf, size_t sz)
     {
-      LogTrace("send ", sz, " to ", m_RemoteAddr);
+      LogTraceHot("send ", sz, " to ", m_RemoteAddr);
       const llarp_buffer_t pkt(buf, sz);
       m_Parent->SendTo_LL(m_RemoteAddr, pkt);
       m_LastTX = time_now_ms();
@@ -75,6 +118,7 @@ namespace llarp
     bool
     Session::GotInboundLIM(const LinkIntroMessage* msg)
     {
+      std::lock_guard lock{m_Access};
       if (msg->rc.pubkey != m_ExpectedIdent)
       {
         LogError(
@@ -83,28 +127,30 @@ namespace llarp
       }
       m_State = State::Ready;
       GotLIM = util::memFn(&Session::GotRenegLIM, this);
-      m_RemoteRC = msg->rc;
-      m_Parent->MapAddr(m_RemoteRC.pubkey, this);
+      m_RemoteRC = std::make_shared<const EncodedRouterContact>(msg->rc);
+      m_Parent->MapAddr(m_RemoteRC->pubkey, this);
       return m_Parent->SessionEstablished(this, true);
     }
 
     bool
     Session::GotOutboundLIM(const LinkIntroMessage* msg)
     {
-      if (msg->rc.pubkey != m_RemoteRC.pubkey)
+      std::lock_guard lock{m_Access};
+      if (msg->rc.pubkey != m_RemoteRC->pubkey)
       {
         LogError("ident key mismatch");
         return false;
       }
 
-      m_RemoteRC = msg->rc;
+      m_RemoteRC = std::make_shared<const EncodedRouterContact>(msg->rc);
       GotLIM = util::memFn(&Session::GotRenegLIM, this);
       assert(shared_from_this().use_count() > 1);
       SendOurLIM([self = shared_from_this()](ILinkSession::DeliveryStatus st) {
         if (st == ILinkSession::DeliveryStatus::eDeliverySuccess)
         {
+          std::lock_guard lock{self->m_Access};
           self->m_State = State::Ready;
-          self->m_Parent->MapAddr(self->m_RemoteRC.pubkey, self.get());
+          self->m_Parent->MapAddr(self->m_RemoteRC->pubkey, self.get());
           self->m_Parent->SessionEstablished(self.get(), false);
         }
       });
@@ -141,8 +187,11 @@ namespace llarp
     void
     Session::EncryptAndSend(ILinkSession::Packet_t data)
     {
+      std::lock_guard lock{m_Access};
       m_EncryptNext.emplace_back(std::move(data));
-      TriggerPump();
+      // a data plane thread sends what it queued itself once it is done with its packet
+      if (not m_OnShard)
+        TriggerPump();
       if (!IsEstablished())
       {
         EncryptWorker(std::move(m_EncryptNext));
@@ -153,18 +202,10 @@ namespace llarp
     void
     Session::EncryptWorker(CryptoQueue_t msgs)
     {
-      LogTrace("encrypt worker ", msgs.size(), " messages");
+      LogTraceHot("encrypt worker ", msgs.size(), " messages");
       for (auto& pkt : msgs)
       {
-        llarp_buffer_t pktbuf{pkt};
-        const TunnelNonce nonce_ptr{pkt.data() + HMACSIZE};
-        pktbuf.base += PacketOverhead;
-        pktbuf.cur = pktbuf.base;
-        pktbuf.sz -= PacketOverhead;
-        CryptoManager::instance()->xchacha20(pktbuf, m_SessionKey, nonce_ptr);
-        pktbuf.base = pkt.data() + HMACSIZE;
-        pktbuf.sz = pkt.size() - HMACSIZE;
-        CryptoManager::instance()->hmac(pkt.data(), pktbuf, m_SessionKey);
+        EncryptPacket(pkt, m_SessionKey);
         Send_LL(pkt.data(), pkt.size());
       }
     }
@@ -172,6 +213,7 @@ namespace llarp
     void
     Session::Close()
     {
+      std::lock_guard lock{m_Access};
       if (m_State == State::Closed)
         return;
       auto close_msg = CreatePacket(Command::eCLOS, 0, 16, 16);
@@ -188,6 +230,7 @@ namespace llarp
     Session::SendMessageBuffer(
         ILinkSession::Message_t buf, ILinkSession::CompletionHandler completed, uint16_t priority)
     {
+      std::lock_guard lock{m_Access};
       if (m_TXMsgs.size() >= MaxSendQueueSize)
       {
         if (completed)
@@ -207,7 +250,7 @@ namespace llarp
         msg.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
       }
       m_Stats.totalInFlightTX++;
-      LogDebug("send message ", msgid, " to ", m_RemoteAddr);
+      LogDebugHot("send message ", msgid, " to ", m_RemoteAddr);
       return true;
     }
 
@@ -223,7 +266,7 @@ namespace llarp
         auto mack = CreatePacket(Command::eMACK, 1 + (numAcks * sizeof(uint64_t)));
         mack[PacketOverhead + CommandOverhead] = byte_t{static_cast<byte_t>(numAcks)};
         byte_t* ptr = mack.data() + 3 + PacketOverhead;
-        LogTrace("send ", numAcks, " macks to ", m_RemoteAddr);
+        LogTraceHot("send ", numAcks, " macks to ", m_RemoteAddr);
         const auto& itr = m_SendMACKs.top();
         while (numAcks > 0)
         {
@@ -245,6 +288,7 @@ namespace llarp
     void
     Session::Pump()
     {
+      std::lock_guard lock{m_Access};
       const auto now = m_Parent->Now();
       if (m_State == State::Ready || m_State == State::LinkIntro)
       {
@@ -286,13 +330,21 @@ namespace llarp
             [self = shared_from_this(), data = m_DecryptNext] { self->DecryptWorker(data); });
         m_DecryptNext.clear();
       }
+
+      if (not m_PlaintextNext.empty())
+      {
+        m_PlaintextRecv.tryPushBack(std::move(m_PlaintextNext));
+        m_PlaintextNext.clear();
+        m_PlaintextEmpty.clear();
+        m_Parent->WakeupPlaintext();
+      }
     }
 
     bool
     Session::GotRenegLIM(const LinkIntroMessage* lim)
     {
       LogDebug("renegotiate session on ", m_RemoteAddr);
-      return m_Parent->SessionRenegotiate(lim->rc, m_RemoteRC);
+      return m_Parent->SessionRenegotiate(lim->rc, *m_RemoteRC);
     }
 
     bool
@@ -305,10 +357,11 @@ namespace llarp
     bool
     Session::ShouldPing() const
     {
+      std::lock_guard lock{m_Access};
       if (m_State == State::Ready)
       {
         const auto now = m_Parent->Now();
-        return now - m_LastTX > PingInterval;
+        return now - m_LastTX.load() > PingInterval;
       }
       return false;
     }
@@ -316,13 +369,14 @@ namespace llarp
     SessionStats
     Session::GetSessionStats() const
     {
-      // TODO: thread safety
+      std::lock_guard lock{m_Access};
       return m_Stats;
     }
 
     util::StatusObject
     Session::ExtractStatus() const
     {
+      std::lock_guard lock{m_Access};
       const auto now = m_Parent->Now();
 
       return {
@@ -344,7 +398,7 @@ namespace llarp
           {"txMsgQueueSize", m_TXMsgs.size()},
           {"rxMsgQueueSize", m_RXMsgs.size()},
           {"remoteAddr", m_RemoteAddr.ToString()},
-          {"remoteRC", m_RemoteRC.ExtractStatus()},
+          {"remoteRC", m_RemoteRC->ExtractStatus()},
           {"created", to_json(m_CreatedAt)},
           {"uptime", to_json(now - m_CreatedAt)}};
     }
@@ -352,12 +406,13 @@ namespace llarp
     bool
     Session::TimedOut(llarp_time_t now) const
     {
+      std::lock_guard lock{m_Access};
       if (m_State == State::Ready)
       {
         return now > m_LastRX
             && now - m_LastRX
-            > (m_Inbound and not m_RemoteRC.IsPublicRouter() ? DefaultLinkSessionLifetime
-                                                             : SessionAliveTimeout);
+            > (m_Inbound and not m_RemoteRC->IsPublicRouter() ? DefaultLinkSessionLifetime
+                                                              : SessionAliveTimeout);
       }
       return now - m_CreatedAt >= LinkLayerConnectTimeout;
     }
@@ -371,15 +426,15 @@ namespace llarp
     void
     Session::ResetRates()
     {
-      m_Stats.currentRateTX = m_TXRate;
+      m_Stats.currentRateTX = m_TXRate.exchange(0);
       m_Stats.currentRateRX = m_RXRate;
       m_RXRate = 0;
-      m_TXRate = 0;
     }
 
     void
     Session::Tick(llarp_time_t now)
     {
+      std::lock_guard lock{m_Access};
       if (ShouldResetRates(now))
       {
         ResetRates();
@@ -395,7 +450,7 @@ namespace llarp
           {
             m_Stats.totalDroppedTX++;
             m_Stats.totalInFlightTX--;
-            LogTrace("Dropped unacked packet to ", m_RemoteAddr);
+            LogTraceHot("Dropped unacked packet to ", m_RemoteAddr);
             itr->second.InformTimeout();
             itr = m_TXMsgs.erase(itr);
           }
@@ -432,16 +487,14 @@ namespace llarp
       }
     }
 
-    using Introduction =
-        AlignedBuffer<PubKey::SIZE + PubKey::SIZE + TunnelNonce::SIZE + Signature::SIZE>;
-
     void
     Session::GenerateAndSendIntro()
     {
       TunnelNonce N;
       N.Randomize();
       {
-        ILinkSession::Packet_t req(Introduction::SIZE + PacketOverhead);
+        const size_t cookieSize = m_Cookie ? m_Cookie->size() : 0;
+        ILinkSession::Packet_t req(Introduction::SIZE + PacketOverhead + cookieSize);
         const auto pk = m_Parent->GetOurRC().pubkey;
         const auto e_pk = m_Parent->RouterEncryptionSecret().toPublic();
         auto itr = req.data() + PacketOverhead;
@@ -457,7 +510,13 @@ namespace llarp
             Z.data(),
             Z.size(),
             req.data() + PacketOverhead + (Introduction::SIZE - Signature::SIZE));
+        if (m_Cookie)
+        {
+          std::copy_n(
+              m_Cookie->data(), cookieSize, req.data() + PacketOverhead + Introduction::SIZE);
+        }
         CryptoManager::instance()->randbytes(req.data() + HMACSIZE, TUNNONCESIZE);
+        m_SessionKey = m_IntroKey;
         EncryptAndSend(std::move(req));
       }
       m_State = State::Introduction;
@@ -502,19 +561,17 @@ namespace llarp
       SendOurLIM();
     }
 
-    void
-    Session::HandleGotIntro(Packet_t pkt)
+    std::optional<VerifiedIntro>
+    Session::VerifyIntro(const Packet_t& pkt, const SecretKey& transportKey)
     {
       if (pkt.size() < (Introduction::SIZE + PacketOverhead))
-      {
-        LogWarn(m_Parent->PrintableName(), " intro too small from ", m_RemoteAddr);
-        return;
-      }
-      byte_t* ptr = pkt.data() + PacketOverhead;
+        return std::nullopt;
+      const byte_t* ptr = pkt.data() + PacketOverhead;
+      VerifiedIntro intro;
       TunnelNonce N;
-      std::copy_n(ptr, PubKey::SIZE, m_ExpectedIdent.data());
+      std::copy_n(ptr, PubKey::SIZE, intro.ident.data());
       ptr += PubKey::SIZE;
-      std::copy_n(ptr, PubKey::SIZE, m_RemoteOnionKey.data());
+      std::copy_n(ptr, PubKey::SIZE, intro.onionKey.data());
       ptr += PubKey::SIZE;
       std::copy_n(ptr, TunnelNonce::SIZE, N.data());
       ptr += TunnelNonce::SIZE;
@@ -522,34 +579,12 @@ namespace llarp
       std::copy_n(ptr, Z.size(), Z.data());
       const llarp_buffer_t verifybuf(
           pkt.data() + PacketOverhead, Introduction::SIZE - Signature::SIZE);
-      if (!CryptoManager::instance()->verify(m_ExpectedIdent, verifybuf, Z))
-      {
-        LogError(m_Parent->PrintableName(), " intro verify failed from ", m_RemoteAddr);
-        return;
-      }
-      const PubKey pk = m_Parent->TransportSecretKey().toPublic();
-      LogDebug(
-          "got intro: remote-pk=",
-          m_RemoteOnionKey.ToHex(),
-          " N=",
-          N.ToHex(),
-          " local-pk=",
-          pk.ToHex());
+      if (not CryptoManager::instance()->verify(intro.ident, verifybuf, Z))
+        return std::nullopt;
       if (not CryptoManager::instance()->transport_dh_server(
-              m_SessionKey, m_RemoteOnionKey, m_Parent->TransportSecretKey(), N))
-      {
-        LogError("failed to transport_dh_server on inbound intro from ", m_RemoteAddr);
-        return;
-      }
-      Packet_t reply(token.size() + PacketOverhead);
-      // random nonce
-      CryptoManager::instance()->randbytes(reply.data() + HMACSIZE, TUNNONCESIZE);
-      // set token
-      std::copy_n(token.data(), token.size(), reply.data() + PacketOverhead);
-      m_LastRX = m_Parent->Now();
-      EncryptAndSend(std::move(reply));
-      LogDebug("sent intro ack to ", m_RemoteAddr);
-      m_State = State::Introduction;
+              intro.sessionKey, intro.onionKey, transportKey, N))
+        return std::nullopt;
+      return intro;
     }
 
     void
@@ -567,12 +602,13 @@ namespace llarp
             m_RemoteAddr);
         return;
       }
-      Packet_t reply(token.size() + PacketOverhead);
       if (not DecryptMessageInPlace(pkt))
       {
-        LogError(m_Parent->PrintableName(), " intro ack decrypt failed from ", m_RemoteAddr);
+        if (not HandleCookie(pkt))
+          LogError(m_Parent->PrintableName(), " intro ack decrypt failed from ", m_RemoteAddr);
         return;
       }
+      Packet_t reply(token.size() + PacketOverhead);
       m_LastRX = m_Parent->Now();
       std::copy_n(pkt.data() + PacketOverhead, token.size(), token.data());
       std::copy_n(token.data(), token.size(), reply.data() + PacketOverhead);
@@ -583,6 +619,21 @@ namespace llarp
       m_State = State::LinkIntro;
     }
 
+    bool
+    Session::HandleCookie(Packet_t& pkt)
+    {
+      // only ever answer one cookie, anyone can make them
+      if (m_Cookie or not DecryptPacket(pkt, m_IntroKey))
+        return false;
+      if (pkt.size() < PacketOverhead + HandshakeCookie::SIZE)
+        return false;
+      m_Cookie.emplace();
+      std::copy_n(pkt.data() + PacketOverhead, HandshakeCookie::SIZE, m_Cookie->data());
+      LogDebug("got handshake cookie from ", m_RemoteAddr, ", sending intro again");
+      GenerateAndSendIntro();
+      return true;
+    }
+
     bool
     Session::DecryptMessageInPlace(Packet_t& pkt)
     {
@@ -591,46 +642,46 @@ namespace llarp
         LogError("packet too small from ", m_RemoteAddr);
         return false;
       }
-      const llarp_buffer_t buf(pkt);
-      ShortHash H;
-      llarp_buffer_t curbuf(buf.base, buf.sz);
-      curbuf.base += ShortHash::SIZE;
-      curbuf.sz -= ShortHash::SIZE;
-      if (not CryptoManager::instance()->hmac(H.data(), curbuf, m_SessionKey))
+      static auto& decryptTime = metrics::registry().GetHistogram(
+          "lokinet_link_decrypt_seconds", "time to authenticate and decrypt a link packet");
+      bool decrypted;
       {
-        LogError("failed to caclulate keyed hash for ", m_RemoteAddr);
-        return false;
+        metrics::Timer timer{decryptTime};
+        decrypted = DecryptPacket(pkt, m_SessionKey);
       }
-      const ShortHash expected{buf.base};
-      if (H != expected)
+      if (not decrypted)
       {
-        LogDebug(
+        LogDebugHot(
             m_Parent->PrintableName(),
-            " keyed hash mismatch ",
-            H,
-            " != ",
-            expected,
-            " from ",
+            " keyed hash mismatch from ",
             m_RemoteAddr,
             " state=",
             int(m_State),
             " size=",
-            buf.sz);
+            pkt.size());
         return false;
       }
-      const TunnelNonce N{curbuf.base};
-      curbuf.base += 32;
-      curbuf.sz -= 32;
-      LogTrace("decrypt: ", curbuf.sz, " bytes from ", m_RemoteAddr);
-      return CryptoManager::instance()->xchacha20(curbuf, m_SessionKey, N);
+      LogTraceHot("decrypt: ", pkt.size() - PacketOverhead, " bytes from ", m_RemoteAddr);
+      return true;
     }
 
     void
     Session::Start()
     {
-      if (m_Inbound)
+      std::lock_guard lock{m_Access};
+      if (not m_Inbound)
+      {
+        GenerateAndSendIntro();
         return;
-      GenerateAndSendIntro();
+      }
+      // the intro was verified before we were made, ack it with our token
+      Packet_t reply(token.size() + PacketOverhead);
+      CryptoManager::instance()->randbytes(reply.data() + HMACSIZE, TUNNONCESIZE);
+      std::copy_n(token.data(), token.size(), reply.data() + PacketOverhead);
+      m_LastRX = m_Parent->Now();
+      EncryptAndSend(std::move(reply));
+      LogDebug("sent intro ack to ", m_RemoteAddr);
+      m_State = State::Introduction;
     }
 
     void
@@ -675,43 +726,48 @@ namespace llarp
     {
       if (m_PlaintextEmpty.test_and_set())
         return;
+      std::lock_guard lock{m_Access};
       while (auto maybe_queue = m_PlaintextRecv.tryPopFront())
       {
         for (auto& result : *maybe_queue)
-        {
-          LogTrace("Command ", int(result[PacketOverhead + 1]), " from ", m_RemoteAddr);
-          switch (result[PacketOverhead + 1])
-          {
-            case Command::eXMIT:
-              HandleXMIT(std::move(result));
-              break;
-            case Command::eDATA:
-              HandleDATA(std::move(result));
-              break;
-            case Command::eACKS:
-              HandleACKS(std::move(result));
-              break;
-            case Command::ePING:
-              HandlePING(std::move(result));
-              break;
-            case Command::eNACK:
-              HandleNACK(std::move(result));
-              break;
-            case Command::eCLOS:
-              HandleCLOS(std::move(result));
-              break;
-            case Command::eMACK:
-              HandleMACK(std::move(result));
-              break;
-            default:
-              LogError("invalid command ", int(result[PacketOverhead + 1]), " from ", m_RemoteAddr);
-          }
-        }
+          HandleCommand(std::move(result));
       }
       SendMACK();
       m_Parent->WakeupPlaintext();
     }
 
+    void
+    Session::HandleCommand(Packet_t pkt)
+    {
+      LogTraceHot("Command ", int(pkt[PacketOverhead + 1]), " from ", m_RemoteAddr);
+      switch (pkt[PacketOverhead + 1])
+      {
+        case Command::eXMIT:
+          HandleXMIT(std::move(pkt));
+          break;
+        case Command::eDATA:
+          HandleDATA(std::move(pkt));
+          break;
+        case Command::eACKS:
+          HandleACKS(std::move(pkt));
+          break;
+        case Command::ePING:
+          HandlePING(std::move(pkt));
+          break;
+        case Command::eNACK:
+          HandleNACK(std::move(pkt));
+          break;
+        case Command::eCLOS:
+          HandleCLOS(std::move(pkt));
+          break;
+        case Command::eMACK:
+          HandleMACK(std::move(pkt));
+          break;
+        default:
+          LogError("invalid command ", int(pkt[PacketOverhead + 1]), " from ", m_RemoteAddr);
+      }
+    }
+
     void
     Session::HandleMACK(Packet_t data)
     {
@@ -726,12 +782,12 @@ namespace llarp
         LogError("short mack from ", m_RemoteAddr);
         return;
       }
-      LogTrace("got ", int(numAcks), " mack from ", m_RemoteAddr);
+      LogTraceHot("got ", int(numAcks), " mack from ", m_RemoteAddr);
       byte_t* ptr = data.data() + CommandOverhead + PacketOverhead + 1;
       while (numAcks > 0)
       {
         auto acked = oxenc::load_big_to_host<uint64_t>(ptr);
-        LogTrace("mack containing txid=", acked, " from ", m_RemoteAddr);
+        LogTraceHot("mack containing txid=", acked, " from ", m_RemoteAddr);
         auto itr = m_TXMsgs.find(acked);
         if (itr != m_TXMsgs.end())
         {
@@ -742,7 +798,7 @@ namespace llarp
         }
         else
         {
-          LogTrace("ignored mack for txid=", acked, " from ", m_RemoteAddr);
+          LogTraceHot("ignored mack for txid=", acked, " from ", m_RemoteAddr);
         }
         ptr += sizeof(uint64_t);
         numAcks--;
@@ -758,7 +814,7 @@ namespace llarp
         return;
       }
       auto txid = oxenc::load_big_to_host<uint64_t>(data.data() + CommandOverhead + PacketOverhead);
-      LogTrace("got nack on ", txid, " from ", m_RemoteAddr);
+      LogTraceHot("got nack on ", txid, " from ", m_RemoteAddr);
       auto itr = m_TXMsgs.find(txid);
       if (itr != m_TXMsgs.end())
       {
@@ -785,7 +841,7 @@ namespace llarp
       pos += sizeof(rxid);
       auto p2 = pos + ShortHash::SIZE;
       assert(p2 == data.data() + XMITOverhead);
-      LogTrace("rxid=", rxid, " sz=", sz, " h=", oxenc::to_hex(pos, p2), " from ", m_RemoteAddr);
+      LogTraceHot("rxid=", rxid, " sz=", sz, " h=", oxenc::to_hex(pos, p2), " from ", m_RemoteAddr);
       m_LastRX = m_Parent->Now();
       {
         // check for replay
@@ -793,7 +849,7 @@ namespace llarp
         if (itr != m_ReplayFilter.end())
         {
           m_SendMACKs.emplace(rxid);
-          LogTrace("duplicate rxid=", rxid, " from ", m_RemoteAddr);
+          LogTraceHot("duplicate rxid=", rxid, " from ", m_RemoteAddr);
           return;
         }
       }
@@ -827,7 +883,7 @@ namespace llarp
           }
         }
         else
-          LogTrace("got duplicate xmit on ", rxid, " from ", m_RemoteAddr);
+          LogTraceHot("got duplicate xmit on ", rxid, " from ", m_RemoteAddr);
       }
     }
 
@@ -848,14 +904,14 @@ namespace llarp
       {
         if (m_ReplayFilter.find(rxid) == m_ReplayFilter.end())
         {
-          LogTrace("no rxid=", rxid, " for ", m_RemoteAddr);
+          LogTraceHot("no rxid=", rxid, " for ", m_RemoteAddr);
           auto nack = CreatePacket(Command::eNACK, 8);
           oxenc::write_host_as_big(rxid, nack.data() + PacketOverhead + CommandOverhead);
           EncryptAndSend(std::move(nack));
         }
         else
         {
-          LogTrace("replay hit for rxid=", rxid, " for ", m_RemoteAddr);
+          LogTraceHot("replay hit for rxid=", rxid, " for ", m_RemoteAddr);
           m_SendMACKs.emplace(rxid);
         }
         return;
@@ -881,14 +937,23 @@ namespace llarp
     }
 
     void
-    Session::HandleRecvMsgCompleted(const InboundMessage& msg)
+    Session::HandleRecvMsgCompleted(InboundMessage& msg)
     {
       const auto rxid = msg.m_MsgID;
       if (m_ReplayFilter.emplace(rxid, m_Parent->Now()).second)
       {
-        m_Parent->HandleMessage(this, msg.m_Data);
+        if (m_OnShard)
+        {
+          // link messages are handled on the main loop, in the order we completed them
+          m_Parent->Router()->loop()->call_soon(
+              [self = shared_from_this(), data = std::move(msg.m_Data)]() {
+                self->m_Parent->HandleMessage(self.get(), data);
+              });
+        }
+        else
+          m_Parent->HandleMessage(this, msg.m_Data);
         EncryptAndSend(msg.ACKS());
-        LogDebug("recv'd message ", rxid, " from ", m_RemoteAddr);
+        LogDebugHot("recv'd message ", rxid, " from ", m_RemoteAddr);
       }
       m_RXMsgs.erase(rxid);
     }
@@ -907,14 +972,14 @@ namespace llarp
       auto itr = m_TXMsgs.find(txid);
       if (itr == m_TXMsgs.end())
       {
-        LogTrace("no txid=", txid, " for ", m_RemoteAddr);
+        LogTraceHot("no txid=", txid, " for ", m_RemoteAddr);
         return;
       }
       itr->second.Ack(data[10 + PacketOverhead]);
 
       if (itr->second.IsTransmitted())
       {
-        LogDebug("sent message ", itr->first, " to ", m_RemoteAddr);
+        LogDebugHot("sent message ", itr->first, " to ", m_RemoteAddr);
         itr->second.Completed();
         itr = m_TXMsgs.erase(itr);
       }
@@ -928,7 +993,11 @@ namespace llarp
     Session::HandleCLOS(Packet_t)
     {
       LogInfo("remote closed by ", m_RemoteAddr);
-      Close();
+      // closing unmaps us from the link, which is the main loop's
+      if (m_OnShard)
+        m_Parent->Router()->loop()->call_soon([self = shared_from_this()]() { self->Close(); });
+      else
+        Close();
     }
 
     void
@@ -940,6 +1009,7 @@ namespace llarp
     bool
     Session::SendKeepAlive()
     {
+      std::lock_guard lock{m_Access};
       if (m_State == State::Ready)
       {
         EncryptAndSend(CreatePacket(Command::ePING, 0));
@@ -951,12 +1021,14 @@ namespace llarp
     bool
     Session::IsEstablished() const
     {
+      std::lock_guard lock{m_Access};
       return m_State == State::Ready;
     }
 
     bool
     Session::Recv_LL(ILinkSession::Packet_t data)
     {
+      std::lock_guard lock{m_Access};
       m_RXRate += data.size();
 
       // TODO: differentiate between good and bad RX packets here
@@ -964,20 +1036,7 @@ namespace llarp
       switch (m_State)
       {
         case State::Initial:
-          if (m_Inbound)
-          {
-            // initial data
-            // enter introduction phase
-            if (DecryptMessageInPlace(data))
-            {
-              HandleGotIntro(std::move(data));
-            }
-            else
-            {
-              LogDebug("bad intro from ", m_RemoteAddr);
-              return false;
-            }
-          }
+          // inbound sessions are made from verified intros and start in introduction phase
           break;
         case State::Introduction:
           if (m_Inbound)
@@ -1000,6 +1059,42 @@ namespace llarp
       return true;
     }
 
+    void
+    Session::RecvDecrypted(size_t shard, Packet_t pkt)
+    {
+      std::lock_guard lock{m_Access};
+      // the main loop may have closed us while the shard still had us
+      if (m_State != State::Ready)
+        return;
+      m_RXRate += pkt.size();
+      m_Stats.totalPacketsRX++;
+      if (pkt[PacketOverhead] != llarp::constants::proto_version)
+      {
+        LogError(
+            "protocol version mismatch ",
+            int(pkt[PacketOverhead]),
+            " != ",
+            llarp::constants::proto_version);
+        return;
+      }
+      m_OnShard = true;
+      HandleCommand(std::move(pkt));
+      // the multiacks for whatever else the shard reads before it gets back to us go together
+      if (not m_SendMACKs.empty() and not std::exchange(m_MACKQueued, true))
+      {
+        m_Parent->CallOnShard(shard, [self = shared_from_this()]() {
+          std::lock_guard lock{self->m_Access};
+          self->m_MACKQueued = false;
+          self->m_OnShard = true;
+          self->SendMACK();
+          self->m_OnShard = false;
+          self->EncryptWorker(std::exchange(self->m_EncryptNext, {}));
+        });
+      }
+      m_OnShard = false;
+      EncryptWorker(std::exchange(m_EncryptNext, {}));
+    }
+
     std::string
     Session::StateToString(State state)
     {
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <llarp/link/session.hpp>
+#include "handshake_guard.hpp"
 #include "linklayer.hpp"
 #include "message_buffer.hpp"
 #include <llarp/net/ip_address.hpp>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <unordered_set>
 #include <deque>
 
@@ -21,6 +24,16 @@ namespace llarp
     /// creates a packet with plaintext size + wire overhead + random pad
     ILinkSession::Packet_t
     CreatePacket(Command cmd, size_t plainsize, size_t min_pad = 16, size_t pad_variance = 16);
+    /// encrypt a packet in place with key and put its keyed hash in front
+    void
+    EncryptPacket(ILinkSession::Packet_t& pkt, const SharedSecret& key);
+    /// check the keyed hash of a packet with key and decrypt it in place
+    bool
+    DecryptPacket(ILinkSession::Packet_t& pkt, const SharedSecret& key);
+    /// identity key, onion key, nonce and signature of the initiator of a session. on the wire it
+    /// may be followed by the handshake cookie the other end asked for.
+    using Introduction =
+        AlignedBuffer<PubKey::SIZE + PubKey::SIZE + TunnelNonce::SIZE + Signature::SIZE>;
     /// Time how long we try delivery for
     static constexpr std::chrono::milliseconds DeliveryTimeout = 500ms;
     /// Time how long we wait to recieve a message
@@ -36,6 +49,14 @@ namespace llarp
     /// How long we wait for a session to die with no tx from them
     static constexpr auto SessionAliveTimeout = PingInterval * 5;
 
+    /// an intro from an unknown address that we verified and did the key exchange for
+    struct VerifiedIntro
+    {
+      PubKey ident;
+      PubKey onionKey;
+      SharedSecret sessionKey;
+    };
+
     struct Session : public ILinkSession, public std::enable_shared_from_this<Session>
     {
       using Time_t = std::chrono::milliseconds;
@@ -44,9 +65,14 @@ namespace llarp
       static constexpr std::size_t MaxACKSInMACK = 1024 / sizeof(uint64_t);
 
       /// outbound session
-      Session(LinkLayer* parent, const RouterContact& rc, const AddressInfo& ai);
-      /// inbound session
-      Session(LinkLayer* parent, const SockAddr& from);
+      Session(LinkLayer* parent, RouterContact_ptr rc, const AddressInfo& ai);
+      /// inbound session from an intro we verified
+      Session(LinkLayer* parent, const SockAddr& from, const VerifiedIntro& intro);
+
+      /// check the signature of a decrypted intro and derive the session key from it, this is
+      /// the expensive part of an inbound handshake and is safe to call off the event loop
+      static std::optional<VerifiedIntro>
+      VerifyIntro(const Packet_t& pkt, const SecretKey& transportKey);
 
       // Signal the event loop that a pump is needed (idempotent)
       void
@@ -78,6 +104,17 @@ namespace llarp
 
       bool Recv_LL(ILinkSession::Packet_t) override;
 
+      /// a packet of ours that data plane thread shard read and decrypted, which we handle right
+      /// there on that thread.  link messages it completes go to the main loop.
+      void
+      RecvDecrypted(size_t shard, Packet_t pkt);
+
+      const SharedSecret&
+      SessionKey() const
+      {
+        return m_SessionKey;
+      }
+
       bool
       SendKeepAlive() override;
 
@@ -90,7 +127,7 @@ namespace llarp
       PubKey
       GetPubKey() const override
       {
-        return m_RemoteRC.pubkey;
+        return m_RemoteRC->pubkey;
       }
 
       const SockAddr&
@@ -99,7 +136,7 @@ namespace llarp
         return m_RemoteAddr;
       }
 
-      RouterContact
+      const RouterContact_ptr&
       GetRemoteRC() const override
       {
         return m_RemoteRC;
@@ -108,6 +145,7 @@ namespace llarp
       size_t
       SendQueueBacklog() const override
       {
+        std::lock_guard lock{m_Access};
         return m_TXMsgs.size();
       }
 
@@ -153,6 +191,15 @@ namespace llarp
       };
       static std::string
       StateToString(State state);
+      /// held by whatever thread is working on us: the main loop, or the data plane thread that
+      /// reads our packets once we are established.  recursive as handling one thing we do often
+      /// ends up in another.
+      mutable std::recursive_mutex m_Access;
+      /// set while a data plane thread is handling a packet of ours, what that queues to encrypt
+      /// and send goes out on that thread when it is done instead of on the next pump
+      bool m_OnShard = false;
+      /// a multiack flush is queued on the data plane thread that reads our packets
+      bool m_MACKQueued = false;
       State m_State;
       SessionStats m_Stats;
 
@@ -164,21 +211,26 @@ namespace llarp
       const SockAddr m_RemoteAddr;
 
       AddressInfo m_ChosenAI;
-      /// remote rc
-      RouterContact m_RemoteRC;
+      /// remote rc, an empty one on inbound sessions until their intro arrives
+      RouterContact_ptr m_RemoteRC;
       /// session key
       SharedSecret m_SessionKey;
+      /// key intros to the remote and cookies from it are encrypted with
+      SharedSecret m_IntroKey;
+      /// the cookie the remote asked us to send with our intro
+      std::optional<HandshakeCookie> m_Cookie;
       /// session token
       AlignedBuffer<24> token;
 
       PubKey m_ExpectedIdent;
       PubKey m_RemoteOnionKey;
 
-      llarp_time_t m_LastTX = 0s;
+      /// written by whichever thread sends for us, which is not always one that holds m_Access
+      std::atomic<llarp_time_t> m_LastTX = 0s;
       llarp_time_t m_LastRX = 0s;
 
       // accumulate for periodic rate calculation
-      uint64_t m_TXRate = 0;
+      std::atomic<uint64_t> m_TXRate = 0;
       uint64_t m_RXRate = 0;
 
       llarp_time_t m_ResetRatesAt = 0s;
@@ -203,6 +255,8 @@ namespace llarp
 
       CryptoQueue_t m_EncryptNext;
       CryptoQueue_t m_DecryptNext;
+      /// decrypted on a data plane thread, to go to m_PlaintextRecv on the next pump
+      CryptoQueue_t m_PlaintextNext;
 
       std::atomic_flag m_PlaintextEmpty;
       llarp::thread::Queue<CryptoQueue_t> m_PlaintextRecv;
@@ -214,12 +268,12 @@ namespace llarp
       void
       DecryptWorker(CryptoQueue_t msgs);
 
-      void
-      HandleGotIntro(Packet_t pkt);
-
       void
       HandleGotIntroAck(Packet_t pkt);
 
+      bool
+      HandleCookie(Packet_t& pkt);
+
       void
       HandleCreateSessionRequest(Packet_t pkt);
 
@@ -236,7 +290,11 @@ namespace llarp
       SendMACK();
 
       void
-      HandleRecvMsgCompleted(const InboundMessage& msg);
+      HandleRecvMsgCompleted(InboundMessage& msg);
+
+      /// handle a decrypted packet of an established session by its command
+      void
+      HandleCommand(Packet_t pkt);
 
       void
       GenerateAndSendIntro();
@@ -0,0 +1,190 @@
+#include "data_plane.hpp"
+
+#include <llarp/ev/udp_handle.hpp>
+#include <llarp/util/logging.hpp>
+#include <llarp/util/metrics.hpp>
+#include <llarp/util/thread/threading.hpp>
+
+namespace llarp
+{
+  static auto logcat = log::Cat("data-plane");
+
+  DataPlane::DataPlane(EventLoop_ptr mainLoop, size_t threads, RecvFunc recv, PrepareFunc prepare)
+      : m_MainLoop{std::move(mainLoop)}, m_Recv{std::move(recv)}, m_Prepare{std::move(prepare)}
+  {
+    m_Shards.reserve(threads);
+    for (size_t idx = 0; idx < threads; ++idx)
+      m_Shards.emplace_back(std::make_unique<Shard>(RingSize));
+    m_Waker = m_MainLoop->make_waker([this]() { Drain(); });
+  }
+
+  DataPlane::~DataPlane()
+  {
+    Stop();
+  }
+
+  bool
+  DataPlane::Start(const SockAddr& addr)
+  {
+    static auto& dropped = metrics::registry().GetCounter(
+        "lokinet_data_plane_dropped_packets_total",
+        "packets dropped because the main loop fell behind the data plane threads");
+
+    auto bindAddr = addr;
+    for (size_t idx = 0; idx < m_Shards.size(); ++idx)
+    {
+      auto& shard = m_Shards[idx];
+      shard->loop = EventLoop::create();
+      shard->udp = shard->loop->make_udp(
+          [this, shard = shard.get(), idx](UDPHandle&, const SockAddr& from, llarp_buffer_t buf) {
+            ILinkSession::Packet_t pkt(buf.sz);
+            std::copy_n(buf.base, buf.sz, pkt.data());
+            if (m_Prepare and m_Prepare(idx, from, pkt))
+              return;
+            if (shard->inbound.tryPushBack(Packet{from, std::move(pkt)})
+                != thread::QueueReturn::Success)
+            {
+              dropped.Add();
+              return;
+            }
+            // wakeups coalesce, so under load the main loop drains many packets per wakeup
+            m_Waker->Trigger();
+          });
+      shard->sender = shard->loop->make_waker([shard = shard.get()]() { Flush(*shard); });
+      if (not shard->udp->listen_shared(bindAddr))
+      {
+        for (auto& started : m_Shards)
+        {
+          started->sender.reset();
+          started->udp.reset();
+          started->loop.reset();
+        }
+        return false;
+      }
+      // every socket after the first shares the port the first one got
+      if (bindAddr.getPort() == 0)
+      {
+        if (auto local = shard->udp->LocalAddr())
+          bindAddr.setPort(local->getPort());
+      }
+    }
+
+    for (size_t idx = 0; idx < m_Shards.size(); ++idx)
+    {
+      m_Shards[idx]->thread = std::thread{[loop = m_Shards[idx]->loop, idx]() {
+        util::SetThreadName(fmt::format("llarp-dp{}", idx));
+        loop->run();
+      }};
+    }
+    m_Running = true;
+    log::info(logcat, "running {} data plane threads on {}", m_Shards.size(), bindAddr);
+    return true;
+  }
+
+  void
+  DataPlane::Stop()
+  {
+    if (not m_Running.exchange(false))
+      return;
+    for (auto& shard : m_Shards)
+    {
+      // always queued, so that stop() runs on the shard's own thread
+      shard->loop->call_soon([loop = shard->loop.get()]() { loop->stop(); });
+    }
+    for (auto& shard : m_Shards)
+    {
+      if (shard->thread.joinable())
+        shard->thread.join();
+    }
+  }
+
+  bool
+  DataPlane::Send(const SockAddr& to, const llarp_buffer_t& buf)
+  {
+    static auto& dropped = metrics::registry().GetCounter(
+        "lokinet_data_plane_dropped_sends_total",
+        "packets not sent because a data plane thread fell behind on its sends");
+
+    if (not m_Running)
+      return false;
+    auto& shard = *m_Shards[std::hash<SockAddr>{}(to) % m_Shards.size()];
+    ILinkSession::Packet_t pkt(buf.sz);
+    std::copy_n(buf.base, buf.sz, pkt.data());
+    if (shard.outbound.tryPushBack(Packet{to, std::move(pkt)}) != thread::QueueReturn::Success)
+    {
+      dropped.Add();
+      return false;
+    }
+    shard.sender->Trigger();
+    return true;
+  }
+
+  void
+  DataPlane::Flush(Shard& shard)
+  {
+    // like Drain, a ring's worth at a time so that sends do not starve the shard's reads
+    for (size_t n = 0; n < RingSize; ++n)
+    {
+      auto maybe = shard.outbound.tryPopFront();
+      if (not maybe)
+        return;
+      const auto& [to, pkt] = *maybe;
+      if (not shard.udp->send(to, llarp_buffer_t{pkt}))
+        log::debug(logcat, "could not send udp packet to {}", to);
+    }
+    shard.sender->Trigger();
+  }
+
+  void
+  DataPlane::CallOnShards(std::function<void(size_t)> f)
+  {
+    if (not m_Running)
+      return;
+    for (size_t idx = 0; idx < m_Shards.size(); ++idx)
+      m_Shards[idx]->loop->call_soon([f, idx]() { f(idx); });
+  }
+
+  void
+  DataPlane::CallOnShard(size_t shard, std::function<void()> f)
+  {
+    if (m_Running)
+      m_Shards.at(shard)->loop->call_soon(std::move(f));
+  }
+
+  std::optional<int>
+  DataPlane::FileDescriptor() const
+  {
+    if (m_Shards.empty() or not m_Shards.front()->udp)
+      return std::nullopt;
+    return m_Shards.front()->udp->file_descriptor();
+  }
+
+  std::optional<SockAddr>
+  DataPlane::LocalAddr() const
+  {
+    if (m_Shards.empty() or not m_Shards.front()->udp)
+      return std::nullopt;
+    return m_Shards.front()->udp->LocalAddr();
+  }
+
+  void
+  DataPlane::Drain()
+  {
+    bool more = false;
+    for (auto& shard : m_Shards)
+    {
+      // take no more than a ring's worth from each shard per wakeup so that one busy shard
+      // cannot keep the main loop from everything else
+      for (size_t n = 0; n < RingSize; ++n)
+      {
+        auto maybe = shard->inbound.tryPopFront();
+        if (not maybe)
+          break;
+        m_Recv(maybe->first, std::move(maybe->second));
+      }
+      more = more or not shard->inbound.empty();
+    }
+    if (more)
+      m_Waker->Trigger();
+  }
+}  // namespace llarp
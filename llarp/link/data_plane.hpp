@@ -0,0 +1,125 @@
+#pragma once
+
+#include "session.hpp"
+
+#include <llarp/ev/ev.hpp>
+#include <llarp/net/sock_addr.hpp>
+#include <llarp/util/buffer.hpp>
+#include <llarp/util/thread/queue.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  struct UDPHandle;
+
+  /// moves the socket side of a link off of the main event loop: runs a number of event loops,
+  /// each on its own thread with its own SO_REUSEPORT socket bound on the link's address, so the
+  /// kernel shards the remote routers we talk to across them.
+  ///
+  /// each shard reads its packets and gives the link the first go at them on its own thread (for
+  /// iwp, the shard that reads an established session's packets does everything the session does
+  /// with them), what the link does not handle there goes to the main loop over a lock free ring.
+  /// sends are queued onto the shard that owns the remote and go out on its thread, a socket is
+  /// only ever touched by the thread of its loop.
+  class DataPlane
+  {
+   public:
+    using Packet = std::pair<SockAddr, ILinkSession::Packet_t>;
+    /// called on a shard's thread, with the index of the shard, for every packet it reads.
+    /// returns true if it handled the packet there, the packets it leaves alone go to RecvFunc.
+    using PrepareFunc =
+        std::function<bool(size_t shard, const SockAddr&, ILinkSession::Packet_t&)>;
+    using RecvFunc = std::function<void(const SockAddr&, ILinkSession::Packet_t)>;
+
+    /// how many packets each shard can have waiting for the main loop, or for its socket, before
+    /// it drops them
+    static constexpr size_t RingSize = 4096;
+
+    /// recv is called on mainLoop for every packet any of the shards read that prepare, if there
+    /// is one, did not handle on the shard's thread
+    DataPlane(EventLoop_ptr mainLoop, size_t threads, RecvFunc recv, PrepareFunc prepare = nullptr);
+
+    ~DataPlane();
+
+    DataPlane(const DataPlane&) = delete;
+    DataPlane&
+    operator=(const DataPlane&) = delete;
+
+    /// bind every shard's socket on addr and start their threads.  if addr has port 0 the first
+    /// shard's socket picks the port and the others share it.  returns false if this platform
+    /// cannot share a udp port between sockets, throws if binding fails.
+    bool
+    Start(const SockAddr& addr);
+
+    /// stop and join every shard thread, packets still in the rings are dropped
+    void
+    Stop();
+
+    /// queue a packet to a remote onto a shard to send, can be called from any thread.  every
+    /// shard socket is bound on the same address so it does not matter which we use, we spread
+    /// them by remote.  returns false if we are not running or the shard's queue is full.
+    bool
+    Send(const SockAddr& to, const llarp_buffer_t& buf);
+
+    /// run f on every shard's thread with the index of the shard, which is how the state that
+    /// prepare reads is kept.  does nothing if we are not running.
+    void
+    CallOnShards(std::function<void(size_t shard)> f);
+
+    /// run f on the thread of one shard, later even if we are on it already.  does nothing if we
+    /// are not running.
+    void
+    CallOnShard(size_t shard, std::function<void()> f);
+
+    /// the file descriptor of the first shard's socket, if there is one
+    std::optional<int>
+    FileDescriptor() const;
+
+    /// the address the shard sockets are bound on
+    std::optional<SockAddr>
+    LocalAddr() const;
+
+    size_t
+    NumShards() const
+    {
+      return m_Shards.size();
+    }
+
+   private:
+    struct Shard
+    {
+      explicit Shard(size_t queueSize) : inbound{queueSize}, outbound{queueSize}
+      {}
+
+      EventLoop_ptr loop;
+      std::shared_ptr<UDPHandle> udp;
+      /// wakes the shard's loop to send what is queued in outbound
+      std::shared_ptr<EventLoopWakeup> sender;
+      std::thread thread;
+      thread::Queue<Packet> inbound;
+      thread::Queue<Packet> outbound;
+    };
+
+    /// pass on everything the shards have queued, called on the main loop
+    void
+    Drain();
+
+    /// send everything queued to go out on shard, called on the shard's thread
+    static void
+    Flush(Shard& shard);
+
+    const EventLoop_ptr m_MainLoop;
+    const RecvFunc m_Recv;
+    const PrepareFunc m_Prepare;
+    std::vector<std::unique_ptr<Shard>> m_Shards;
+    std::shared_ptr<EventLoopWakeup> m_Waker;
+    std::atomic<bool> m_Running = false;
+  };
+}  // namespace llarp
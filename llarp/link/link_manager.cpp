@@ -259,7 +259,7 @@ namespace llarp
     auto fn = [&connectedRouters](const ILinkSession* session, bool) {
       if (session->IsEstablished())
       {
-        const RouterContact rc(session->GetRemoteRC());
+        const RouterContact& rc = *session->GetRemoteRC();
         if (rc.IsPublicRouter())
         {
           connectedRouters.insert(rc.pubkey);
@@ -280,7 +280,7 @@ namespace llarp
     auto fn = [&connectedClients](const ILinkSession* session, bool) {
       if (session->IsEstablished())
       {
-        const RouterContact rc(session->GetRemoteRC());
+        const RouterContact& rc = *session->GetRemoteRC();
         if (!rc.IsPublicRouter())
         {
           connectedClients.insert(rc.pubkey);
@@ -313,7 +313,7 @@ namespace llarp
   bool
   LinkManager::GetRandomConnectedRouter(RouterContact& router) const
   {
-    std::unordered_map<RouterID, RouterContact> connectedRouters;
+    std::unordered_map<RouterID, RouterContact_ptr> connectedRouters;
 
     ForEachPeer(
         [&connectedRouters](const ILinkSession* peer, bool unused) {
@@ -331,7 +331,7 @@ namespace llarp
         std::advance(itr, randint() % sz);
       }
 
-      router = itr->second;
+      router = *itr->second;
 
       return true;
     }
@@ -393,7 +393,7 @@ namespace llarp
 
     ForEachPeer([&](ILinkSession* session) {
       // derive RouterID
-      RouterID id = RouterID(session->GetRemoteRC().pubkey);
+      RouterID id = RouterID(session->GetRemoteRC()->pubkey);
 
       SessionStats sessionStats = session->GetSessionStats();
       SessionStats diff;
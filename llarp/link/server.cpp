@@ -130,12 +130,34 @@ namespace llarp
   }
 
   void
-  ILinkLayer::Bind(AbstractRouter* router, SockAddr bind_addr)
+  ILinkLayer::Bind(AbstractRouter* router, SockAddr bind_addr, size_t dataPlaneThreads)
   {
     if (router->Net().IsLoopbackAddress(bind_addr.getIP()))
       throw std::runtime_error{"cannot udp bind socket on loopback"};
     m_ourAddr = bind_addr;
     m_Router = router;
+    if (dataPlaneThreads > 0)
+    {
+      m_DataPlane = std::make_unique<DataPlane>(
+          m_Router->loop(),
+          dataPlaneThreads,
+          [this](const SockAddr& from, ILinkSession::Packet_t pkt) {
+            RecvFrom(from, std::move(pkt));
+          },
+          [this](size_t shard, const SockAddr& from, ILinkSession::Packet_t& pkt) {
+            return PrepareOnShard(shard, from, pkt);
+          });
+      SetupShards(dataPlaneThreads);
+      if (m_DataPlane->Start(m_ourAddr))
+        return;
+      LogWarn(
+          "cannot share a udp port between threads here, running ",
+          Name(),
+          " link on ",
+          m_ourAddr,
+          " on the main loop");
+      m_DataPlane.reset();
+    }
     m_udp = m_Router->loop()->make_udp(
         [this]([[maybe_unused]] UDPHandle& udp, const SockAddr& from, llarp_buffer_t buf) {
           ILinkSession::Packet_t pkt;
@@ -291,20 +313,20 @@ namespace llarp
   }
 
   bool
-  ILinkLayer::TryEstablishTo(RouterContact rc)
+  ILinkLayer::TryEstablishTo(RouterContact_ptr rc)
   {
     {
       Lock_t l(m_AuthedLinksMutex);
-      if (m_AuthedLinks.count(rc.pubkey))
+      if (m_AuthedLinks.count(rc->pubkey))
       {
-        LogWarn("Too many links to ", RouterID{rc.pubkey}, ", not establishing another one");
+        LogWarn("Too many links to ", RouterID{rc->pubkey}, ", not establishing another one");
         return false;
       }
     }
     llarp::AddressInfo to;
-    if (not PickAddress(rc, to))
+    if (not PickAddress(*rc, to))
     {
-      LogWarn("router ", RouterID{rc.pubkey}, " has no acceptable inbound addresses");
+      LogWarn("router ", RouterID{rc->pubkey}, " has no acceptable inbound addresses");
       return false;
     }
     const SockAddr address{to};
@@ -316,7 +338,7 @@ namespace llarp
             "Too many pending connections to ",
             address,
             " while establishing to ",
-            RouterID{rc.pubkey},
+            RouterID{rc->pubkey},
             ", not establishing another");
         return false;
       }
@@ -324,7 +346,7 @@ namespace llarp
     std::shared_ptr<ILinkSession> s = NewOutboundSession(rc, to);
     if (BeforeConnect)
     {
-      BeforeConnect(std::move(rc));
+      BeforeConnect(*rc);
     }
     if (not PutSession(s))
     {
@@ -386,6 +408,8 @@ namespace llarp
       for (const auto& [addr, link] : m_Pending)
         link->Close();
     }
+    if (m_DataPlane)
+      m_DataPlane->Stop();
   }
 
   void
@@ -424,7 +448,7 @@ namespace llarp
   void
   ILinkLayer::SendTo_LL(const SockAddr& to, const llarp_buffer_t& pkt)
   {
-    if (not m_udp->send(to, pkt))
+    if (not(m_DataPlane ? m_DataPlane->Send(to, pkt) : m_udp->send(to, pkt)))
       LogError("could not send udp packet to ", to);
   }
 
@@ -491,6 +515,8 @@ namespace llarp
   std::optional<int>
   ILinkLayer::GetUDPFD() const
   {
+    if (m_DataPlane)
+      return m_DataPlane->FileDescriptor();
     return m_udp->file_descriptor();
   }
 
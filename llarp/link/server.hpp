@@ -2,6 +2,7 @@
 
 #include <llarp/crypto/types.hpp>
 #include <llarp/ev/ev.hpp>
+#include "data_plane.hpp"
 #include "session.hpp"
 #include <llarp/net/sock_addr.hpp>
 #include <llarp/router_contact.hpp>
@@ -69,7 +70,7 @@ namespace llarp
   using WorkerFunc_t = std::function<void(Work_t)>;
 
   /// before connection hook, called before we try connecting via outbound link
-  using BeforeConnectFunc_t = std::function<void(llarp::RouterContact)>;
+  using BeforeConnectFunc_t = std::function<void(const llarp::RouterContact&)>;
 
   struct ILinkLayer
   {
@@ -101,17 +102,19 @@ namespace llarp
     void
     ForEachSession(std::function<void(ILinkSession*)> visit) EXCLUDES(m_AuthedLinksMutex);
 
-    void
+    virtual void
     UnmapAddr(const SockAddr& addr);
 
     void
     SendTo_LL(const SockAddr& to, const llarp_buffer_t& pkt);
 
+    /// bind our udp socket on addr.  if dataPlaneThreads is not zero we read and write packets on
+    /// that many threads of their own instead of the router's event loop, see DataPlane.
     void
-    Bind(AbstractRouter* router, SockAddr addr);
+    Bind(AbstractRouter* router, SockAddr addr, size_t dataPlaneThreads = 0);
 
     virtual std::shared_ptr<ILinkSession>
-    NewOutboundSession(const RouterContact& rc, const AddressInfo& ai) = 0;
+    NewOutboundSession(RouterContact_ptr rc, const AddressInfo& ai) = 0;
 
     /// fetch a session by the identity pubkey it claims
     std::shared_ptr<ILinkSession>
@@ -123,11 +126,23 @@ namespace llarp
     virtual void
     RecvFrom(const SockAddr& from, ILinkSession::Packet_t pkt) = 0;
 
+    /// called on data plane thread shard for every packet it reads, see DataPlane::PrepareFunc.
+    /// returns true if it handled pkt there, what it leaves alone goes to RecvFrom.
+    virtual bool
+    PrepareOnShard(
+        [[maybe_unused]] size_t shard,
+        [[maybe_unused]] const SockAddr& from,
+        [[maybe_unused]] ILinkSession::Packet_t& pkt)
+    {
+      return false;
+    }
+
     bool
     PickAddress(const RouterContact& rc, AddressInfo& picked) const;
 
+    /// start a session to rc, which the session holds on to
     bool
-    TryEstablishTo(RouterContact rc);
+    TryEstablishTo(RouterContact_ptr rc);
 
     bool
     Start();
@@ -138,7 +153,7 @@ namespace llarp
     virtual std::string_view
     Name() const = 0;
 
-    util::StatusObject
+    virtual util::StatusObject
     ExtractStatus() const EXCLUDES(m_AuthedLinksMutex);
 
     void
@@ -186,10 +201,10 @@ namespace llarp
       return false;
     }
 
-    bool
+    virtual bool
     MapAddr(const RouterID& pk, ILinkSession* s);
 
-    void
+    virtual void
     Tick(llarp_time_t now);
 
     LinkMessageHandler HandleMessage;
@@ -256,9 +271,16 @@ namespace llarp
     bool
     PutSession(const std::shared_ptr<ILinkSession>& s);
 
+    /// called before the data plane starts with how many shards it runs
+    virtual void
+    SetupShards([[maybe_unused]] size_t count)
+    {}
+
     AbstractRouter* m_Router;
     SockAddr m_ourAddr;
     std::shared_ptr<llarp::UDPHandle> m_udp;
+    /// set instead of m_udp when we run our socket side on threads of its own
+    std::unique_ptr<DataPlane> m_DataPlane;
     SecretKey m_SecretKey;
 
     using AuthedLinks = std::unordered_multimap<RouterID, std::shared_ptr<ILinkSession>>;
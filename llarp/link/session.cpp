@@ -5,7 +5,7 @@ namespace llarp
   bool
   ILinkSession::IsRelay() const
   {
-    return GetRemoteRC().IsPublicRouter();
+    return GetRemoteRC()->IsPublicRouter();
   }
 
 }  // namespace llarp
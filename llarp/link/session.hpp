@@ -98,8 +98,8 @@ namespace llarp
     virtual const SockAddr&
     GetRemoteEndpoint() const = 0;
 
-    // get remote rc
-    virtual RouterContact
+    // get remote rc, shared with whoever else holds it
+    virtual const RouterContact_ptr&
     GetRemoteRC() const = 0;
 
     /// is this session a session to a relay?
@@ -24,6 +24,12 @@ namespace llarp
       return bencode_end(buf);
     }
 
+    size_t
+    MaxEncodedSize() const override
+    {
+      return 16;
+    }
+
     void
     Clear() override
     {
@@ -26,6 +26,12 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    size_t
+    MaxEncodedSize() const override
+    {
+      return MaxSize;
+    }
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <llarp/constants/link_layer.hpp>
 #include <llarp/link/session.hpp>
 #include <llarp/router_id.hpp>
 #include <llarp/util/bencode.hpp>
@@ -45,6 +46,13 @@ namespace llarp
     virtual bool
     BEncode(llarp_buffer_t* buf) const = 0;
 
+    /// the most BEncode can write, which is what is set aside to encode it into
+    virtual size_t
+    MaxEncodedSize() const
+    {
+      return MAX_LINK_MSG_SIZE;
+    }
+
     virtual bool
     HandleMessage(AbstractRouter* router) const = 0;
 
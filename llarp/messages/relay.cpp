@@ -11,6 +11,7 @@ namespace llarp
   {
     pathid.Zero();
     X.Clear();
+    XView = {};
     Y.Zero();
     version = 0;
   }
@@ -42,7 +43,7 @@ namespace llarp
       return false;
     if (!BEncodeMaybeVerifyVersion("v", version, llarp::constants::proto_version, read, key, buf))
       return false;
-    if (!BEncodeMaybeReadDictEntry("x", X, read, key, buf))
+    if (!BEncodeMaybeReadDictView("x", XView, MAX_LINK_MSG_SIZE - 128, read, key, buf))
       return false;
     if (!BEncodeMaybeReadDictEntry("y", Y, read, key, buf))
       return false;
@@ -55,7 +56,7 @@ namespace llarp
     auto path = r->pathContext().GetByDownstream(session->GetPubKey(), pathid);
     if (path)
     {
-      return path->HandleUpstream(llarp_buffer_t(X), Y, r);
+      return path->HandleUpstream(llarp_buffer_t(XView), Y, r);
     }
     return false;
   }
@@ -65,6 +66,7 @@ namespace llarp
   {
     pathid.Zero();
     X.Clear();
+    XView = {};
     Y.Zero();
     version = 0;
   }
@@ -96,7 +98,7 @@ namespace llarp
       return false;
     if (!BEncodeMaybeVerifyVersion("v", version, llarp::constants::proto_version, read, key, buf))
       return false;
-    if (!BEncodeMaybeReadDictEntry("x", X, read, key, buf))
+    if (!BEncodeMaybeReadDictView("x", XView, MAX_LINK_MSG_SIZE - 128, read, key, buf))
       return false;
     if (!BEncodeMaybeReadDictEntry("y", Y, read, key, buf))
       return false;
@@ -109,7 +111,7 @@ namespace llarp
     auto path = r->pathContext().GetByUpstream(session->GetPubKey(), pathid);
     if (path)
     {
-      return path->HandleDownstream(llarp_buffer_t(X), Y, r);
+      return path->HandleDownstream(llarp_buffer_t(XView), Y, r);
     }
     llarp::LogWarn("no path for downstream message id=", pathid);
     return false;
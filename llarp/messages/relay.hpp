@@ -13,6 +13,9 @@ namespace llarp
   {
     Encrypted<MAX_LINK_MSG_SIZE - 128> X;
     TunnelNonce Y;
+    /// on messages we read, X is not copied out of the link message, this is where it is in the
+    /// buffer being parsed, which lives until HandleMessage returns
+    byte_view_t XView;
 
     bool
     DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* buf) override;
@@ -20,6 +23,12 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    size_t
+    MaxEncodedSize() const override
+    {
+      return X.size() + 128;
+    }
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
@@ -42,6 +51,8 @@ namespace llarp
   {
     Encrypted<MAX_LINK_MSG_SIZE - 128> X;
     TunnelNonce Y;
+    /// as RelayUpstreamMessage::XView
+    byte_view_t XView;
 
     bool
     DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* buf) override;
@@ -49,6 +60,12 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    size_t
+    MaxEncodedSize() const override
+    {
+      return X.size() + 128;
+    }
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
@@ -12,10 +12,12 @@
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/logging.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/tooling/path_event.hpp>
 
 #include <functional>
 #include <optional>
+#include <utility>
 
 namespace llarp
 {
@@ -73,6 +75,17 @@ namespace llarp
       llarp::LogError("got LRCM when not permitting transit");
       return false;
     }
+    if (not router->pathContext().AcceptingTransitBuilds())
+    {
+      // shed it before we spend any crypto on it, whoever sent it will time out and try another
+      // path
+      static auto& shed = metrics::registry().GetCounter(
+          "lokinet_transit_builds_shed_total",
+          "transit path build requests dropped because we were too far behind on them");
+      shed.Add();
+      llarp::LogDebug("dropping LRCM, too many transit builds waiting already");
+      return true;
+    }
     return AsyncDecrypt(&router->pathContext());
   }
 
@@ -133,8 +146,13 @@ namespace llarp
       return false;
     if (key->startswith("u"))
     {
-      nextRC = std::make_unique<RouterContact>();
-      return nextRC->BDecode(buffer);
+      RouterContact rc;
+      const auto* start = buffer->cur;
+      if (not rc.BDecode(buffer))
+        return false;
+      nextRC = std::make_shared<const EncodedRouterContact>(
+          std::move(rc), byte_view_t{start, static_cast<size_t>(buffer->cur - start)});
+      return true;
     }
     if (!BEncodeMaybeVerifyVersion(
             "v", version, llarp::constants::proto_version, read, *key, buffer))
@@ -185,6 +203,8 @@ namespace llarp
     LR_CommitRecord record;
     // the actual hop
     std::shared_ptr<Hop> hop;
+    // what to do on the logic thread once we have decrypted
+    std::function<void()> then;
 
     const std::optional<IpAddress> fromAddr;
 
@@ -194,7 +214,7 @@ namespace llarp
         , context(ctx)
         , hop(std::make_shared<Hop>())
         , fromAddr(
-              commit->session->GetRemoteRC().IsPublicRouter()
+              commit->session->GetRemoteRC()->IsPublicRouter()
                   ? std::optional<IpAddress>{}
                   : commit->session->GetRemoteEndpoint())
     {
@@ -450,22 +470,20 @@ namespace llarp
         // we are the farthest hop
         llarp::LogDebug("We are the farthest hop for ", info);
         // send a LRSM down the path
-        self->context->loop()->call([self] {
+        self->then = [self] {
           SendPathConfirm(self);
           self->decrypter = nullptr;
-        });
+        };
       }
       else
       {
         // forward upstream
-        // we are still in the worker thread so post job to logic
-        self->context->loop()->call([self] {
+        // we are still in the worker thread, this is run on logic with the rest of the batch
+        self->then = [self] {
           SendLRCM(self);
           self->decrypter = nullptr;
-        });
+        };
       }
-      // trigger idempotent pump to ensure that the build messages propagate
-      self->context->Router()->TriggerPump();
     }
   };
 
@@ -477,10 +495,16 @@ namespace llarp
     // copy frames so we own them
     auto frameDecrypt = std::make_shared<LRCMFrameDecrypt>(context, std::move(decrypter), this);
 
-    // decrypt frames async
+    // decrypt frames async, batched with the other LRCMs we got this cycle
+    std::function<void()> decrypt;
     frameDecrypt->decrypter->AsyncDecrypt(
-        frameDecrypt->frames[0], frameDecrypt, [r = context->Router()](auto func) {
-          r->QueueWork(std::move(func));
+        frameDecrypt->frames[0], frameDecrypt, [&decrypt](auto func) {
+          decrypt = std::move(func);
+        });
+    context->QueueTransitBuild(
+        [decrypt = std::move(decrypt), frameDecrypt]() -> std::function<void()> {
+          decrypt();
+          return std::exchange(frameDecrypt->then, nullptr);
         });
     return true;
   }
@@ -5,6 +5,7 @@
 #include <llarp/messages/link_message.hpp>
 #include <llarp/path/path_types.hpp>
 #include <llarp/pow.hpp>
+#include <llarp/router_contact.hpp>
 
 #include <array>
 #include <memory>
@@ -26,7 +27,8 @@ namespace llarp
     TunnelNonce tunnelNonce;
     PathID_t txid, rxid;
 
-    std::unique_ptr<RouterContact> nextRC;
+    /// shared with the path we build, and written out as it was encoded when we got it
+    RouterContact_ptr nextRC;
     std::unique_ptr<PoW> work;
     uint64_t version = 0;
     llarp_time_t lifetime = 0s;
@@ -66,6 +68,13 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    /// every frame with its length in front, and the message type and version around them
+    size_t
+    MaxEncodedSize() const override
+    {
+      return frames.size() * (EncryptedFrameSize + 8) + 64;
+    }
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
@@ -78,6 +78,13 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    /// as LR_CommitMessage, with room for the path id and status
+    size_t
+    MaxEncodedSize() const override
+    {
+      return frames.size() * (EncryptedFrameSize + 8) + 128;
+    }
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
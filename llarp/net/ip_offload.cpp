@@ -0,0 +1,280 @@
+#include "ip_offload.hpp"
+
+#include <llarp/constants/net.hpp>
+
+#include <oxenc/endian.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+namespace llarp::net
+{
+  namespace
+  {
+    constexpr uint8_t tcp_fin = 0x01;
+    constexpr uint8_t tcp_psh = 0x08;
+    constexpr uint8_t tcp_ack = 0x10;
+    constexpr uint8_t tcp_cwr = 0x80;
+    constexpr uint16_t ip_dont_fragment = 0x4000;
+    constexpr size_t ipv6_header_bytes = 40;
+    constexpr size_t tcp_checksum_offset = 16;
+
+    struct tcp_layout
+    {
+      bool v6;
+      size_t iphlen;
+      size_t thlen;
+    };
+
+    /// where the ip and tcp headers of pkt end, if it is tcp with no ipv6 extension headers
+    std::optional<tcp_layout>
+    parse_tcp(byte_view_t pkt)
+    {
+      if (pkt.empty())
+        return std::nullopt;
+      tcp_layout layout{};
+      const auto tcp = static_cast<byte_t>(IPProtocol::TCP);
+      switch (pkt[0] >> 4)
+      {
+        case 4:
+          layout.iphlen = (pkt[0] & 0x0F) * 4;
+          if (layout.iphlen < 20 or pkt.size() < layout.iphlen or pkt[9] != tcp)
+            return std::nullopt;
+          break;
+        case 6:
+          layout.v6 = true;
+          layout.iphlen = ipv6_header_bytes;
+          if (pkt.size() < layout.iphlen or pkt[6] != tcp)
+            return std::nullopt;
+          break;
+        default:
+          return std::nullopt;
+      }
+      if (pkt.size() < layout.iphlen + 20)
+        return std::nullopt;
+      layout.thlen = (pkt[layout.iphlen + 12] >> 4) * 4;
+      if (layout.thlen < 20 or pkt.size() < layout.iphlen + layout.thlen)
+        return std::nullopt;
+      return layout;
+    }
+
+    /// unfolded one's complement sum of the tcp pseudo header for a segment of l4len bytes
+    uint32_t
+    pseudo_header_sum(const byte_t* ip, bool v6, size_t l4len)
+    {
+      const byte_t* addrs = ip + (v6 ? 8 : 12);
+      const size_t addrlen = v6 ? 32 : 8;
+      uint32_t sum = 0;
+      for (size_t idx = 0; idx < addrlen; idx += 2)
+      {
+        uint16_t word;
+        std::memcpy(&word, addrs + idx, sizeof(word));
+        sum += word;
+      }
+      sum += oxenc::host_to_big<uint16_t>(static_cast<uint16_t>(IPProtocol::TCP));
+      sum += oxenc::host_to_big<uint16_t>(static_cast<uint16_t>(l4len));
+      return sum;
+    }
+
+    uint16_t
+    fold(uint32_t sum)
+    {
+      sum = (sum & 0xFFff) + (sum >> 16);
+      sum += sum >> 16;
+      return uint16_t(sum & 0xFFff);
+    }
+
+    /// set the lengths in the ip header for a packet of sz bytes, and the ipv4 header checksum
+    void
+    set_ip_length(byte_t* ip, const tcp_layout& layout, size_t sz)
+    {
+      if (layout.v6)
+      {
+        oxenc::write_host_as_big<uint16_t>(sz - ipv6_header_bytes, ip + 4);
+        return;
+      }
+      oxenc::write_host_as_big<uint16_t>(sz, ip + 2);
+      std::memset(ip + 10, 0, 2);
+      const auto check = ipchksum(ip, layout.iphlen);
+      std::memcpy(ip + 10, &check, sizeof(check));
+    }
+  }  // namespace
+
+  std::vector<IPPacket>
+  SplitOffloaded(const vnet_header& hdr, byte_view_t pkt)
+  {
+    std::vector<IPPacket> segments;
+    const uint8_t gso_type = hdr.gso_type & ~vnet_header::GSOECN;
+    if (gso_type == vnet_header::GSONone)
+    {
+      if (pkt.size() < IPPacket::MinSize)
+        return segments;
+      IPPacket ip{pkt};
+      if (hdr.flags & vnet_header::NeedsChecksum)
+      {
+        const size_t start = hdr.csum_start;
+        const size_t at = start + hdr.csum_offset;
+        if (at + 2 > ip.size())
+          return segments;
+        // the kernel left the pseudo header sum where the checksum goes, so summing everything
+        // from csum_start on gives us the whole checksum
+        uint16_t check = ipchksum(ip.data() + start, ip.size() - start);
+        // 0 is used to indicate "no checksum" for udp
+        if (check == 0 and ip.protocol() == static_cast<byte_t>(IPProtocol::UDP))
+          check = 0xFFff;
+        std::memcpy(ip.data() + at, &check, sizeof(check));
+      }
+      segments.push_back(std::move(ip));
+      return segments;
+    }
+    if (gso_type != vnet_header::GSOTCPv4 and gso_type != vnet_header::GSOTCPv6)
+      return segments;
+
+    const auto layout = parse_tcp(pkt);
+    if (not layout or layout->v6 != (gso_type == vnet_header::GSOTCPv6) or hdr.gso_size == 0)
+      return segments;
+    const size_t hdrlen = layout->iphlen + layout->thlen;
+    // every segment has to fit in one lokinet frame, whatever size the kernel asked for
+    const size_t mss = std::min<size_t>(hdr.gso_size, IPPacket::MaxSize - hdrlen);
+    const uint32_t seq = oxenc::load_big_to_host<uint32_t>(pkt.data() + layout->iphlen + 4);
+    const uint16_t id = layout->v6 ? 0 : oxenc::load_big_to_host<uint16_t>(pkt.data() + 4);
+
+    segments.reserve((pkt.size() - hdrlen + mss - 1) / mss);
+    for (size_t off = hdrlen; off < pkt.size(); off += mss)
+    {
+      const size_t len = std::min(mss, pkt.size() - off);
+      IPPacket seg{hdrlen + len};
+      byte_t* ip = seg.data();
+      byte_t* tcp = ip + layout->iphlen;
+      std::copy_n(pkt.data(), hdrlen, ip);
+      std::copy_n(pkt.data() + off, len, ip + hdrlen);
+
+      oxenc::write_host_as_big<uint32_t>(seq + (off - hdrlen), tcp + 4);
+      // fin and psh belong on the last segment only, cwr on the first
+      if (off + len != pkt.size())
+        tcp[13] &= ~(tcp_fin | tcp_psh);
+      if (off != hdrlen)
+        tcp[13] &= ~tcp_cwr;
+      if (not layout->v6)
+        oxenc::write_host_as_big<uint16_t>(id + segments.size(), ip + 4);
+      set_ip_length(ip, *layout, seg.size());
+
+      const size_t l4len = seg.size() - layout->iphlen;
+      std::memset(tcp + tcp_checksum_offset, 0, 2);
+      const auto check = ipchksum(tcp, l4len, pseudo_header_sum(ip, layout->v6, l4len));
+      std::memcpy(tcp + tcp_checksum_offset, &check, sizeof(check));
+      segments.push_back(std::move(seg));
+    }
+    return segments;
+  }
+
+  bool
+  TCPCoalescer::Append(const IPPacket& pkt)
+  {
+    const auto layout = parse_tcp(pkt.view());
+    if (not layout)
+      return false;
+    const byte_t* ip = pkt.data();
+    const byte_t* tcp = ip + layout->iphlen;
+    const size_t hdrlen = layout->iphlen + layout->thlen;
+    const size_t payload = pkt.size() - hdrlen;
+    const uint8_t flags = tcp[13];
+
+    // plain data segments only, the kernel has to see anything else as it is
+    if (payload == 0 or (flags & ~tcp_psh) != tcp_ack)
+      return false;
+    if (layout->v6)
+    {
+      if (oxenc::load_big_to_host<uint16_t>(ip + 4) + ipv6_header_bytes != pkt.size())
+        return false;
+    }
+    else if (
+        layout->iphlen != constants::ip_header_min_bytes
+        or oxenc::load_big_to_host<uint16_t>(ip + 2) != pkt.size()
+        or (oxenc::load_big_to_host<uint16_t>(ip + 6) & ~ip_dont_fragment) != 0)
+      return false;
+
+    const uint32_t seq = oxenc::load_big_to_host<uint32_t>(tcp + 4);
+    const uint16_t id = layout->v6 ? 0 : oxenc::load_big_to_host<uint16_t>(ip + 4);
+
+    if (empty())
+    {
+      m_Buf.resize(sizeof(vnet_header));
+      m_Buf.insert(m_Buf.end(), ip, ip + pkt.size());
+      m_Segments = 1;
+      m_IPHeaderLen = layout->iphlen;
+      m_HeaderLen = hdrlen;
+      m_SegmentSize = payload;
+      m_NextSeq = seq + payload;
+      m_NextID = id + 1;
+      m_Closed = flags & tcp_psh;
+      return true;
+    }
+
+    if (m_Closed or layout->iphlen != m_IPHeaderLen or hdrlen != m_HeaderLen
+        or payload > m_SegmentSize or seq != m_NextSeq
+        or m_Buf.size() - sizeof(vnet_header) + payload > MaxOffloadSize)
+      return false;
+
+    const byte_t* held = m_Buf.data() + sizeof(vnet_header);
+    const auto same = [ip, held](size_t from, size_t to) {
+      return std::equal(ip + from, ip + to, held + from);
+    };
+    // the ip headers must match but for the length, id and checksum
+    const bool ip_same = layout->v6
+        ? same(0, 4) and same(6, ipv6_header_bytes)
+        : same(0, 2) and same(6, 10) and same(12, 20) and id == m_NextID;
+    // and the tcp headers but for the sequence number, checksum and push flag
+    const size_t th = layout->iphlen;
+    const bool tcp_same = same(th, th + 4) and same(th + 8, th + 13) and same(th + 14, th + 16)
+        and same(th + 18, hdrlen) and ((held[th + 13] ^ flags) & ~tcp_psh) == 0;
+    if (not ip_same or not tcp_same)
+      return false;
+
+    m_Buf.insert(m_Buf.end(), ip + hdrlen, ip + pkt.size());
+    m_Segments++;
+    m_NextSeq += payload;
+    m_NextID++;
+    // a short or pushed segment ends a burst, the kernel would not join anything after it either
+    if (payload < m_SegmentSize or flags & tcp_psh)
+    {
+      m_Closed = true;
+      m_Buf[sizeof(vnet_header) + th + 13] |= flags & tcp_psh;
+    }
+    return true;
+  }
+
+  std::vector<byte_t>
+  TCPCoalescer::Flush()
+  {
+    std::vector<byte_t> out;
+    if (empty())
+      return out;
+    std::swap(out, m_Buf);
+
+    vnet_header hdr{};
+    if (m_Segments > 1)
+    {
+      byte_t* ip = out.data() + sizeof(hdr);
+      const size_t sz = out.size() - sizeof(hdr);
+      const bool v6 = (ip[0] >> 4) == 6;
+      set_ip_length(ip, tcp_layout{v6, m_IPHeaderLen, m_HeaderLen - m_IPHeaderLen}, sz);
+      // the kernel finishes the checksum of each segment it cuts from this starting from the
+      // pseudo header sum over the whole thing
+      const uint16_t check = fold(pseudo_header_sum(ip, v6, sz - m_IPHeaderLen));
+      std::memcpy(ip + m_IPHeaderLen + tcp_checksum_offset, &check, sizeof(check));
+
+      hdr.flags = vnet_header::NeedsChecksum;
+      hdr.gso_type = v6 ? vnet_header::GSOTCPv6 : vnet_header::GSOTCPv4;
+      hdr.hdr_len = m_HeaderLen;
+      hdr.gso_size = m_SegmentSize;
+      hdr.csum_start = m_IPHeaderLen;
+      hdr.csum_offset = tcp_checksum_offset;
+    }
+    std::memcpy(out.data(), &hdr, sizeof(hdr));
+    m_Segments = 0;
+    m_Closed = false;
+    return out;
+  }
+}  // namespace llarp::net
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ip_packet.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace llarp::net
+{
+  /// what linux puts in front of every packet on a tun opened with IFF_VNET_HDR.  this is struct
+  /// virtio_net_hdr, in host byte order, which we spell out ourselves because linux/virtio_net.h
+  /// does not build as c++ and so that it can be tested on any platform.  it is the size a tun
+  /// expects unless told otherwise.
+  struct vnet_header
+  {
+    /// csum_start and csum_offset say where the checksum goes that is left to us
+    static constexpr uint8_t NeedsChecksum = 1;
+
+    static constexpr uint8_t GSONone = 0;
+    static constexpr uint8_t GSOTCPv4 = 1;
+    static constexpr uint8_t GSOTCPv6 = 4;
+    static constexpr uint8_t GSOECN = 0x80;
+
+    uint8_t flags;
+    uint8_t gso_type;
+    uint16_t hdr_len;
+    uint16_t gso_size;
+    uint16_t csum_start;
+    uint16_t csum_offset;
+  };
+
+  static_assert(sizeof(vnet_header) == 10);
+
+  /// the biggest packet we read from or write to a tun with offload on
+  static constexpr size_t MaxOffloadSize = 65535;
+
+  /// turn a packet from a tun with offload on into packets we can send: finishes the checksum the
+  /// kernel left to us if there is one and cuts a tcp super packet back into segments of at most
+  /// gso_size, or of as much as fits in an IPPacket if that is smaller.  returns nothing if the
+  /// packet is not one we understand.
+  std::vector<IPPacket>
+  SplitOffloaded(const vnet_header& hdr, byte_view_t pkt);
+
+  /// joins consecutive segments of a tcp flow that we are going to write to a tun with offload on
+  /// into one super packet for the kernel to split up again, so that a burst of segments costs one
+  /// write and one trip through the kernel's stack
+  class TCPCoalescer
+  {
+   public:
+    /// add pkt onto the super packet we hold, or start a new one with it if we hold nothing.
+    /// returns false without taking it if pkt does not continue what we hold, or is not a tcp
+    /// segment we know how to join.
+    bool
+    Append(const IPPacket& pkt);
+
+    bool
+    empty() const
+    {
+      return m_Segments == 0;
+    }
+
+    /// the vnet header followed by the packet to write for what we hold, and start over
+    std::vector<byte_t>
+    Flush();
+
+   private:
+    /// the vnet header and then the packet we are building
+    std::vector<byte_t> m_Buf;
+    size_t m_Segments = 0;
+    size_t m_IPHeaderLen = 0;
+    size_t m_HeaderLen = 0;
+    size_t m_SegmentSize = 0;
+    uint32_t m_NextSeq = 0;
+    uint16_t m_NextID = 0;
+    /// set once a segment ends the burst, by being short or pushed
+    bool m_Closed = false;
+  };
+}  // namespace llarp::net
@@ -11,8 +11,13 @@
 #include <oxenc/endian.h>
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace llarp::net
 {
   constexpr uint32_t ipv6_flowlabel_mask = 0b0000'0000'0000'1111'1111'1111'1111'1111;
@@ -206,26 +211,55 @@ namespace llarp::net
   uint16_t
   ipchksum(const byte_t* buf, size_t sz, uint32_t sum)
   {
-    while (sz > 1)
+    // adding the 16 bit words as wider words gives the same one's complement sum once folded, so
+    // we add as many bytes at a time as we can into a 64 bit sum that cannot carry out
+    uint64_t acc = sum;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    while (sz >= 16)
+    {
+      // widen each 16 bit word into a 32 bit lane, each round adds at most 2 * 0xFFff to a lane
+      // so we move the lanes into acc before they could overflow
+      __m128i lanes = zero;
+      for (size_t n = std::min<size_t>(sz / 16, 0x8000); n > 0; --n, buf += 16, sz -= 16)
+      {
+        const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+        lanes = _mm_add_epi32(lanes, _mm_unpacklo_epi16(words, zero));
+        lanes = _mm_add_epi32(lanes, _mm_unpackhi_epi16(words, zero));
+      }
+      alignas(16) uint32_t out[4];
+      _mm_store_si128(reinterpret_cast<__m128i*>(out), lanes);
+      acc += uint64_t{out[0]} + out[1] + out[2] + out[3];
+    }
+#endif
+    for (; sz >= 8; buf += 8, sz -= 8)
+    {
+      uint64_t word;
+      std::memcpy(&word, buf, sizeof(word));
+      acc += (word & 0xFFff'FFff) + (word >> 32);
+    }
+    for (; sz >= 2; buf += 2, sz -= 2)
     {
-      sum += *(const uint16_t*)buf;
-      sz -= sizeof(uint16_t);
-      buf += sizeof(uint16_t);
+      uint16_t word;
+      std::memcpy(&word, buf, sizeof(word));
+      acc += word;
     }
     if (sz != 0)
     {
       uint16_t x = 0;
 
       *(byte_t*)&x = *(const byte_t*)buf;
-      sum += x;
+      acc += x;
     }
 
-    // only need to do it 2 times to be sure
+    // fold 64 bits down to 32 and then to 16, 2 times each to be sure
     // proof: 0xFFff + 0xFFff = 0x1FFfe -> 0xFFff
-    sum = (sum & 0xFFff) + (sum >> 16);
-    sum += sum >> 16;
+    acc = (acc & 0xFFff'FFff) + (acc >> 32);
+    acc = (acc & 0xFFff'FFff) + (acc >> 32);
+    acc = (acc & 0xFFff) + (acc >> 16);
+    acc = (acc & 0xFFff) + (acc >> 16);
 
-    return uint16_t((~sum) & 0xFFff);
+    return uint16_t((~acc) & 0xFFff);
   }
 
 #define ADD32CS(x) ((uint32_t)(x & 0xFFff) + (uint32_t)(x >> 16))
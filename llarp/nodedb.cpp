@@ -22,7 +22,8 @@ namespace llarp
 {
   static auto logcat = log::Cat("nodedb");
 
-  NodeDB::Entry::Entry(RouterContact value) : rc(std::move(value)), insertedAt(llarp::time_now_ms())
+  NodeDB::Entry::Entry(RouterContact_ptr value)
+      : rc(std::move(value)), insertedAt(llarp::time_now_ms())
   {}
 
   static void
@@ -77,16 +78,17 @@ namespace llarp
     if (now > m_NextFlushAt)
     {
       m_NextFlushAt += FlushInterval;
-      // make copy of all rcs
-      std::vector<RouterContact> copy;
+      // hold on to all rcs, they do not change so this needs no copies
+      std::vector<RouterContact_ptr> rcs;
+      rcs.reserve(m_Entries.size());
       for (const auto& item : m_Entries)
-        copy.push_back(item.second.rc);
+        rcs.push_back(item.second.rc);
       // flush them to disk in one big job
       // TODO: split this up? idk maybe some day...
-      disk([this, data = std::move(copy)]() {
+      disk([this, data = std::move(rcs)]() {
         for (const auto& rc : data)
         {
-          rc.Write(GetPathForPubkey(rc.pubkey));
+          rc->Write(GetPathForPubkey(rc->pubkey));
         }
       });
     }
@@ -107,11 +109,13 @@ namespace llarp
   }
 
   void
-  NodeDB::LoadFromDisk()
+  NodeDB::LoadFromDisk(const std::function<void(std::function<void()>)>& work)
   {
     if (m_Root.empty())
       return;
     std::set<fs::path> purge;
+    std::vector<fs::path> loadedPaths;
+    std::vector<RouterContact> loaded;
 
     for (const char& ch : skiplist_subdirs)
     {
@@ -148,17 +152,30 @@ namespace llarp
           return true;
         }
 
-        // validate signature and purge entries with invalid signatures
-        // load ones with valid signatures
-        if (rc.VerifySignature())
-          m_Entries.emplace(rc.pubkey, rc);
-        else
+        if (not rc.IsPublicRouter())
+        {
+          // we only keep rcs of public routers around, purge it
           purge.emplace(f);
+          return true;
+        }
 
+        loadedPaths.emplace_back(f);
+        loaded.emplace_back(std::move(rc));
         return true;
       });
     }
 
+    // validate signatures as one batch and purge entries with invalid signatures
+    // load ones with valid signatures
+    const auto valid = RouterContact::VerifySignatures(loaded, work);
+    for (size_t idx = 0; idx < loaded.size(); ++idx)
+    {
+      if (valid[idx])
+        InsertEntry(std::make_shared<const EncodedRouterContact>(std::move(loaded[idx])));
+      else
+        purge.emplace(loadedPaths[idx]);
+    }
+
     if (not purge.empty())
     {
       log::warning(logcat, "removing {} invalid RCs from disk", purge.size());
@@ -176,7 +193,7 @@ namespace llarp
 
     for (const auto& item : m_Entries)
     {
-      item.second.rc.Write(GetPathForPubkey(item.first));
+      item.second.rc->Write(GetPathForPubkey(item.first));
     }
   }
 
@@ -187,21 +204,43 @@ namespace llarp
     return m_Entries.find(pk) != m_Entries.end();
   }
 
-  std::optional<RouterContact>
+  RouterContact_ptr
   NodeDB::Get(RouterID pk) const
   {
     util::NullLock lock{m_Access};
     const auto itr = m_Entries.find(pk);
     if (itr == m_Entries.end())
-      return std::nullopt;
+      return nullptr;
     return itr->second.rc;
   }
 
+  void
+  NodeDB::InsertEntry(RouterContact_ptr rc)
+  {
+    if (auto itr = m_Entries.find(rc->pubkey); itr != m_Entries.end())
+      EraseEntry(itr);
+    const RouterID pk{rc->pubkey};
+    const auto expiresAt = rc->ExpiresAt();
+    const auto& entry = m_Entries.emplace(pk, std::move(rc)).first->second;
+    m_ExpiryIndex.emplace(expiresAt, pk);
+    m_InsertionIndex.emplace(entry.insertedAt, pk);
+  }
+
+  NodeDB::NodeMap::iterator
+  NodeDB::EraseEntry(NodeMap::iterator itr)
+  {
+    const auto& [pk, entry] = *itr;
+    m_ExpiryIndex.erase({entry.rc->ExpiresAt(), pk});
+    m_InsertionIndex.erase({entry.insertedAt, pk});
+    return m_Entries.erase(itr);
+  }
+
   void
   NodeDB::Remove(RouterID pk)
   {
     util::NullLock lock{m_Access};
-    m_Entries.erase(pk);
+    if (auto itr = m_Entries.find(pk); itr != m_Entries.end())
+      EraseEntry(itr);
     AsyncRemoveManyFromDisk({pk});
   }
 
@@ -210,17 +249,15 @@ namespace llarp
   {
     util::NullLock lock{m_Access};
     std::unordered_set<RouterID> removed;
-    auto itr = m_Entries.begin();
-    while (itr != m_Entries.end())
+    for (const auto& [insertedAt, pk] : m_InsertionIndex)
     {
-      if (itr->second.insertedAt < cutoff and keep.count(itr->second.rc.pubkey) == 0)
-      {
-        removed.insert(itr->second.rc.pubkey);
-        itr = m_Entries.erase(itr);
-      }
-      else
-        ++itr;
+      if (insertedAt >= cutoff)
+        break;
+      if (keep.count(pk) == 0)
+        removed.insert(pk);
     }
+    for (const auto& pk : removed)
+      EraseEntry(m_Entries.find(pk));
     if (not removed.empty())
       AsyncRemoveManyFromDisk(std::move(removed));
   }
@@ -229,8 +266,7 @@ namespace llarp
   NodeDB::Put(RouterContact rc)
   {
     util::NullLock lock{m_Access};
-    m_Entries.erase(rc.pubkey);
-    m_Entries.emplace(rc.pubkey, rc);
+    InsertEntry(std::make_shared<const EncodedRouterContact>(std::move(rc)));
   }
 
   size_t
@@ -243,15 +279,22 @@ namespace llarp
   void
   NodeDB::PutIfNewer(RouterContact rc)
   {
+    if (rc.IsPublicRouter())
+      PutIfNewer(std::make_shared<const EncodedRouterContact>(std::move(rc)));
+  }
+
+  void
+  NodeDB::PutIfNewer(RouterContact_ptr rc)
+  {
+    // we only keep rcs of public routers around
+    if (not rc->IsPublicRouter())
+      return;
     util::NullLock lock{m_Access};
-    auto itr = m_Entries.find(rc.pubkey);
-    if (itr == m_Entries.end() or itr->second.rc.OtherIsNewer(rc))
+    auto itr = m_Entries.find(rc->pubkey);
+    if (itr == m_Entries.end() or itr->second.rc->OtherIsNewer(*rc))
     {
-      // delete if existing
-      if (itr != m_Entries.end())
-        m_Entries.erase(itr);
-      // add new entry
-      m_Entries.emplace(rc.pubkey, rc);
+      // replaces the existing entry if there is one
+      InsertEntry(std::move(rc));
     }
   }
 
@@ -273,23 +316,20 @@ namespace llarp
     });
   }
 
-  llarp::RouterContact
+  RouterContact_ptr
   NodeDB::FindClosestTo(llarp::dht::Key_t location) const
   {
     util::NullLock lock{m_Access};
-    llarp::RouterContact rc;
+    RouterContact_ptr rc;
     const llarp::dht::XorMetric compare(location);
-    VisitAll([&rc, compare](const auto& otherRC) {
-      if (rc.pubkey.IsZero())
-      {
-        rc = otherRC;
-        return;
-      }
-      if (compare(
-              llarp::dht::Key_t{otherRC.pubkey.as_array()},
-              llarp::dht::Key_t{rc.pubkey.as_array()}))
-        rc = otherRC;
-    });
+    for (const auto& [pk, entry] : m_Entries)
+    {
+      if (not rc
+          or compare(
+              llarp::dht::Key_t{entry.rc->pubkey.as_array()},
+              llarp::dht::Key_t{rc->pubkey.as_array()}))
+        rc = entry.rc;
+    }
     return rc;
   }
 
@@ -304,7 +344,7 @@ namespace llarp
     all.reserve(entries.size());
     for (auto& entry : entries)
     {
-      all.push_back(&entry.second.rc);
+      all.push_back(entry.second.rc.get());
     }
 
     auto it_mid = numRouters < all.size() ? all.begin() + numRouters : all.end();
@@ -23,14 +23,23 @@ namespace llarp
   {
     struct Entry
     {
-      const RouterContact rc;
+      /// shared with whoever we hand it out to, so that does not cost a copy
+      const RouterContact_ptr rc;
       llarp_time_t insertedAt;
-      explicit Entry(RouterContact rc);
+      explicit Entry(RouterContact_ptr rc);
     };
     using NodeMap = std::unordered_map<RouterID, Entry>;
+    /// secondary index of entries ordered by a timestamp
+    using TimeIndex = std::set<std::pair<llarp_time_t, RouterID>>;
 
     NodeMap m_Entries;
 
+    /// entries ordered by when their rc expires
+    TimeIndex m_ExpiryIndex;
+
+    /// entries ordered by when they were inserted
+    TimeIndex m_InsertionIndex;
+
     const fs::path m_Root;
 
     const std::function<void(std::function<void()>)> disk;
@@ -47,15 +56,24 @@ namespace llarp
     fs::path
     GetPathForPubkey(RouterID pk) const;
 
+    /// put an rc into our entries and indexes replacing any entry we had for it
+    void
+    InsertEntry(RouterContact_ptr rc);
+
+    /// erase an entry and its index entries, returns the iterator following it
+    NodeMap::iterator
+    EraseEntry(NodeMap::iterator itr);
+
    public:
     explicit NodeDB(fs::path rootdir, std::function<void(std::function<void()>)> diskCaller);
 
     /// in memory nodedb
     NodeDB();
 
-    /// load all entries from disk syncrhonously
+    /// load all entries from disk syncrhonously, verifying their signatures in batches via work
+    /// if it is set
     void
-    LoadFromDisk();
+    LoadFromDisk(const std::function<void(std::function<void()>)>& work = nullptr);
 
     /// explicit save all RCs to disk synchronously
     void
@@ -69,8 +87,8 @@ namespace llarp
     void
     Tick(llarp_time_t now);
 
-    /// find the absolute closets router to a dht location
-    RouterContact
+    /// find the absolute closets router to a dht location, shared like Get.  null if we have none.
+    RouterContact_ptr
     FindClosestTo(dht::Key_t location) const;
 
     /// find many routers closest to dht key
@@ -81,12 +99,14 @@ namespace llarp
     bool
     Has(RouterID pk) const;
 
-    /// maybe get an rc by its ident pubkey
-    std::optional<RouterContact>
+    /// maybe get an rc by its ident pubkey.  the rc is shared with us and stays valid after we
+    /// drop or replace it.
+    RouterContact_ptr
     Get(RouterID pk) const;
 
+    /// get a random rc that visit returns true for, shared like Get
     template <typename Filter>
-    std::optional<RouterContact>
+    RouterContact_ptr
     GetRandom(Filter visit) const
     {
       util::NullLock lock{m_Access};
@@ -99,11 +119,11 @@ namespace llarp
 
       for (const auto entry : entries)
       {
-        if (visit(entry->second.rc))
+        if (visit(*entry->second.rc))
           return entry->second.rc;
       }
 
-      return std::nullopt;
+      return nullptr;
     }
 
     /// visit all entries
@@ -114,20 +134,21 @@ namespace llarp
       util::NullLock lock{m_Access};
       for (const auto& item : m_Entries)
       {
-        visit(item.second.rc);
+        visit(*item.second.rc);
       }
     }
 
-    /// visit all entries inserted before a timestamp
+    /// visit all entries inserted before a timestamp, oldest first
     template <typename Visit>
     void
     VisitInsertedBefore(Visit visit, llarp_time_t insertedBefore)
     {
       util::NullLock lock{m_Access};
-      for (const auto& item : m_Entries)
+      for (const auto& [insertedAt, pk] : m_InsertionIndex)
       {
-        if (item.second.insertedAt < insertedBefore)
-          visit(item.second.rc);
+        if (insertedAt >= insertedBefore)
+          break;
+        visit(*m_Entries.at(pk).rc);
       }
     }
 
@@ -145,10 +166,10 @@ namespace llarp
       auto itr = m_Entries.begin();
       while (itr != m_Entries.end())
       {
-        if (visit(itr->second.rc))
+        if (visit(*itr->second.rc))
         {
-          removed.insert(itr->second.rc.pubkey);
-          itr = m_Entries.erase(itr);
+          removed.insert(itr->second.rc->pubkey);
+          itr = EraseEntry(itr);
         }
         else
           ++itr;
@@ -157,14 +178,65 @@ namespace llarp
         AsyncRemoveManyFromDisk(std::move(removed));
     }
 
+    /// remove the entries whose rc expired at or before now, leaving the ones keep returns true
+    /// for. only expired entries are visited.
+    template <typename Filter>
+    void
+    RemoveExpired(llarp_time_t now, Filter keep)
+    {
+      util::NullLock lock{m_Access};
+      std::unordered_set<RouterID> removed;
+      std::vector<RouterID> expired;
+      for (const auto& [expiresAt, pk] : m_ExpiryIndex)
+      {
+        if (expiresAt > now)
+          break;
+        expired.push_back(pk);
+      }
+      for (const auto& pk : expired)
+      {
+        auto itr = m_Entries.find(pk);
+        if (keep(*itr->second.rc))
+          continue;
+        removed.insert(pk);
+        EraseEntry(itr);
+      }
+      if (not removed.empty())
+        AsyncRemoveManyFromDisk(std::move(removed));
+    }
+
+    /// remove the entries for a set of routers, leaving the ones keep returns true for
+    template <typename Filter>
+    void
+    RemoveMany(const std::unordered_set<RouterID>& idents, Filter keep)
+    {
+      util::NullLock lock{m_Access};
+      std::unordered_set<RouterID> removed;
+      for (const auto& pk : idents)
+      {
+        auto itr = m_Entries.find(pk);
+        if (itr == m_Entries.end() or keep(*itr->second.rc))
+          continue;
+        removed.insert(pk);
+        EraseEntry(itr);
+      }
+      if (not removed.empty())
+        AsyncRemoveManyFromDisk(std::move(removed));
+    }
+
     /// remove rcs that are not in keep and have been inserted before cutoff
     void
     RemoveStaleRCs(std::unordered_set<RouterID> keep, llarp_time_t cutoff);
 
-    /// put this rc into the cache if it is not there or newer than the one there already
+    /// put this rc into the cache if it is a public router and it is not there or newer than the
+    /// one there already
     void
     PutIfNewer(RouterContact rc);
 
+    /// like PutIfNewer but keeps the handle we are given instead of making one
+    void
+    PutIfNewer(RouterContact_ptr rc);
+
     /// unconditional put of rc into cache
     void
     Put(RouterContact rc);
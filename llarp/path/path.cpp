@@ -14,6 +14,7 @@
 #include <llarp/routing/path_latency_message.hpp>
 #include <llarp/routing/transfer_traffic_message.hpp>
 #include <llarp/util/buffer.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/tooling/path_event.hpp>
 
 #include <oxenc/endian.h>
@@ -26,7 +27,7 @@ namespace llarp
   namespace path
   {
     Path::Path(
-        const std::vector<RouterContact>& h,
+        const std::vector<RouterContact_ptr>& h,
         std::weak_ptr<PathSet> pathset,
         PathRole startingRoles,
         std::string shortName)
@@ -54,7 +55,7 @@ namespace llarp
         hops[idx].txID = hops[idx + 1].rxID;
       }
       // initialize parts of the introduction
-      intro.router = hops[hsz - 1].rc.pubkey;
+      intro.router = hops[hsz - 1].rc->pubkey;
       intro.pathID = hops[hsz - 1].txID;
       if (auto parent = m_PathSet.lock())
         EnterState(ePathBuilding, parent->Now());
@@ -85,13 +86,13 @@ namespace llarp
     RouterID
     Path::Endpoint() const
     {
-      return hops[hops.size() - 1].rc.pubkey;
+      return hops[hops.size() - 1].rc->pubkey;
     }
 
     PubKey
     Path::EndpointPubKey() const
     {
-      return hops[hops.size() - 1].rc.pubkey;
+      return hops[hops.size() - 1].rc->pubkey;
     }
 
     PathID_t
@@ -117,13 +118,13 @@ namespace llarp
     bool
     Path::IsEndpoint(const RouterID& r, const PathID_t& id) const
     {
-      return hops[hops.size() - 1].rc.pubkey == r && hops[hops.size() - 1].txID == id;
+      return hops[hops.size() - 1].rc->pubkey == r && hops[hops.size() - 1].txID == id;
     }
 
     RouterID
     Path::Upstream() const
     {
-      return hops[0].rc.pubkey;
+      return hops[0].rc->pubkey;
     }
 
     const std::string&
@@ -141,7 +142,7 @@ namespace llarp
       {
         if (!hops.empty())
           hops_str += " -> ";
-        hops_str += RouterID(hop.rc.pubkey).ToString();
+        hops_str += RouterID(hop.rc->pubkey).ToString();
       }
       return hops_str;
     }
@@ -158,10 +159,10 @@ namespace llarp
         if (!frames[index].DoDecrypt(hops[index].shared))
         {
           currentStatus = LR_StatusRecord::FAIL_DECRYPT_ERROR;
-          failedAt = hops[index].rc.pubkey;
+          failedAt = hops[index].rc->pubkey;
           break;
         }
-        llarp::LogDebug("decrypted LRSM frame from ", hops[index].rc.pubkey);
+        llarp::LogDebug("decrypted LRSM frame from ", hops[index].rc->pubkey);
 
         llarp_buffer_t* buf = frames[index].Buffer();
         buf->cur = buf->base + EncryptedFrameOverheadSize;
@@ -170,12 +171,12 @@ namespace llarp
         // successful decrypt
         if (!record.BDecode(buf))
         {
-          llarp::LogWarn("malformed frame inside LRCM from ", hops[index].rc.pubkey);
+          llarp::LogWarn("malformed frame inside LRCM from ", hops[index].rc->pubkey);
           currentStatus = LR_StatusRecord::FAIL_MALFORMED_RECORD;
-          failedAt = hops[index].rc.pubkey;
+          failedAt = hops[index].rc->pubkey;
           break;
         }
-        llarp::LogDebug("Decoded LR Status Record from ", hops[index].rc.pubkey);
+        llarp::LogDebug("Decoded LR Status Record from ", hops[index].rc->pubkey);
 
         currentStatus = record.status;
         if ((record.status & LR_StatusRecord::SUCCESS) != LR_StatusRecord::SUCCESS)
@@ -183,13 +184,13 @@ namespace llarp
           if (record.status & LR_StatusRecord::FAIL_CONGESTION and index == 0)
           {
             // first hop building too fast
-            failedAt = hops[index].rc.pubkey;
+            failedAt = hops[index].rc->pubkey;
             break;
           }
           // failed at next hop
           if (index + 1 < hops.size())
           {
-            failedAt = hops[index + 1].rc.pubkey;
+            failedAt = hops[index + 1].rc->pubkey;
           }
           break;
         }
@@ -305,10 +306,16 @@ namespace llarp
       {
         LogInfo("path ", Name(), " is building");
         buildStarted = now;
+        static auto& builds = metrics::registry().GetCounter(
+            "lokinet_path_builds_total", "path builds we started");
+        builds.Add();
       }
       else if (st == ePathEstablished && _status == ePathBuilding)
       {
         LogInfo("path ", Name(), " is built, took ", ToString(now - buildStarted));
+        static auto& buildTime = metrics::registry().GetHistogram(
+            "lokinet_path_build_seconds", "time from starting a path build to it being confirmed");
+        buildTime.Observe(now - buildStarted);
       }
       else if (st == ePathTimeout && _status == ePathEstablished)
       {
@@ -333,11 +340,11 @@ namespace llarp
     util::StatusObject
     PathHopConfig::ExtractStatus() const
     {
-      const auto ip = net::In6ToHUInt(rc.addrs[0].ip);
+      const auto ip = net::In6ToHUInt(rc->addrs[0].ip);
       util::StatusObject obj{
           {"ip", ip.ToString()},
           {"lifetime", to_json(lifetime)},
-          {"router", rc.pubkey.ToHex()},
+          {"router", rc->pubkey.ToHex()},
           {"txid", txID.ToHex()},
           {"rxid", rxID.ToHex()}};
       return obj;
@@ -359,6 +366,7 @@ namespace llarp
           {"ready", IsReady()},
           {"txRateCurrent", m_LastTXRate},
           {"rxRateCurrent", m_LastRXRate},
+          {"metrics", metrics.ExtractStatus()},
           {"replayTX", m_UpstreamReplayFilter.Size()},
           {"replayRX", m_DownstreamReplayFilter.Size()},
           {"hasExit", SupportsAnyRoles(ePathRoleExit)}};
@@ -403,7 +411,7 @@ namespace llarp
     {
       if (auto parent = m_PathSet.lock())
       {
-        std::vector<RouterContact> newHops;
+        std::vector<RouterContact_ptr> newHops;
         for (const auto& hop : hops)
           newHops.emplace_back(hop.rc);
         LogInfo(Name(), " rebuilding on ", ShortName());
@@ -434,6 +442,10 @@ namespace llarp
       if (Expired(now))
         return;
 
+      if (m_LastTickAt > 0s)
+        metrics.AddTraffic(m_TXRate, m_RXRate, now - m_LastTickAt);
+      m_LastTickAt = now;
+
       m_LastRXRate = m_RXRate;
       m_LastTXRate = m_TXRate;
 
@@ -459,8 +471,18 @@ namespace llarp
       // check to see if this path is dead
       if (_status == ePathEstablished)
       {
+        // probe more often while we carry traffic so paths in use get scored on fresh samples
+        constexpr double BusyRate = 1024;
+        const auto interval = metrics.TXRate() > BusyRate ? path::busy_latency_interval
+                                                          : path::latency_interval;
         auto dlt = now - m_LastLatencyTestTime;
-        if (dlt > path::latency_interval && m_LastLatencyTestID == 0)
+        // a probe still in flight is not lost until it had its time to come back
+        if (m_LastLatencyTestID and dlt >= path::latency_timeout)
+        {
+          metrics.AddLost();
+          m_LastLatencyTestID = 0;
+        }
+        if (dlt > interval && m_LastLatencyTestID == 0)
         {
           SendLatencyMessage(r);
           // latency test FEC
@@ -685,6 +707,7 @@ namespace llarp
     Path::HandleDataDiscardMessage(const routing::DataDiscardMessage& msg, AbstractRouter* r)
     {
       MarkActive(r->Now());
+      metrics.AddLost();
       if (m_DropHandler)
         return m_DropHandler(shared_from_this(), msg.P, msg.S);
       return true;
@@ -750,13 +773,17 @@ namespace llarp
       if (m_LastLatencyTestID)
       {
         m_LatencySamples.emplace_back(now - m_LastLatencyTestTime);
+        metrics.AddRTT(m_LatencySamples.back());
+        metrics.AddDelivered();
 
         while (m_LatencySamples.size() > MaxLatencySamples)
           m_LatencySamples.pop_front();
 
         intro.latency = computeLatency(m_LatencySamples);
         m_LastLatencyTestID = 0;
-        EnterState(ePathEstablished, now);
+        // a path we retired stays retired
+        if (_status != ePathIgnore)
+          EnterState(ePathEstablished, now);
         if (m_BuiltHook)
           m_BuiltHook(shared_from_this());
         m_BuiltHook = nullptr;
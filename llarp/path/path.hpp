@@ -5,6 +5,7 @@
 #include <llarp/crypto/types.hpp>
 #include <llarp/messages/relay.hpp>
 #include "ihophandler.hpp"
+#include "path_metrics.hpp"
 #include "path_types.hpp"
 #include "pathbuilder.hpp"
 #include "pathset.hpp"
@@ -42,8 +43,8 @@ namespace llarp
     {
       /// path id
       PathID_t txID, rxID;
-      // router contact of router
-      RouterContact rc;
+      // router contact of router, shared with the nodedb and our sessions
+      RouterContact_ptr rc;
       // temp public encryption key
       SecretKey commkey;
       /// shared secret at this hop
@@ -64,8 +65,8 @@ namespace llarp
     inline bool
     operator<(const PathHopConfig& lhs, const PathHopConfig& rhs)
     {
-      return std::tie(lhs.txID, lhs.rxID, lhs.rc, lhs.upstream, lhs.lifetime)
-          < std::tie(rhs.txID, rhs.rxID, rhs.rc, rhs.upstream, rhs.lifetime);
+      return std::tie(lhs.txID, lhs.rxID, *lhs.rc, lhs.upstream, lhs.lifetime)
+          < std::tie(rhs.txID, rhs.rxID, *rhs.rc, rhs.upstream, rhs.lifetime);
     }
 
     /// A path we made
@@ -91,10 +92,12 @@ namespace llarp
 
       service::Introduction intro;
 
+      PathMetrics metrics;
+
       llarp_time_t buildStarted = 0s;
 
       Path(
-          const std::vector<RouterContact>& routers,
+          const std::vector<RouterContact_ptr>& routers,
           std::weak_ptr<PathSet> parent,
           PathRole startingRoles,
           std::string shortName);
@@ -427,6 +430,7 @@ namespace llarp
       uint64_t m_RXRate = 0;
       uint64_t m_LastTXRate = 0;
       uint64_t m_TXRate = 0;
+      llarp_time_t m_LastTickAt = 0s;
       std::deque<llarp_time_t> m_LatencySamples;
       const std::string m_shortName;
     };
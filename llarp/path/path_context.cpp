@@ -4,6 +4,7 @@
 #include "path.hpp"
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/router/i_outbound_message_handler.hpp>
+#include <llarp/util/metrics.hpp>
 
 namespace llarp
 {
@@ -27,6 +28,60 @@ namespace llarp
       return m_AllowTransit;
     }
 
+    bool
+    PathContext::AcceptingTransitBuilds() const
+    {
+      return m_TransitBuildBacklog < MaxTransitBuildBacklog;
+    }
+
+    void
+    PathContext::QueueTransitBuild(TransitBuildWork work)
+    {
+      m_TransitBuildBacklog++;
+      m_TransitBuildQueue.emplace_back(std::move(work));
+      // the first one in a cycle schedules the flush, everything else that arrives in the same
+      // cycle (usually from the same burst of link traffic) joins it
+      if (m_TransitBuildQueue.size() == 1)
+        m_Router->loop()->call_soon([this]() { FlushTransitBuilds(); });
+    }
+
+    void
+    PathContext::FlushTransitBuilds()
+    {
+      static auto& batchTime = metrics::registry().GetHistogram(
+          "lokinet_transit_build_batch_seconds",
+          "worker time spent on the crypto for one batch of transit path builds");
+
+      auto queued = std::move(m_TransitBuildQueue);
+      m_TransitBuildQueue.clear();
+      for (size_t idx = 0; idx < queued.size(); idx += TransitBuildBatchSize)
+      {
+        const auto end = std::min(idx + TransitBuildBatchSize, queued.size());
+        std::vector<TransitBuildWork> batch{
+            std::make_move_iterator(queued.begin() + idx),
+            std::make_move_iterator(queued.begin() + end)};
+        m_Router->QueueWork([this, batch = std::move(batch)]() {
+          std::vector<std::function<void()>> then;
+          then.reserve(batch.size());
+          {
+            metrics::Timer timer{batchTime};
+            for (const auto& work : batch)
+            {
+              if (auto f = work())
+                then.emplace_back(std::move(f));
+            }
+          }
+          m_Router->loop()->call([this, then = std::move(then), num = batch.size()]() {
+            for (const auto& f : then)
+              f();
+            m_TransitBuildBacklog -= num;
+            // trigger idempotent pump to ensure that the build messages propagate
+            m_Router->TriggerPump();
+          });
+        });
+      }
+    }
+
     bool
     PathContext::CheckPathLimitHitByIP(const IpAddress& ip)
     {
@@ -12,8 +12,10 @@
 #include <llarp/util/decaying_hashset.hpp>
 #include <llarp/util/types.hpp>
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -62,6 +64,26 @@ namespace llarp
       bool
       HandleRelayCommit(const LR_CommitMessage& msg);
 
+      /// the crypto for a transit path build request, run on a worker.  returns what to then do on
+      /// the event loop, if anything.
+      using TransitBuildWork = std::function<std::function<void()>()>;
+
+      /// how many transit build requests we let wait for crypto before we drop new ones
+      static constexpr size_t MaxTransitBuildBacklog = 1024;
+      /// how many transit build requests one worker job handles
+      static constexpr size_t TransitBuildBatchSize = 32;
+
+      /// false if we are so far behind on transit path builds that we should drop new ones
+      /// without doing any crypto for them
+      bool
+      AcceptingTransitBuilds() const;
+
+      /// queue the crypto for a transit path build request.  requests queued in the same event
+      /// loop cycle are handed to the worker pool in batches, and what each batch needs done on the
+      /// event loop afterwards is done in one go.  called from the event loop.
+      void
+      QueueTransitBuild(TransitBuildWork work);
+
       void
       PutTransitHop(std::shared_ptr<TransitHop> hop);
 
@@ -183,6 +205,13 @@ namespace llarp
       SyncOwnedPathsMap_t m_OurPaths;
       bool m_AllowTransit;
       util::DecayingHashSet<IpAddress> m_PathLimits;
+      /// transit builds waiting for the next flush to the worker pool
+      std::vector<TransitBuildWork> m_TransitBuildQueue;
+      /// transit builds queued or on the worker pool that we have not finished yet
+      size_t m_TransitBuildBacklog = 0;
+
+      void
+      FlushTransitBuilds();
     };
   }  // namespace path
 }  // namespace llarp
@@ -0,0 +1,87 @@
+#include "path_metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace llarp
+{
+  namespace path
+  {
+    void
+    PathMetrics::AddRTT(llarp_time_t rtt)
+    {
+      const double sample = rtt.count();
+      if (m_Samples == 0)
+      {
+        m_RTT = sample;
+        m_Jitter = sample / 2;
+      }
+      else
+      {
+        m_Jitter += JitterGain * (std::abs(sample - m_RTT) - m_Jitter);
+        m_RTT += RTTGain * (sample - m_RTT);
+      }
+      m_Samples++;
+    }
+
+    void
+    PathMetrics::AddDelivered()
+    {
+      m_Loss -= LossGain * m_Loss;
+      m_Delivered++;
+    }
+
+    void
+    PathMetrics::AddLost()
+    {
+      m_Loss += LossGain * (1 - m_Loss);
+      m_Lost++;
+    }
+
+    void
+    PathMetrics::AddTraffic(uint64_t txBytes, uint64_t rxBytes, llarp_time_t interval)
+    {
+      if (interval <= 0s)
+        return;
+      const double seconds = std::chrono::duration<double>(interval).count();
+      m_TXRate += RateGain * (txBytes / seconds - m_TXRate);
+      m_RXRate += RateGain * (rxBytes / seconds - m_RXRate);
+    }
+
+    llarp_time_t
+    PathMetrics::RTT() const
+    {
+      return llarp_time_t{static_cast<int64_t>(std::lround(m_RTT))};
+    }
+
+    llarp_time_t
+    PathMetrics::Jitter() const
+    {
+      return llarp_time_t{static_cast<int64_t>(std::lround(m_Jitter))};
+    }
+
+    llarp_time_t
+    PathMetrics::Score() const
+    {
+      if (m_Samples == 0)
+        return 0s;
+      const double score = (m_RTT + 2 * m_Jitter) / (1 - std::min(m_Loss, MaxLoss));
+      return llarp_time_t{static_cast<int64_t>(std::lround(score))};
+    }
+
+    util::StatusObject
+    PathMetrics::ExtractStatus() const
+    {
+      return {
+          {"rtt", RTT().count()},
+          {"jitter", Jitter().count()},
+          {"loss", m_Loss},
+          {"txRate", m_TXRate},
+          {"rxRate", m_RXRate},
+          {"score", Score().count()},
+          {"samples", m_Samples},
+          {"delivered", m_Delivered},
+          {"lost", m_Lost}};
+    }
+  }  // namespace path
+}  // namespace llarp
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <cstdint>
+
+namespace llarp
+{
+  namespace path
+  {
+    /// smoothed round trip time, jitter, loss and throughput of one of our paths.
+    /// round trips come from latency probes, loss from probes that went unanswered and data our
+    /// remote end told us it dropped, throughput from the traffic we push through the path.
+    struct PathMetrics
+    {
+      /// gains for the rtt and jitter averages, the same as tcp uses (rfc 6298)
+      static constexpr double RTTGain = 1. / 8;
+      static constexpr double JitterGain = 1. / 4;
+      static constexpr double LossGain = 1. / 16;
+      static constexpr double RateGain = 1. / 8;
+      /// cap on the loss we score with so a very lossy path still gets a finite score
+      static constexpr double MaxLoss = 0.9;
+
+      void
+      AddRTT(llarp_time_t rtt);
+
+      void
+      AddDelivered();
+
+      void
+      AddLost();
+
+      /// add the bytes sent and received over the last interval
+      void
+      AddTraffic(uint64_t txBytes, uint64_t rxBytes, llarp_time_t interval);
+
+      uint64_t
+      Samples() const
+      {
+        return m_Samples;
+      }
+
+      llarp_time_t
+      RTT() const;
+
+      llarp_time_t
+      Jitter() const;
+
+      double
+      Loss() const
+      {
+        return m_Loss;
+      }
+
+      /// bytes per second
+      double
+      TXRate() const
+      {
+        return m_TXRate;
+      }
+
+      /// bytes per second
+      double
+      RXRate() const
+      {
+        return m_RXRate;
+      }
+
+      /// the round trip time we expect a message to take on this path, padded by jitter and
+      /// inflated by loss. lower is better, 0 when we have no samples yet.
+      llarp_time_t
+      Score() const;
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      /// in milliseconds
+      double m_RTT = 0;
+      double m_Jitter = 0;
+      double m_Loss = 0;
+      double m_TXRate = 0;
+      double m_RXRate = 0;
+      uint64_t m_Samples = 0;
+      uint64_t m_Delivered = 0;
+      uint64_t m_Lost = 0;
+    };
+  }  // namespace path
+}  // namespace llarp
@@ -2,6 +2,7 @@
 #include "path_context.hpp"
 
 #include <llarp/crypto/crypto.hpp>
+#include <llarp/crypto/keypair_pool.hpp>
 #include <llarp/messages/relay_commit.hpp>
 #include <llarp/nodedb.hpp>
 #include <llarp/util/logging.hpp>
@@ -21,59 +22,40 @@ namespace llarp
     auto log_path = log::Cat("path");
   }
 
-  struct AsyncPathKeyExchangeContext : std::enable_shared_from_this<AsyncPathKeyExchangeContext>
+  namespace path
   {
-    using WorkFunc_t = std::function<void(void)>;
-    using WorkerFunc_t = std::function<void(WorkFunc_t)>;
-    using Path_t = path::Path_ptr;
-    using PathSet_t = path::PathSet_ptr;
-    PathSet_t pathset = nullptr;
-    Path_t path = nullptr;
-    using Handler = std::function<void(std::shared_ptr<AsyncPathKeyExchangeContext>)>;
-
-    Handler result;
-    size_t idx = 0;
-    AbstractRouter* router = nullptr;
-    WorkerFunc_t work;
-    EventLoop_ptr loop;
-    LR_CommitMessage LRCM;
-
-    void
-    GenerateNextKey()
+    bool
+    GenerateHopKeys(Path& path, size_t idx, EncryptedFrame& frame, EncryptionKeyPool& keys)
     {
-      // current hop
-      auto& hop = path->hops[idx];
-      auto& frame = LRCM.frames[idx];
-
+      auto& hop = path.hops[idx];
       auto crypto = CryptoManager::instance();
 
       // generate key
-      crypto->encryption_keygen(hop.commkey);
+      hop.commkey = keys.Take();
       hop.nonce.Randomize();
       // do key exchange
-      if (!crypto->dh_client(hop.shared, hop.rc.enckey, hop.commkey, hop.nonce))
+      if (!crypto->dh_client(hop.shared, hop.rc->enckey, hop.commkey, hop.nonce))
       {
-        LogError(pathset->Name(), " Failed to generate shared key for path build");
-        return;
+        LogError(path.ShortName(), " Failed to generate shared key for path build");
+        return false;
       }
       // generate nonceXOR valueself->hop->pathKey
       crypto->shorthash(hop.nonceXOR, llarp_buffer_t(hop.shared));
-      ++idx;
 
-      bool isFarthestHop = idx == path->hops.size();
+      const bool isFarthestHop = idx + 1 == path.hops.size();
 
       LR_CommitRecord record;
       if (isFarthestHop)
       {
-        hop.upstream = hop.rc.pubkey;
+        hop.upstream = hop.rc->pubkey;
       }
       else
       {
-        hop.upstream = path->hops[idx].rc.pubkey;
-        record.nextRC = std::make_unique<RouterContact>(path->hops[idx].rc);
+        hop.upstream = path.hops[idx + 1].rc->pubkey;
+        record.nextRC = path.hops[idx + 1].rc;
       }
       // build record
-      record.lifetime = path::default_lifetime;
+      record.lifetime = default_lifetime;
       record.version = llarp::constants::proto_version;
       record.txid = hop.txID;
       record.rxid = hop.rxID;
@@ -87,49 +69,76 @@ namespace llarp
       if (!record.BEncode(&buf))
       {
         // failed to encode?
-        LogError(pathset->Name(), " Failed to generate Commit Record");
+        LogError(path.ShortName(), " Failed to generate Commit Record");
         DumpBuffer(buf);
-        return;
+        return false;
       }
       // use ephemeral keypair for frame
-      SecretKey framekey;
-      crypto->encryption_keygen(framekey);
-      if (!frame.EncryptInPlace(framekey, hop.rc.enckey))
+      const SecretKey framekey = keys.Take();
+      if (!frame.EncryptInPlace(framekey, hop.rc->enckey))
       {
-        LogError(pathset->Name(), " Failed to encrypt LRCR");
-        return;
+        LogError(path.ShortName(), " Failed to encrypt LRCR");
+        return false;
       }
+      return true;
+    }
+  }  // namespace path
 
-      if (isFarthestHop)
-      {
-        // farthest hop
-        // TODO: encrypt junk frames because our public keys are not eligator
-        loop->call([self = shared_from_this()] {
-          self->result(self);
-          self->result = nullptr;
-        });
-      }
-      else
+  struct AsyncPathKeyExchangeContext : std::enable_shared_from_this<AsyncPathKeyExchangeContext>
+  {
+    using WorkFunc_t = std::function<void(void)>;
+    using WorkerFunc_t = std::function<void(WorkFunc_t)>;
+    using Path_t = path::Path_ptr;
+    using PathSet_t = path::PathSet_ptr;
+    PathSet_t pathset = nullptr;
+    Path_t path = nullptr;
+    using Handler = std::function<void(std::shared_ptr<AsyncPathKeyExchangeContext>)>;
+
+    Handler result;
+    AbstractRouter* router = nullptr;
+    EventLoop_ptr loop;
+    LR_CommitMessage LRCM;
+    /// hops whose keys are still being generated
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> failed{false};
+
+    void
+    GenerateKey(size_t idx)
+    {
+      // hops only touch their own hop and frame so they can all be done at once
+      if (not path::GenerateHopKeys(*path, idx, LRCM.frames[idx], router->encryptionKeyPool()))
+        failed = true;
+
+      if (--pending > 0)
+        return;
+      // we are the last hop to finish
+      if (failed)
       {
-        // next hop
-        work([self = shared_from_this()] { self->GenerateNextKey(); });
+        LogError(pathset->Name(), " failed to generate keys for ", path->ShortName());
+        return;
       }
+      // TODO: encrypt junk frames because our public keys are not eligator
+      loop->call([self = shared_from_this()] {
+        self->result(self);
+        self->result = nullptr;
+      });
     }
 
     /// Generate all keys asynchronously and call handler when done
     void
-    AsyncGenerateKeys(Path_t p, EventLoop_ptr l, WorkerFunc_t worker, Handler func)
+    AsyncGenerateKeys(Path_t p, EventLoop_ptr l, WorkerFunc_t work, Handler func)
     {
       path = p;
       loop = std::move(l);
       result = func;
-      work = worker;
 
       for (size_t i = 0; i < path::max_len; ++i)
       {
         LRCM.frames[i].Randomize();
       }
-      work([self = shared_from_this()] { self->GenerateNextKey(); });
+      pending = path->hops.size();
+      for (size_t idx = 0; idx < path->hops.size(); ++idx)
+        work([self = shared_from_this(), idx] { self->GenerateKey(idx); });
     }
   };
 
@@ -207,6 +216,8 @@ namespace llarp
       ExpirePaths(now, m_router);
       if (ShouldBuildMore(now))
         BuildOne();
+      else
+        ReplaceSlowPath(now);
       TickPaths(m_router);
       if (m_BuildStats.attempts > 50)
       {
@@ -218,11 +229,38 @@ namespace llarp
       }
     }
 
+    void
+    Builder::ReplaceSlowPath(llarp_time_t now)
+    {
+      // give the last replacement time to settle
+      constexpr auto SlowPathRetireInterval = 1min;
+      if (IsStopped() or now < m_LastSlowPathRetired + SlowPathRetireInterval)
+        return;
+      const auto slow = GetSlowPath(now);
+      if (not slow)
+        return;
+      if (NumInStatus(ePathEstablished) > numDesiredPaths)
+      {
+        LogInfo(
+            Name(),
+            " retiring slow path ",
+            slow->ShortName(),
+            " score=",
+            ToString(slow->metrics.Score()));
+        slow->EnterState(ePathIgnore, now);
+        m_LastSlowPathRetired = now;
+        m_SlowPathsRetired++;
+      }
+      else if (NumInStatus(ePathBuilding) == 0 and not BuildCooldownHit(now))
+        BuildOne();
+    }
+
     util::StatusObject
     Builder::ExtractStatus() const
     {
       util::StatusObject obj{
           {"buildStats", m_BuildStats.ExtractStatus()},
+          {"slowPathsRetired", m_SlowPathsRetired},
           {"numHops", uint64_t{numHops}},
           {"numPaths", uint64_t{numDesiredPaths}}};
       std::transform(
@@ -233,15 +271,15 @@ namespace llarp
       return obj;
     }
 
-    std::optional<RouterContact>
+    RouterContact_ptr
     Builder::SelectFirstHop(const std::set<RouterID>& exclude) const
     {
-      std::optional<RouterContact> found = std::nullopt;
+      RouterContact_ptr found;
       m_router->ForEachPeer(
           [&](const ILinkSession* s, bool isOutbound) {
-            if (s && s->IsEstablished() && isOutbound && not found.has_value())
+            if (s && s->IsEstablished() && isOutbound && not found)
             {
-              const RouterContact rc = s->GetRemoteRC();
+              const RouterContact& rc = *s->GetRemoteRC();
 #ifndef TESTNET
               if (m_router->IsBootstrapNode(rc.pubkey))
                 return;
@@ -255,14 +293,14 @@ namespace llarp
               if (m_router->routerProfiling().IsBadForPath(rc.pubkey))
                 return;
 
-              found = rc;
+              found = s->GetRemoteRC();
             }
           },
           true);
       return found;
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Builder::GetHopsForBuild()
     {
       auto filter = [r = m_router](const auto& rc) -> bool {
@@ -341,28 +379,22 @@ namespace llarp
       return buildIntervalLimit > MIN_PATH_BUILD_INTERVAL * 4;
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Builder::GetHopsAlignedToForBuild(RouterID endpoint, const std::set<RouterID>& exclude)
     {
       const auto pathConfig = m_router->GetConfig()->paths;
 
-      std::vector<RouterContact> hops;
-      {
-        const auto maybe = SelectFirstHop(exclude);
-        if (not maybe.has_value())
-        {
-          log::warning(log_path, "{} has no first hop candidate", Name());
-          return std::nullopt;
-        }
-        hops.emplace_back(*maybe);
-      };
-
-      RouterContact endpointRC;
-      if (const auto maybe = m_router->nodedb()->Get(endpoint))
+      std::vector<RouterContact_ptr> hops;
+      if (auto first = SelectFirstHop(exclude))
+        hops.emplace_back(std::move(first));
+      else
       {
-        endpointRC = *maybe;
+        log::warning(log_path, "{} has no first hop candidate", Name());
+        return std::nullopt;
       }
-      else
+
+      const auto endpointRC = m_router->nodedb()->Get(endpoint);
+      if (not endpointRC)
         return std::nullopt;
 
       for (size_t idx = hops.size(); idx < numHops; ++idx)
@@ -374,32 +406,29 @@ namespace llarp
         else
         {
           auto filter =
-              [&hops, r = m_router, endpointRC, pathConfig, exclude](const auto& rc) -> bool {
+              [&hops, r = m_router, &endpointRC, &pathConfig, &exclude](const auto& rc) -> bool {
             if (exclude.count(rc.pubkey))
               return false;
 
-            std::set<RouterContact> hopsSet;
-            hopsSet.insert(endpointRC);
-            hopsSet.insert(hops.begin(), hops.end());
-
             if (r->routerProfiling().IsBadForPath(rc.pubkey, 1))
               return false;
-            for (const auto& hop : hopsSet)
+            for (const auto& hop : hops)
             {
-              if (hop.pubkey == rc.pubkey)
+              if (hop->pubkey == rc.pubkey)
                 return false;
             }
-
-            hopsSet.insert(rc);
 #ifndef TESTNET
-            if (not pathConfig.Acceptable(hopsSet))
+            std::vector<const RouterContact*> picked{endpointRC.get(), &rc};
+            for (const auto& hop : hops)
+              picked.push_back(hop.get());
+            if (not pathConfig.Acceptable(picked))
               return false;
 #endif
-            return rc.pubkey != endpointRC.pubkey;
+            return rc.pubkey != endpointRC->pubkey;
           };
 
-          if (const auto maybe = m_router->nodedb()->GetRandom(filter))
-            hops.emplace_back(*maybe);
+          if (auto maybe = m_router->nodedb()->GetRandom(filter))
+            hops.emplace_back(std::move(maybe));
           else
             return std::nullopt;
         }
@@ -426,12 +455,12 @@ namespace llarp
     }
 
     void
-    Builder::Build(std::vector<RouterContact> hops, PathRole roles)
+    Builder::Build(std::vector<RouterContact_ptr> hops, PathRole roles)
     {
       if (IsStopped())
         return;
       lastBuild = Now();
-      const RouterID edge{hops[0].pubkey};
+      const RouterID edge{hops[0]->pubkey};
       if (not m_router->pathBuildLimiter().Attempt(edge))
       {
         LogWarn(Name(), " building too fast to edge router ", edge);
@@ -489,17 +518,17 @@ namespace llarp
       DoPathBuildBackoff();
       for (const auto& hop : p->hops)
       {
-        const RouterID router{hop.rc.pubkey};
+        const RouterID router{hop.rc->pubkey};
         // look up router and see if it's still on the network
         m_router->loop()->call_soon([router, r = m_router]() {
           LogInfo("looking up ", router, " because of path build timeout");
           r->rcLookupHandler().GetRC(
               router,
-              [r](const auto& router, const auto* rc, auto result) {
+              [r](const auto& router, auto rc, auto result) {
                 if (result == RCRequestResult::Success && rc != nullptr)
                 {
                   LogInfo("refreshed rc for ", router);
-                  r->nodedb()->PutIfNewer(*rc);
+                  r->nodedb()->PutIfNewer(std::move(rc));
                 }
                 else
                 {
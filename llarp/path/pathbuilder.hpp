@@ -9,12 +9,20 @@
 
 namespace llarp
 {
+  struct EncryptedFrame;
+  class EncryptionKeyPool;
+
   namespace path
   {
     // milliseconds waiting between builds on a path per router
     static constexpr auto MIN_PATH_BUILD_INTERVAL = 500ms;
     static constexpr auto PATH_BUILD_RATE = 100ms;
 
+    /// generate the keys of hop idx of a path and encrypt its commit record into frame.
+    /// each hop only touches its own state so the hops of a path can be done concurrently.
+    bool
+    GenerateHopKeys(Path& path, size_t idx, EncryptedFrame& frame, EncryptionKeyPool& keys);
+
     /// limiter for path builds
     /// prevents overload and such
     class BuildLimiter
@@ -40,6 +48,8 @@ namespace llarp
     {
      private:
       llarp_time_t m_LastWarn = 0s;
+      llarp_time_t m_LastSlowPathRetired = 0s;
+      uint64_t m_SlowPathsRetired = 0;
 
      protected:
       /// flag for PathSet::Stop()
@@ -52,6 +62,11 @@ namespace llarp
       bool
       BuildCooldownHit(RouterID edge) const;
 
+      /// build a replacement for our slowest path if it is much slower than the others and retire
+      /// it once the replacement is up
+      void
+      ReplaceSlowPath(llarp_time_t now);
+
      private:
       void
       DoPathBuildBackoff();
@@ -119,17 +134,17 @@ namespace llarp
       bool
       BuildOneAlignedTo(const RouterID endpoint) override;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsAlignedToForBuild(RouterID endpoint, const std::set<RouterID>& exclude = {});
 
       void
-      Build(std::vector<RouterContact> hops, PathRole roles = ePathRoleAny) override;
+      Build(std::vector<RouterContact_ptr> hops, PathRole roles = ePathRoleAny) override;
 
       /// pick a first hop
-      std::optional<RouterContact>
+      RouterContact_ptr
       SelectFirstHop(const std::set<RouterID>& exclude = {}) const;
 
-      virtual std::optional<std::vector<RouterContact>>
+      virtual std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
       void
@@ -1,10 +1,12 @@
 #include "pathset.hpp"
 
+#include <llarp/crypto/crypto.hpp>
 #include <llarp/dht/messages/pubintro.hpp>
 #include "path.hpp"
 #include <llarp/routing/dht_message.hpp>
 #include <llarp/router/abstractrouter.hpp>
 
+#include <algorithm>
 #include <random>
 
 namespace llarp
@@ -183,10 +185,8 @@ namespace llarp
         {
           if (itr->second->Endpoint() == id)
           {
-            if (chosen == nullptr)
-              chosen = itr->second;
-            else if (
-                chosen->intro.latency != 0s and chosen->intro.latency > itr->second->intro.latency)
+            if (chosen == nullptr
+                or chosen->metrics.Score() > itr->second->metrics.Score())
               chosen = itr->second;
           }
         }
@@ -299,6 +299,16 @@ namespace llarp
       }
     }
 
+    void
+    PathSet::RemovePath(const Path_ptr& path)
+    {
+      Lock_t l(m_PathsMutex);
+      m_Paths.erase({path->Upstream(), path->RXID()});
+      if (auto itr = m_PathCache.find(path->Endpoint());
+          itr != m_PathCache.end() and itr->second.lock() == path)
+        m_PathCache.erase(itr);
+    }
+
     Path_ptr
     PathSet::GetByUpstream(RouterID remote, PathID_t rxid) const
     {
@@ -414,12 +424,57 @@ namespace llarp
           established.push_back(itr->second);
         ++itr;
       }
-      auto sz = established.size();
-      if (sz)
+      if (established.empty())
+        return nullptr;
+      std::vector<double> weights;
+      for (const auto score : WeighingScores(established))
+        weights.push_back(1. / std::max<int64_t>(score.count(), 1));
+      CSRNG rng{};
+      return established[std::discrete_distribution<size_t>{weights.begin(), weights.end()}(rng)];
+    }
+
+    std::vector<llarp_time_t>
+    PathSet::WeighingScores(const std::vector<Path_ptr>& paths)
+    {
+      std::vector<llarp_time_t> scores;
+      std::vector<llarp_time_t> known;
+      for (const auto& path : paths)
       {
-        return established[randint() % sz];
+        scores.push_back(path->metrics.Score());
+        if (scores.back() > 0s)
+          known.push_back(scores.back());
       }
+      if (known.empty())
+        return scores;
+      auto mid = known.begin() + known.size() / 2;
+      std::nth_element(known.begin(), mid, known.end());
+      std::replace(scores.begin(), scores.end(), 0s, *mid);
+      return scores;
+    }
 
+    Path_ptr
+    PathSet::GetSlowPath(llarp_time_t now) const
+    {
+      std::vector<Path_ptr> scored;
+      Lock_t l(m_PathsMutex);
+      for (const auto& item : m_Paths)
+      {
+        const auto& path = item.second;
+        // paths expiring soon get replaced anyways
+        if (path->IsReady() and path->metrics.Samples() >= min_score_samples
+            and not path->ExpiresSoon(now, intro_path_spread))
+          scored.push_back(path);
+      }
+      // we need a few paths to say what normal is
+      if (scored.size() < 3)
+        return nullptr;
+      std::sort(scored.begin(), scored.end(), [](const auto& left, const auto& right) {
+        return left->metrics.Score() < right->metrics.Score();
+      });
+      const auto median = scored[scored.size() / 2]->metrics.Score();
+      const auto worst = scored.back()->metrics.Score();
+      if (worst > median * slow_path_ratio and worst - median > slow_path_margin)
+        return scored.back();
       return nullptr;
     }
 
@@ -436,12 +491,13 @@ namespace llarp
         ++itr;
       }
       Path_ptr chosen = nullptr;
-      llarp_time_t minLatency = 30s;
+      llarp_time_t minScore = 30s;
       for (const auto& path : established)
       {
-        if (path->intro.latency < minLatency and path->intro.latency != 0s)
+        const auto score = path->metrics.Score();
+        if (score < minScore and score != 0s)
         {
-          minLatency = path->intro.latency;
+          minScore = score;
           chosen = path;
         }
       }
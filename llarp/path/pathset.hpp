@@ -103,6 +103,12 @@ namespace llarp
     {
       /// maximum number of paths a path set can maintain
       static constexpr size_t max_paths = 32;
+      /// round trips we need to have measured on a path before we judge it against the others
+      static constexpr uint64_t min_score_samples = 4;
+      /// a path is slow when it scores this many times worse than the median of our paths...
+      static constexpr auto slow_path_ratio = 3;
+      /// ...and is at least this much worse, so we leave sets of fast paths alone
+      static constexpr auto slow_path_margin = 250ms;
       /// construct
       /// @params numDesiredPaths the number of paths to maintain
       PathSet(size_t numDesiredPaths);
@@ -120,7 +126,7 @@ namespace llarp
 
       /// manual build on these hops
       virtual void
-      Build(std::vector<RouterContact> hops, PathRole roles = ePathRoleAny) = 0;
+      Build(std::vector<RouterContact_ptr> hops, PathRole roles = ePathRoleAny) = 0;
 
       /// tick owned paths
       virtual void
@@ -152,6 +158,10 @@ namespace llarp
       void
       AddPath(Path_ptr path);
 
+      /// stop tracking a path without tearing it down, used to hand a path to another path set
+      void
+      RemovePath(const Path_ptr& path);
+
       Path_ptr
       GetByUpstream(RouterID remote, PathID_t rxid) const;
 
@@ -245,9 +255,19 @@ namespace llarp
       Path_ptr
       PickEstablishedPath(PathRole roles = ePathRoleAny) const;
 
+      /// pick a random established path, paths with a better score are more likely to be picked
       Path_ptr
       PickRandomEstablishedPath(PathRole roles = ePathRoleAny) const;
 
+      /// the scores of paths to weigh them against each other by, paths we have not measured yet
+      /// get the median of the scores we have so they are neither favoured nor left out
+      static std::vector<llarp_time_t>
+      WeighingScores(const std::vector<Path_ptr>& paths);
+
+      /// get the established path that scores much worse than the rest of our paths, if any
+      Path_ptr
+      GetSlowPath(llarp_time_t now) const;
+
       Path_ptr
       GetPathByRouter(RouterID router, PathRole roles = ePathRoleAny) const;
 
@@ -283,7 +303,7 @@ namespace llarp
       virtual void
       SendPacketToRemote(const llarp_buffer_t& pkt, service::ProtocolType t) = 0;
 
-      virtual std::optional<std::vector<RouterContact>>
+      virtual std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() = 0;
 
       void
@@ -14,6 +14,7 @@
 #include <llarp/routing/path_transfer_message.hpp>
 #include <llarp/routing/handler.hpp>
 #include <llarp/util/buffer.hpp>
+#include <llarp/util/metrics.hpp>
 
 #include <oxenc/endian.h>
 
@@ -105,6 +106,15 @@ namespace llarp
       return HandleDownstream(buf, N, r);
     }
 
+    /// time to add or remove our layer of a relayed message
+    static metrics::Histogram&
+    RelayCryptoTime()
+    {
+      static auto& hist = metrics::registry().GetHistogram(
+          "lokinet_relay_crypto_seconds", "time to apply our layer of a relayed message");
+      return hist;
+    }
+
     void
     TransitHop::DownstreamWork(TrafficQueue_t msgs, AbstractRouter* r)
     {
@@ -122,9 +132,12 @@ namespace llarp
         const llarp_buffer_t buf(ev.first);
         msg.pathid = info.rxID;
         msg.Y = ev.second ^ nonceXOR;
-        CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
+        {
+          metrics::Timer timer{RelayCryptoTime()};
+          CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
+        }
         msg.X = buf;
-        llarp::LogDebug(
+        LogDebugHot(
             "relay ",
             msg.X.size(),
             " bytes downstream from ",
@@ -148,7 +161,10 @@ namespace llarp
       {
         const llarp_buffer_t buf(ev.first);
         RelayUpstreamMessage msg;
-        CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
+        {
+          metrics::Timer timer{RelayCryptoTime()};
+          CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
+        }
         msg.pathid = info.txID;
         msg.Y = ev.second ^ nonceXOR;
         msg.X = buf;
@@ -192,7 +208,7 @@ namespace llarp
       {
         for (const auto& msg : msgs)
         {
-          llarp::LogDebug(
+          LogDebugHot(
               "relay ",
               msg.X.size(),
               " bytes upstream from ",
@@ -210,7 +226,7 @@ namespace llarp
     {
       for (const auto& msg : msgs)
       {
-        llarp::LogDebug(
+        LogDebugHot(
             "relay ",
             msg.X.size(),
             " bytes downstream from ",
@@ -5,6 +5,8 @@
 #include "util/file.hpp"
 #include "util/logging.hpp"
 
+#include <algorithm>
+
 using oxenc::bt_dict_consumer;
 using oxenc::bt_dict_producer;
 
@@ -59,12 +61,17 @@ namespace llarp
     lastDecay = llarp::time_now_ms();
   }
 
+  bool
+  RouterProfile::ShouldDecay(llarp_time_t now) const
+  {
+    static constexpr auto updateInterval = 30s;
+    return lastDecay < now && now - lastDecay > updateInterval;
+  }
+
   void
   RouterProfile::Tick()
   {
-    static constexpr auto updateInterval = 30s;
-    const auto now = llarp::time_now_ms();
-    if (lastDecay < now && now - lastDecay > updateInterval)
+    if (ShouldDecay(llarp::time_now_ms()))
       Decay();
   }
 
@@ -99,6 +106,56 @@ namespace llarp
     return checkIsGood(pathFailCount, pathSuccessCount, chances);
   }
 
+  /// the append log is compacted into the snapshot once it is bigger than the snapshot and this
+  static constexpr size_t MinCompactLogBytes = 64 * 1024;
+
+  static size_t
+  EncodedSizeFor(size_t numProfiles)
+  {
+    return (numProfiles * (RouterProfile::MaxSize + 32 + 8)) + 8;
+  }
+
+  static fs::path
+  LogPathFor(fs::path fpath)
+  {
+    fpath += ".log";
+    return fpath;
+  }
+
+  /// where a compaction writes the new snapshot before it takes the old one's place
+  static fs::path
+  NewSnapshotPathFor(fs::path fpath)
+  {
+    fpath += ".new";
+    return fpath;
+  }
+
+  /// where a compaction moves the log it made obsolete until the new snapshot is in place
+  static fs::path
+  OldLogPathFor(const fs::path& fpath)
+  {
+    auto logpath = LogPathFor(fpath);
+    logpath += ".old";
+    return logpath;
+  }
+
+  /// finish or undo a compaction that was cut short.  a new snapshot without the old log moved
+  /// aside may not have been written in full, so it is dropped.  once the log was moved aside the
+  /// new snapshot was complete and is put in place.
+  static void
+  RecoverCompaction(const fs::path& fpath)
+  {
+    const auto newpath = NewSnapshotPathFor(fpath);
+    const auto oldlog = OldLogPathFor(fpath);
+    if (fs::exists(oldlog))
+    {
+      if (fs::exists(newpath))
+        fs::rename(newpath, fpath);
+      fs::remove(oldlog);
+    }
+    fs::remove(newpath);
+  }
+
   Profiling::Profiling() : m_DisableProfiling(false)
   {}
 
@@ -114,16 +171,99 @@ namespace llarp
     m_DisableProfiling.store(false);
   }
 
+  Profiling::Shard&
+  Profiling::ShardFor(const RouterID& r)
+  {
+    return m_Shards[r[0] % NumShards];
+  }
+
+  std::optional<RouterProfile>
+  Profiling::Find(const RouterID& r) const
+  {
+    const auto profiles = std::atomic_load(&m_Shards[r[0] % NumShards].profiles);
+    const auto itr = profiles->find(r);
+    if (itr == profiles->end())
+      return std::nullopt;
+    return itr->second;
+  }
+
+  void
+  Profiling::Change::Apply(ProfileMap& profiles) const
+  {
+    if (kind == Kind::Clear)
+    {
+      profiles.erase(router);
+      return;
+    }
+    auto& profile = profiles[router];
+    switch (kind)
+    {
+      case Kind::ConnectTimeout:
+        profile.connectTimeoutCount += 1;
+        break;
+      case Kind::ConnectSuccess:
+        profile.connectGoodCount += 1;
+        break;
+      case Kind::HopFail:
+        profile.pathFailCount += 1;
+        break;
+      case Kind::PathTimeout:
+        profile.pathTimeoutCount += 1;
+        break;
+      case Kind::PathSuccess:
+        // redeem previous fails by halfing the fail count and setting timeout to zero
+        profile.pathFailCount /= 2;
+        profile.pathTimeoutCount = 0;
+        // mark success at hop
+        profile.pathSuccessCount += pathLength;
+        break;
+      case Kind::Clear:
+        break;
+    }
+    profile.lastUpdated = at;
+  }
+
+  void
+  Profiling::Queue(Change change)
+  {
+    auto& shard = ShardFor(change.router);
+    util::Lock lock{shard.writeMutex};
+    shard.dirty.insert(change.router);
+    shard.pending.push_back(std::move(change));
+    if (shard.pending.size() >= MaxPending)
+      Publish(shard, false);
+  }
+
+  void
+  Profiling::Publish(Shard& shard, bool decay)
+  {
+    const auto current = std::atomic_load(&shard.profiles);
+    const auto now = llarp::time_now_ms();
+    if (shard.pending.empty()
+        and (not decay or std::none_of(current->begin(), current->end(), [now](const auto& item) {
+              return item.second.ShouldDecay(now);
+            })))
+      return;
+    auto profiles = std::make_shared<ProfileMap>(*current);
+    for (const auto& change : shard.pending)
+      change.Apply(*profiles);
+    shard.pending.clear();
+    // decays are not persisted on their own, a loaded profile decays on our next tick
+    if (decay)
+    {
+      for (auto& [rid, profile] : *profiles)
+        profile.Tick();
+    }
+    std::atomic_store(&shard.profiles, std::shared_ptr<const ProfileMap>{std::move(profiles)});
+  }
+
   bool
   Profiling::IsBadForConnect(const RouterID& r, uint64_t chances)
   {
     if (m_DisableProfiling.load())
       return false;
-    util::Lock lock{m_ProfilesMutex};
-    auto itr = m_Profiles.find(r);
-    if (itr == m_Profiles.end())
-      return false;
-    return not itr->second.IsGoodForConnect(chances);
+    const auto maybe = Find(r);
+    return maybe and not maybe->IsGoodForConnect(chances);
   }
 
   bool
@@ -131,11 +271,8 @@ namespace llarp
   {
     if (m_DisableProfiling.load())
       return false;
-    util::Lock lock{m_ProfilesMutex};
-    auto itr = m_Profiles.find(r);
-    if (itr == m_Profiles.end())
-      return false;
-    return not itr->second.IsGoodForPath(chances);
+    const auto maybe = Find(r);
+    return maybe and not maybe->IsGoodForPath(chances);
   }
 
   bool
@@ -143,59 +280,47 @@ namespace llarp
   {
     if (m_DisableProfiling.load())
       return false;
-    util::Lock lock{m_ProfilesMutex};
-    auto itr = m_Profiles.find(r);
-    if (itr == m_Profiles.end())
-      return false;
-    return not itr->second.IsGood(chances);
+    const auto maybe = Find(r);
+    return maybe and not maybe->IsGood(chances);
   }
 
   void
   Profiling::Tick()
   {
-    util::Lock lock(m_ProfilesMutex);
-    for (auto& [rid, profile] : m_Profiles)
-      profile.Tick();
+    for (auto& shard : m_Shards)
+    {
+      util::Lock lock{shard.writeMutex};
+      Publish(shard, true);
+    }
   }
 
   void
   Profiling::MarkConnectTimeout(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    auto& profile = m_Profiles[r];
-    profile.connectTimeoutCount += 1;
-    profile.lastUpdated = llarp::time_now_ms();
+    Queue({r, Change::Kind::ConnectTimeout, llarp::time_now_ms()});
   }
 
   void
   Profiling::MarkConnectSuccess(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    auto& profile = m_Profiles[r];
-    profile.connectGoodCount += 1;
-    profile.lastUpdated = llarp::time_now_ms();
+    Queue({r, Change::Kind::ConnectSuccess, llarp::time_now_ms()});
   }
 
   void
   Profiling::ClearProfile(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    m_Profiles.erase(r);
+    Queue({r, Change::Kind::Clear, llarp::time_now_ms()});
   }
 
   void
   Profiling::MarkHopFail(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    auto& profile = m_Profiles[r];
-    profile.pathFailCount += 1;
-    profile.lastUpdated = llarp::time_now_ms();
+    Queue({r, Change::Kind::HopFail, llarp::time_now_ms()});
   }
 
   void
   Profiling::MarkPathFail(path::Path* p)
   {
-    util::Lock lock{m_ProfilesMutex};
     bool first = true;
     for (const auto& hop : p->hops)
     {
@@ -203,66 +328,118 @@ namespace llarp
       if (first)
         first = false;
       else
-      {
-        auto& profile = m_Profiles[hop.rc.pubkey];
-        profile.pathFailCount += 1;
-        profile.lastUpdated = llarp::time_now_ms();
-      }
+        MarkHopFail(hop.rc->pubkey);
     }
   }
 
   void
   Profiling::MarkPathTimeout(path::Path* p)
   {
-    util::Lock lock{m_ProfilesMutex};
+    const auto now = llarp::time_now_ms();
     for (const auto& hop : p->hops)
-    {
-      auto& profile = m_Profiles[hop.rc.pubkey];
-      profile.pathTimeoutCount += 1;
-      profile.lastUpdated = llarp::time_now_ms();
-    }
+      Queue({RouterID{hop.rc->pubkey}, Change::Kind::PathTimeout, now});
   }
 
   void
   Profiling::MarkPathSuccess(path::Path* p)
   {
-    util::Lock lock{m_ProfilesMutex};
-    const auto sz = p->hops.size();
+    const auto now = llarp::time_now_ms();
     for (const auto& hop : p->hops)
+      Queue({RouterID{hop.rc->pubkey}, Change::Kind::PathSuccess, now, p->hops.size()});
+  }
+
+  std::map<RouterID, RouterProfile>
+  Profiling::Snapshot() const
+  {
+    std::map<RouterID, RouterProfile> all;
+    for (const auto& shard : m_Shards)
     {
-      auto& profile = m_Profiles[hop.rc.pubkey];
-      // redeem previous fails by halfing the fail count and setting timeout to zero
-      profile.pathFailCount /= 2;
-      profile.pathTimeoutCount = 0;
-      // mark success at hop
-      profile.pathSuccessCount += sz;
-      profile.lastUpdated = llarp::time_now_ms();
+      const auto profiles = std::atomic_load(&shard.profiles);
+      all.insert(profiles->begin(), profiles->end());
     }
+    return all;
   }
 
   bool
   Profiling::Save(const fs::path fpath)
   {
-    std::string buf;
+    util::Lock saveLock{m_SaveMutex};
+
+    // collect what changed since the last save, publishing what is still queued so we save it
+    std::map<RouterID, std::optional<RouterProfile>> changed;
+    for (auto& shard : m_Shards)
     {
-      util::Lock lock{m_ProfilesMutex};
-      buf.resize((m_Profiles.size() * (RouterProfile::MaxSize + 32 + 8)) + 8);
-      bt_dict_producer d{buf.data(), buf.size()};
-      try
+      util::Lock lock{shard.writeMutex};
+      Publish(shard, false);
+      const auto profiles = std::atomic_load(&shard.profiles);
+      for (const auto& r : shard.dirty)
       {
-        BEncode(d);
+        const auto itr = profiles->find(r);
+        if (itr == profiles->end())
+          changed.emplace(r, std::nullopt);
+        else
+          changed.emplace(r, itr->second);
       }
-      catch (const std::exception& e)
+      shard.dirty.clear();
+    }
+
+    bool ok = true;
+    if (m_CompactNext or m_SnapshotBytes == 0
+        or m_LogBytes > std::max(m_SnapshotBytes, MinCompactLogBytes))
+      ok = Compact(fpath);
+    else if (not changed.empty())
+      ok = AppendLog(fpath, changed);
+
+    if (not ok)
+    {
+      // try again next save
+      for (const auto& [r, _] : changed)
       {
-        log::warning(logcat, "Failed to encode profiling data: {}", e.what());
-        return false;
+        auto& shard = ShardFor(r);
+        util::Lock lock{shard.writeMutex};
+        shard.dirty.insert(r);
       }
+      return false;
+    }
+
+    m_LastSave = llarp::time_now_ms();
+    return true;
+  }
+
+  bool
+  Profiling::Compact(const fs::path& fpath)
+  {
+    const auto all = Snapshot();
+    std::string buf;
+    buf.resize(EncodedSizeFor(all.size()));
+    try
+    {
+      bt_dict_producer d{buf.data(), buf.size()};
+      for (const auto& [r_id, profile] : all)
+        profile.BEncode(d.append_dict(r_id.ToView()));
       buf.resize(d.end() - buf.data());
     }
+    catch (const std::exception& e)
+    {
+      log::warning(logcat, "Failed to encode profiling data: {}", e.what());
+      return false;
+    }
 
     try
     {
-      util::dump_file(fpath, buf);
+      // the old snapshot and log stay as they are until the new snapshot is written in full, and
+      // the log is out of the way before the new snapshot replaces the old one so that it is never
+      // replayed over it. RecoverCompaction finishes what a crash cuts short.
+      const auto newpath = NewSnapshotPathFor(fpath);
+      const auto logpath = LogPathFor(fpath);
+      const auto oldlog = OldLogPathFor(fpath);
+      util::dump_file(newpath, buf);
+      if (fs::exists(logpath))
+        fs::rename(logpath, oldlog);
+      else
+        util::dump_file(oldlog, std::string{});
+      fs::rename(newpath, fpath);
+      fs::remove(oldlog);
     }
     catch (const std::exception& e)
     {
@@ -270,44 +447,154 @@ namespace llarp
       return false;
     }
 
-    m_LastSave = llarp::time_now_ms();
+    m_SnapshotBytes = buf.size();
+    m_LogBytes = 0;
+    m_CompactNext = false;
+    return true;
+  }
+
+  bool
+  Profiling::AppendLog(
+      const fs::path& fpath, const std::map<RouterID, std::optional<RouterProfile>>& changed)
+  {
+    std::string buf;
+    buf.resize(EncodedSizeFor(changed.size()));
+    try
+    {
+      bt_dict_producer d{buf.data(), buf.size()};
+      for (const auto& [r_id, maybe] : changed)
+      {
+        // cleared profiles are logged as an empty dict
+        auto sub = d.append_dict(r_id.ToView());
+        if (maybe)
+          maybe->BEncode(sub);
+      }
+      buf.resize(d.end() - buf.data());
+    }
+    catch (const std::exception& e)
+    {
+      log::warning(logcat, "Failed to encode profiling data: {}", e.what());
+      return false;
+    }
+
+    const auto logpath = LogPathFor(fpath);
+    std::error_code ec;
+    const auto oldsize = fs::exists(logpath, ec) ? fs::file_size(logpath, ec) : 0;
+    fs::ofstream out{logpath, std::ios::binary | std::ios::app};
+    out.write(buf.data(), buf.size());
+    out.flush();
+    if (not out)
+    {
+      log::warning(logcat, "Failed to append profiling data to {}", logpath);
+      // a record written in part would stop the replay of every record after it
+      out.close();
+      fs::resize_file(logpath, oldsize, ec);
+      if (ec)
+        m_CompactNext = true;
+      return false;
+    }
+    m_LogBytes += buf.size();
     return true;
   }
 
   void
-  Profiling::BEncode(bt_dict_producer& dict) const
+  Profiling::BDecode(bt_dict_consumer dict, ShardProfiles& profiles)
   {
-    for (const auto& [r_id, profile] : m_Profiles)
-      profile.BEncode(dict.append_dict(r_id.ToView()));
+    while (dict)
+    {
+      auto [rid, subdict] = dict.next_dict_consumer();
+      if (rid.size() != RouterID::SIZE)
+        throw std::invalid_argument{"invalid RouterID"};
+      const RouterID r{reinterpret_cast<const byte_t*>(rid.data())};
+      profiles[r[0] % NumShards].emplace(r, subdict);
+    }
   }
 
   void
-  Profiling::BDecode(bt_dict_consumer dict)
+  Profiling::ReplayLogRecord(bt_dict_consumer dict, ShardProfiles& profiles)
   {
-    m_Profiles.clear();
     while (dict)
     {
       auto [rid, subdict] = dict.next_dict_consumer();
       if (rid.size() != RouterID::SIZE)
         throw std::invalid_argument{"invalid RouterID"};
-      m_Profiles.emplace(reinterpret_cast<const byte_t*>(rid.data()), subdict);
+      const RouterID r{reinterpret_cast<const byte_t*>(rid.data())};
+      auto& shard = profiles[r[0] % NumShards];
+      if (subdict)
+        shard[r] = RouterProfile{subdict};
+      else
+        shard.erase(r);
+    }
+  }
+
+  void
+  Profiling::Replace(ShardProfiles loaded)
+  {
+    for (size_t idx = 0; idx < NumShards; ++idx)
+    {
+      auto& shard = m_Shards[idx];
+      std::shared_ptr<const ProfileMap> profiles =
+          std::make_shared<ProfileMap>(std::move(loaded[idx]));
+      util::Lock lock{shard.writeMutex};
+      shard.pending.clear();
+      shard.dirty.clear();
+      std::atomic_store(&shard.profiles, std::move(profiles));
     }
   }
 
   bool
   Profiling::Load(const fs::path fname)
   {
+    util::Lock saveLock{m_SaveMutex};
+    ShardProfiles loaded;
     try
     {
+      RecoverCompaction(fname);
       std::string data = util::slurp_file(fname);
-      util::Lock lock{m_ProfilesMutex};
-      BDecode(bt_dict_consumer{data});
+      BDecode(bt_dict_consumer{data}, loaded);
+      m_SnapshotBytes = data.size();
     }
     catch (const std::exception& e)
     {
       log::warning(logcat, "failed to load router profiles from {}: {}", fname, e.what());
       return false;
     }
+
+    m_LogBytes = 0;
+    bool torn = false;
+    const auto logpath = LogPathFor(fname);
+    if (fs::exists(logpath))
+    {
+      size_t records = 0;
+      try
+      {
+        // the log is a sequence of dicts, read it as the contents of one list
+        const std::string data = "l" + util::slurp_file(logpath) + "e";
+        m_LogBytes = data.size() - 2;
+        oxenc::bt_list_consumer log{data};
+        while (not log.is_finished())
+        {
+          ReplayLogRecord(log.consume_dict_consumer(), loaded);
+          ++records;
+        }
+      }
+      catch (const std::exception& e)
+      {
+        // a save interrupted half way leaves a truncated last record, keep what we replayed
+        torn = true;
+        log::warning(
+            logcat,
+            "stopped replaying router profile log {} after {} records: {}",
+            logpath,
+            records,
+            e.what());
+      }
+    }
+    Replace(std::move(loaded));
+    // anything appended after the bad record would never be replayed, so start over from what we
+    // have now
+    if (torn and not Compact(fname))
+      m_CompactNext = true;
     m_LastSave = llarp::time_now_ms();
     return true;
   }
@@ -6,7 +6,13 @@
 #include "util/thread/threading.hpp"
 
 #include "util/thread/annotations.hpp"
+#include <array>
 #include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace oxenc
 {
@@ -55,11 +61,22 @@ namespace llarp
     void
     Decay();
 
+    /// returns true if the stats are due to be decayed
+    bool
+    ShouldDecay(llarp_time_t now) const;
+
     // rotate stats if timeout reached
     void
     Tick();
   };
 
+  /// profiles of the routers we have used, sharded by router id.
+  /// the IsBad* checks done for every candidate hop during path selection read a published copy of
+  /// a shard and never wait on a writer. writers only queue their change; each tick the changes
+  /// queued for a shard are applied to one copy of it which is then published, so marks show up in
+  /// the IsBad* checks on the next tick, or sooner once a shard has many queued. profiles are
+  /// persisted as a full snapshot plus an append log of the profiles changed since, which is
+  /// compacted back into the snapshot once it grows larger than it.
   struct Profiling
   {
     Profiling();
@@ -68,46 +85,45 @@ namespace llarp
 
     /// generic variant
     bool
-    IsBad(const RouterID& r, uint64_t chances = profiling_chances) EXCLUDES(m_ProfilesMutex);
+    IsBad(const RouterID& r, uint64_t chances = profiling_chances);
 
     /// check if this router should have paths built over it
     bool
-    IsBadForPath(const RouterID& r, uint64_t chances = profiling_chances) EXCLUDES(m_ProfilesMutex);
+    IsBadForPath(const RouterID& r, uint64_t chances = profiling_chances);
 
     /// check if this router should be connected directly to
     bool
-    IsBadForConnect(const RouterID& r, uint64_t chances = profiling_chances)
-        EXCLUDES(m_ProfilesMutex);
+    IsBadForConnect(const RouterID& r, uint64_t chances = profiling_chances);
 
     void
-    MarkConnectTimeout(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    MarkConnectTimeout(const RouterID& r);
 
     void
-    MarkConnectSuccess(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    MarkConnectSuccess(const RouterID& r);
 
     void
-    MarkPathTimeout(path::Path* p) EXCLUDES(m_ProfilesMutex);
+    MarkPathTimeout(path::Path* p);
 
     void
-    MarkPathFail(path::Path* p) EXCLUDES(m_ProfilesMutex);
+    MarkPathFail(path::Path* p);
 
     void
-    MarkPathSuccess(path::Path* p) EXCLUDES(m_ProfilesMutex);
+    MarkPathSuccess(path::Path* p);
 
     void
-    MarkHopFail(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    MarkHopFail(const RouterID& r);
 
     void
-    ClearProfile(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    ClearProfile(const RouterID& r);
 
     void
-    Tick() EXCLUDES(m_ProfilesMutex);
+    Tick();
 
     bool
-    Load(const fs::path fname) EXCLUDES(m_ProfilesMutex);
+    Load(const fs::path fname);
 
     bool
-    Save(const fs::path fname) EXCLUDES(m_ProfilesMutex);
+    Save(const fs::path fname);
 
     bool
     ShouldSave(llarp_time_t now) const;
@@ -119,16 +135,100 @@ namespace llarp
     Enable();
 
    private:
+    static constexpr size_t NumShards = 16;
+    /// a shard with this many changes queued is published without waiting for the tick
+    static constexpr size_t MaxPending = 1024;
+
+    using ProfileMap = std::unordered_map<RouterID, RouterProfile>;
+
+    /// a change to the profile of one router that is not published yet
+    struct Change
+    {
+      enum class Kind
+      {
+        ConnectTimeout,
+        ConnectSuccess,
+        HopFail,
+        PathTimeout,
+        PathSuccess,
+        Clear,
+      };
+
+      RouterID router;
+      Kind kind;
+      llarp_time_t at;
+      /// number of hops of the path for PathSuccess
+      size_t pathLength = 0;
+
+      void
+      Apply(ProfileMap& profiles) const;
+    };
+
+    struct Shard
+    {
+      /// serializes writers of this shard
+      util::Mutex writeMutex;
+      /// the published profiles, only ever replaced and loaded atomically
+      std::shared_ptr<const ProfileMap> profiles = std::make_shared<const ProfileMap>();
+      /// changes to apply the next time we publish, in the order they were made
+      std::vector<Change> pending GUARDED_BY(writeMutex);
+      /// routers whose profiles changed or were cleared since the last save
+      std::unordered_set<RouterID> dirty GUARDED_BY(writeMutex);
+    };
+
+    using ShardProfiles = std::array<ProfileMap, NumShards>;
+
+    Shard&
+    ShardFor(const RouterID& r);
+
+    /// get the published profile of a router without taking any writer lock
+    std::optional<RouterProfile>
+    Find(const RouterID& r) const;
+
+    /// queue a change for the shard of its router and mark the router as changed
     void
-    BEncode(oxenc::bt_dict_producer& dict) const;
+    Queue(Change change);
 
+    /// apply the changes queued for a shard, and decay its profiles if decay is set, to one copy
+    /// of it and publish that. must hold the shard's writeMutex.
     void
-    BDecode(oxenc::bt_dict_consumer dict);
+    Publish(Shard& shard, bool decay) REQUIRES(shard.writeMutex);
+
+    /// copy of every profile ordered by router id
+    std::map<RouterID, RouterProfile>
+    Snapshot() const;
+
+    /// write every profile to fpath and drop the append log
+    bool
+    Compact(const fs::path& fpath);
+
+    /// append the profiles in changed to the log next to fpath, nullopt marks a cleared profile
+    bool
+    AppendLog(
+        const fs::path& fpath, const std::map<RouterID, std::optional<RouterProfile>>& changed);
 
-    mutable util::Mutex m_ProfilesMutex;  // protects m_Profiles
-    std::map<RouterID, RouterProfile> m_Profiles GUARDED_BY(m_ProfilesMutex);
+    /// read every profile in dict into profiles
+    static void
+    BDecode(oxenc::bt_dict_consumer dict, ShardProfiles& profiles);
+
+    /// apply one append log record to profiles
+    static void
+    ReplayLogRecord(oxenc::bt_dict_consumer dict, ShardProfiles& profiles);
+
+    /// publish profiles in place of every profile and change we have
+    void
+    Replace(ShardProfiles profiles);
+
+    std::array<Shard, NumShards> m_Shards;
     llarp_time_t m_LastSave = 0s;
     std::atomic<bool> m_DisableProfiling;
+
+    /// protects the persistence state below
+    util::Mutex m_SaveMutex;
+    size_t m_SnapshotBytes GUARDED_BY(m_SaveMutex) = 0;
+    size_t m_LogBytes GUARDED_BY(m_SaveMutex) = 0;
+    /// set when the log may hold a bad record, so that the next save writes a snapshot
+    bool m_CompactNext GUARDED_BY(m_SaveMutex) = false;
   };
 
 }  // namespace llarp
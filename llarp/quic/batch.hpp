@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace llarp::quic
+{
+  // Batched frames carry several quic packets in a single lokinet frame, following the usual
+  // 4-byte lokinet packet header (see Endpoint::write_packet_header).  Each quic packet inside the
+  // frame is preceded by a record header made up of:
+  // - size [2 bytes, network order]: the size of the quic packet that follows
+  // - ecn value [1 byte]: the ecn value from ngtcp2 for that packet
+  namespace batch
+  {
+    using bstring_view = std::basic_string_view<std::byte>;
+
+    inline constexpr size_t RECORD_HEADER_SIZE = 3;
+
+    /// Returns the number of bytes a record holding a packet of `size` bytes takes up.
+    inline constexpr size_t
+    record_size(size_t size)
+    {
+      return RECORD_HEADER_SIZE + size;
+    }
+
+    /// Writes a record holding `pkt` to `out`, which must have at least record_size(pkt.size())
+    /// bytes available.  Returns the number of bytes written.
+    inline size_t
+    write_record(std::byte* out, bstring_view pkt, uint8_t ecn)
+    {
+      out[0] = std::byte{static_cast<uint8_t>(pkt.size() >> 8)};
+      out[1] = std::byte{static_cast<uint8_t>(pkt.size() & 0xff)};
+      out[2] = std::byte{ecn};
+      std::memcpy(out + RECORD_HEADER_SIZE, pkt.data(), pkt.size());
+      return record_size(pkt.size());
+    }
+
+    /// Calls `f(ecn, pkt)` for each quic packet in the records of a batched frame (i.e. the frame
+    /// data following the lokinet packet header).  Nothing is delivered and false is returned if
+    /// the records are malformed.
+    template <typename F>
+    bool
+    for_each_packet(bstring_view records, F&& f)
+    {
+      // Validate everything first so that we never deliver part of a mangled frame
+      size_t pos = 0;
+      while (pos < records.size())
+      {
+        if (records.size() - pos < RECORD_HEADER_SIZE)
+          return false;
+        const size_t sz = (std::to_integer<size_t>(records[pos]) << 8)
+            | std::to_integer<size_t>(records[pos + 1]);
+        if (sz == 0 or records.size() - pos - RECORD_HEADER_SIZE < sz)
+          return false;
+        pos += record_size(sz);
+      }
+
+      for (pos = 0; pos < records.size();)
+      {
+        const size_t sz = (std::to_integer<size_t>(records[pos]) << 8)
+            | std::to_integer<size_t>(records[pos + 1]);
+        f(std::to_integer<uint8_t>(records[pos + 2]), records.substr(pos + RECORD_HEADER_SIZE, sz));
+        pos += record_size(sz);
+      }
+      return true;
+    }
+
+    /// Builds a batched frame of at most `Capacity` bytes: the lokinet packet header followed by
+    /// the records of the quic packets added to it.
+    template <size_t Capacity>
+    class frame
+    {
+      std::array<std::byte, Capacity> buf;
+      size_t limit = 0;
+      size_t header_size = 0;
+      size_t size = 0;
+      size_t packets = 0;
+
+     public:
+      /// Starts over with `header`, letting the frame grow to `max_size` bytes (or the capacity
+      /// if that is smaller).  Returns false if the header does not fit.
+      bool
+      start(bstring_view header, size_t max_size)
+      {
+        limit = std::min(max_size, Capacity);
+        packets = 0;
+        if (header.size() > limit)
+        {
+          header_size = size = 0;
+          return false;
+        }
+        std::memcpy(buf.data(), header.data(), header.size());
+        header_size = size = header.size();
+        return true;
+      }
+
+      /// True if a packet of `pkt_size` bytes still fits.
+      bool
+      fits(size_t pkt_size) const
+      {
+        return size + record_size(pkt_size) <= limit;
+      }
+
+      /// Adds a record holding `pkt`, which must fit.
+      void
+      add(bstring_view pkt, uint8_t ecn)
+      {
+        size += write_record(&buf[size], pkt, ecn);
+        ++packets;
+      }
+
+      /// The number of quic packets added since `start`.
+      size_t
+      count() const
+      {
+        return packets;
+      }
+
+      /// The lokinet packet header, which can be modified in place.
+      std::byte*
+      header()
+      {
+        return buf.data();
+      }
+
+      /// The whole frame.
+      bstring_view
+      view() const
+      {
+        return {buf.data(), size};
+      }
+
+      /// Just the records, for `for_each_packet`.
+      bstring_view
+      records() const
+      {
+        return view().substr(header_size);
+      }
+    };
+  }  // namespace batch
+}  // namespace llarp::quic
@@ -0,0 +1,65 @@
+#include "buffer_pool.hpp"
+
+namespace llarp::quic
+{
+  void
+  buffer_deleter::operator()(const std::byte* buf) const
+  {
+    if (pool)
+      pool->release(buf);
+    else
+      delete[] buf;
+  }
+
+  BufferPool::~BufferPool()
+  {
+    for (auto* slab : idle)
+      delete[] slab;
+  }
+
+  std::byte*
+  BufferPool::acquire()
+  {
+    if (idle.empty())
+    {
+      ++allocations;
+      return new std::byte[SLAB_SIZE];
+    }
+    ++reuses;
+    auto* slab = idle.back();
+    idle.pop_back();
+    return slab;
+  }
+
+  void
+  BufferPool::release(const std::byte* slab)
+  {
+    if (idle.size() >= MAX_IDLE)
+    {
+      delete[] slab;
+      return;
+    }
+    if (idle.capacity() == 0)
+      idle.reserve(MAX_IDLE);
+    idle.push_back(const_cast<std::byte*>(slab));
+  }
+
+  stream_buffer
+  BufferPool::own(std::byte* slab)
+  {
+    return stream_buffer{slab, buffer_deleter{shared_from_this()}};
+  }
+
+  util::StatusObject
+  BufferPool::ExtractStatus() const
+  {
+    const double mib = (bytes_read + bytes_written) / double{1024 * 1024};
+    return util::StatusObject{
+        {"slabAllocations", allocations},
+        {"slabReuses", reuses},
+        {"idleSlabs", idle.size()},
+        {"bytesRead", bytes_read},
+        {"bytesWritten", bytes_written},
+        {"allocationsPerMiB", mib > 0 ? allocations / mib : 0.}};
+  }
+}  // namespace llarp::quic
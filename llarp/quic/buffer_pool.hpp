@@ -0,0 +1,82 @@
+#pragma once
+
+#include <llarp/util/status.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace llarp::quic
+{
+  class BufferPool;
+
+  // Deleter for outgoing stream buffers: slabs that came from a pool go back to it, anything else
+  // was allocated with new[] and is deleted.
+  struct buffer_deleter
+  {
+    std::shared_ptr<BufferPool> pool;
+
+    void
+    operator()(const std::byte* buf) const;
+  };
+
+  // An owned buffer of outgoing stream data
+  using stream_buffer = std::unique_ptr<const std::byte[], buffer_deleter>;
+
+  // Pool of fixed size slabs that local TCP reads land in and that hold data on its way to a TCP
+  // socket, so that moving data through a tunnel doesn't cost an allocation per read or write
+  // once the pool has warmed up.  Not thread safe: a pool belongs to a single TunnelManager and is
+  // only used from its event loop.
+  class BufferPool : public std::enable_shared_from_this<BufferPool>
+  {
+   public:
+    static constexpr size_t SLAB_SIZE = 16 * 1024;
+    // Most idle slabs we hold on to; anything past this is freed when released.
+    static constexpr size_t MAX_IDLE = 256;
+
+    BufferPool() = default;
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool&
+    operator=(const BufferPool&) = delete;
+
+    // Takes a SLAB_SIZE slab from the pool, allocating one if none are idle.  Give it back with
+    // `release()` or hand ownership to a stream_buffer with `own()`.
+    std::byte*
+    acquire();
+
+    // Returns a slab taken with `acquire()` to the pool.
+    void
+    release(const std::byte* slab);
+
+    // Wraps a slab taken with `acquire()` so that it returns to the pool when freed.
+    stream_buffer
+    own(std::byte* slab);
+
+    // Accounting of the bytes moved through the pooled buffers
+    void
+    count_read(size_t bytes)
+    {
+      bytes_read += bytes;
+    }
+    void
+    count_written(size_t bytes)
+    {
+      bytes_written += bytes;
+    }
+
+    // Slab allocations, reuses and bytes moved, plus allocations per MiB transferred
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    std::vector<std::byte*> idle;
+    uint64_t allocations = 0;
+    uint64_t reuses = 0;
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+  };
+
+}  // namespace llarp::quic
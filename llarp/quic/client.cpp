@@ -12,8 +12,11 @@
 
 namespace llarp::quic
 {
-  Client::Client(EndpointBase& ep, const SockAddr& remote, uint16_t pseudo_port) : Endpoint{ep}
+  Client::Client(
+      EndpointBase& ep, const SockAddr& remote, uint16_t pseudo_port, TransportProfile profile)
+      : Endpoint{ep}
   {
+    transport_profile = profile;
     default_stream_buffer_size =
         0;  // We steal uvw's provided buffers so don't need an outgoing data buffer
 
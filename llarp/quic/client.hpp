@@ -13,8 +13,12 @@ namespace llarp::quic
     // Constructs a client that establishes an outgoing connection to `remote` to tunnel packets to
     // `remote.getPort()` on the remote's lokinet address.  `pseudo_port` is *our* unique local
     // identifier which we include in outgoing packets (so that the remote server knows where to
-    // send the back to *this* client).
-    Client(EndpointBase& ep, const SockAddr& remote, uint16_t pseudo_port);
+    // send the back to *this* client).  `profile` picks the transport parameters of the connection.
+    Client(
+        EndpointBase& ep,
+        const SockAddr& remote,
+        uint16_t pseudo_port,
+        TransportProfile profile = TransportProfile::standard);
 
     // Returns a reference to the client's connection to the server. Returns a nullptr if there is
     // no connection.
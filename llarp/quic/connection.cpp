@@ -57,7 +57,7 @@ namespace llarp::quic
     int
     client_initial(ngtcp2_conn* conn_, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
 
       // Initialization the connection and send our transport parameters to the server.  This will
       // put the connection into NGTCP2_CS_CLIENT_WAIT_HANDSHAKE state.
@@ -66,7 +66,7 @@ namespace llarp::quic
     int
     recv_client_initial(ngtcp2_conn* conn_, const ngtcp2_cid* dcid, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
 
       // New incoming connection from a client: our server connection starts out here in state
       // NGTCP2_CS_SERVER_INITIAL, but we should immediately get into recv_crypto_data because the
@@ -165,8 +165,8 @@ namespace llarp::quic
         const uint8_t* ad,
         size_t adlen)
     {
-      LogTrace("######################", __func__);
-      LogTrace("Lengths: ", plaintextlen, "+", noncelen, "+", adlen);
+      LogTraceHot("######################", __func__);
+      LogTraceHot("Lengths: ", plaintextlen, "+", noncelen, "+", adlen);
       if (dest != plaintext)
         std::memmove(dest, plaintext, plaintextlen);
       return 0;
@@ -183,8 +183,8 @@ namespace llarp::quic
         const uint8_t* ad,
         size_t adlen)
     {
-      LogTrace("######################", __func__);
-      LogTrace("Lengths: ", ciphertextlen, "+", noncelen, "+", adlen);
+      LogTraceHot("######################", __func__);
+      LogTraceHot("Lengths: ", ciphertextlen, "+", noncelen, "+", adlen);
       if (dest != ciphertext)
         std::memmove(dest, ciphertext, ciphertextlen);
       return 0;
@@ -196,7 +196,7 @@ namespace llarp::quic
         const ngtcp2_crypto_cipher_ctx* hp_ctx,
         const uint8_t* sample)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       memset(dest, 0, NGTCP2_HP_MASKLEN);
       return 0;
     }
@@ -211,7 +211,7 @@ namespace llarp::quic
         void* user_data,
         void* stream_user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       return static_cast<Connection*>(user_data)->stream_receive(
           {stream_id},
           {reinterpret_cast<const std::byte*>(data), datalen},
@@ -227,15 +227,15 @@ namespace llarp::quic
         void* user_data,
         void* stream_user_data)
     {
-      LogTrace("######################", __func__);
-      LogTrace("Ack [", offset, ",", offset + datalen, ")");
+      LogTraceHot("######################", __func__);
+      LogTraceHot("Ack [", offset, ",", offset + datalen, ")");
       return static_cast<Connection*>(user_data)->stream_ack({stream_id}, datalen);
     }
 
     int
     stream_open(ngtcp2_conn* conn, int64_t stream_id, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       return static_cast<Connection*>(user_data)->stream_opened({stream_id});
     }
     int
@@ -247,7 +247,7 @@ namespace llarp::quic
         void* user_data,
         void* stream_user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       static_cast<Connection*>(user_data)->stream_closed({stream_id}, app_error_code);
       return 0;
     }
@@ -256,7 +256,7 @@ namespace llarp::quic
     int
     recv_retry(ngtcp2_conn* conn, const ngtcp2_pkt_hd* hd, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       LogError("FIXME UNIMPLEMENTED ", __func__);
       // FIXME
       return 0;
@@ -264,7 +264,7 @@ namespace llarp::quic
     int
     extend_max_local_streams_bidi(ngtcp2_conn* conn_, uint64_t max_streams, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       auto& conn = *static_cast<Connection*>(user_data);
       if (conn.on_stream_available)
         if (uint64_t left = ngtcp2_conn_get_streams_bidi_left(conn); left > 0)
@@ -276,7 +276,7 @@ namespace llarp::quic
     void
     rand(uint8_t* dest, size_t destlen, const ngtcp2_rand_ctx* rand_ctx)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       randombytes_buf(dest, destlen);
     }
 
@@ -284,7 +284,7 @@ namespace llarp::quic
     get_new_connection_id(
         ngtcp2_conn* conn_, ngtcp2_cid* cid_, uint8_t* token, size_t cidlen, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
 
       auto& conn = *static_cast<Connection*>(user_data);
       auto cid = conn.make_alias_id(cidlen);
@@ -301,7 +301,7 @@ namespace llarp::quic
     int
     remove_connection_id(ngtcp2_conn* conn, const ngtcp2_cid* cid, void* user_data)
     {
-      LogTrace("######################", __func__);
+      LogTraceHot("######################", __func__);
       LogError("FIXME UNIMPLEMENTED ", __func__);
       // FIXME
       return 0;
@@ -348,7 +348,10 @@ namespace llarp::quic
 
     if (!send_data.empty())
     {
-      rv = endpoint.send_packet(path.remote, send_data, send_pkt_info.ecn);
+      if (peer_accepts_batches)
+        rv = endpoint.send_batched(path.remote, send_data, send_pkt_info.ecn);
+      else
+        rv = endpoint.send_packet(path.remote, send_data, send_pkt_info.ecn);
     }
     return rv;
   }
@@ -362,7 +365,7 @@ namespace llarp::quic
 
     retransmit_timer = loop->resource<uvw::TimerHandle>();
     retransmit_timer->on<uvw::TimerEvent>([this](auto&, auto&) {
-      LogTrace("Retransmit timer fired!");
+      LogTraceHot("Retransmit timer fired!");
       if (auto rv = ngtcp2_conn_handle_expiry(*this, get_timestamp()); rv != 0)
       {
         LogWarn("expiry handler invocation returned an error: ", ngtcp2_strerror(rv));
@@ -391,6 +394,8 @@ namespace llarp::quic
     cb.remove_connection_id = remove_connection_id;
     cb.update_key = update_key;
 
+    transport = transport_settings(endpoint.transport_profile);
+
     ngtcp2_settings_default(&settings);
 #ifndef NDEBUG
     settings.log_printf = ngtcp_trace_logger;
@@ -399,19 +404,22 @@ namespace llarp::quic
     settings.initial_ts = get_timestamp();
     // FIXME: IPv6
     settings.max_udp_payload_size = Endpoint::max_pkt_size_v4;
-    settings.cc_algo = NGTCP2_CC_ALGO_CUBIC;
+    settings.cc_algo = transport.cc_algo;
+    // Let ngtcp2 grow the windows below as it measures the bandwidth-delay product
+    settings.max_window = transport.max_connection_window;
+    settings.max_stream_window = transport.max_stream_window;
     // settings.initial_rtt = ???; # NGTCP2's default is 333ms
 
     ngtcp2_transport_params_default(&tparams);
 
     // Connection level flow control window:
-    tparams.initial_max_data = CONNECTION_BUFFER;
+    tparams.initial_max_data = transport.connection_window;
     // Max send buffer for a streams (local is for streams we initiate, remote is for replying on
     // streams they initiate to us):
-    tparams.initial_max_stream_data_bidi_local = STREAM_BUFFER;
-    tparams.initial_max_stream_data_bidi_remote = STREAM_BUFFER;
+    tparams.initial_max_stream_data_bidi_local = transport.stream_window;
+    tparams.initial_max_stream_data_bidi_remote = transport.stream_window;
     // Max *cumulative* streams we support on a connection:
-    tparams.initial_max_streams_bidi = STREAM_LIMIT;
+    tparams.initial_max_streams_bidi = transport.stream_limit;
     tparams.initial_max_streams_uni = 0;
     tparams.max_idle_timeout = std::chrono::nanoseconds(IDLE_TIMEOUT).count();
     tparams.active_connection_id_limit = 8;
@@ -538,9 +546,9 @@ namespace llarp::quic
   void
   Connection::on_io_ready()
   {
-    LogTrace(__func__);
+    LogTraceHot(__func__);
     flush_streams();
-    LogTrace("done ", __func__);
+    LogTraceHot("done ", __func__);
   }
 
   void
@@ -549,6 +557,9 @@ namespace llarp::quic
     // conn, path, pi, dest, destlen, and ts
     std::optional<uint64_t> ts;
 
+    // Collect everything we send below so that it goes out in as few lokinet frames as possible
+    Endpoint::batch_scope batch{endpoint};
+
     send_pkt_info = {};
 
     auto add_stream_data =
@@ -558,7 +569,7 @@ namespace llarp::quic
           if (!ts)
             ts = get_timestamp();
 
-          LogTrace(
+          LogTraceHot(
               "send_buffer size=", send_buffer.size(), ", datalen=", datalen, ", flags=", flags);
           nwrite = ngtcp2_conn_writev_stream(
               conn.get(),
@@ -577,7 +588,7 @@ namespace llarp::quic
 
     auto send_packet = [&](auto nwrite) -> bool {
       send_buffer_size = nwrite;
-      LogTrace("Sending ", send_buffer_size, "B packet");
+      LogTraceHot("Sending ", send_buffer_size, "B packet");
 
       auto sent = send();
       if (sent.blocked())
@@ -593,11 +604,16 @@ namespace llarp::quic
         // FIXME: disconnect?
         return false;
       }
-      LogTrace("packet away!");
+      LogTraceHot("packet away!");
       return true;
     };
 
-    std::list<Stream*> strs;
+    // These are members rather than locals so that their storage gets reused from one flush to the
+    // next rather than allocated every time.
+    auto& strs = flush_streams_buf;
+    auto& bufs = flush_pending_buf;
+    auto& vecs = flush_vecs_buf;
+    strs.clear();
     for (auto& [stream_id, stream_ptr] : streams)
       if (stream_ptr)
         strs.push_back(stream_ptr.get());
@@ -611,9 +627,8 @@ namespace llarp::quic
       for (auto it = strs.begin(); it != strs.end();)
       {
         auto& stream = **it;
-        auto bufs = stream.pending();
-        std::vector<ngtcp2_vec> vecs;
-        vecs.reserve(bufs.size());
+        stream.pending(bufs);
+        vecs.clear();
         std::transform(bufs.begin(), bufs.end(), std::back_inserter(vecs), [](const auto& buf) {
           return ngtcp2_vec{const_cast<uint8_t*>(u8data(buf)), buf.size()};
         });
@@ -627,14 +642,14 @@ namespace llarp::quic
               buf_sizes += '+';
             buf_sizes += std::to_string(b.size());
           }
-          LogDebug("Sending ", buf_sizes.empty() ? "no" : buf_sizes, " data for ", stream.id());
+          LogDebugHot("Sending ", buf_sizes.empty() ? "no" : buf_sizes, " data for ", stream.id());
         }
 #endif
 
         uint32_t extra_flags = 0;
         if (stream.is_closing && !stream.sent_fin)
         {
-          LogDebug("Sending FIN");
+          LogDebugHot("Sending FIN");
           extra_flags |= NGTCP2_WRITE_STREAM_FLAG_FIN;
           stream.sent_fin = true;
         }
@@ -645,18 +660,18 @@ namespace llarp::quic
 
         auto [nwrite, consumed] =
             add_stream_data(stream.id(), vecs.data(), vecs.size(), extra_flags);
-        LogTrace(
+        LogTraceHot(
             "add_stream_data for stream ", stream.id(), " returned [", nwrite, ",", consumed, "]");
 
         if (nwrite > 0)
         {
           if (consumed >= 0)
           {
-            LogTrace("consumed ", consumed, " bytes from stream ", stream.id());
+            LogTraceHot("consumed ", consumed, " bytes from stream ", stream.id());
             stream.wrote(consumed);
           }
 
-          LogTrace("Sending stream data packet");
+          LogTraceHot("Sending stream data packet");
           if (!send_packet(nwrite))
             return;
           ++stream_packets;
@@ -667,14 +682,14 @@ namespace llarp::quic
         switch (nwrite)
         {
           case 0:
-            LogTrace(
+            LogTraceHot(
                 "Done stream writing to ",
                 stream.id(),
                 " (either stream is congested or we have nothing else to send right now)");
             assert(consumed <= 0);
             break;
           case NGTCP2_ERR_WRITE_MORE:
-            LogTrace(
+            LogTraceHot(
                 "consumed ", consumed, " bytes from stream ", stream.id(), " and have space left");
             stream.wrote(consumed);
             if (stream.unsent() > 0)
@@ -685,10 +700,10 @@ namespace llarp::quic
             }
             break;
           case NGTCP2_ERR_STREAM_DATA_BLOCKED:
-            LogDebug("cannot add to stream ", stream.id(), " right now: stream is blocked");
+            LogDebugHot("cannot add to stream ", stream.id(), " right now: stream is blocked");
             break;
           case NGTCP2_ERR_STREAM_SHUT_WR:
-            LogDebug("cannot write to ", stream.id(), ": stream is shut down");
+            LogDebugHot("cannot write to ", stream.id(), ": stream is shut down");
             break;
           default:
             assert(consumed <= 0);
@@ -704,11 +719,11 @@ namespace llarp::quic
     for (;;)
     {
       auto [nwrite, consumed] = add_stream_data(StreamID{}, nullptr, 0);
-      LogTrace("add_stream_data for non-stream returned [", nwrite, ",", consumed, "]");
+      LogTraceHot("add_stream_data for non-stream returned [", nwrite, ",", consumed, "]");
       assert(consumed <= 0);
       if (nwrite == NGTCP2_ERR_WRITE_MORE)
       {
-        LogTrace("Writing non-stream data, and have space left");
+        LogTraceHot("Writing non-stream data, and have space left");
         continue;
       }
       if (nwrite < 0)
@@ -718,14 +733,14 @@ namespace llarp::quic
       }
       if (nwrite == 0)
       {
-        LogTrace("Nothing else to write for non-stream data for now (or we are congested)");
+        LogTraceHot("Nothing else to write for non-stream data for now (or we are congested)");
         ngtcp2_conn_stat cstat;
         ngtcp2_conn_get_conn_stat(*this, &cstat);
-        LogTrace("Current unacked bytes in flight: ", cstat.bytes_in_flight);
+        LogTraceHot("Current unacked bytes in flight: ", cstat.bytes_in_flight);
         break;
       }
 
-      LogTrace("Sending non-stream data packet");
+      LogTraceHot("Sending non-stream data packet");
       if (!send_packet(nwrite))
         return;
     }
@@ -739,7 +754,7 @@ namespace llarp::quic
     auto exp = ngtcp2_conn_get_expiry(*this);
     if (exp == std::numeric_limits<decltype(exp)>::max())
     {
-      LogTrace("no retransmit currently needed");
+      LogTraceHot("no retransmit currently needed");
       retransmit_timer->stop();
       return;
     }
@@ -749,7 +764,7 @@ namespace llarp::quic
         0ms,
         std::chrono::duration_cast<std::chrono::milliseconds>(
             expiry - get_time().time_since_epoch()));
-    LogDebug("Next retransmit in ", expires_in.count(), "ms");
+    LogDebugHot("Next retransmit in ", expires_in.count(), "ms");
     retransmit_timer->stop();
     retransmit_timer->start(expires_in, 0ms);
   }
@@ -789,7 +804,8 @@ namespace llarp::quic
   {
     auto str = get_stream(id);
     if (!str->data_callback)
-      LogDebug("Dropping incoming data on stream ", str->id(), ": stream has no data callback set");
+      LogDebugHot(
+          "Dropping incoming data on stream ", str->id(), ": stream has no data callback set");
     else
     {
       bool good = false;
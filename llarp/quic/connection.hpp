@@ -3,6 +3,7 @@
 #include "address.hpp"
 #include "stream.hpp"
 #include "io_result.hpp"
+#include "transport_profile.hpp"
 
 #include <chrono>
 #include <cstddef>
@@ -132,6 +133,11 @@ namespace llarp::quic
       }
     };
 
+    // Scratch space for flush_streams() that we keep around between calls
+    std::vector<Stream*> flush_streams_buf;
+    std::vector<bstring_view> flush_pending_buf;
+    std::vector<ngtcp2_vec> flush_vecs_buf;
+
     // Packet data storage for a packet we are currently sending
     std::array<std::byte, NGTCP2_MAX_UDP_PAYLOAD_SIZE> send_buffer{};
     size_t send_buffer_size = 0;
@@ -186,6 +192,14 @@ namespace llarp::quic
     /// True when we are closing; conn_buffer will contain the closing stanza.
     bool closing = false;
 
+    /// The transport parameters we set up this connection with, taken from the endpoint's
+    /// transport profile when the connection is created.
+    TransportSettings transport{};
+
+    /// True once the remote has told us that it accepts batched frames, after which we coalesce
+    /// the packets of each flush into as few lokinet frames as we can.
+    bool peer_accepts_batches = false;
+
     /// Buffer where we store non-stream connection data, e.g. for initial transport params during
     /// connection and the closing stanza when disconnecting.
     std::basic_string<std::byte> conn_buffer;
@@ -1,6 +1,7 @@
 #include "endpoint.hpp"
 #include "client.hpp"
 #include "server.hpp"
+#include "batch.hpp"
 #include "uvw/async.h"
 #include <llarp/crypto/crypto.hpp>
 #include <llarp/util/logging/buffer.hpp>
@@ -49,13 +50,14 @@ namespace llarp::quic
   }
 
   void
-  Endpoint::receive_packet(const SockAddr& src, uint8_t ecn, bstring_view data)
+  Endpoint::receive_packet(
+      const SockAddr& src, uint8_t ecn, bstring_view data, bool accepts_batches)
   {
     // ngtcp2 wants a local address but we don't necessarily have something so just set it to
     // IPv4 or IPv6 "unspecified" address (0.0.0.0 or ::)
     SockAddr local = src.isIPv6() ? SockAddr{in6addr_any} : SockAddr{nuint32_t{INADDR_ANY}};
 
-    Packet pkt{Path{local, src}, data, ngtcp2_pkt_info{.ecn = ecn}};
+    Packet pkt{Path{local, src}, data, ngtcp2_pkt_info{.ecn = ecn}, accepts_batches};
 
     LogTrace("[", pkt.path, ",ecn=", pkt.info.ecn, "]: received ", data.size(), " bytes");
 
@@ -130,6 +132,8 @@ namespace llarp::quic
   void
   Endpoint::handle_conn_packet(Connection& conn, const Packet& p)
   {
+    if (p.accepts_batches)
+      conn.peer_accepts_batches = true;
     if (ngtcp2_conn_is_in_closing_period(conn))
     {
       LogDebug("Connection is in closing period, dropping");
@@ -179,7 +183,7 @@ namespace llarp::quic
   {
     assert(service_endpoint.Loop()->inEventLoop());
 
-    size_t header_size = write_packet_header(to.port(), ecn);
+    size_t header_size = write_packet_header(to.port(), ecn | ECN_ACCEPTS_BATCHES);
     size_t outgoing_len = header_size + data.size();
     assert(outgoing_len <= buf_.size());
     std::memcpy(&buf_[header_size], data.data(), data.size());
@@ -197,6 +201,76 @@ namespace llarp::quic
     return {};
   }
 
+  io_result
+  Endpoint::send_batched(const Address& to, bstring_view data, uint8_t ecn)
+  {
+    assert(service_endpoint.Loop()->inEventLoop());
+
+    if (batch_depth == 0)
+      return send_packet(to, data, ecn);
+
+    if (batch_to and (SockAddr{*batch_to} != SockAddr{to} or not batch_.fits(data.size())))
+      flush_batch();
+
+    if (not batch_to)
+    {
+      const auto header_size = write_packet_header(to.port(), ECN_ACCEPTS_BATCHES);
+      if (not batch_.start(bstring_view{buf_.data(), header_size}, max_frame_size(to))
+          or not batch_.fits(data.size()))
+        return send_packet(to, data, ecn);
+      batch_.header()[0] |= BATCHED_FLAG;
+      batch_to = to;
+    }
+
+    batch_.add(data, ecn);
+    return {};
+  }
+
+  void
+  Endpoint::flush_batch()
+  {
+    if (not batch_to)
+      return;
+    const Address to = *batch_to;
+    batch_to.reset();
+
+    if (batch_.count() == 1)
+    {
+      // Nothing to coalesce with, so send it as a plain packet
+      batch::for_each_packet(batch_.records(), [this, &to](uint8_t ecn, bstring_view pkt) {
+        send_packet(to, pkt, ecn);
+      });
+      return;
+    }
+
+    const auto frame = batch_.view();
+    if (service_endpoint.SendToOrQueue(
+            to, llarp_buffer_t{frame.data(), frame.size()}, service::ProtocolType::QUIC))
+    {
+      LogTrace("[", to, "]: sent batch of ", batch_.count(), " packets (", frame.size(), "B)");
+    }
+    else
+    {
+      LogDebug(
+          "Failed to send quic batch to ",
+          to,
+          "; was sending ",
+          batch_.count(),
+          " packets (",
+          frame.size(),
+          "B)");
+    }
+  }
+
+  size_t
+  Endpoint::max_frame_size(const Address& to) const
+  {
+    if (auto maybe = service_endpoint.GetEndpointWithConvoTag(to);
+        maybe and std::holds_alternative<RouterID>(*maybe))
+      return net::IPPacket::MaxSize;
+    return service::MAX_PROTOCOL_PAYLOAD_SIZE;
+  }
+
   void
   Endpoint::send_version_negotiation(const version_info& vi, const Address& source)
   {
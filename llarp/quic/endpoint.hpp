@@ -1,16 +1,19 @@
 #pragma once
 
 #include "address.hpp"
+#include "batch.hpp"
 #include "connection.hpp"
 #include "io_result.hpp"
 #include "null_crypto.hpp"
 #include "packet.hpp"
 #include "stream.hpp"
 #include <llarp/net/ip_packet.hpp>
+#include <llarp/service/protocol.hpp>
 
 #include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <unordered_map>
 #include <vector>
@@ -31,6 +34,13 @@ namespace llarp::quic
 
   inline constexpr std::byte CLIENT_TO_SERVER{1};
   inline constexpr std::byte SERVER_TO_CLIENT{2};
+  // Set in the type byte of a frame carrying several quic packets (see batch.hpp)
+  inline constexpr std::byte BATCHED_FLAG{0x80};
+
+  // Set in the header ecn byte by senders that understand batched frames.  ngtcp2 only ever looks
+  // at the lower 2 ecn bits, so older peers simply ignore it.
+  inline constexpr uint8_t ECN_ACCEPTS_BATCHES{0x80};
+  inline constexpr uint8_t ECN_MASK{0x03};
 
   /// QUIC Tunnel Endpoint; this is the class that implements either end of a quic tunnel for both
   /// servers and clients.
@@ -42,8 +52,10 @@ namespace llarp::quic
     /// \param src - the source address; this may be a tun interface address, or may be a fake IPv6
     /// address based on the convo tag.  The port is not used.
     /// \param ecn - the packet ecn parameter
+    /// \param accepts_batches - true if the sender advertised that it understands batched frames
     void
-    receive_packet(const SockAddr& src, uint8_t ecn, bstring_view data);
+    receive_packet(
+        const SockAddr& src, uint8_t ecn, bstring_view data, bool accepts_batches = false);
 
     /// Returns a shared pointer to the uvw loop.
     std::shared_ptr<uvw::Loop>
@@ -184,6 +196,53 @@ namespace llarp::quic
       return send_packet(to, bstring_view{data.data(), data.size()}, ecn);
     }
 
+    // Packets we are collecting to send out together in a single lokinet frame; see
+    // `send_batched`.  A frame to a hidden service can be as big as the payload of a
+    // ProtocolMessage, which is more than an IP packet, so a full size packet still has company;
+    // see `max_frame_size`.
+    batch::frame<service::MAX_PROTOCOL_PAYLOAD_SIZE> batch_;
+    std::optional<Address> batch_to;
+    // How many batching scopes (see `batch_scope`) are currently open
+    int batch_depth = 0;
+
+    // Queues a packet for `to` in the current batch, sending the batch first if it is for a
+    // different remote or does not have room left.  If no batch scope is open this sends the
+    // packet straight away, just like `send_packet`.  Only use this for remotes that told us they
+    // accept batched frames.
+    io_result
+    send_batched(const Address& to, bstring_view data, uint8_t ecn);
+
+    // Sends whatever packets are waiting in the current batch as a single lokinet frame.
+    void
+    flush_batch();
+
+    // The biggest lokinet frame we can send to `to`: frames to a snode travel as an IP packet,
+    // frames to a hidden service as the payload of a ProtocolMessage.
+    size_t
+    max_frame_size(const Address& to) const;
+
+    // While one of these is alive packets given to `send_batched` are collected and sent together
+    // in as few lokinet frames as possible; the batch is flushed when the outermost one is
+    // destroyed.
+    class batch_scope
+    {
+      Endpoint& ep;
+
+     public:
+      explicit batch_scope(Endpoint& ep) : ep{ep}
+      {
+        ++ep.batch_depth;
+      }
+      ~batch_scope()
+      {
+        if (--ep.batch_depth == 0)
+          ep.flush_batch();
+      }
+      batch_scope(const batch_scope&) = delete;
+      batch_scope&
+      operator=(const batch_scope&) = delete;
+    };
+
     void
     send_version_negotiation(const version_info& vi, const Address& source);
 
@@ -246,6 +305,13 @@ namespace llarp::quic
     // Default stream buffer size for streams opened through this endpoint.
     size_t default_stream_buffer_size = 64 * 1024;
 
+    // Transport profile used for connections created by this endpoint from now on.
+    TransportProfile transport_profile = TransportProfile::standard;
+
+    // Pool that tunnel reads and writes on this endpoint's streams take their buffers from; the
+    // TunnelManager shares one pool between all of its endpoints.
+    std::shared_ptr<BufferPool> buffer_pool = std::make_shared<BufferPool>();
+
     // Packet buffer we use when constructing custom packets to fire over lokinet
     std::array<std::byte, net::IPPacket::MaxSize> buf_;
 
@@ -10,6 +10,8 @@ namespace llarp::quic
     Path path;
     bstring_view data;
     ngtcp2_pkt_info info;
+    // True if the sender told us it accepts batched frames
+    bool accepts_batches = false;
   };
 
 }  // namespace llarp::quic
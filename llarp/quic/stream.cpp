@@ -159,9 +159,15 @@ namespace llarp::quic
 
   void
   Stream::append_buffer(const std::byte* buffer, size_t length)
+  {
+    append_buffer(stream_buffer{buffer, buffer_deleter{}}, length);
+  }
+
+  void
+  Stream::append_buffer(stream_buffer buffer, size_t length)
   {
     assert(this->buffer.empty());
-    user_buffers.emplace_back(buffer, length);
+    user_buffers.emplace_back(std::move(buffer), length);
     size += length;
     conn.io_ready();
   }
@@ -215,8 +221,7 @@ namespace llarp::quic
   }
 
   auto
-  get_buffer_it(
-      std::deque<std::pair<std::unique_ptr<const std::byte[]>, size_t>>& bufs, size_t offset)
+  get_buffer_it(std::deque<std::pair<stream_buffer, size_t>>& bufs, size_t offset)
   {
     auto it = bufs.begin();
     while (offset >= it->second)
@@ -227,13 +232,13 @@ namespace llarp::quic
     return std::make_pair(std::move(it), offset);
   }
 
-  std::vector<bstring_view>
-  Stream::pending()
+  void
+  Stream::pending(std::vector<bstring_view>& bufs)
   {
-    std::vector<bstring_view> bufs;
+    bufs.clear();
     size_t rsize = unsent();
     if (!rsize)
-      return bufs;
+      return;
     if (!buffer.empty())
     {
       size_t rpos = (start + unacked_size) % buffer.size();
@@ -243,7 +248,6 @@ namespace llarp::quic
       }
       else
       {  // wrapping
-        bufs.reserve(2);
         bufs.emplace_back(buffer.data() + rpos, buffer.size() - rpos);
         bufs.emplace_back(buffer.data(), rend % buffer.size());
       }
@@ -252,13 +256,11 @@ namespace llarp::quic
     {
       assert(!user_buffers.empty());  // If empty then unsent() should have been 0
       auto [it, offset] = get_buffer_it(user_buffers, start + unacked_size);
-      bufs.reserve(std::distance(it, user_buffers.end()));
       assert(it != user_buffers.end());
       bufs.emplace_back(it->first.get() + offset, it->second - offset);
       for (++it; it != user_buffers.end(); ++it)
         bufs.emplace_back(it->first.get(), it->second);
     }
-    return bufs;
   }
 
   void
@@ -13,6 +13,7 @@
 #include <uvw/async.h>
 
 #include <llarp/util/formattable.hpp>
+#include "buffer_pool.hpp"
 
 namespace llarp::quic
 {
@@ -188,6 +189,10 @@ namespace llarp::quic
     void
     append_buffer(const std::byte* buf, size_t length);
 
+    // Same as above, but for a buffer with its own deleter (such as a slab from a BufferPool).
+    void
+    append_buffer(stream_buffer buf, size_t length);
+
     // Starting closing the stream and prevent any more outgoing data from being appended.  If
     // `error_code` is provided then we close immediately with the given code; if std::nullopt (the
     // default) we close gracefully by sending a FIN bit.
@@ -308,11 +313,12 @@ namespace llarp::quic
     void
     acknowledge(size_t bytes);
 
-    // Returns a view into unwritten stream data.  This returns a vector of string_views of the data
-    // to write, in order.  After writing any of the provided data you must call `wrote()` to signal
-    // how much of the given data was consumed (to advance the next pending() call).
-    std::vector<bstring_view>
-    pending();
+    // Returns a view into unwritten stream data.  This fills `bufs` (replacing anything already in
+    // it) with string_views of the data to write, in order; the caller can keep reusing the same
+    // vector to avoid allocating.  After writing any of the provided data you must call `wrote()`
+    // to signal how much of the given data was consumed (to advance the next pending() call).
+    void
+    pending(std::vector<bstring_view>& bufs);
 
     // Called to signal that bytes have been written and should now be considered sent (but still
     // unacknowledged), thereby advancing the initial data position returned by the next `pending()`
@@ -337,7 +343,7 @@ namespace llarp::quic
 
     // user-provided buffers; only used when `buffer` is empty (via a `set_buffer_size(0)` or a 0
     // size given in the constructor).
-    std::deque<std::pair<std::unique_ptr<const std::byte[]>, size_t>> user_buffers;
+    std::deque<std::pair<stream_buffer, size_t>> user_buffers;
 
     // Offset of the first used byte in the circular buffer, will always be in [0, buffer.size()).
     // For user-provided buffers this is the starting offset in the currently sending user-provided
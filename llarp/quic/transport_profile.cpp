@@ -0,0 +1,79 @@
+#include "transport_profile.hpp"
+#include "connection.hpp"
+#include "tunnel.hpp"
+
+namespace llarp::quic
+{
+  namespace
+  {
+    constexpr TransportSettings standard_settings{
+        NGTCP2_CC_ALGO_CUBIC,
+        CONNECTION_BUFFER,
+        STREAM_BUFFER,
+        CONNECTION_BUFFER,
+        STREAM_BUFFER,
+        STREAM_LIMIT,
+        tunnel::PAUSE_SIZE};
+
+    // Sized so that a single stream can fill ~8MiB/s over a path with a 1s round trip.
+    constexpr TransportSettings bulk_settings{
+        NGTCP2_CC_ALGO_BBR,
+        4 * 1024 * 1024,
+        1024 * 1024,
+        32 * 1024 * 1024,
+        8 * 1024 * 1024,
+        STREAM_LIMIT,
+        8 * 1024 * 1024};
+
+    constexpr TransportSettings interactive_settings{
+        NGTCP2_CC_ALGO_BBR,
+        CONNECTION_BUFFER,
+        256 * 1024,
+        4 * 1024 * 1024,
+        512 * 1024,
+        256,
+        tunnel::PAUSE_SIZE};
+  }  // namespace
+
+  const TransportSettings&
+  transport_settings(TransportProfile profile)
+  {
+    switch (profile)
+    {
+      case TransportProfile::bulk:
+        return bulk_settings;
+      case TransportProfile::interactive:
+        return interactive_settings;
+      case TransportProfile::standard:
+      default:
+        return standard_settings;
+    }
+  }
+
+  std::optional<TransportProfile>
+  parse_transport_profile(std::string_view name)
+  {
+    if (name.empty() or name == "default")
+      return TransportProfile::standard;
+    if (name == "bulk")
+      return TransportProfile::bulk;
+    if (name == "interactive")
+      return TransportProfile::interactive;
+    return std::nullopt;
+  }
+
+  std::string_view
+  to_string(TransportProfile profile)
+  {
+    switch (profile)
+    {
+      case TransportProfile::bulk:
+        return "bulk";
+      case TransportProfile::interactive:
+        return "interactive";
+      case TransportProfile::standard:
+      default:
+        return "default";
+    }
+  }
+}  // namespace llarp::quic
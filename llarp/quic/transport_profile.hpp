@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+extern "C"
+{
+#include <ngtcp2/ngtcp2.h>
+}
+
+namespace llarp::quic
+{
+  // Named sets of transport parameters that can be picked per tunnel, ordered from least to most
+  // demanding.
+  enum class TransportProfile
+  {
+    // What we have always used: CUBIC, fixed 1MiB connection and 64kiB stream windows.  Named
+    // "default" in rpc.
+    standard,
+    // For many short lived, latency sensitive streams: BBR, moderate windows, many streams.
+    interactive,
+    // For long transfers over high bandwidth-delay paths: BBR, large auto-tuned windows.
+    bulk,
+  };
+
+  // The concrete transport parameters of a profile.
+  struct TransportSettings
+  {
+    ngtcp2_cc_algo cc_algo;
+    // Initial connection and stream flow control windows we advertise
+    uint64_t connection_window;
+    uint64_t stream_window;
+    // Windows that ngtcp2 may auto-tune the above up to as it sees the bandwidth-delay product
+    // grow; equal to the initial windows to disable auto-tuning.
+    uint64_t max_connection_window;
+    uint64_t max_stream_window;
+    // Max number of simultaneous streams we support over one connection
+    uint64_t stream_limit;
+    // We pause reading from a local TCP socket once this much data is unacked in its stream
+    size_t pause_size;
+  };
+
+  // Returns the transport parameters for a profile.
+  const TransportSettings&
+  transport_settings(TransportProfile profile);
+
+  // Parses a profile name ("default", "bulk" or "interactive"); the empty string is the default
+  // profile.  Returns nullopt if the name is not a known profile.
+  std::optional<TransportProfile>
+  parse_transport_profile(std::string_view name);
+
+  std::string_view
+  to_string(TransportProfile profile);
+
+}  // namespace llarp::quic
@@ -3,6 +3,10 @@
 #include <llarp/service/endpoint.hpp>
 #include <llarp/service/name.hpp>
 #include "stream.hpp"
+#include "batch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <queue>
 #include <limits>
 #include <llarp/util/logging.hpp>
 #include <llarp/util/logging/buffer.hpp>
@@ -16,30 +20,37 @@ namespace llarp::quic
 {
   namespace
   {
+    void
+    start_reading(uvw::TCPHandle& tcp);
+
+    // The ip:port of the other end of a tcp connection, for logging
+    [[maybe_unused]] std::string
+    peer_name(uvw::TCPHandle& tcp)
+    {
+      const auto peer = tcp.peer();
+      return fmt::format("{}:{}", peer.ip, peer.port);
+    }
+
     // Takes data from the tcp connection and pushes it down the quic tunnel
     void
-    on_outgoing_data(uvw::DataEvent& event, uvw::TCPHandle& client)
+    on_outgoing_data(Stream& stream, uvw::TCPHandle& client, stream_buffer data, size_t length)
     {
-      auto stream = client.data<Stream>();
-      assert(stream);
-      std::string_view data{event.data.get(), event.length};
-      auto peer = client.peer();
-      LogTrace(peer.ip, ":", peer.port, " → lokinet ", buffer_printer{data});
-      // Steal the buffer from the DataEvent's unique_ptr<char[]>:
-      stream->append_buffer(reinterpret_cast<const std::byte*>(event.data.release()), event.length);
-      if (stream->used() >= tunnel::PAUSE_SIZE)
+      LogTraceHot(
+          peer_name(client), " → lokinet ", buffer_printer{bstring_view{data.get(), length}});
+      stream.append_buffer(std::move(data), length);
+      if (stream.used() >= stream.get_connection().transport.pause_size)
       {
         LogDebug(
             "quic tunnel is congested (have ",
-            stream->used(),
+            stream.used(),
             " bytes in flight); pausing local tcp connection reads");
         client.stop();
-        stream->when_available([](Stream& s) {
+        stream.when_available([](Stream& s) {
           auto client = s.data<uvw::TCPHandle>();
-          if (s.used() < tunnel::PAUSE_SIZE)
+          if (s.used() < s.get_connection().transport.pause_size)
           {
             LogDebug("quic tunnel is no longer congested; resuming tcp connection reading");
-            client->read();
+            start_reading(*client);
             return true;
           }
           return false;
@@ -47,13 +58,107 @@ namespace llarp::quic
       }
       else
       {
-        LogDebug("Queued ", event.length, " bytes");
+        LogDebug("Queued ", length, " bytes");
+      }
+    }
+
+    // Returns the buffer pool of the stream forwarding to the given libuv tcp handle (the uvw
+    // handle stores itself in the raw handle's data pointer), or nullptr if it has no stream.
+    std::shared_ptr<BufferPool>
+    pool_of(uv_handle_t* handle, std::shared_ptr<Stream>* stream_out = nullptr)
+    {
+      auto stream = static_cast<uvw::TCPHandle*>(handle->data)->data<Stream>();
+      if (not stream)
+        return nullptr;
+      auto pool = stream->get_connection().endpoint.buffer_pool;
+      if (stream_out)
+        *stream_out = std::move(stream);
+      return pool;
+    }
+
+    // libuv read buffer allocation: reads land in slabs from the tunnel's buffer pool rather than
+    // in a new allocation of libuv's suggested size for every read.
+    void
+    alloc_pooled(uv_handle_t* handle, size_t, uv_buf_t* buf)
+    {
+      if (auto pool = pool_of(handle))
+        *buf = uv_buf_init(reinterpret_cast<char*>(pool->acquire()), BufferPool::SLAB_SIZE);
+      else
+        *buf = uv_buf_init(nullptr, 0);  // Fails the read with UV_ENOBUFS, see on_pooled_read
+    }
+
+    void
+    on_pooled_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf)
+    {
+      auto& tcp = *static_cast<uvw::TCPHandle*>(handle->data);
+      std::shared_ptr<Stream> stream;
+      auto pool = pool_of(reinterpret_cast<uv_handle_t*>(handle), &stream);
+      // The stream can't go away between the alloc and read callbacks, so if we have a buffer we
+      // have the pool it came from.
+      assert(pool or not buf->base);
+      auto* slab = reinterpret_cast<std::byte*>(buf->base);
+
+      if (not stream)
+      {
+        // The stream is gone so alloc_pooled had no buffer for us; libuv would keep calling us
+        // with UV_ENOBUFS for as long as the socket is readable, so stop reading and drop the
+        // connection.  (We can't stop from alloc_pooled: libuv calls the read callback it had.)
+        uv_read_stop(handle);
+        if (not tcp.closing())
+          tcp.close();
+        return;
+      }
+
+      if (nread > 0)
+      {
+        pool->count_read(nread);
+        on_outgoing_data(*stream, tcp, pool->own(slab), nread);
+        return;
+      }
+      if (slab)
+        pool->release(slab);
+
+      if (nread == 0)
+        return;  // Nothing to read right now
+      if (nread == UV_EOF)
+      {
+        // Most likely because the other side of the TCP connection closed it.
+        LogInfo("EOF on connection to ", tcp.peer().ip, ":", tcp.peer().port);
+        tcp.close();
+        return;
       }
+      LogError(
+          "Read error [",
+          uv_err_name(nread),
+          ": ",
+          uv_strerror(nread),
+          "] on connection with ",
+          tcp.peer().ip,
+          ":",
+          tcp.peer().port,
+          ", shutting down quic stream");
+      stream->close(tunnel::ERROR_TCP);
+      stream->data(nullptr);
+      tcp.data(nullptr);
     }
 
-    // Received data from the quic tunnel and sends it to the TCP connection
+    // Starts (or resumes) reading from a local tcp connection that has had its stream forwarding
+    // installed.  We go to libuv directly rather than through uvw's read() so that we get to
+    // supply the read buffers.
     void
-    on_incoming_data(Stream& stream, bstring_view bdata)
+    start_reading(uvw::TCPHandle& tcp)
+    {
+      if (int rv = uv_read_start(
+              reinterpret_cast<uv_stream_t*>(tcp.raw()), alloc_pooled, on_pooled_read);
+          rv != 0)
+        LogWarn("Failed to start reading from local tcp connection: ", uv_strerror(rv));
+    }
+
+    // Received data from the quic tunnel and sends it to the TCP connection.  Whatever the socket
+    // doesn't take right away is copied into pooled slabs that are queued in `writing` until libuv
+    // is done writing them.
+    void
+    on_incoming_data(Stream& stream, bstring_view bdata, std::queue<stream_buffer>& writing)
     {
       auto tcp = stream.data<uvw::TCPHandle>();
       if (!tcp)
@@ -61,22 +166,30 @@ namespace llarp::quic
                  // drop it.
 
       std::string_view data{reinterpret_cast<const char*>(bdata.data()), bdata.size()};
-      auto peer = tcp->peer();
-      LogTrace(peer.ip, ":", peer.port, " ← lokinet ", buffer_printer{data});
+      LogTraceHot(peer_name(*tcp), " ← lokinet ", buffer_printer{data});
 
       if (data.empty())
         return;
 
-      // Try first to write immediately from the existing buffer to avoid needing an
-      // allocation and copy:
+      auto& pool = *stream.get_connection().endpoint.buffer_pool;
+      pool.count_written(data.size());
+
+      // Try first to write immediately from the existing buffer to avoid needing a copy:
       auto written = tcp->tryWrite(const_cast<char*>(data.data()), data.size());
-      if (written < (int)data.size())
-      {
-        data.remove_prefix(written);
+      if (written >= (int)data.size())
+        return;
+      data.remove_prefix(std::max(written, 0));
 
-        auto wdata = std::make_unique<char[]>(data.size());
-        std::copy(data.begin(), data.end(), wdata.get());
-        tcp->write(std::move(wdata), data.size());
+      while (not data.empty())
+      {
+        const auto len = std::min(data.size(), BufferPool::SLAB_SIZE);
+        auto* slab = pool.acquire();
+        std::memcpy(slab, data.data(), len);
+        data.remove_prefix(len);
+        // uvw doesn't take ownership with a plain pointer; we release the slab on the matching
+        // WriteEvent (writes on a handle complete in order).
+        tcp->write(reinterpret_cast<char*>(slab), len);
+        writing.push(pool.own(slab));
       }
     }
 
@@ -109,11 +222,6 @@ namespace llarp::quic
         }
         c.data(nullptr);
       });
-      tcp.on<uvw::EndEvent>([](auto&, uvw::TCPHandle& c) {
-        // This fires on eof, most likely because the other side of the TCP connection closed it.
-        LogInfo("EOF on connection to ", c.peer().ip, ":", c.peer().port);
-        c.close();
-      });
       tcp.on<uvw::ErrorEvent>([](const uvw::ErrorEvent& e, uvw::TCPHandle& tcp) {
         LogError(
             "ErrorEvent[",
@@ -133,8 +241,15 @@ namespace llarp::quic
         }
         // tcp.closeReset();
       });
-      tcp.on<uvw::DataEvent>(on_outgoing_data);
-      stream.data_callback = on_incoming_data;
+      // Reads (and thus eof) are handled by on_pooled_read once start_reading() is called
+      auto writing = std::make_shared<std::queue<stream_buffer>>();
+      tcp.on<uvw::WriteEvent>([writing](auto&, auto&) {
+        if (not writing->empty())
+          writing->pop();
+      });
+      stream.data_callback = [writing](Stream& s, bstring_view data) {
+        on_incoming_data(s, data, *writing);
+      };
       stream.close_callback = close_tcp_pair;
     }
     // This initial data handler is responsible for pulling off the initial stream data that comes
@@ -156,8 +271,8 @@ namespace llarp::quic
       if (auto b0 = bdata[0]; b0 == tunnel::CONNECT_INIT)
       {
         // Set up callbacks, which replaces both of these initial callbacks
-        client.read();  // Unfreeze (we stop() before putting into pending)
         install_stream_forwarding(client, stream);
+        start_reading(client);  // Unfreeze (we stop() before putting into pending)
 
         if (bdata.size() > 1)
         {
@@ -248,6 +363,7 @@ namespace llarp::quic
     // auto loop = get_loop();
 
     server_ = std::make_unique<Server>(service_endpoint_);
+    server_->buffer_pool = buffer_pool_;
     server_->stream_open_callback = [this](Stream& stream, uint16_t port) -> bool {
       stream.close_callback = close_tcp_pair;
 
@@ -297,7 +413,7 @@ namespace llarp::quic
 
             // Send the magic byte, and start reading from the tcp tunnel in the logic thread
             stream->append_buffer(new std::byte[1]{tunnel::CONNECT_INIT}, 1);
-            tcp.read();
+            start_reading(tcp);
           });
 
       tcp->connect(*tunnel_to->operator const sockaddr*());
@@ -307,7 +423,7 @@ namespace llarp::quic
   }
 
   int
-  TunnelManager::listen(ListenHandler handler)
+  TunnelManager::listen(ListenHandler handler, TransportProfile profile)
   {
     if (!handler)
       throw std::logic_error{"Cannot call listen() with a null handler"};
@@ -317,24 +433,47 @@ namespace llarp::quic
 
     int id = next_handler_id_++;
     incoming_handlers_.emplace_hint(incoming_handlers_.end(), id, std::move(handler));
+    incoming_profiles_.emplace_hint(incoming_profiles_.end(), id, profile);
+    update_server_profile();
     return id;
   }
 
   int
-  TunnelManager::listen(SockAddr addr)
+  TunnelManager::listen(SockAddr addr, TransportProfile profile)
   {
-    return listen([addr](std::string_view, uint16_t p) -> std::optional<SockAddr> {
-      LogInfo("try accepting ", addr.getPort());
-      if (p == addr.getPort())
-        return addr;
-      return std::nullopt;
-    });
+    return listen(
+        [addr](std::string_view, uint16_t p) -> std::optional<SockAddr> {
+          LogInfo("try accepting ", addr.getPort());
+          if (p == addr.getPort())
+            return addr;
+          return std::nullopt;
+        },
+        profile);
   }
 
   void
   TunnelManager::forget(int id)
   {
     incoming_handlers_.erase(id);
+    incoming_profiles_.erase(id);
+    update_server_profile();
+  }
+
+  util::StatusObject
+  TunnelManager::ExtractStatus() const
+  {
+    return util::StatusObject{{"bufferPool", buffer_pool_->ExtractStatus()}};
+  }
+
+  void
+  TunnelManager::update_server_profile()
+  {
+    if (not server_)
+      return;
+    auto profile = TransportProfile::standard;
+    for (const auto& [id, p] : incoming_profiles_)
+      profile = std::max(profile, p);
+    server_->transport_profile = profile;
   }
 
   std::optional<SockAddr>
@@ -429,7 +568,11 @@ namespace llarp::quic
 
   std::pair<SockAddr, uint16_t>
   TunnelManager::open(
-      std::string_view remote_address, uint16_t port, OpenCallback on_open, SockAddr bind_addr)
+      std::string_view remote_address,
+      uint16_t port,
+      OpenCallback on_open,
+      SockAddr bind_addr,
+      TransportProfile profile)
   {
     std::string remote_addr = lowercase_ascii_string(std::string{remote_address});
 
@@ -501,6 +644,7 @@ namespace llarp::quic
     assert(client_tunnels_.count(pport) == 0);
     auto& ct = client_tunnels_[pport];
     ct.open_cb = std::move(on_open);
+    ct.profile = profile;
     ct.tcp = std::move(tcp_tunnel);
     // We use this pport shared_ptr value on the listening tcp socket both to hand to pport into the
     // accept handler, and to let the accept handler know that `this` is still safe to use.
@@ -587,7 +731,8 @@ namespace llarp::quic
     assert(remote.getPort() > 0);
     auto& [pport, tunnel] = row;
     assert(not tunnel.client);
-    tunnel.client = std::make_unique<Client>(service_endpoint_, remote, pport);
+    tunnel.client = std::make_unique<Client>(service_endpoint_, remote, pport, tunnel.profile);
+    tunnel.client->buffer_pool = buffer_pool_;
     auto conn = tunnel.client->get_connection();
 
     conn->on_stream_available = [this, id = row.first](Connection&) {
@@ -648,13 +793,37 @@ namespace llarp::quic
     std::memcpy(&pseudo_port_n.n, &buf.base[1], 2);
     uint16_t pseudo_port = ToHost(pseudo_port_n).h;
     auto ecn = static_cast<uint8_t>(buf.base[3]);
+    const bool accepts_batches = ecn & ECN_ACCEPTS_BATCHES;
     bstring_view data{reinterpret_cast<const std::byte*>(&buf.base[4]), buf.sz - 4};
 
+    if ((type & BATCHED_FLAG) == std::byte{0})
+    {
+      deliver_packet(tag, type, pseudo_port, ecn & ECN_MASK, data, accepts_batches);
+      return;
+    }
+
+    type &= ~BATCHED_FLAG;
+    const bool valid = batch::for_each_packet(data, [&](uint8_t pkt_ecn, bstring_view pkt) {
+      deliver_packet(tag, type, pseudo_port, pkt_ecn & ECN_MASK, pkt, accepts_batches);
+    });
+    if (not valid)
+      LogWarn("invalid batched quic frame of size ", buf.sz, "; dropping");
+  }
+
+  void
+  TunnelManager::deliver_packet(
+      const service::ConvoTag& tag,
+      std::byte type,
+      uint16_t pseudo_port,
+      uint8_t ecn,
+      bstring_view data,
+      bool accepts_batches)
+  {
     SockAddr remote{tag.ToV6()};
     quic::Endpoint* ep = nullptr;
     if (type == CLIENT_TO_SERVER)
     {
-      LogTrace("packet is client-to-server from client pport ", pseudo_port);
+      LogTraceHot("packet is client-to-server from client pport ", pseudo_port);
       // Client-to-server: the header port is the return port
       remote.setPort(pseudo_port);
       if (!server_)
@@ -666,7 +835,7 @@ namespace llarp::quic
     }
     else if (type == SERVER_TO_CLIENT)
     {
-      LogTrace("packet is server-to-client to client pport ", pseudo_port);
+      LogTraceHot("packet is server-to-client to client pport ", pseudo_port);
       // Server-to-client: the header port tells us which client tunnel this is going to
       if (auto it = client_tunnels_.find(pseudo_port); it != client_tunnels_.end())
         ep = it->second.client.get();
@@ -682,7 +851,7 @@ namespace llarp::quic
       if (auto conn = static_cast<quic::Client&>(*ep).get_connection())
       {
         remote.setPort(conn->path.remote.port());
-        LogTrace("remote port is ", remote.getPort());
+        LogTraceHot("remote port is ", remote.getPort());
       }
       else
       {
@@ -695,6 +864,6 @@ namespace llarp::quic
       LogWarn("Invalid incoming quic packet type ", type, "; dropping packet");
       return;
     }
-    ep->receive_packet(remote, ecn, data);
+    ep->receive_packet(remote, ecn, data, accepts_batches);
   }
 }  // namespace llarp::quic
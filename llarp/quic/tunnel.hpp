@@ -32,7 +32,8 @@ namespace llarp::quic
     inline constexpr uint64_t ERROR_TCP{0x5471909};
 
     // We pause reading from the local TCP socket if we have more than this amount of outstanding
-    // unacked data in the quic tunnel, then resume once it drops below this.
+    // unacked data in the quic tunnel, then resume once it drops below this.  This is the default
+    // profile's value; connections use their own TransportSettings::pause_size.
     inline constexpr size_t PAUSE_SIZE = 64 * 1024;
   }  // namespace tunnel
 
@@ -65,13 +66,17 @@ namespace llarp::quic
     /// dropped.
     ///
     /// For plain-C wrappers around this see [FIXME].
+    ///
+    /// `profile` picks the transport parameters for incoming connections.  All listeners share one
+    /// quic server which has to pick its parameters before it knows which listener a connection is
+    /// for, so it uses the most demanding profile of any current listener.
     int
-    listen(ListenHandler handler);
+    listen(ListenHandler handler, TransportProfile profile = TransportProfile::standard);
 
     /// Simple wrapper around `listen(...)` that adds a handler that accepts all incoming
     /// connections trying to tunnel to port `port` and maps them to `localhost:port`.
     int
-    listen(SockAddr port);
+    listen(SockAddr port, TransportProfile profile = TransportProfile::standard);
 
     /// Removes an incoming connection handler; takes the ID returned by `listen()`.
     void
@@ -91,6 +96,8 @@ namespace llarp::quic
     /// out.
     /// \param bind_addr is the bind address and port that we should use for the localhost TCP
     /// connection.  Use port 0 to let the OS choose a random high port.  Defaults to `127.0.0.1:0`.
+    /// \param profile picks the transport parameters (congestion control, flow control windows and
+    /// stream limits) of the quic connection.
     ///
     /// This call immediately opens the local TCP socket, and initiates the lokinet connection and
     /// QUIC tunnel to the remote.  If the connection fails, the TCP socket will be closed.  Note,
@@ -115,7 +122,8 @@ namespace llarp::quic
         std::string_view remote_addr,
         uint16_t port,
         OpenCallback on_open = {},
-        SockAddr bind_addr = {127, 0, 0, 1});
+        SockAddr bind_addr = {127, 0, 0, 1},
+        TransportProfile profile = TransportProfile::standard);
 
     /// Start closing an outgoing tunnel; takes the ID returned by `open()`.  Note that an existing
     /// established tunneled connections will not be forcibly closed; this simply stops accepting
@@ -126,7 +134,8 @@ namespace llarp::quic
     /// Called from tun code to deliver a quic packet.
     ///
     /// \param dest - the convotag for which the packet arrived
-    /// \param buf - the raw arriving packet
+    /// \param buf - the raw arriving packet, which may be a batched frame holding several quic
+    /// packets
     ///
     void
     receive_packet(const service::ConvoTag& tag, const llarp_buffer_t& buf);
@@ -138,15 +147,25 @@ namespace llarp::quic
       return not incoming_handlers_.empty();
     }
 
+    /// status of our tunnels' buffer pool
+    util::StatusObject
+    ExtractStatus() const;
+
    private:
     EndpointBase& service_endpoint_;
 
+    // Buffers for data moving between local tcp sockets and quic streams, shared by the server and
+    // all client endpoints.
+    std::shared_ptr<BufferPool> buffer_pool_ = std::make_shared<BufferPool>();
+
     struct ClientTunnel
     {
       // quic endpoint
       std::unique_ptr<Client> client;
       // Callback to invoke on quic connection established (true argument) or failed (false arg)
       OpenCallback open_cb;
+      // Transport profile the connection gets created with
+      TransportProfile profile = TransportProfile::standard;
       // TCP listening socket
       std::shared_ptr<uvw::TCPHandle> tcp;
       // Accepted TCP connections
@@ -183,6 +202,17 @@ namespace llarp::quic
     void
     make_server();
 
+    // Hands a single quic packet that arrived from `tag` to the server or client endpoint
+    // identified by the packet type and pseudo-port.
+    void
+    deliver_packet(
+        const service::ConvoTag& tag,
+        std::byte type,
+        uint16_t pseudo_port,
+        uint8_t ecn,
+        bstring_view data,
+        bool accepts_batches);
+
     // Called when a new during connection handshaking once we have the established transport
     // parameters (which include the port) if this is an incoming connection (and this endpoint is a
     // server).  This checks handlers to see whether the stream is allowed and, if so, returns a
@@ -193,6 +223,12 @@ namespace llarp::quic
 
     // Incoming stream handlers
     std::map<int, ListenHandler> incoming_handlers_;
+    // Transport profile each incoming stream handler asked for
+    std::map<int, TransportProfile> incoming_profiles_;
+
+    // Points the server at the most demanding transport profile of the current listeners
+    void
+    update_server_profile();
     int next_handler_id_ = 1;
 
     std::shared_ptr<uvw::Loop>
@@ -39,6 +39,7 @@ namespace llarp
   struct Profiling;
   struct SecretKey;
   struct Signature;
+  class EncryptionKeyPool;
   struct IOutboundMessageHandler;
   struct IOutboundSessionMaker;
   struct ILinkManager;
@@ -253,7 +254,7 @@ namespace llarp
     ConnectToRandomRouters(int N) = 0;
 
     virtual bool
-    TryConnectAsync(RouterContact rc, uint16_t tries) = 0;
+    TryConnectAsync(RouterContact_ptr rc, uint16_t tries) = 0;
 
     /// called by link when a remote session has no more sessions open
     virtual void
@@ -340,6 +341,10 @@ namespace llarp
     virtual path::BuildLimiter&
     pathBuildLimiter() = 0;
 
+    /// pregenerated keypairs for path builds
+    virtual EncryptionKeyPool&
+    encryptionKeyPool() = 0;
+
     /// return true if we have at least 1 session to this router in either
     /// direction
     virtual bool
@@ -357,6 +362,10 @@ namespace llarp
     virtual util::StatusObject
     ExtractSummaryStatus() const = 0;
 
+    /// the status sections that changed after version since, along with the current version
+    virtual util::StatusObject
+    ExtractStatusChanges(uint64_t since) const = 0;
+
     /// gossip an rc if required
     virtual void
     GossipRCIfNeeded(const RouterContact rc) = 0;
@@ -54,7 +54,7 @@ namespace llarp
     CreateSessionTo(const RouterID& router, RouterCallback on_result) = 0;
 
     virtual void
-    CreateSessionTo(const RouterContact& rc, RouterCallback on_result) = 0;
+    CreateSessionTo(RouterContact_ptr rc, RouterCallback on_result) = 0;
 
     virtual bool
     HavePendingSessionTo(const RouterID& router) const = 0;
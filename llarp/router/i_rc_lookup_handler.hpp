@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 namespace llarp
@@ -19,8 +20,9 @@ namespace llarp
     BadRC
   };
 
+  /// called with the rc we found, shared with whoever else holds it, or null if we found none
   using RCRequestCallback =
-      std::function<void(const RouterID&, const RouterContact* const, const RCRequestResult)>;
+      std::function<void(const RouterID&, RouterContact_ptr, const RCRequestResult)>;
 
   struct I_RCLookupHandler
   {
@@ -32,7 +34,9 @@ namespace llarp
     virtual void
     RemoveValidRouter(const RouterID& router) = 0;
 
-    virtual void
+    /// replace the service node lists, returns the routers that sessions were allowed with before
+    /// and are not allowed with anymore
+    virtual std::unordered_set<RouterID>
     SetRouterWhitelist(
         const std::vector<RouterID>& whitelist,
         const std::vector<RouterID>& greylist,
@@ -59,6 +63,10 @@ namespace llarp
     virtual bool
     CheckRC(const RouterContact& rc) const = 0;
 
+    /// like CheckRC but the nodedb and dht keep the handle we are given instead of a copy
+    virtual bool
+    CheckRC(const RouterContact_ptr& rc) const = 0;
+
     virtual bool
     GetRandomWhitelistRouter(RouterID& router) const = 0;
 
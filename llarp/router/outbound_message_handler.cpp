@@ -4,6 +4,7 @@
 #include "router.hpp"
 #include <llarp/constants/link_layer.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/util/status.hpp>
 
 #include <algorithm>
@@ -35,19 +36,14 @@ namespace llarp
     ent.inform = std::move(callback);
     ent.pathid = msg.pathid;
     ent.priority = msg.Priority();
+    if (metrics::timers_enabled.load(std::memory_order_relaxed) and metrics::Timer::Sampled())
+      ent.queuedAt = std::chrono::steady_clock::now();
 
-    std::array<byte_t, MAX_LINK_MSG_SIZE> linkmsg_buffer;
-    llarp_buffer_t buf{linkmsg_buffer};
-
-    if (!EncodeBuffer(msg, buf))
+    if (!EncodeBuffer(msg, ent.message))
     {
       return false;
     }
 
-    ent.message.resize(buf.sz);
-
-    std::copy_n(buf.base, buf.sz, ent.message.data());
-
     // if we have a session to the destination, queue the message and return
     if (_router->linkManager().HasSessionTo(remote))
     {
@@ -176,23 +172,43 @@ namespace llarp
   }
 
   bool
-  OutboundMessageHandler::EncodeBuffer(const ILinkMessage& msg, llarp_buffer_t& buf)
+  OutboundMessageHandler::EncodeBuffer(const ILinkMessage& msg, std::vector<byte_t>& buf)
   {
-    if (!msg.BEncode(&buf))
+    const auto maxsz = std::min(msg.MaxEncodedSize(), MAX_LINK_MSG_SIZE);
+    if (maxsz < MAX_LINK_MSG_SIZE)
     {
-      LogWarn("failed to encode outbound message, buffer size left: ", buf.size_left());
-      return false;
+      // messages that know how big they get are encoded into their own buffer, which holds on to
+      // no more than that
+      if (BEncodeToSize(msg, buf, maxsz))
+        return true;
     }
-    // set size of message
-    buf.sz = buf.cur - buf.base;
-    buf.cur = buf.base;
-
-    return true;
+    else
+    {
+      // the others go through scratch space that is kept around, so that each does not allocate
+      // and clear a full link message only to keep holding on to it once it is queued
+      static thread_local std::vector<byte_t> scratch(MAX_LINK_MSG_SIZE);
+      llarp_buffer_t scratchbuf{scratch};
+      if (msg.BEncode(&scratchbuf))
+      {
+        buf.assign(scratch.begin(), scratch.begin() + (scratchbuf.cur - scratchbuf.base));
+        return true;
+      }
+    }
+    LogWarn("failed to encode outbound ", msg.Name(), " message");
+    return false;
   }
 
   bool
   OutboundMessageHandler::Send(const MessageQueueEntry& ent)
   {
+    if (ent.queuedAt)
+    {
+      static auto& queueWait = metrics::registry().GetHistogram(
+          "lokinet_outbound_queue_wait_seconds",
+          "time link messages wait in our outbound queues before going to the link layer");
+      queueWait.Observe(
+          std::chrono::steady_clock::now() - *ent.queuedAt, metrics::Timer::SampleEvery);
+    }
     const llarp_buffer_t buf{ent.message};
     m_queueStats.sent++;
     SendStatusHandler callback = ent.inform;
@@ -10,6 +10,7 @@
 #include <llarp/router_id.hpp>
 
 #include <list>
+#include <optional>
 #include <unordered_map>
 #include <utility>
 
@@ -84,6 +85,9 @@ namespace llarp
       SendStatusHandler inform;
       PathID_t pathid;
       RouterID router;
+      /// when it was handed to us, for the queue wait metric; only set on sampled entries while
+      /// timers are enabled
+      std::optional<std::chrono::steady_clock::time_point> queuedAt;
 
       bool
       operator>(const MessageQueueEntry& other) const
@@ -122,8 +126,9 @@ namespace llarp
     void
     QueueSessionCreation(const RouterID& remote);
 
+    /// encode msg into the buffer that is queued and later handed to the link layer
     bool
-    EncodeBuffer(const ILinkMessage& msg, llarp_buffer_t& buf);
+    EncodeBuffer(const ILinkMessage& msg, std::vector<byte_t>& buf);
 
     /* sends the message along to the link layer, and hopefully out to the network
      *
@@ -21,12 +21,12 @@ namespace llarp
   {
     // TODO: add session establish status metadata, e.g. num retries
 
-    const RouterContact rc;
+    const RouterContact_ptr rc;
     LinkLayer_ptr link;
 
     size_t attemptCount = 0;
 
-    PendingSession(RouterContact _rc, LinkLayer_ptr _link)
+    PendingSession(RouterContact_ptr _rc, LinkLayer_ptr _link)
         : rc(std::move(_rc)), link(std::move(_link))
     {}
   };
@@ -35,10 +35,10 @@ namespace llarp
   OutboundSessionMaker::OnSessionEstablished(ILinkSession* session)
   {
     // TODO: do we want to keep it
-    const RouterContact rc = session->GetRemoteRC();
+    const auto& rc = session->GetRemoteRC();
     const auto router = RouterID(session->GetPubKey());
     const bool isOutbound = not session->IsInbound();
-    const std::string remoteType = rc.IsPublicRouter() ? "router" : "client";
+    const std::string remoteType = rc->IsPublicRouter() ? "router" : "client";
     LogInfo(
         "session with ", remoteType, " [", router, "] ", isOutbound ? "established" : "received");
 
@@ -99,9 +99,9 @@ namespace llarp
   }
 
   void
-  OutboundSessionMaker::CreateSessionTo(const RouterContact& rc, RouterCallback on_result)
+  OutboundSessionMaker::CreateSessionTo(RouterContact_ptr rc, RouterCallback on_result)
   {
-    const RouterID router{rc.pubkey};
+    const RouterID router{rc->pubkey};
 
     if (on_result)
     {
@@ -125,7 +125,7 @@ namespace llarp
       return;
     }
 
-    GotRouterContact(router, rc);
+    GotRouterContact(router, std::move(rc));
   }
 
   bool
@@ -144,20 +144,16 @@ namespace llarp
     {
       auto filter = [exclude](const auto& rc) -> bool { return exclude.count(rc.pubkey) == 0; };
 
-      RouterContact other;
-      if (const auto maybe = _nodedb->GetRandom(filter))
-      {
-        other = *maybe;
-      }
-      else
+      auto other = _nodedb->GetRandom(filter);
+      if (not other)
         break;
 
-      exclude.insert(other.pubkey);
-      if (not _rcLookup->SessionIsAllowed(other.pubkey))
+      exclude.insert(other->pubkey);
+      if (not _rcLookup->SessionIsAllowed(other->pubkey))
       {
         continue;
       }
-      if (not(_linkManager->HasSessionTo(other.pubkey) || HavePendingSessionTo(other.pubkey)))
+      if (not(_linkManager->HasSessionTo(other->pubkey) || HavePendingSessionTo(other->pubkey)))
       {
         CreateSessionTo(other, nullptr);
         --remainingDesired;
@@ -215,7 +211,7 @@ namespace llarp
   }
 
   void
-  OutboundSessionMaker::GotRouterContact(const RouterID& router, const RouterContact& rc)
+  OutboundSessionMaker::GotRouterContact(const RouterID& router, RouterContact_ptr rc)
   {
     {
       std::unique_lock l{_mutex};
@@ -228,7 +224,7 @@ namespace llarp
         return;
       }
 
-      LinkLayer_ptr link = _linkManager->GetCompatibleLink(rc);
+      LinkLayer_ptr link = _linkManager->GetCompatibleLink(*rc);
 
       if (not link)
       {
@@ -237,7 +233,7 @@ namespace llarp
         return;
       }
 
-      auto session = std::make_shared<PendingSession>(rc, link);
+      auto session = std::make_shared<PendingSession>(std::move(rc), link);
 
       itr->second = session;
     }
@@ -285,7 +281,7 @@ namespace llarp
 
   void
   OutboundSessionMaker::OnRouterContactResult(
-      const RouterID& router, const RouterContact* const rc, const RCRequestResult result)
+      const RouterID& router, RouterContact_ptr rc, const RCRequestResult result)
   {
     if (not HavePendingSessionTo(router))
     {
@@ -298,7 +294,7 @@ namespace llarp
       case RCRequestResult::Success:
         if (rc)
         {
-          GotRouterContact(router, *rc);
+          GotRouterContact(router, std::move(rc));
         }
         else
         {
@@ -319,15 +315,15 @@ namespace llarp
   }
 
   void
-  OutboundSessionMaker::VerifyRC(const RouterContact rc)
+  OutboundSessionMaker::VerifyRC(const RouterContact_ptr& rc)
   {
     if (not _rcLookup->CheckRC(rc))
     {
-      FinalizeRequest(rc.pubkey, SessionResult::InvalidRouter);
+      FinalizeRequest(rc->pubkey, SessionResult::InvalidRouter);
       return;
     }
 
-    FinalizeRequest(rc.pubkey, SessionResult::Establish);
+    FinalizeRequest(rc->pubkey, SessionResult::Establish);
   }
 
   void
@@ -38,7 +38,7 @@ namespace llarp
     CreateSessionTo(const RouterID& router, RouterCallback on_result) override EXCLUDES(_mutex);
 
     void
-    CreateSessionTo(const RouterContact& rc, RouterCallback on_result) override EXCLUDES(_mutex);
+    CreateSessionTo(RouterContact_ptr rc, RouterCallback on_result) override EXCLUDES(_mutex);
 
     bool
     HavePendingSessionTo(const RouterID& router) const override EXCLUDES(_mutex);
@@ -77,7 +77,7 @@ namespace llarp
     DoEstablish(const RouterID& router) EXCLUDES(_mutex);
 
     void
-    GotRouterContact(const RouterID& router, const RouterContact& rc) EXCLUDES(_mutex);
+    GotRouterContact(const RouterID& router, RouterContact_ptr rc) EXCLUDES(_mutex);
 
     void
     InvalidRouter(const RouterID& router);
@@ -87,10 +87,10 @@ namespace llarp
 
     void
     OnRouterContactResult(
-        const RouterID& router, const RouterContact* const rc, const RCRequestResult result);
+        const RouterID& router, RouterContact_ptr rc, const RCRequestResult result);
 
     void
-    VerifyRC(const RouterContact rc);
+    VerifyRC(const RouterContact_ptr& rc);
 
     void
     CreatePendingSession(const RouterID& router) EXCLUDES(_mutex);
@@ -94,9 +94,16 @@ namespace llarp
       m_LastGossipedOurRC = now;
     }
 
-    // send a GRCM as gossip method
+    // send a GRCM as gossip method, encoded once for every peer we send it to
     DHTImmediateMessage gossip;
     gossip.msgs.emplace_back(new dht::GotRouterMessage(dht::Key_t{}, 0, {rc}, false));
+    ILinkSession::Message_t encoded(MAX_LINK_MSG_SIZE / 2);
+    {
+      llarp_buffer_t buf(encoded);
+      if (not gossip.BEncode(&buf))
+        return false;
+      encoded.resize(buf.cur - buf.base);
+    }
 
     std::vector<RouterID> gossipTo;
 
@@ -107,7 +114,7 @@ namespace llarp
           if (not(peerSession && peerSession->IsEstablished()))
             return;
           // check if public router
-          const auto other_rc = peerSession->GetRemoteRC();
+          const auto& other_rc = *peerSession->GetRemoteRC();
           if (not other_rc.IsPublicRouter())
             return;
           gossipTo.emplace_back(other_rc.pubkey);
@@ -127,18 +134,10 @@ namespace llarp
       if (keys.count(peerSession->GetPubKey()) == 0)
         return;
 
-      // encode message
-      ILinkSession::Message_t msg{};
-      msg.resize(MAX_LINK_MSG_SIZE / 2);
-      llarp_buffer_t buf(msg);
-      if (not gossip.BEncode(&buf))
-        return;
-      msg.resize(buf.cur - buf.base);
-
       m_router->NotifyRouterEvent<tooling::RCGossipSentEvent>(m_router->pubkey(), rc);
 
       // send message
-      peerSession->SendMessageBuffer(std::move(msg), nullptr, gossip.Priority());
+      peerSession->SendMessageBuffer(encoded, nullptr, gossip.Priority());
     });
     return true;
   }
@@ -39,21 +39,32 @@ namespace llarp
     beigelist.insert(new_beige.begin(), new_beige.end());
   }
 
-  void
+  std::unordered_set<RouterID>
   RCLookupHandler::SetRouterWhitelist(
       const std::vector<RouterID>& whitelist,
       const std::vector<RouterID>& greylist,
       const std::vector<RouterID>& greenlist)
   {
+    std::unordered_set<RouterID> revoked;
     if (whitelist.empty())
-      return;
+      return revoked;
     util::Lock l(_mutex);
 
+    // everything we allowed sessions with before, minus what is still allowed below
+    revoked.insert(whitelistRouters.begin(), whitelistRouters.end());
+    revoked.insert(greylistRouters.begin(), greylistRouters.end());
+
     loadColourList(whitelistRouters, whitelist);
     loadColourList(greylistRouters, greylist);
     loadColourList(greenlistRouters, greenlist);
 
+    for (const auto& router : whitelist)
+      revoked.erase(router);
+    for (const auto& router : greylist)
+      revoked.erase(router);
+
     LogInfo("lokinet service node list now has ", whitelistRouters.size(), " active routers");
+    return revoked;
   }
 
   bool
@@ -66,17 +77,15 @@ namespace llarp
   void
   RCLookupHandler::GetRC(const RouterID& router, RCRequestCallback callback, bool forceLookup)
   {
-    RouterContact remoteRC;
     if (not forceLookup)
     {
-      if (const auto maybe = _nodedb->Get(router); maybe.has_value())
+      if (auto remoteRC = _nodedb->Get(router))
       {
-        remoteRC = *maybe;
         if (callback)
         {
-          callback(router, &remoteRC, RCRequestResult::Success);
+          callback(router, remoteRC, RCRequestResult::Success);
         }
-        FinalizeRequest(router, &remoteRC, RCRequestResult::Success);
+        FinalizeRequest(router, std::move(remoteRC), RCRequestResult::Success);
         return;
       }
     }
@@ -193,6 +202,18 @@ namespace llarp
 
   bool
   RCLookupHandler::CheckRC(const RouterContact& rc) const
+  {
+    return CheckRC(rc, nullptr);
+  }
+
+  bool
+  RCLookupHandler::CheckRC(const RouterContact_ptr& rc) const
+  {
+    return CheckRC(*rc, rc);
+  }
+
+  bool
+  RCLookupHandler::CheckRC(const RouterContact& rc, RouterContact_ptr shared) const
   {
     if (not SessionIsAllowed(rc.pubkey))
     {
@@ -210,8 +231,11 @@ namespace llarp
     if (rc.IsPublicRouter())
     {
       LogDebug("Adding or updating RC for ", RouterID(rc.pubkey), " to nodedb and dht.");
-      _loop->call([rc, n = _nodedb] { n->PutIfNewer(rc); });
-      _dht->impl->PutRCNodeAsync(rc);
+      // the nodedb and the dht share one copy
+      if (not shared)
+        shared = std::make_shared<const EncodedRouterContact>(rc);
+      _loop->call([shared, n = _nodedb] { n->PutIfNewer(shared); });
+      _dht->impl->PutRCNodeAsync(dht::RCNode{std::move(shared)});
     }
 
     return true;
@@ -248,13 +272,14 @@ namespace llarp
     if (!SessionIsAllowed(newrc.pubkey))
       return false;
 
-    auto func = [this, newrc] { CheckRC(newrc); };
+    auto shared = std::make_shared<const EncodedRouterContact>(std::move(newrc));
+    auto func = [this, shared] { CheckRC(shared); };
     _work(func);
 
     // update dht if required
-    if (_dht->impl->Nodes()->HasNode(dht::Key_t{newrc.pubkey}))
+    if (_dht->impl->Nodes()->HasNode(dht::Key_t{shared->pubkey}))
     {
-      _dht->impl->Nodes()->PutNode(newrc);
+      _dht->impl->Nodes()->PutNode(dht::RCNode{shared});
     }
 
     // TODO: check for other places that need updating the RC
@@ -340,7 +365,7 @@ namespace llarp
     _linkManager->ForEachPeer([&](ILinkSession* s) {
       if (!s->IsEstablished())
         return;
-      const RouterContact rc = s->GetRemoteRC();
+      const RouterContact& rc = *s->GetRemoteRC();
       if (rc.IsPublicRouter() && (_bootstrapRCList.find(rc) == _bootstrapRCList.end()))
       {
         LogDebug("Doing explore via public node: ", RouterID(rc.pubkey));
@@ -388,19 +413,22 @@ namespace llarp
       return;
     }
 
+    // one handle for the result that the nodedb, the dht and our callers all share
+    auto rc = std::make_shared<const EncodedRouterContact>(results[0]);
+
     if (not SessionIsAllowed(remote))
     {
-      FinalizeRequest(remote, &results[0], RCRequestResult::InvalidRouter);
+      FinalizeRequest(remote, std::move(rc), RCRequestResult::InvalidRouter);
       return;
     }
 
-    if (not CheckRC(results[0]))
+    if (not CheckRC(rc))
     {
-      FinalizeRequest(remote, &results[0], RCRequestResult::BadRC);
+      FinalizeRequest(remote, std::move(rc), RCRequestResult::BadRC);
       return;
     }
 
-    FinalizeRequest(remote, &results[0], RCRequestResult::Success);
+    FinalizeRequest(remote, std::move(rc), RCRequestResult::Success);
   }
 
   bool
@@ -425,7 +453,7 @@ namespace llarp
 
   void
   RCLookupHandler::FinalizeRequest(
-      const RouterID& router, const RouterContact* const rc, RCRequestResult result)
+      const RouterID& router, RouterContact_ptr rc, RCRequestResult result)
   {
     CallbacksQueue movedCallbacks;
     {
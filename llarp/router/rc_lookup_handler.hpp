@@ -40,7 +40,7 @@ namespace llarp
     void
     RemoveValidRouter(const RouterID& router) override EXCLUDES(_mutex);
 
-    void
+    std::unordered_set<RouterID>
     SetRouterWhitelist(
         const std::vector<RouterID>& whitelist,
         const std::vector<RouterID>& greylist,
@@ -77,6 +77,9 @@ namespace llarp
     bool
     CheckRC(const RouterContact& rc) const override;
 
+    bool
+    CheckRC(const RouterContact_ptr& rc) const override;
+
     bool
     GetRandomWhitelistRouter(RouterID& router) const override EXCLUDES(_mutex);
 
@@ -123,9 +126,13 @@ namespace llarp
     RemoteInBootstrap(const RouterID& remote) const;
 
     void
-    FinalizeRequest(const RouterID& router, const RouterContact* const rc, RCRequestResult result)
+    FinalizeRequest(const RouterID& router, RouterContact_ptr rc, RCRequestResult result)
         EXCLUDES(_mutex);
 
+    /// check rc, storing shared if it is set and a copy of rc if not
+    bool
+    CheckRC(const RouterContact& rc, RouterContact_ptr shared) const;
+
     mutable util::Mutex _mutex;  // protects pendingCallbacks, whitelistRouters
 
     llarp_dht_context* _dht = nullptr;
@@ -16,7 +16,9 @@
 #include <stdexcept>
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/logging.hpp>
+#include <llarp/util/logging/async_sink.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/util/str.hpp>
 #include <llarp/ev/ev.hpp>
 #include <llarp/tooling/peer_stats_event.hpp>
@@ -93,20 +95,59 @@ namespace llarp
     llarp::LogTrace("Router::PumpLL() end");
   }
 
+  void
+  Router::SetupStatusCache(llarp_time_t maxAge)
+  {
+    // rates and timestamps are different every time we look, they alone are not a change
+    m_StatusCache = util::StatusCache{{
+        "txRate",
+        "rxRate",
+        "txRateCurrent",
+        "rxRateCurrent",
+        "tx",
+        "rx",
+        "uptime",
+        "lastSend",
+        "lastRecv",
+        "lastRecvMsg",
+        "lastActive",
+        "lastLatencyTest",
+        "lastFlushMs",
+        "lastUpdated",
+    }};
+    m_StatusCache.Add("dht", [this]() { return _dht->impl->ExtractStatus(); }, maxAge);
+    m_StatusCache.Add("rcVerify", []() { return RouterContact::ExtractVerifyStats(); }, maxAge);
+    m_StatusCache.Add(
+        "services", [this]() { return _hiddenServiceContext.ExtractStatus(); }, maxAge);
+    m_StatusCache.Add("exit", [this]() { return _exitContext.ExtractStatus(); }, maxAge);
+    m_StatusCache.Add("links", [this]() { return _linkManager.ExtractStatus(); }, maxAge);
+    m_StatusCache.Add(
+        "outboundMessages", [this]() { return _outboundMessageHandler.ExtractStatus(); }, maxAge);
+    m_StatusCache.Add(
+        "encryptionKeyPool", [this]() { return m_EncryptionKeyPool->ExtractStatus(); }, maxAge);
+  }
+
   util::StatusObject
   Router::ExtractStatus() const
   {
     if (not _running)
-      util::StatusObject{{"running", false}};
+      return util::StatusObject{{"running", false}};
 
+    auto status = m_StatusCache.Collect(Now());
+    status["running"] = true;
+    status["numNodesKnown"] = _nodedb->NumLoaded();
+    return status;
+  }
+
+  util::StatusObject
+  Router::ExtractStatusChanges(uint64_t since) const
+  {
+    if (not _running)
+      return util::StatusObject{{"running", false}};
+
+    auto changed = m_StatusCache.ChangedSince(since, Now());
     return util::StatusObject{
-        {"running", true},
-        {"numNodesKnown", _nodedb->NumLoaded()},
-        {"dht", _dht->impl->ExtractStatus()},
-        {"services", _hiddenServiceContext.ExtractStatus()},
-        {"exit", _exitContext.ExtractStatus()},
-        {"links", _linkManager.ExtractStatus()},
-        {"outboundMessages", _outboundMessageHandler.ExtractStatus()}};
+        {"running", true}, {"version", m_StatusCache.Version()}, {"changed", std::move(changed)}};
   }
 
   util::StatusObject
@@ -115,9 +156,10 @@ namespace llarp
     if (!_running)
       return util::StatusObject{{"running", false}};
 
-    auto services = _hiddenServiceContext.ExtractStatus();
+    const auto now = Now();
+    const auto& services = m_StatusCache.Get("services", now);
 
-    auto link_types = _linkManager.ExtractStatus();
+    const auto& link_types = m_StatusCache.Get("links", now);
 
     uint64_t tx_rate = 0;
     uint64_t rx_rate = 0;
@@ -146,11 +188,11 @@ namespace llarp
       const auto& serviceDefault = services.at("default");
       builders.push_back(serviceDefault);
 
-      auto snode_sessions = serviceDefault.at("snodeSessions");
+      const auto& snode_sessions = serviceDefault.at("snodeSessions");
       for (const auto& session : snode_sessions)
         builders.push_back(session);
 
-      auto remote_sessions = serviceDefault.at("remoteSessions");
+      const auto& remote_sessions = serviceDefault.at("remoteSessions");
       for (const auto& session : remote_sessions)
         builders.push_back(session);
     }
@@ -198,10 +240,11 @@ namespace llarp
 
     if (services.is_object())
     {
-      stats["authCodes"] = services["default"]["authCodes"];
-      stats["exitMap"] = services["default"]["exitMap"];
-      stats["networkReady"] = services["default"]["networkReady"];
-      stats["lokiAddress"] = services["default"]["identity"];
+      const auto& serviceDefault = services.at("default");
+      stats["authCodes"] = serviceDefault.value("authCodes", util::StatusObject{});
+      stats["exitMap"] = serviceDefault.value("exitMap", util::StatusObject{});
+      stats["networkReady"] = serviceDefault.value("networkReady", util::StatusObject{});
+      stats["lokiAddress"] = serviceDefault.value("identity", util::StatusObject{});
     }
     return stats;
   }
@@ -412,7 +455,12 @@ namespace llarp
     if (log::get_level_default() != log::Level::off)
       log::reset_level(conf.logging.m_logLevel);
     log::clear_sinks();
-    log::add_sink(log_type, log_type == log::Type::System ? "lokinet" : conf.logging.m_logFile);
+    if (auto sink = logging::make_sink(log_type, conf.logging.m_logFile))
+      log::add_sink(
+          logging::maybe_async(std::move(sink), conf.logging.m_logAsync),
+          log_type == log::Type::Print ? log::DEFAULT_PATTERN_COLOR : log::DEFAULT_PATTERN_MONO);
+    else
+      log::add_sink(log_type, log_type == log::Type::System ? "lokinet" : conf.logging.m_logFile);
 
     // re-add rpc log sink if rpc enabled, else free it
     if (m_Config->api.m_enableRPCServer and llarp::logRingBuffer)
@@ -678,6 +726,9 @@ namespace llarp
 
     RouterContact::BlockBogons = conf.router.m_blockBogons;
 
+    if (conf.router.m_IntroSetStorageLimit)
+      _dht->impl->services().SetMaxBytes(conf.router.m_IntroSetStorageLimit);
+
     auto& networkConfig = conf.network;
 
     /// build a set of  strictConnectPubkeys (
@@ -725,6 +776,10 @@ namespace llarp
     // in case someone has an old bootstrap file and is trying to use a bootstrap
     // that no longer exists
     auto clearBadRCs = [this]() {
+      // check all signatures in one batch up front so the checks below hit the signature cache
+      RouterContact::VerifySignatures(
+          std::vector<RouterContact>(bootstrapRCList.begin(), bootstrapRCList.end()),
+          util::memFn(&AbstractRouter::QueueWork, this));
       for (auto it = bootstrapRCList.begin(); it != bootstrapRCList.end();)
       {
         if (it->IsObsoleteBootstrap())
@@ -825,6 +880,14 @@ namespace llarp
       hiddenServiceContext().AddEndpoint(conf);
     }
 
+    SetupStatusCache(conf.api.m_statusInterval);
+
+    if (conf.router.m_LoopProfiling)
+    {
+      LogInfo("event loop profiling enabled");
+      _loop->profiler().Enable(conf.router.m_LoopStallThreshold);
+    }
+
     return true;
   }
 
@@ -937,6 +1000,9 @@ namespace llarp
 
     llarp::sys::service_manager->report_periodic_stats();
 
+    m_StatusCache.Refresh(now, StatusRefreshBudget);
+    metrics::registry().Tick();
+
     m_PathBuildLimiter.Decay(now);
 
     routerProfiling().Tick();
@@ -976,52 +1042,16 @@ namespace llarp
       // the white or grey list, we want to gossip our RC
       GossipRCIfNeeded(_rc);
     }
-    // remove RCs for nodes that are no longer allowed by network policy
-    nodedb()->RemoveIf([&](const RouterContact& rc) -> bool {
+    // remove expired RCs, only the entries that actually expired are visited. RCs that are no
+    // longer allowed by network policy are removed when the service node list changes.
+    nodedb()->RemoveExpired(now, [this](const RouterContact& rc) -> bool {
       // don't purge bootstrap nodes from nodedb
       if (IsBootstrapNode(rc.pubkey))
       {
         log::trace(logcat, "Not removing {}: is bootstrap node", rc.pubkey);
-        return false;
-      }
-      // if for some reason we stored an RC that isn't a valid router
-      // purge this entry
-      if (not rc.IsPublicRouter())
-      {
-        log::debug(logcat, "Removing {}: not a valid router", rc.pubkey);
-        return true;
-      }
-      /// clear out a fully expired RC
-      if (rc.IsExpired(now))
-      {
-        log::debug(logcat, "Removing {}: RC is expired", rc.pubkey);
-        return true;
-      }
-      // clients have no notion of a whilelist
-      // we short circuit logic here so we dont remove
-      // routers that are not whitelisted for first hops
-      if (not isSvcNode)
-      {
-        log::trace(logcat, "Not removing {}: we are a client and it looks fine", rc.pubkey);
-        return false;
-      }
-
-      // if we have a whitelist enabled and we don't
-      // have the whitelist yet don't remove the entry
-      if (whitelistRouters and not gotWhitelist)
-      {
-        log::debug(logcat, "Skipping check on {}: don't have whitelist yet", rc.pubkey);
-        return false;
-      }
-      // if we have no whitelist enabled or we have
-      // the whitelist enabled and we got the whitelist
-      // check against the whitelist and remove if it's not
-      // in the whitelist OR if there is no whitelist don't remove
-      if (gotWhitelist and not _rcLookupHandler.SessionIsAllowed(rc.pubkey))
-      {
-        log::debug(logcat, "Removing {}: not a valid router", rc.pubkey);
         return true;
       }
+      log::debug(logcat, "Removing {}: RC is expired", rc.pubkey);
       return false;
     });
 
@@ -1146,6 +1176,8 @@ namespace llarp
         [&peersWeHave](const dht::Key_t& k) -> bool { return peersWeHave.count(k) == 0; });
     // expire paths
     paths.ExpirePaths(now);
+    if (m_RPCServer)
+      m_RPCServer->Tick(now);
     // update tick timestamp
     _lastTick = llarp::time_now_ms();
   }
@@ -1165,7 +1197,7 @@ namespace llarp
     LogInfo("Session to ", remote, " fully closed");
     if (IsServiceNode())
       return;
-    if (const auto maybe = nodedb()->Get(remote); maybe.has_value())
+    if (const auto maybe = nodedb()->Get(remote))
     {
       for (const auto& addr : maybe->addrs)
         m_RoutePoker->DelRoute(addr.IPv4());
@@ -1229,7 +1261,7 @@ namespace llarp
   {
     _rcLookupHandler.GetRC(
         remote,
-        [=](const RouterID& id, const RouterContact* const rc, const RCRequestResult result) {
+        [=](const RouterID& id, RouterContact_ptr rc, const RCRequestResult result) {
           (void)id;
           if (resultHandler)
           {
@@ -1249,7 +1281,35 @@ namespace llarp
       const std::vector<RouterID>& greylist,
       const std::vector<RouterID>& unfundedlist)
   {
-    _rcLookupHandler.SetRouterWhitelist(whitelist, greylist, unfundedlist);
+    const bool hadWhitelist = _rcLookupHandler.HaveReceivedWhitelist();
+    auto revoked = _rcLookupHandler.SetRouterWhitelist(whitelist, greylist, unfundedlist);
+
+    // clients have no notion of a whitelist, they keep routers around for first hops
+    if (not IsServiceNode() or not _rcLookupHandler.HaveReceivedWhitelist())
+      return;
+
+    auto keep = [this](const RouterContact& rc) -> bool {
+      // don't purge bootstrap nodes from nodedb
+      return IsBootstrapNode(rc.pubkey);
+    };
+
+    if (not hadWhitelist)
+    {
+      // first list we got, check everything we loaded before it arrived
+      nodedb()->RemoveIf([&](const RouterContact& rc) -> bool {
+        if (keep(rc) or _rcLookupHandler.SessionIsAllowed(rc.pubkey))
+          return false;
+        log::debug(logcat, "Removing {}: not a valid router", rc.pubkey);
+        return true;
+      });
+      return;
+    }
+
+    if (not revoked.empty())
+    {
+      log::debug(logcat, "Removing {} routers no longer in the service node list", revoked.size());
+      nodedb()->RemoveMany(revoked, keep);
+    }
   }
 
   bool
@@ -1369,6 +1429,9 @@ namespace llarp
       }
     }
 
+    // have keys ready for the path builds our services are about to start
+    m_EncryptionKeyPool->Start(util::memFn(&AbstractRouter::QueueWork, this));
+
     LogInfo("starting hidden service context...");
     if (!hiddenServiceContext().StartAll())
     {
@@ -1378,7 +1441,7 @@ namespace llarp
 
     {
       LogInfo("Loading nodedb from disk...");
-      _nodedb->LoadFromDisk();
+      _nodedb->LoadFromDisk(util::memFn(&AbstractRouter::QueueWork, this));
     }
 
     llarp_dht_context_start(dht(), pubkey());
@@ -1609,21 +1672,21 @@ namespace llarp
   }
 
   bool
-  Router::TryConnectAsync(RouterContact rc, uint16_t tries)
+  Router::TryConnectAsync(RouterContact_ptr rc, uint16_t tries)
   {
     (void)tries;
 
-    if (rc.pubkey == pubkey())
+    if (rc->pubkey == pubkey())
     {
       return false;
     }
 
-    if (not _rcLookupHandler.SessionIsAllowed(rc.pubkey))
+    if (not _rcLookupHandler.SessionIsAllowed(rc->pubkey))
     {
       return false;
     }
 
-    _outboundSessionMaker.CreateSessionTo(rc, nullptr);
+    _outboundSessionMaker.CreateSessionTo(std::move(rc), nullptr);
 
     return true;
   }
@@ -1716,7 +1779,7 @@ namespace llarp
           util::memFn(&AbstractRouter::TriggerPump, this),
           util::memFn(&AbstractRouter::QueueWork, this));
 
-      server->Bind(this, bind_addr);
+      server->Bind(this, bind_addr, m_Config->router.m_DataPlaneThreads);
       _linkManager.AddLink(std::move(server), true);
     }
   }
@@ -1736,7 +1799,7 @@ namespace llarp
           util::memFn(&AbstractRouter::rc, this),
           util::memFn(&AbstractRouter::HandleRecvLinkMessageBuffer, this),
           util::memFn(&AbstractRouter::Sign, this),
-          [this](llarp::RouterContact rc) {
+          [this](const llarp::RouterContact& rc) {
             if (IsServiceNode())
               return;
             for (const auto& addr : rc.addrs)
@@ -6,6 +6,7 @@
 #include <llarp/config/config.hpp>
 #include <llarp/config/key_manager.hpp>
 #include <llarp/constants/link_layer.hpp>
+#include <llarp/crypto/keypair_pool.hpp>
 #include <llarp/crypto/types.hpp>
 #include <llarp/ev/ev.hpp>
 #include <llarp/exit/context.hpp>
@@ -33,6 +34,7 @@
 #include <llarp/util/fs.hpp>
 #include <llarp/util/mem.hpp>
 #include <llarp/util/status.hpp>
+#include <llarp/util/status_cache.hpp>
 #include <llarp/util/str.hpp>
 #include <llarp/util/time.hpp>
 #include <llarp/util/service_manager.hpp>
@@ -77,6 +79,9 @@ namespace llarp
 
     path::BuildLimiter m_PathBuildLimiter;
 
+    std::shared_ptr<EncryptionKeyPool> m_EncryptionKeyPool =
+        std::make_shared<EncryptionKeyPool>();
+
     std::shared_ptr<EventLoopWakeup> m_Pump;
 
     path::BuildLimiter&
@@ -85,6 +90,12 @@ namespace llarp
       return m_PathBuildLimiter;
     }
 
+    EncryptionKeyPool&
+    encryptionKeyPool() override
+    {
+      return *m_EncryptionKeyPool;
+    }
+
     const llarp::net::Platform&
     Net() const override;
 
@@ -115,6 +126,9 @@ namespace llarp
     util::StatusObject
     ExtractSummaryStatus() const override;
 
+    util::StatusObject
+    ExtractStatusChanges(uint64_t since) const override;
+
     const std::shared_ptr<NodeDB>&
     nodedb() const override
     {
@@ -300,6 +314,14 @@ namespace llarp
 
     std::unique_ptr<rpc::RPCServer> m_RPCServer;
 
+    /// snapshots of the expensive parts of our status, so status polls do not rebuild them all
+    mutable util::StatusCache m_StatusCache;
+    /// how long a tick spends at most making status snapshots again
+    static constexpr auto StatusRefreshBudget = 2ms;
+
+    void
+    SetupStatusCache(llarp_time_t maxAge);
+
     const llarp_time_t _randomStartDelay;
 
     std::shared_ptr<rpc::LokidRpcClient> m_lokidRpcClient;
@@ -455,7 +477,7 @@ namespace llarp
     try_connect(fs::path rcfile);
 
     bool
-    TryConnectAsync(RouterContact rc, uint16_t tries) override;
+    TryConnectAsync(RouterContact_ptr rc, uint16_t tries) override;
 
     /// send to remote router or queue for sending
     /// returns false on overflow
@@ -2,6 +2,7 @@
 
 #include "constants/version.hpp"
 #include "crypto/crypto.hpp"
+#include "crypto/signature_cache.hpp"
 #include "net/net.hpp"
 #include "util/bencode.hpp"
 #include "util/buffer.hpp"
@@ -13,6 +14,9 @@
 
 #include "util/file.hpp"
 
+#include <condition_variable>
+#include <mutex>
+
 namespace llarp
 {
   static auto logcat = log::Cat("RC");
@@ -110,6 +114,27 @@ namespace llarp
     return false;
   }
 
+  EncodedRouterContact::EncodedRouterContact(RouterContact rc) : RouterContact{std::move(rc)}
+  {
+    std::array<byte_t, MAX_RC_SIZE> tmp;
+    llarp_buffer_t buf{tmp};
+    // one that does not encode is left to fail the long way when it is sent
+    if (RouterContact::BEncode(&buf))
+      m_Encoded.assign(tmp.begin(), tmp.begin() + (buf.cur - buf.base));
+  }
+
+  EncodedRouterContact::EncodedRouterContact(RouterContact rc, byte_view_t encoded)
+      : RouterContact{std::move(rc)}, m_Encoded{encoded.begin(), encoded.end()}
+  {}
+
+  bool
+  EncodedRouterContact::BEncode(llarp_buffer_t* buf) const
+  {
+    if (m_Encoded.empty())
+      return RouterContact::BEncode(buf);
+    return buf->write(m_Encoded.begin(), m_Encoded.end());
+  }
+
   std::string
   RouterContact::ToTXTRecord() const
   {
@@ -421,6 +446,12 @@ namespace llarp
     return Age(now) >= rc_expire_age;
   }
 
+  llarp_time_t
+  RouterContact::ExpiresAt() const
+  {
+    return last_updated + rc_expire_age;
+  }
+
   llarp_time_t
   RouterContact::TimeUntilExpires(llarp_time_t now) const
   {
@@ -504,6 +535,41 @@ namespace llarp
     return true;
   }
 
+  namespace
+  {
+    SignatureCache&
+    signature_cache()
+    {
+      static SignatureCache cache;
+      return cache;
+    }
+
+    bool
+    verify_signed_content(const PubKey& pubkey, const llarp_buffer_t& buf, const Signature& sig)
+    {
+      auto* crypto = CryptoManager::instance();
+
+      ShortHash h;
+      // without a hash there is nothing to look up or remember, just verify
+      if (not crypto->shorthash(h, buf))
+        return crypto->verify(pubkey, buf, sig);
+
+      auto& cache = signature_cache();
+      if (cache.Has(h, sig))
+        return true;
+
+      const auto started = std::chrono::steady_clock::now();
+      const bool valid = crypto->verify(pubkey, buf, sig);
+      cache.Verified(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - started),
+          valid);
+      if (valid)
+        cache.Put(h, sig);
+      return valid;
+    }
+  }  // namespace
+
   bool
   RouterContact::VerifySignature() const
   {
@@ -521,18 +587,64 @@ namespace llarp
       }
       buf.sz = buf.cur - buf.base;
       buf.cur = buf.base;
-      return CryptoManager::instance()->verify(pubkey, buf, signature);
+      return verify_signed_content(pubkey, buf, signature);
     }
     /* else */
     if (version == 1)
     {
-      llarp_buffer_t buf{signed_bt_dict};
-      return CryptoManager::instance()->verify(pubkey, buf, signature);
+      return verify_signed_content(pubkey, llarp_buffer_t{signed_bt_dict}, signature);
     }
 
     return false;
   }
 
+  std::vector<bool>
+  RouterContact::VerifySignatures(
+      const std::vector<RouterContact>& rcs,
+      const std::function<void(std::function<void()>)>& work)
+  {
+    // bytes instead of bools so that jobs can write their results concurrently
+    std::vector<uint8_t> valid(rcs.size(), 0);
+
+    static constexpr size_t BatchSize = 32;
+    if (not work or rcs.size() <= BatchSize)
+    {
+      for (size_t idx = 0; idx < rcs.size(); ++idx)
+        valid[idx] = rcs[idx].VerifySignature();
+      return {valid.begin(), valid.end()};
+    }
+
+    std::mutex m;
+    std::condition_variable cv;
+    size_t pending = 0;
+
+    for (size_t begin = 0; begin < rcs.size(); begin += BatchSize)
+    {
+      const size_t end = std::min(begin + BatchSize, rcs.size());
+      {
+        std::lock_guard lock{m};
+        ++pending;
+      }
+      work([&, begin, end] {
+        for (size_t idx = begin; idx < end; ++idx)
+          valid[idx] = rcs[idx].VerifySignature();
+        std::lock_guard lock{m};
+        if (--pending == 0)
+          cv.notify_one();
+      });
+    }
+
+    std::unique_lock lock{m};
+    cv.wait(lock, [&pending] { return pending == 0; });
+    return {valid.begin(), valid.end()};
+  }
+
+  util::StatusObject
+  RouterContact::ExtractVerifyStats()
+  {
+    return signature_cache().ExtractStatus();
+  }
+
   static constexpr std::array obsolete_bootstraps = {
       "7a16ac0b85290bcf69b2f3b52456d7e989ac8913b4afbb980614e249a3723218"sv,
       "e6b3a6fe5e32c379b64212c72232d65b0b88ddf9bbaed4997409d329f8519e0b"sv,
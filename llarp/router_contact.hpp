@@ -12,6 +12,7 @@
 #include "llarp/dns/srv_data.hpp"
 
 #include <functional>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <vector>
 
@@ -178,6 +179,10 @@ namespace llarp
     bool
     IsExpired(llarp_time_t now) const;
 
+    /// the time at which IsExpired starts returning true
+    llarp_time_t
+    ExpiresAt() const;
+
     /// returns time in ms until we expire or 0 if we have expired
     llarp_time_t
     TimeUntilExpires(llarp_time_t now) const;
@@ -198,9 +203,23 @@ namespace llarp
     bool
     Write(const fs::path& fname) const;
 
+    /// verify our signature, signatures that verified before are remembered in a bounded process
+    /// wide cache so the same rc arriving again does not cost another ed25519 verify
     bool
     VerifySignature() const;
 
+    /// verify the signatures of many rcs at once, spread over jobs submitted via work, blocking
+    /// until all are done. the results land in the signature cache so the following Verify calls
+    /// on these rcs are cheap. when work is not set verification happens on the calling thread.
+    static std::vector<bool>
+    VerifySignatures(
+        const std::vector<RouterContact>& rcs,
+        const std::function<void(std::function<void()>)>& work);
+
+    /// hit rate and verify cost of the signature cache
+    static util::StatusObject
+    ExtractVerifyStats();
+
     /// return true if the netid in this rc is for the network id we are using
     bool
     FromOurNetwork() const;
@@ -221,6 +240,32 @@ namespace llarp
   template <>
   constexpr inline bool IsToStringFormattable<RouterContact> = true;
 
+  /// an rc that no longer changes, along with what it encodes to, so that sending it on writes
+  /// those bytes out instead of encoding it again
+  struct EncodedRouterContact : public RouterContact
+  {
+    explicit EncodedRouterContact(RouterContact rc);
+
+    /// rc along with the bytes it was decoded from
+    EncodedRouterContact(RouterContact rc, byte_view_t encoded);
+
+    /// writes what we encode to, hides RouterContact::BEncode which encodes from scratch
+    bool
+    BEncode(llarp_buffer_t* buf) const;
+
+    const std::vector<byte_t>&
+    Encoded() const
+    {
+      return m_Encoded;
+    }
+
+   private:
+    std::vector<byte_t> m_Encoded;
+  };
+
+  /// an rc that no longer changes, shared by reference instead of copied around
+  using RouterContact_ptr = std::shared_ptr<const EncodedRouterContact>;
+
   using RouterLookupHandler = std::function<void(const std::vector<RouterContact>&)>;
 }  // namespace llarp
 
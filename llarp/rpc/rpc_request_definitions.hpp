@@ -81,6 +81,52 @@ namespace llarp::rpc
     static constexpr auto name = "get_status"sv;
   };
 
+  //  RPC: metrics
+  //    Returns our counters, gauges and latency histograms in the prometheus text exposition
+  //    format, as the raw reply rather than wrapped in json, so it can be handed to a scraper
+  //    as is
+  //
+  //  Inputs: none
+  //
+  //  Returns: e.g.
+  //    # HELP lokinet_udp_recv_packets_total udp packets read off our sockets
+  //    # TYPE lokinet_udp_recv_packets_total counter
+  //    lokinet_udp_recv_packets_total 1234
+  //    etc
+  //
+  struct Metrics : NoArgs, Immediate
+  {
+    static constexpr auto name = "metrics"sv;
+  };
+
+  //  RPC: loop_profile
+  //    Returns the event loop callback sites we spent the most time in, if loop profiling is
+  //    on ([router]:loop-profiling, or "enable" below)
+  //
+  //  Inputs:
+  //    "count" : how many sites to return, defaults to 10 (int, optional)
+  //    "enable" : turn loop profiling on or off (bool, optional)
+  //    "reset" : forget what was recorded so far, after returning it (bool, optional)
+  //
+  //  Returns:
+  //    "enabled"
+  //    "stallThresholdUs"
+  //    "seconds" : how long we have been recording
+  //    "sites" : how many distinct sites we have seen
+  //    "top" : [{"site", "calls", "totalUs", "meanUs", "p50Us", "p99Us", "maxUs", "stalls"}]
+  //
+  struct LoopProfile : RPCRequest
+  {
+    static constexpr auto name = "loop_profile"sv;
+
+    struct request_parameters
+    {
+      std::optional<int> count;
+      std::optional<bool> enable;
+      bool reset = false;
+    } request;
+  };
+
   //  RPC: quic_connect
   //    Initializes QUIC connection tunnel
   //    Passes request parameters in nlohmann::json format
@@ -91,6 +137,7 @@ namespace llarp::rpc
   //    "host" : remote host ID (string)
   //    "port" : port to bind to (int)
   //    "close" : close connection to port or host ID
+  //    "transportProfile" : "default", "bulk" or "interactive" (string, optional)
   //
   //  Returns:
   //    "id" : connection ID
@@ -107,6 +154,7 @@ namespace llarp::rpc
       std::string endpoint;
       uint16_t port;
       std::string remoteHost;
+      std::string transportProfile;
     } request;
   };
 
@@ -120,6 +168,7 @@ namespace llarp::rpc
   //    "port" : port to bind to (int)
   //    "close" : close connection to port or host ID
   //    "srv-proto" :
+  //    "transportProfile" : "default", "bulk" or "interactive" (string, optional)
   //
   //  Returns:
   //    "id" : connection ID
@@ -136,6 +185,7 @@ namespace llarp::rpc
       uint16_t port;
       std::string remoteHost;
       std::string srvProto;
+      std::string transportProfile;
     } request;
   };
 
@@ -298,6 +348,8 @@ namespace llarp::rpc
       Version,
       Status,
       GetStatus,
+      Metrics,
+      LoopProfile,
       QuicConnect,
       QuicListener,
       LookupSnode,
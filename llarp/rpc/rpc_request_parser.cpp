@@ -11,6 +11,19 @@ namespace llarp::rpc
 {
   using nlohmann::json;
 
+  void
+  parse_request(LoopProfile& loopprofile, rpc_input input)
+  {
+    get_values(
+        input,
+        "count",
+        loopprofile.request.count,
+        "enable",
+        loopprofile.request.enable,
+        "reset",
+        loopprofile.request.reset);
+  }
+
   void
   parse_request(QuicConnect& quicconnect, rpc_input input)
   {
@@ -25,7 +38,9 @@ namespace llarp::rpc
         "port",
         quicconnect.request.port,
         "remoteHost",
-        quicconnect.request.remoteHost);
+        quicconnect.request.remoteHost,
+        "transportProfile",
+        quicconnect.request.transportProfile);
   }
 
   void
@@ -42,7 +57,9 @@ namespace llarp::rpc
         "remoteHost",
         quiclistener.request.remoteHost,
         "srvProto",
-        quiclistener.request.srvProto);
+        quiclistener.request.srvProto,
+        "transportProfile",
+        quiclistener.request.transportProfile);
   }
 
   void
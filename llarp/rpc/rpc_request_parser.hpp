@@ -15,6 +15,8 @@ namespace llarp::rpc
   parse_request(NoArgs&, rpc_input)
   {}
 
+  void
+  parse_request(LoopProfile& loopprofile, rpc_input input);
   void
   parse_request(QuicConnect& quicconnect, rpc_input input);
   void
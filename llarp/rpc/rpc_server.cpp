@@ -19,6 +19,7 @@
 #include <llarp/service/name.hpp>
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/dns/dns.hpp>
+#include <llarp/util/metrics.hpp>
 #include <vector>
 #include <oxenmq/fmt.h>
 
@@ -130,7 +131,9 @@ namespace llarp::rpc
   RPCServer::AddCategories()
   {
     m_LMQ->add_category("llarp", oxenmq::AuthLevel::none)
-        .add_request_command("logs", [this](oxenmq::Message& msg) { HandleLogsSubRequest(msg); });
+        .add_request_command("logs", [this](oxenmq::Message& msg) { HandleLogsSubRequest(msg); })
+        .add_request_command(
+            "status_subscribe", [this](oxenmq::Message& msg) { HandleStatusSubRequest(msg); });
 
     for (auto& req : rpc_request_map)
     {
@@ -177,6 +180,36 @@ namespace llarp::rpc
     SetJSONResponse(m_Router.ExtractSummaryStatus(), getstatus.response);
   }
 
+  void
+  RPCServer::invoke(Metrics& metrics)
+  {
+    // the registry is safe to read from any thread, so this does not go near the event loop
+    metrics.move().reply(llarp::metrics::registry().Prometheus());
+  }
+
+  void
+  RPCServer::invoke(LoopProfile& loopprofile)
+  {
+    // not Immediate, so we are on the event loop which is the only place the profile is touched
+    auto& profiler = m_Router.loop()->profiler();
+    if (loopprofile.request.enable)
+    {
+      if (*loopprofile.request.enable)
+        profiler.Enable(m_Router.GetConfig()->router.m_LoopStallThreshold);
+      else
+        profiler.Disable();
+    }
+    const auto count = loopprofile.request.count.value_or(10);
+    if (count < 0)
+    {
+      SetJSONError("count cannot be negative", loopprofile.response);
+      return;
+    }
+    SetJSONResponse(profiler.TopN(count), loopprofile.response);
+    if (loopprofile.request.reset)
+      profiler.Reset();
+  }
+
   void
   RPCServer::invoke(QuicConnect& quicconnect)
   {
@@ -219,12 +252,23 @@ namespace llarp::rpc
       return;
     }
 
+    auto profile = quic::parse_transport_profile(quicconnect.request.transportProfile);
+    if (not profile)
+    {
+      SetJSONError("Invalid transport profile", quicconnect.response);
+      return;
+    }
+
     SockAddr laddr{quicconnect.request.bindAddr};
 
     try
     {
       auto [addr, id] = quic->open(
-          quicconnect.request.remoteHost, quicconnect.request.port, [](auto&&) {}, laddr);
+          quicconnect.request.remoteHost,
+          quicconnect.request.port,
+          [](auto&&) {},
+          laddr,
+          *profile);
 
       util::StatusObject status;
       status["addr"] = addr.ToString();
@@ -276,11 +320,18 @@ namespace llarp::rpc
 
     if (quiclistener.request.port)
     {
+      auto profile = quic::parse_transport_profile(quiclistener.request.transportProfile);
+      if (not profile)
+      {
+        SetJSONError("Invalid transport profile", quiclistener.response);
+        return;
+      }
+
       auto id = 0;
       try
       {
         SockAddr addr{quiclistener.request.remoteHost, huint16_t{quiclistener.request.port}};
-        id = quic->listen(addr);
+        id = quic->listen(addr, *profile);
       }
       catch (std::exception& e)
       {
@@ -617,4 +668,83 @@ namespace llarp::rpc
     }
   }
 
+  void
+  RPCServer::HandleStatusSubRequest(oxenmq::Message& m)
+  {
+    if (m.data.empty() or m.data.size() > 2)
+    {
+      m.send_reply("Invalid subscription request: no status receipt endpoint given");
+      return;
+    }
+
+    auto endpoint = std::string{m.data[0]};
+    const bool full = m.data.size() == 2 and m.data[1] == "full";
+
+    // subscriptions are only ever touched on the event loop
+    m_Router.loop()->call([this,
+                           conn = m.conn,
+                           remote = std::string{m.remote},
+                           endpoint = std::move(endpoint),
+                           full,
+                           reply = m.send_later()]() mutable {
+      if (endpoint == "unsubscribe")
+      {
+        log::info(logcat, "New status unsubscribe request from conn {}@{}", conn, remote);
+        m_StatusSubs.erase(conn);
+        reply.reply("OK");
+        return;
+      }
+
+      const auto expiresAt = m_Router.Now() + StatusSubscriptionTimeout;
+      auto [itr, is_new] =
+          m_StatusSubs.try_emplace(conn, StatusSubscriber{endpoint, full, expiresAt});
+      if (is_new)
+      {
+        log::info(logcat, "New status subscription request from conn {}@{}", conn, remote);
+        reply.reply("OK");
+        // push to them on the next tick
+        m_NextStatusPush = 0s;
+        return;
+      }
+      log::debug(logcat, "Renewed status subscription request from conn {}@{}", conn, remote);
+      auto& sub = itr->second;
+      sub.expiresAt = expiresAt;
+      if (sub.endpoint != endpoint or sub.full != full)
+      {
+        // they changed what they want, start over with a complete update
+        sub = StatusSubscriber{endpoint, full, expiresAt};
+      }
+      reply.reply("ALREADY");
+    });
+  }
+
+  void
+  RPCServer::Tick(llarp_time_t now)
+  {
+    if (m_StatusSubs.empty() or now < m_NextStatusPush)
+      return;
+    m_NextStatusPush = now + m_Router.GetConfig()->api.m_statusPushInterval;
+
+    const auto summary = m_Router.ExtractSummaryStatus();
+    for (auto itr = m_StatusSubs.begin(); itr != m_StatusSubs.end();)
+    {
+      auto& [conn, sub] = *itr;
+      if (sub.expiresAt <= now)
+      {
+        log::info(logcat, "Status subscription from conn {} expired", conn);
+        itr = m_StatusSubs.erase(itr);
+        continue;
+      }
+      util::StatusObject update{{"summary", summary}};
+      if (sub.full)
+      {
+        auto changes = m_Router.ExtractStatusChanges(sub.version);
+        sub.version = changes.value("version", sub.version);
+        update["changes"] = std::move(changes);
+      }
+      m_LMQ->send(conn, sub.endpoint, update.dump());
+      ++itr;
+    }
+  }
+
 }  // namespace llarp::rpc
@@ -87,6 +87,23 @@ namespace llarp::rpc
     void
     HandleLogsSubRequest(oxenmq::Message& m);
 
+    //  llarp.status_subscribe
+    //    Subscribes the connection to status updates pushed every [api]:status-push-interval
+    //    to the given endpoint.  Subscriptions expire after StatusSubscriptionTimeout unless
+    //    renewed by subscribing again.
+    //
+    //  Inputs: endpoint, optionally followed by "full"; or "unsubscribe"
+    //
+    //  Pushes: {"summary": <get_status>} and, for full subscriptions,
+    //    {"changes": {"version": <n>, "changed": {<status sections changed since the last push>}}}
+    //
+    void
+    HandleStatusSubRequest(oxenmq::Message& m);
+
+    /// push status updates to subscribers that are due for one, called from the router tick
+    void
+    Tick(llarp_time_t now);
+
     void
     AddCategories();
 
@@ -99,6 +116,10 @@ namespace llarp::rpc
     void
     invoke(GetStatus& getstatus);
     void
+    invoke(Metrics& metrics);
+    void
+    invoke(LoopProfile& loopprofile);
+    void
     invoke(QuicConnect& quicconnect);
     void
     invoke(QuicListener& quiclistener);
@@ -120,6 +141,21 @@ namespace llarp::rpc
     LMQ_ptr m_LMQ;
     AbstractRouter& m_Router;
     oxen::log::PubsubLogger log_subs;
+
+    static constexpr auto StatusSubscriptionTimeout = 30min;
+
+   private:
+    struct StatusSubscriber
+    {
+      std::string endpoint;
+      bool full;
+      llarp_time_t expiresAt;
+      /// the status version we last sent them
+      uint64_t version = 0;
+    };
+
+    std::unordered_map<oxenmq::ConnectionID, StatusSubscriber> m_StatusSubs;
+    llarp_time_t m_NextStatusPush = 0s;
   };
 
   template <typename RPC>
@@ -3,9 +3,15 @@
 
 #include <llarp/router/abstractrouter.hpp>
 #include "protocol.hpp"
+#include <llarp/util/decaying_hashtable.hpp>
 #include <llarp/util/str.hpp>
 #include <llarp/util/fs.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
 namespace llarp::service
 {
   /// maybe get auth result from string
@@ -85,17 +91,40 @@ namespace llarp::service
 
   class FileAuthPolicy : public IAuthPolicy, public std::enable_shared_from_this<FileAuthPolicy>
   {
+    /// how long we remember a token that matched a password hash
+    static constexpr auto HashCacheInterval = 10min;
+    /// how many password hashes a single worker job checks
+    static constexpr size_t HashesPerJob = 4;
+
     const std::set<fs::path> m_Files;
     const AuthFileType m_Type;
     AbstractRouter* const m_Router;
     mutable util::Mutex m_Access;
     std::unordered_set<ConvoTag> m_Pending;
-    /// returns an auth result for a auth info challange, opens every file until it finds a token
-    /// matching it
-    /// this is expected to be done in the IO thread
-    AuthResult
-    CheckFiles(const AuthInfo& info) const
+
+    /// protects the loaded whitelist below, which is only used from the IO thread
+    mutable util::Mutex m_StoreAccess;
+    /// last modification time of each file when we loaded it
+    std::map<fs::path, fs::file_time_type> m_LoadedAt GUARDED_BY(m_StoreAccess);
+    /// every token or password hash from all files
+    std::unordered_set<std::string> m_Entries GUARDED_BY(m_StoreAccess);
+    /// tokens that matched a password hash recently and the hash they matched
+    util::DecayingHashTable<std::string, std::string> m_HashCache GUARDED_BY(m_StoreAccess);
+
+    /// reload every file into memory if any of them changed since we last loaded them
+    void
+    MaybeReload() REQUIRES(m_StoreAccess)
     {
+      std::map<fs::path, fs::file_time_type> modified;
+      for (const auto& f : m_Files)
+      {
+        std::error_code ec;
+        modified[f] = fs::last_write_time(f, ec);
+      }
+      if (modified == m_LoadedAt and not m_LoadedAt.empty())
+        return;
+
+      m_Entries.clear();
       for (const auto& f : m_Files)
       {
         fs::ifstream i{f};
@@ -106,33 +135,96 @@ namespace llarp::service
           const auto parts = split_any(line, "#;", true);
           if (auto part = parts[0]; not parts.empty() and not parts[0].empty())
           {
-            // split off whitespaces and check password
-            if (CheckPasswd(std::string{TrimWhitespace(part)}, info.token))
-              return AuthResult{AuthResultCode::eAuthAccepted, "accepted by whitelist"};
+            // split off whitespaces
+            m_Entries.emplace(TrimWhitespace(part));
           }
         }
       }
-      return AuthResult{AuthResultCode::eAuthRejected, "rejected by whitelist"};
+      m_LoadedAt = std::move(modified);
+      // entries we remembered might have been removed from the files
+      m_HashCache = util::DecayingHashTable<std::string, std::string>{HashCacheInterval};
+      LogInfo("loaded ", m_Entries.size(), " auth entries from ", m_Files.size(), " files");
     }
 
-    bool
-    CheckPasswd(std::string hash, std::string challenge) const
+    /// returns an auth result for a auth info challange against the whitelist we hold in memory,
+    /// reloading it first if the files changed.
+    /// this is expected to be done in the IO thread
+    AuthResult
+    CheckFiles(const AuthInfo& info)
     {
+      util::Lock lock{m_StoreAccess};
+      MaybeReload();
+
+      bool accepted = false;
       switch (m_Type)
       {
         case AuthFileType::eAuthFilePlain:
-          return hash == challenge;
+          accepted = m_Entries.count(info.token) != 0;
+          break;
         case AuthFileType::eAuthFileHashes:
-          return CryptoManager::instance()->check_passwd_hash(
-              std::move(hash), std::move(challenge));
+          accepted = CheckHashes(info.token);
+          break;
         default:
-          return false;
+          break;
       }
+      if (accepted)
+        return AuthResult{AuthResultCode::eAuthAccepted, "accepted by whitelist"};
+      return AuthResult{AuthResultCode::eAuthRejected, "rejected by whitelist"};
+    }
+
+    /// check a token against every password hash, spreading the hashing over worker jobs
+    bool
+    CheckHashes(const std::string& token) REQUIRES(m_StoreAccess)
+    {
+      const auto now = time_now_ms();
+      m_HashCache.Decay(now);
+      if (auto maybe = m_HashCache.Get(token); maybe and m_Entries.count(*maybe))
+        return true;
+
+      const std::vector<std::string> hashes{m_Entries.begin(), m_Entries.end()};
+      std::optional<std::string> match;
+      std::atomic_bool found{false};
+      std::mutex m;
+      std::condition_variable cv;
+      size_t pending = 0;
+
+      for (size_t begin = 0; begin < hashes.size(); begin += HashesPerJob)
+      {
+        const size_t end = std::min(begin + HashesPerJob, hashes.size());
+        {
+          std::lock_guard l{m};
+          ++pending;
+        }
+        m_Router->QueueWork([&, begin, end] {
+          for (size_t idx = begin; idx < end and not found; ++idx)
+          {
+            if (CryptoManager::instance()->check_passwd_hash(hashes[idx], token))
+            {
+              std::lock_guard l{m};
+              found = true;
+              match = hashes[idx];
+            }
+          }
+          std::lock_guard l{m};
+          if (--pending == 0)
+            cv.notify_one();
+        });
+      }
+
+      std::unique_lock l{m};
+      cv.wait(l, [&pending] { return pending == 0; });
+      if (not match)
+        return false;
+      m_HashCache.Put(token, *match, now);
+      return true;
     }
 
    public:
     FileAuthPolicy(AbstractRouter* r, std::set<fs::path> files, AuthFileType filetype)
-        : m_Files{std::move(files)}, m_Type{filetype}, m_Router{r}
+        : m_Files{std::move(files)}
+        , m_Type{filetype}
+        , m_Router{r}
+        , m_HashCache{HashCacheInterval}
     {}
 
     void
@@ -14,9 +14,7 @@ namespace llarp
     static auto logcat = log::Cat("service");
     namespace
     {
-      using EndpointConstructor =
-          std::function<service::Endpoint_ptr(AbstractRouter*, service::Context*)>;
-      using EndpointConstructors = std::map<std::string, EndpointConstructor>;
+      using EndpointConstructors = std::map<std::string, Context::EndpointConstructor>;
 
       static EndpointConstructors endpointConstructors = {
           {"tun",
@@ -41,6 +39,12 @@ namespace llarp
 
     Context::~Context() = default;
 
+    void
+    Context::AddEndpointType(std::string type, EndpointConstructor ctor)
+    {
+      endpointConstructors[std::move(type)] = std::move(ctor);
+    }
+
     bool
     Context::StopAll()
     {
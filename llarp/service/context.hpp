@@ -5,6 +5,7 @@
 #include <llarp/config/config.hpp>
 #include "endpoint.hpp"
 
+#include <functional>
 #include <unordered_map>
 
 namespace llarp
@@ -16,9 +17,16 @@ namespace llarp
     ///       only supports one endpoint per instance
     struct Context
     {
+      using EndpointConstructor = std::function<Endpoint_ptr(AbstractRouter*, Context*)>;
+
       explicit Context(AbstractRouter* r);
       ~Context();
 
+      /// make endpoints for [network]:type=type with ctor from now on, for tooling that needs an
+      /// endpoint to do something lokinet itself does not
+      static void
+      AddEndpointType(std::string type, EndpointConstructor ctor);
+
       void
       Tick(llarp_time_t now);
 
@@ -8,6 +8,7 @@
 #include "protocol.hpp"
 #include "info.hpp"
 #include "protocol_type.hpp"
+#include "spare_paths.hpp"
 
 #include <llarp/net/ip.hpp>
 #include <llarp/net/ip_range.hpp>
@@ -74,6 +75,9 @@ namespace llarp
       if (conf.m_Hops.has_value())
         numHops = *conf.m_Hops;
 
+      m_SparePaths = std::make_shared<SparePaths>(this, conf.m_SparePaths);
+      m_MultipathLanes = conf.m_MultipathLanes;
+
       conf.m_ExitMap.ForEachEntry(
           [&](const IPRange& range, const service::Address& addr) { MapExitRange(range, addr); });
 
@@ -390,6 +394,17 @@ namespace llarp
         authCodes[service.ToString()] = info.token;
       }
       obj["authCodes"] = authCodes;
+      if (m_quic)
+        obj["quic"] = m_quic->ExtractStatus();
+      if (m_SparePaths)
+        obj["sparePaths"] = m_SparePaths->ExtractStatus();
+      obj["introsetCache"] = m_RemoteIntroSets.ExtractStatus();
+
+      obj["multipath"] = util::StatusObject{
+          {"lanes", uint64_t{m_MultipathLanes}},
+          {"reorderHeld", m_InboundReorder.Held()},
+          {"reorderLate", m_InboundReorder.Late()},
+          {"reorderSkipped", m_InboundReorder.Skipped()}};
 
       return m_state->ExtractStatus(obj);
     }
@@ -399,13 +414,26 @@ namespace llarp
     {
       const auto now = llarp::time_now_ms();
       path::Builder::Tick(now);
+      if (m_SparePaths)
+        m_SparePaths->Tick(now);
       // publish descriptors
       if (ShouldPublishDescriptors(now))
       {
         RegenAndPublishIntroSet();
       }
+      m_InboundReorder.ExpireLanes([this](const auto& tag) { return HasConvoTag(tag); });
       // decay introset lookup filter
       m_IntrosetLookupFilter.Decay(now);
+      // refresh the introsets of remotes we have sessions to before they go stale
+      m_RemoteIntroSets.Decay(now);
+      for (const auto& remote : m_RemoteIntroSets.NeedRefresh(now))
+      {
+        if (m_state->m_RemoteSessions.count(remote) == 0
+            or not m_RemoteIntroSets.StartLookup(remote, now))
+          continue;
+        LogInfo(Name(), " refreshing introset of ", remote);
+        SendIntroSetLookups(remote, IntroSetRefreshTimeout);
+      }
       // expire name cache
       m_state->nameCache.Decay(now);
       // expire snode sessions
@@ -457,6 +485,8 @@ namespace llarp
       // stop snode sessions
       log::debug(logcat, "Endpoint stopping snode sessions.");
       EndpointUtil::StopSnodeSessions(m_state->m_SNodeSessions);
+      if (m_SparePaths)
+        m_SparePaths->Stop();
       log::debug(logcat, "Endpoint stopping its path builder.");
       return path::Builder::Stop();
     }
@@ -737,7 +767,7 @@ namespace llarp
           r->NotifyRouterEvent<tooling::PubIntroSentEvent>(
               r->pubkey(),
               llarp::dht::Key_t{introset.derivedSigningKey.as_array()},
-              RouterID(path->hops[path->hops.size() - 1].rc.pubkey),
+              RouterID(path->hops[path->hops.size() - 1].rc->pubkey),
               published);
           if (PublishIntroSetVia(introset, r, path, published))
             published++;
@@ -841,6 +871,8 @@ namespace llarp
       };
       resetState(m_state->m_RemoteSessions, [](const auto& item) { return item.second; });
       resetState(m_state->m_SNodeSessions, [](const auto& item) { return item.second; });
+      if (m_SparePaths)
+        m_SparePaths->ResetInternalState();
     }
 
     bool
@@ -873,7 +905,7 @@ namespace llarp
       m_state->m_LastPublish = now;
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Endpoint::GetHopsForBuild()
     {
       std::unordered_set<RouterID> exclude;
@@ -883,12 +915,12 @@ namespace llarp
             return exclude.count(rc.pubkey) == 0
                 and not r->routerProfiling().IsBadForPath(rc.pubkey);
           });
-      if (not maybe.has_value())
+      if (not maybe)
         return std::nullopt;
       return GetHopsForBuildWithEndpoint(maybe->pubkey);
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Endpoint::GetHopsForBuildWithEndpoint(RouterID endpoint)
     {
       return path::Builder::GetHopsAlignedToForBuild(endpoint, SnodeBlacklist());
@@ -911,8 +943,16 @@ namespace llarp
 
       if (remoteSessions.count(addr) < MaxOutboundContextPerRemote)
       {
-        remoteSessions.emplace(addr, std::make_shared<OutboundContext>(introset, this));
+        auto ctx = std::make_shared<OutboundContext>(introset, this);
+        remoteSessions.emplace(addr, ctx);
         LogInfo("Created New outbound context for ", addr.ToString());
+        if (m_SparePaths)
+        {
+          // start on a spare path if one already ends on an intro of theirs
+          if (auto maybe = m_SparePaths->Claim(introset, Now()))
+            ctx->AdoptPath(maybe->first, maybe->second);
+          m_SparePaths->AddHints(introset);
+        }
       }
 
       auto sessionRange = remoteSessions.equal_range(addr);
@@ -947,8 +987,11 @@ namespace llarp
         {
           Router()->QueueWork([this, rc, msg]() mutable {
             bool valid = rc.Verify(llarp::time_now_ms());
-            Router()->loop()->call([this, valid, rc = std::move(rc), msg] {
-              Router()->nodedb()->PutIfNewer(rc);
+            Router()->loop()->call([this, valid, rc = std::move(rc), msg]() mutable {
+              // only keep rcs of routers we would talk to
+              valid = valid and Router()->rcLookupHandler().SessionIsAllowed(rc.pubkey);
+              if (valid)
+                Router()->nodedb()->PutIfNewer(rc);
               HandleVerifyGotRouter(msg, rc.pubkey, valid);
             });
           });
@@ -1297,7 +1340,9 @@ namespace llarp
       if (msg->proto == ProtocolType::Control)
       {
         // TODO: implement me (?)
-        // right now it's just random noise
+        // right now it's just random noise, but it takes up a sequence number we put traffic
+        // back in order by
+        m_InboundTrafficQueue.tryPushBack(std::move(msg));
         return true;
       }
       return false;
@@ -1449,6 +1494,7 @@ namespace llarp
       // tell all our existing remote sessions about this introset update
 
       const auto now = Router()->Now();
+      m_RemoteIntroSets.HandleResult(addr, introset, now);
       auto& lookups = m_state->m_PendingServiceLookups;
       if (introset)
       {
@@ -1530,6 +1576,13 @@ namespace llarp
     void
     Endpoint::InformPathToService(const Address remote, OutboundContext* ctx)
     {
+      if (m_SparePaths)
+      {
+        if (ctx)
+          m_SparePaths->SessionReady(remote, Now());
+        else
+          m_SparePaths->SessionFailed(remote);
+      }
       auto& serviceLookups = m_state->m_PendingServiceLookups;
       auto range = serviceLookups.equal_range(remote);
       auto itr = range.first;
@@ -1552,11 +1605,6 @@ namespace llarp
         return false;
       }
 
-      /// how many routers to use for lookups
-      static constexpr size_t NumParallelLookups = 2;
-      /// how many requests per router
-      static constexpr size_t RequestsPerLookup = 2;
-
       // add response hook to list for address.
       m_state->m_PendingServiceLookups.emplace(remote, hook);
 
@@ -1574,19 +1622,42 @@ namespace llarp
           ++itr;
         }
       }
+      if (m_SparePaths)
+        m_SparePaths->SessionStarted(remote, Now());
+      // start the session on the introset we already have instead of waiting on a lookup, it is
+      // refreshed in the background once it goes stale
+      if (sessions.count(remote) == 0)
+      {
+        if (const auto maybe = m_RemoteIntroSets.Get(remote, Now()))
+        {
+          PutNewOutboundContext(*maybe, timeout);
+          return true;
+        }
+      }
       /// check replay filter
       if (not m_IntrosetLookupFilter.Insert(remote))
         return true;
+      // a lookup is already under way and its result will inform us
+      if (not m_RemoteIntroSets.StartLookup(remote, Now()))
+        return true;
+
+      return SendIntroSetLookups(remote, timeout);
+    }
+
+    bool
+    Endpoint::SendIntroSetLookups(const Address& remote, llarp_time_t timeout)
+    {
+      /// how many routers to use for lookups
+      static constexpr size_t NumParallelLookups = 2;
+      /// how many requests per router
+      static constexpr size_t RequestsPerLookup = 2;
 
       const auto paths = GetManyPathsWithUniqueEndpoints(this, NumParallelLookups);
 
-      using namespace std::placeholders;
       const dht::Key_t location = remote.ToKey();
       uint64_t order = 0;
 
-      // flag to only add callback to list of callbacks for
-      // address once.
-      bool hookAdded = false;
+      bool sent = false;
 
       for (const auto& path : paths)
       {
@@ -1615,13 +1686,17 @@ namespace llarp
           order++;
           if (job->SendRequestViaPath(path, Router()))
           {
-            hookAdded = true;
+            m_RemoteIntroSets.RequestSent(remote);
+            sent = true;
           }
           else
             LogError(Name(), " send via path failed for lookup");
         }
       }
-      return hookAdded;
+      // nothing to wait on
+      if (not sent)
+        m_RemoteIntroSets.HandleResult(remote, std::nullopt, Now());
+      return sent;
     }
 
     void
@@ -1754,32 +1829,51 @@ namespace llarp
         session->FlushDownstream();
 
       // handle inbound traffic sorted
-      util::ascending_priority_queue<ProtocolMessage> queue;
+      std::vector<std::shared_ptr<ProtocolMessage>> inbound;
       while (not m_InboundTrafficQueue.empty())
       {
         // succ it out
-        queue.emplace(std::move(*m_InboundTrafficQueue.popFront()));
+        inbound.emplace_back(m_InboundTrafficQueue.popFront());
       }
-      while (not queue.empty())
-      {
-        const auto& msg = queue.top();
+      std::sort(inbound.begin(), inbound.end(), [](const auto& left, const auto& right) {
+        return left->seqno < right->seqno;
+      });
+      const auto handleInbound = [this](std::shared_ptr<ProtocolMessage> msg) {
+        // control messages only hold their place in the sequence
+        if (msg->proto == ProtocolType::Control)
+          return;
         LogDebug(
             Name(),
             " handle inbound packet on ",
-            msg.tag,
+            msg->tag,
             " ",
-            msg.payload.size(),
+            msg->payload.size(),
             " bytes seqno=",
-            msg.seqno);
-        if (HandleInboundPacket(msg.tag, msg.payload, msg.proto, msg.seqno))
+            msg->seqno);
+        if (HandleInboundPacket(msg->tag, msg->payload, msg->proto, msg->seqno))
         {
-          ConvoTagRX(msg.tag);
+          ConvoTagRX(msg->tag);
         }
         else
         {
           LogWarn("Failed to handle inbound message");
         }
-        queue.pop();
+      };
+      // a remote spreading a session over several paths gets its traffic to us out of order
+      for (auto& msg : inbound)
+      {
+        const auto tag = msg->tag;
+        const auto seqno = msg->seqno;
+        const auto from = msg->introReply.pathID;
+        m_InboundReorder.Put(tag, from, seqno, std::move(msg), now, handleInbound);
+      }
+      const bool holding = m_InboundReorder.Flush(
+          now, handleInbound, [this](const auto& tag) { return HasConvoTag(tag); });
+      // make sure we come back for what we held even if nothing else wakes us up
+      if (holding and now >= m_InboundReorderFlushAt)
+      {
+        m_InboundReorderFlushAt = now + MultipathReorderDelay;
+        Loop()->call_later(MultipathReorderDelay, [r = Router()] { r->TriggerPump(); });
       }
 
       auto router = Router();
@@ -1836,7 +1930,8 @@ namespace llarp
 
               if (path and path->IsReady())
               {
-                const auto rttEstimate = (session.replyIntro.latency + path->intro.latency) * 2;
+                const auto rttEstimate =
+                    (session.replyIntro.latency + path->metrics.Score()) * 2;
                 if (rttEstimate < rtt)
                 {
                   ret = tag;
@@ -18,6 +18,8 @@
 #include <llarp/service/protocol_type.hpp>
 #include <llarp/service/session.hpp>
 #include <llarp/service/lookup.hpp>
+#include <llarp/service/introset_cache.hpp>
+#include <llarp/service/multipath.hpp>
 #include <llarp/service/endpoint_types.hpp>
 #include <llarp/endpoint_base.hpp>
 #include <llarp/service/auth.hpp>
@@ -49,6 +51,7 @@ namespace llarp
     struct Context;
     struct EndpointState;
     struct OutboundContext;
+    struct SparePaths;
 
     /// minimum interval for publishing introsets
     inline constexpr auto IntrosetPublishInterval = path::intro_path_spread / 2;
@@ -62,6 +65,12 @@ namespace llarp
     /// number of unique snodes we want to talk to do to ons lookups
     inline constexpr size_t MIN_ENDPOINTS_FOR_LNS_LOOKUP = 2;
 
+    /// the longest we hold inbound traffic back waiting for a message sent over another path
+    inline constexpr auto MultipathReorderDelay = 100ms;
+
+    /// timeout for the lookups that refresh cached introsets in the background
+    inline constexpr auto IntroSetRefreshTimeout = 10s;
+
     struct Endpoint : public path::Builder,
                       public ILookupHolder,
                       public IDataHandler,
@@ -436,10 +445,10 @@ namespace llarp
       bool
       HasExit() const;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuildWithEndpoint(RouterID endpoint);
 
       virtual void
@@ -543,6 +552,20 @@ namespace llarp
       bool
       ReadyForNetwork() const;
 
+      /// how many paths outbound sessions spread their traffic over
+      size_t
+      MultipathLanes() const
+      {
+        return m_MultipathLanes;
+      }
+
+      /// the introsets of remotes we looked up, shared by all our sessions
+      IntroSetCache&
+      RemoteIntroSets()
+      {
+        return m_RemoteIntroSets;
+      }
+
      protected:
       bool
       ReadyToDoLookup(size_t num_paths) const;
@@ -557,6 +580,15 @@ namespace llarp
       std::shared_ptr<IAuthPolicy> m_AuthPolicy;
       std::unordered_map<Address, AuthInfo> m_RemoteAuthInfos;
       std::unique_ptr<quic::TunnelManager> m_quic;
+      /// prebuilt paths new outbound sessions can start on
+      std::shared_ptr<SparePaths> m_SparePaths;
+      /// how many paths our outbound sessions spread their traffic over
+      size_t m_MultipathLanes = 1;
+      /// puts inbound traffic of conversations that reached us over more than one path back in
+      /// order
+      InboundReorder<ConvoTag, PathID_t, std::shared_ptr<ProtocolMessage>> m_InboundReorder{
+          MultipathReorderDelay};
+      llarp_time_t m_InboundReorderFlushAt = 0s;
 
       /// (lns name, optional exit range, optional auth info) for looking up on startup
       std::unordered_map<std::string, std::pair<std::optional<IPRange>, std::optional<AuthInfo>>>
@@ -588,6 +620,13 @@ namespace llarp
 
       /// for rate limiting introset lookups
       util::DecayingHashSet<Address> m_IntrosetLookupFilter;
+
+      IntroSetCache m_RemoteIntroSets;
+
+      /// send the requests of a lookup for the introset of remote started on the introset cache,
+      /// the results go to OnLookup. return true if any request was sent.
+      bool
+      SendIntroSetLookups(const Address& remote, llarp_time_t timeout);
     };
 
     using Endpoint_ptr = std::shared_ptr<Endpoint>;
@@ -0,0 +1,144 @@
+#include "introset_cache.hpp"
+
+#include <algorithm>
+
+namespace llarp
+{
+  namespace service
+  {
+    std::optional<IntroSet>
+    IntroSetCache::Get(const Address& remote, llarp_time_t now)
+    {
+      const auto itr = m_IntroSets.find(remote);
+      if (itr == m_IntroSets.end() or itr->second.introset.IsExpired(now))
+      {
+        m_Misses++;
+        return std::nullopt;
+      }
+      m_Hits++;
+      return itr->second.introset;
+    }
+
+    bool
+    IntroSetCache::IsFresh(const Address& remote, llarp_time_t now) const
+    {
+      const auto itr = m_IntroSets.find(remote);
+      return itr != m_IntroSets.end() and now < itr->second.fetchedAt + MinRefreshInterval;
+    }
+
+    bool
+    IntroSetCache::StartLookup(const Address& remote, llarp_time_t now)
+    {
+      const auto itr = m_Pending.find(remote);
+      if (itr != m_Pending.end() and now < itr->second.startedAt + LookupTimeout)
+      {
+        m_LookupsDeduped++;
+        return false;
+      }
+      m_Pending[remote] = Lookup{now};
+      m_Lookups++;
+      return true;
+    }
+
+    void
+    IntroSetCache::RequestSent(const Address& remote)
+    {
+      if (auto itr = m_Pending.find(remote); itr != m_Pending.end())
+        itr->second.outstanding++;
+    }
+
+    void
+    IntroSetCache::HandleResult(
+        const Address& remote, const std::optional<IntroSet>& found, llarp_time_t now)
+    {
+      const bool got = found and not found->IsExpired(now);
+      if (got)
+        Put(remote, *found, now);
+
+      auto itr = m_Pending.find(remote);
+      if (itr == m_Pending.end())
+        return;
+      if (got or itr->second.outstanding <= 1)
+        m_Pending.erase(itr);
+      else
+        itr->second.outstanding--;
+    }
+
+    void
+    IntroSetCache::Put(const Address& remote, const IntroSet& introset, llarp_time_t now)
+    {
+      auto [itr, inserted] = m_IntroSets.try_emplace(remote, Entry{introset, now});
+      if (inserted)
+        return;
+      auto& entry = itr->second;
+      if (entry.introset.timestampSignedAt > introset.timestampSignedAt)
+        return;
+      if (entry.introset.timestampSignedAt < introset.timestampSignedAt
+          and not entry.introset.intros.empty())
+      {
+        const auto expiresAt = std::min_element(
+                                   entry.introset.intros.begin(),
+                                   entry.introset.intros.end(),
+                                   [](const auto& left, const auto& right) {
+                                     return left.expiresAt < right.expiresAt;
+                                   })
+                                   ->expiresAt;
+        const auto lead = expiresAt - now;
+        m_Refreshes++;
+        m_TotalRefreshLead += lead;
+        m_MinRefreshLead = std::min(m_MinRefreshLead.value_or(lead), lead);
+      }
+      entry = Entry{introset, now};
+    }
+
+    std::vector<Address>
+    IntroSetCache::NeedRefresh(llarp_time_t now) const
+    {
+      std::vector<Address> remotes;
+      for (const auto& [remote, entry] : m_IntroSets)
+      {
+        if (now < entry.fetchedAt + MinRefreshInterval or m_Pending.count(remote))
+          continue;
+        if (entry.introset.HasStaleIntros(now, RefreshLead))
+          remotes.push_back(remote);
+      }
+      return remotes;
+    }
+
+    void
+    IntroSetCache::Decay(llarp_time_t now)
+    {
+      for (auto itr = m_IntroSets.begin(); itr != m_IntroSets.end();)
+      {
+        if (itr->second.introset.IsExpired(now))
+          itr = m_IntroSets.erase(itr);
+        else
+          ++itr;
+      }
+      for (auto itr = m_Pending.begin(); itr != m_Pending.end();)
+      {
+        if (itr->second.startedAt + LookupTimeout <= now)
+          itr = m_Pending.erase(itr);
+        else
+          ++itr;
+      }
+    }
+
+    util::StatusObject
+    IntroSetCache::ExtractStatus() const
+    {
+      const auto gets = m_Hits + m_Misses;
+      return {
+          {"size", uint64_t{m_IntroSets.size()}},
+          {"hits", m_Hits},
+          {"misses", m_Misses},
+          {"hitRate", gets ? double(m_Hits) / gets : 0.},
+          {"lookups", m_Lookups},
+          {"lookupsDeduped", m_LookupsDeduped},
+          {"pendingLookups", uint64_t{m_Pending.size()}},
+          {"refreshes", m_Refreshes},
+          {"avgRefreshLead", m_Refreshes ? m_TotalRefreshLead.count() / int64_t(m_Refreshes) : 0},
+          {"minRefreshLead", m_MinRefreshLead.value_or(0s).count()}};
+    }
+  }  // namespace service
+}  // namespace llarp
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <llarp/constants/path.hpp>
+#include <llarp/util/status.hpp>
+#include "address.hpp"
+#include "intro_set.hpp"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  namespace service
+  {
+    /// the introsets of remotes we looked up, shared by every session of an endpoint.
+    /// the last good introset of a remote is served right away even when its intros are about to
+    /// expire and is refreshed in the background ahead of that. only one lookup per remote is in
+    /// flight at a time, everyone else waits on its result.
+    class IntroSetCache
+    {
+     public:
+      /// refresh an introset once one of its intros expires within this long
+      static constexpr auto RefreshLead = path::intro_path_spread;
+      /// never look up an introset again sooner than this after we got it
+      static constexpr auto MinRefreshInterval = 1min;
+      /// how long we wait on the requests of a lookup before we allow another one
+      static constexpr auto LookupTimeout = 1min;
+
+      /// get the introset of remote if we have one that did not expire
+      std::optional<IntroSet>
+      Get(const Address& remote, llarp_time_t now);
+
+      /// return true if we got the introset of remote less than the min refresh interval ago
+      bool
+      IsFresh(const Address& remote, llarp_time_t now) const;
+
+      /// start a lookup for the introset of remote, return false if one is already under way
+      bool
+      StartLookup(const Address& remote, llarp_time_t now);
+
+      /// a request of the lookup for remote was sent
+      void
+      RequestSent(const Address& remote);
+
+      /// a request of the lookup for remote came back, with the introset if it found one.
+      /// the lookup is done once we have the introset or every request came back empty.
+      void
+      HandleResult(const Address& remote, const std::optional<IntroSet>& found, llarp_time_t now);
+
+      /// get the remotes whose introsets should be refreshed now
+      std::vector<Address>
+      NeedRefresh(llarp_time_t now) const;
+
+      /// drop expired introsets and lookups that never finished
+      void
+      Decay(llarp_time_t now);
+
+      size_t
+      Size() const
+      {
+        return m_IntroSets.size();
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      struct Entry
+      {
+        IntroSet introset;
+        llarp_time_t fetchedAt;
+      };
+
+      struct Lookup
+      {
+        llarp_time_t startedAt;
+        size_t outstanding = 0;
+      };
+
+      void
+      Put(const Address& remote, const IntroSet& introset, llarp_time_t now);
+
+      std::unordered_map<Address, Entry> m_IntroSets;
+      std::unordered_map<Address, Lookup> m_Pending;
+
+      uint64_t m_Hits = 0;
+      uint64_t m_Misses = 0;
+      uint64_t m_Lookups = 0;
+      uint64_t m_LookupsDeduped = 0;
+      uint64_t m_Refreshes = 0;
+      /// how long before its first intro expired we replaced an introset, summed over refreshes
+      llarp_time_t m_TotalRefreshLead = 0s;
+      std::optional<llarp_time_t> m_MinRefreshLead;
+    };
+  }  // namespace service
+}  // namespace llarp
@@ -0,0 +1,29 @@
+#include "multipath.hpp"
+
+#include <numeric>
+
+namespace llarp
+{
+  namespace service
+  {
+    size_t
+    LaneScheduler::Next(const std::vector<double>& weights)
+    {
+      if (weights.empty())
+        return 0;
+      // start over when the set of lanes changes
+      if (m_Current.size() != weights.size())
+        m_Current.assign(weights.size(), 0);
+      const auto total = std::accumulate(weights.begin(), weights.end(), 0.);
+      size_t chosen = 0;
+      for (size_t idx = 0; idx < weights.size(); ++idx)
+      {
+        m_Current[idx] += weights[idx];
+        if (m_Current[idx] > m_Current[chosen])
+          chosen = idx;
+      }
+      m_Current[chosen] -= total;
+      return chosen;
+    }
+  }  // namespace service
+}  // namespace llarp
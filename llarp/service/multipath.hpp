@@ -0,0 +1,249 @@
+#pragma once
+
+#include <llarp/util/time.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace service
+  {
+    /// the most paths a single conversation will spread its traffic over
+    constexpr size_t MaxMultipathLanes = 4;
+
+    /// picks which of a set of weighted lanes the next frame goes out on. uses smooth weighted
+    /// round robin so frames are interleaved across lanes in proportion to their weights instead
+    /// of in bursts.
+    class LaneScheduler
+    {
+     public:
+      /// pick the next lane given the weight of every lane, the weights may change between calls
+      size_t
+      Next(const std::vector<double>& weights);
+
+     private:
+      std::vector<double> m_Current;
+    };
+
+    /// put the messages of one conversation back in order after they arrived over several paths.
+    /// until we see a message arrive out of order nothing is ever held back, after that messages
+    /// after a gap are held until the gap is filled or for at most the max delay.
+    template <typename Val_t>
+    class ReorderBuffer
+    {
+     public:
+      /// how long we keep holding messages after the last time one arrived out of order
+      static constexpr auto ReorderWindow = 10s;
+      /// the most messages we hold back before giving up on a gap
+      static constexpr size_t MaxHeld = 256;
+
+      explicit ReorderBuffer(llarp_time_t maxDelay) : m_MaxDelay{maxDelay}
+      {}
+
+      /// add a message with its sequence number, calls visit with every message that can be
+      /// delivered now in order
+      template <typename Visit_t>
+      void
+      Put(uint64_t seqno, Val_t val, llarp_time_t now, Visit_t&& visit)
+      {
+        if (not m_Next)
+          m_Next = seqno;
+        if (seqno < *m_Next)
+        {
+          // it is late, hand it over right away and start holding for a while
+          m_LastReordered = now;
+          m_Late++;
+          visit(std::move(val));
+          return;
+        }
+        if (seqno > *m_Next and now >= m_LastReordered + ReorderWindow and m_Held.empty())
+        {
+          // nothing has been reordered lately so we assume what is missing is lost
+          m_Skipped += seqno - *m_Next;
+          m_Next = seqno;
+        }
+        m_Held.emplace(seqno, std::make_pair(std::move(val), now));
+        Flush(now, visit);
+      }
+
+      /// deliver every held message that is now in order or that we waited for long enough
+      template <typename Visit_t>
+      void
+      Flush(llarp_time_t now, Visit_t&& visit)
+      {
+        // find the newest message we gave up waiting for the gap before
+        std::optional<uint64_t> giveUpTo;
+        for (const auto& [seqno, held] : m_Held)
+        {
+          if (held.second + m_MaxDelay <= now)
+            giveUpTo = seqno;
+        }
+        if (m_Held.size() > MaxHeld)
+          giveUpTo = std::max(giveUpTo.value_or(0), std::prev(m_Held.end(), MaxHeld)->first);
+
+        while (not m_Held.empty())
+        {
+          auto itr = m_Held.begin();
+          if (itr->first != *m_Next)
+          {
+            if (not giveUpTo or itr->first > *giveUpTo)
+              break;
+            m_Skipped += itr->first - *m_Next;
+            m_Next = itr->first;
+          }
+          visit(std::move(itr->second.first));
+          m_Held.erase(itr);
+          m_Next = *m_Next + 1;
+        }
+      }
+
+      size_t
+      Held() const
+      {
+        return m_Held.size();
+      }
+
+      bool
+      Empty() const
+      {
+        return m_Held.empty();
+      }
+
+      /// how many messages arrived after we moved on past them
+      uint64_t
+      Late() const
+      {
+        return m_Late;
+      }
+
+      /// how many sequence numbers we never saw before we moved on past them
+      uint64_t
+      Skipped() const
+      {
+        return m_Skipped;
+      }
+
+     private:
+      const llarp_time_t m_MaxDelay;
+      std::optional<uint64_t> m_Next;
+      llarp_time_t m_LastReordered = -ReorderWindow;
+      std::map<uint64_t, std::pair<Val_t, llarp_time_t>> m_Held;
+      uint64_t m_Late = 0;
+      uint64_t m_Skipped = 0;
+    };
+
+    /// puts the inbound traffic of every conversation that reaches us over more than one path back
+    /// in order. a conversation only gets a ReorderBuffer once one of its messages arrives over
+    /// another path than the one before, until then its traffic is handed over as it comes.
+    template <typename Tag_t, typename Lane_t, typename Val_t>
+    class InboundReorder
+    {
+     public:
+      explicit InboundReorder(llarp_time_t maxDelay) : m_MaxDelay{maxDelay}
+      {}
+
+      /// add a message of conversation tag that came over lane, calls visit with every message
+      /// of it that can be delivered now in order
+      template <typename Visit_t>
+      void
+      Put(
+          const Tag_t& tag,
+          const Lane_t& lane,
+          uint64_t seqno,
+          Val_t val,
+          llarp_time_t now,
+          Visit_t&& visit)
+      {
+        auto itr = m_Buffers.find(tag);
+        if (itr == m_Buffers.end())
+        {
+          if (auto [last, fresh] = m_Lanes.try_emplace(tag, lane); not fresh)
+          {
+            if (last->second != lane)
+              itr = m_Buffers.try_emplace(tag, m_MaxDelay).first;
+            last->second = lane;
+          }
+        }
+        if (itr == m_Buffers.end())
+          visit(std::move(val));
+        else
+          itr->second.Put(seqno, std::move(val), now, visit);
+      }
+
+      /// deliver every held message that is now in order or that we waited for long enough, and
+      /// drop the buffers that are empty of conversations keep does not want kept. returns true
+      /// if messages are still held.
+      template <typename Visit_t, typename Keep_t>
+      bool
+      Flush(llarp_time_t now, Visit_t&& visit, Keep_t&& keep)
+      {
+        bool holding = false;
+        for (auto itr = m_Buffers.begin(); itr != m_Buffers.end();)
+        {
+          itr->second.Flush(now, visit);
+          holding = holding or not itr->second.Empty();
+          if (itr->second.Empty() and not keep(itr->first))
+            itr = m_Buffers.erase(itr);
+          else
+            ++itr;
+        }
+        return holding;
+      }
+
+      /// forget the last path of the conversations keep does not want kept
+      template <typename Keep_t>
+      void
+      ExpireLanes(Keep_t&& keep)
+      {
+        for (auto itr = m_Lanes.begin(); itr != m_Lanes.end();)
+        {
+          if (keep(itr->first))
+            ++itr;
+          else
+            itr = m_Lanes.erase(itr);
+        }
+      }
+
+      /// how many messages are held over every conversation
+      uint64_t
+      Held() const
+      {
+        uint64_t held = 0;
+        for (const auto& [tag, buf] : m_Buffers)
+          held += buf.Held();
+        return held;
+      }
+
+      uint64_t
+      Late() const
+      {
+        uint64_t late = 0;
+        for (const auto& [tag, buf] : m_Buffers)
+          late += buf.Late();
+        return late;
+      }
+
+      uint64_t
+      Skipped() const
+      {
+        uint64_t skipped = 0;
+        for (const auto& [tag, buf] : m_Buffers)
+          skipped += buf.Skipped();
+        return skipped;
+      }
+
+     private:
+      const llarp_time_t m_MaxDelay;
+      /// the path each conversation last reached us over
+      std::unordered_map<Tag_t, Lane_t> m_Lanes;
+      std::unordered_map<Tag_t, ReorderBuffer<Val_t>> m_Buffers;
+    };
+  }  // namespace service
+}  // namespace llarp
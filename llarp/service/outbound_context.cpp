@@ -8,7 +8,6 @@
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/nodedb.hpp>
 #include <llarp/profiling.hpp>
-#include <llarp/util/meta/memfn.hpp>
 
 #include <random>
 #include <algorithm>
@@ -198,16 +197,7 @@ namespace llarp
     OutboundContext::HandlePathBuilt(path::Path_ptr p)
     {
       path::Builder::HandlePathBuilt(p);
-      p->SetDataHandler([self = weak_from_this()](auto path, auto frame) {
-        if (auto ptr = self.lock())
-          return ptr->HandleHiddenServiceFrame(path, frame);
-        return false;
-      });
-      p->SetDropHandler([self = weak_from_this()](auto path, auto id, auto seqno) {
-        if (auto ptr = self.lock())
-          return ptr->HandleDataDrop(path, id, seqno);
-        return false;
-      });
+      SetPathHandlers(p);
       if (markedBad)
       {
         // ignore new path if we are marked dead
@@ -221,6 +211,32 @@ namespace llarp
       }
     }
 
+    void
+    OutboundContext::SetPathHandlers(path::Path_ptr p)
+    {
+      p->SetDataHandler([self = weak_from_this()](auto path, auto frame) {
+        if (auto ptr = self.lock())
+          return ptr->HandleHiddenServiceFrame(path, frame);
+        return false;
+      });
+      p->SetDropHandler([self = weak_from_this()](auto path, auto id, auto seqno) {
+        if (auto ptr = self.lock())
+          return ptr->HandleDataDrop(path, id, seqno);
+        return false;
+      });
+    }
+
+    void
+    OutboundContext::AdoptPath(path::Path_ptr p, const Introduction& intro)
+    {
+      p->m_PathSet = GetWeak();
+      AddPath(p);
+      SetPathHandlers(p);
+      LogInfo(Name(), " adopted ", p->ShortName(), " to ", intro.router);
+      m_NextIntro = intro;
+      SwapIntros();
+    }
+
     void
     OutboundContext::AsyncGenIntro(const llarp_buffer_t& payload, ProtocolType t)
     {
@@ -286,6 +302,17 @@ namespace llarp
       const auto now = Now();
       if (updatingIntroSet or markedBad or now < m_LastIntrosetUpdateAt + IntrosetUpdateInterval)
         return;
+      auto& cache = m_Endpoint->RemoteIntroSets();
+      // a background refresh may have gotten a newer one for us already
+      if (const auto maybe = cache.Get(addr, now);
+          maybe and maybe->timestampSignedAt > currentIntroSet.timestampSignedAt)
+        OnIntroSetUpdate(addr, maybe, RouterID{}, 0s, 0);
+      // we got it just now, looking it up again would get us the same one
+      if (cache.IsFresh(addr, now))
+        return;
+      // someone else is looking it up already, the endpoint tells us what they find
+      if (not cache.StartLookup(addr, now))
+        return;
       LogInfo(Name(), " updating introset");
       m_LastIntrosetUpdateAt = now;
       // we want to use the parent endpoint's paths because outbound context
@@ -296,7 +323,11 @@ namespace llarp
       {
         HiddenServiceAddressLookup* job = new HiddenServiceAddressLookup(
             m_Endpoint,
-            util::memFn(&OutboundContext::OnIntroSetUpdate, shared_from_this()),
+            [self = shared_from_this()](
+                auto remote, auto result, auto from, auto left, auto order) {
+              self->m_Endpoint->RemoteIntroSets().HandleResult(remote, result, self->Now());
+              return self->OnIntroSetUpdate(remote, result, from, left, order);
+            },
             location,
             PubKey{addr.as_array()},
             path->Endpoint(),
@@ -305,8 +336,13 @@ namespace llarp
             (IntrosetUpdateInterval / 2) + (2 * path->intro.latency) + IntrosetLookupGraceInterval);
         relayOrder++;
         if (job->SendRequestViaPath(path, m_Endpoint->Router()))
+        {
+          cache.RequestSent(addr);
           updatingIntroSet = true;
+        }
       }
+      if (not updatingIntroSet)
+        cache.HandleResult(addr, std::nullopt, now);
     }
 
     util::StatusObject
@@ -461,7 +497,7 @@ namespace llarp
       m_ReadyHooks.push_back(hook);
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     OutboundContext::GetHopsForBuild()
     {
       if (m_NextIntro.router.IsZero())
@@ -470,9 +506,79 @@ namespace llarp
       }
       if (m_NextIntro.router.IsZero())
         return std::nullopt;
+      // once the current intro has its path build lanes to the others
+      if (const auto lane = MissingLaneIntro(Now()); lane and GetPathByRouter(m_NextIntro.router))
+        return GetHopsAlignedToForBuild(lane->router, m_Endpoint->SnodeBlacklist());
       return GetHopsAlignedToForBuild(m_NextIntro.router, m_Endpoint->SnodeBlacklist());
     }
 
+    std::optional<Introduction>
+    OutboundContext::MissingLaneIntro(llarp_time_t now) const
+    {
+      const auto lanes = m_Endpoint->MultipathLanes();
+      if (lanes <= 1)
+        return std::nullopt;
+      std::unordered_set<RouterID> pathTo;
+      ForEachPath([&pathTo](const auto& path) {
+        if (path->IsReady() or path->Status() == path::ePathBuilding)
+          pathTo.insert(path->Endpoint());
+      });
+      std::unordered_set<RouterID> covered;
+      std::optional<Introduction> missing;
+      for (const auto& intro : currentIntroSet.intros)
+      {
+        if (intro.ExpiresSoon(now) or m_Endpoint->SnodeBlacklist().count(intro.router))
+          continue;
+        if (pathTo.count(intro.router))
+          covered.insert(intro.router);
+        else if (not missing)
+          missing = intro;
+      }
+      if (covered.size() >= lanes)
+        return std::nullopt;
+      return missing;
+    }
+
+    std::pair<path::Path_ptr, Introduction>
+    OutboundContext::NextLane()
+    {
+      const auto lanes = m_Endpoint->MultipathLanes();
+      if (lanes <= 1)
+        return SendContext::NextLane();
+      const auto now = Now();
+      std::vector<std::pair<path::Path_ptr, Introduction>> candidates;
+      const auto addLane = [&](const Introduction& intro) {
+        if (candidates.size() >= lanes or intro.ExpiresSoon(now))
+          return;
+        for (const auto& lane : candidates)
+        {
+          if (lane.second.router == intro.router)
+            return;
+        }
+        if (auto path = GetPathByRouter(intro.router))
+          candidates.emplace_back(std::move(path), intro);
+      };
+      addLane(remoteIntro);
+      for (const auto& intro : currentIntroSet.intros)
+        addLane(intro);
+      if (candidates.empty())
+        return SendContext::NextLane();
+
+      std::vector<path::Path_ptr> paths;
+      for (const auto& lane : candidates)
+        paths.push_back(lane.first);
+      const auto scores = WeighingScores(paths);
+      // a session keeps about as much in flight on each path, so what a path can carry goes as
+      // the inverse of the round trip over it
+      std::vector<double> weights;
+      for (size_t idx = 0; idx < candidates.size(); ++idx)
+      {
+        const auto rtt = scores[idx] + candidates[idx].second.latency;
+        weights.push_back(1. / std::max<int64_t>(rtt.count(), 1));
+      }
+      return candidates[m_LaneScheduler.Next(weights)];
+    }
+
     bool
     OutboundContext::ShouldBuildMore(llarp_time_t now) const
     {
@@ -494,7 +600,8 @@ namespace llarp
             havePathToNextIntro = true;
         }
       });
-      return numValidPaths < numDesiredPaths or not havePathToNextIntro;
+      return numValidPaths < numDesiredPaths or not havePathToNextIntro
+          or MissingLaneIntro(now).has_value();
     }
 
     void
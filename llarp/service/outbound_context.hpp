@@ -1,6 +1,7 @@
 #pragma once
 
 #include <llarp/path/pathbuilder.hpp>
+#include "multipath.hpp"
 #include "sendcontext.hpp"
 #include <llarp/util/status.hpp>
 
@@ -89,6 +90,10 @@ namespace llarp
       void
       SendPacketToRemote(const llarp_buffer_t&, ProtocolType t) override;
 
+      /// in multipath mode spread frames over paths to several of the remote's intros
+      std::pair<path::Path_ptr, Introduction>
+      NextLane() override;
+
       bool
       ShouldBuildMore(llarp_time_t now) const override;
 
@@ -114,13 +119,18 @@ namespace llarp
       void
       HandlePathBuilt(path::Path_ptr path) override;
 
+      /// take over an established path from another path set that ends on the router of intro
+      /// and switch to intro right away
+      void
+      AdoptPath(path::Path_ptr path, const Introduction& intro);
+
       void
       HandlePathBuildTimeout(path::Path_ptr path) override;
 
       void
       HandlePathBuildFailedAt(path::Path_ptr path, RouterID hop) override;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
       bool
@@ -157,6 +167,14 @@ namespace llarp
       void
       SwapIntros();
 
+      /// route traffic arriving on a path of ours to us
+      void
+      SetPathHandlers(path::Path_ptr p);
+
+      /// in multipath mode get an intro of the remote we want another lane to but have no path to
+      std::optional<Introduction>
+      MissingLaneIntro(llarp_time_t now) const;
+
       bool
       IntroGenerated() const override;
       bool
@@ -177,6 +195,7 @@ namespace llarp
       std::vector<std::function<void(OutboundContext*)>> m_ReadyHooks;
       llarp_time_t m_LastIntrosetUpdateAt = 0s;
       llarp_time_t m_LastKeepAliveAt = 0s;
+      LaneScheduler m_LaneScheduler;
     };
   }  // namespace service
 
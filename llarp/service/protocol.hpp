@@ -31,6 +31,16 @@ namespace llarp
 
     constexpr std::size_t MAX_PROTOCOL_MESSAGE_SIZE = 2048 * 2;
 
+    /// the most a ProtocolFrame carries of its encrypted ProtocolMessage
+    constexpr std::size_t MAX_PROTOCOL_FRAME_DATA_SIZE = 2048;
+
+    /// the most the fields of a ProtocolMessage other than its payload take up bencoded
+    constexpr std::size_t MAX_PROTOCOL_MESSAGE_OVERHEAD = 384;
+
+    /// the biggest payload we can send to a hidden service in one ProtocolFrame
+    constexpr std::size_t MAX_PROTOCOL_PAYLOAD_SIZE =
+        MAX_PROTOCOL_FRAME_DATA_SIZE - MAX_PROTOCOL_MESSAGE_OVERHEAD;
+
     /// inner message
     struct ProtocolMessage
     {
@@ -73,7 +83,7 @@ namespace llarp
     /// outer message
     struct ProtocolFrame final : public routing::IMessage
     {
-      using Encrypted_t = Encrypted<2048>;
+      using Encrypted_t = Encrypted<MAX_PROTOCOL_FRAME_DATA_SIZE>;
       PQCipherBlock C;
       Encrypted_t D;
       uint64_t R;
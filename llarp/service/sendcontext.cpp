@@ -26,10 +26,17 @@ namespace llarp
 
     bool
     SendContext::Send(std::shared_ptr<ProtocolFrame> msg, path::Path_ptr path)
+    {
+      return Send(std::move(msg), std::move(path), remoteIntro.pathID);
+    }
+
+    bool
+    SendContext::Send(
+        std::shared_ptr<ProtocolFrame> msg, path::Path_ptr path, const PathID_t& remotePath)
     {
       if (path->IsReady()
           and m_SendQueue.tryPushBack(std::make_pair(
-                  std::make_shared<routing::PathTransferMessage>(*msg, remoteIntro.pathID), path))
+                  std::make_shared<routing::PathTransferMessage>(*msg, remotePath), path))
               == thread::QueueReturn::Success)
       {
         m_Endpoint->Router()->TriggerPump();
@@ -53,7 +60,7 @@ namespace llarp
           lastGoodSend = r->Now();
           flushpaths.emplace(path);
           m_Endpoint->ConvoTagTX(msg->T.T);
-          const auto rtt = (path->intro.latency + remoteIntro.latency) * 2;
+          const auto rtt = (path->metrics.Score() + remoteIntro.latency) * 2;
           rttRMS += rtt * rtt.count();
         }
       }
@@ -69,6 +76,12 @@ namespace llarp
     }
 
     /// send on an established convo tag
+    std::pair<path::Path_ptr, Introduction>
+    SendContext::NextLane()
+    {
+      return {m_PathSet->GetPathByRouter(remoteIntro.router), remoteIntro};
+    }
+
     void
     SendContext::EncryptAndSendTo(const llarp_buffer_t& payload, ProtocolType t)
     {
@@ -79,7 +92,8 @@ namespace llarp
       f->T = currentConvoTag;
       f->S = ++sequenceNo;
 
-      auto path = m_PathSet->GetPathByRouter(remoteIntro.router);
+      const auto lane = NextLane();
+      const auto& path = lane.first;
       if (!path)
       {
         ShiftIntroRouter(remoteIntro.router);
@@ -112,13 +126,13 @@ namespace llarp
       m->sender = m_Endpoint->GetIdentity().pub;
       m->tag = f->T;
       m->PutBuffer(payload);
-      m_Endpoint->Router()->QueueWork([f, m, shared, path, this] {
+      m_Endpoint->Router()->QueueWork([f, m, shared, path, to = lane.second.pathID, this] {
         if (not f->EncryptAndSign(*m, shared, m_Endpoint->GetIdentity()))
         {
           LogError(m_PathSet->Name(), " failed to sign message");
           return;
         }
-        Send(f, path);
+        Send(f, path, to);
       });
     }
 
@@ -30,6 +30,15 @@ namespace llarp
       bool
       Send(std::shared_ptr<ProtocolFrame> f, path::Path_ptr path);
 
+      /// queue send a fully encrypted hidden service frame via a path to the remote path of an
+      /// introduction other than the current one
+      bool
+      Send(std::shared_ptr<ProtocolFrame> f, path::Path_ptr path, const PathID_t& remotePath);
+
+      /// pick the path and remote introduction the next frame goes out on
+      virtual std::pair<path::Path_ptr, Introduction>
+      NextLane();
+
       /// flush upstream traffic when in router thread
       void
       FlushUpstream();
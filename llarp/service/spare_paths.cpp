@@ -0,0 +1,179 @@
+#include "spare_paths.hpp"
+#include "endpoint.hpp"
+
+#include <llarp/nodedb.hpp>
+#include <llarp/profiling.hpp>
+#include <llarp/router/abstractrouter.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace llarp
+{
+  namespace service
+  {
+    SparePaths::SparePaths(Endpoint* parent, size_t maxPaths)
+        : path::Builder{parent->Router(), 0, parent->numHops}
+        , m_Endpoint{parent}
+        , m_MaxPaths{maxPaths}
+    {}
+
+    std::string
+    SparePaths::Name() const
+    {
+      return m_Endpoint->Name() + ":spares";
+    }
+
+    void
+    SparePaths::Tick(llarp_time_t now)
+    {
+      while (not m_RecentSessions.empty() and m_RecentSessions.front() + DemandWindow < now)
+        m_RecentSessions.pop_front();
+
+      for (auto itr = m_Pending.begin(); itr != m_Pending.end();)
+      {
+        if (itr->second.startedAt + SessionTimeout < now)
+          itr = m_Pending.erase(itr);
+        else
+          ++itr;
+      }
+
+      // keep about one spare for every two new sessions we made recently, and always one so the
+      // first session after a quiet spell does not wait on a build
+      numDesiredPaths = 0;
+      if (m_MaxPaths)
+        numDesiredPaths = std::clamp<size_t>((m_RecentSessions.size() + 1) / 2, 1, m_MaxPaths);
+
+      path::Builder::Tick(now);
+    }
+
+    bool
+    SparePaths::ShouldBuildMore(llarp_time_t now) const
+    {
+      if (numDesiredPaths == 0)
+        return false;
+      // only warm spares once the endpoint itself is up
+      if (not m_Endpoint->ReadyForNetwork())
+        return false;
+      return path::Builder::ShouldBuildMore(now);
+    }
+
+    std::optional<std::vector<RouterContact_ptr>>
+    SparePaths::GetHopsForBuild()
+    {
+      std::unordered_set<RouterID> exclude;
+      ForEachPath([&exclude](const auto& path) { exclude.insert(path->Endpoint()); });
+      for (const auto& hint : m_Hints)
+      {
+        if (exclude.count(hint))
+          continue;
+        if (auto maybe = GetHopsAlignedToForBuild(hint, m_Endpoint->SnodeBlacklist()))
+          return maybe;
+      }
+      const auto maybe =
+          m_router->nodedb()->GetRandom([&exclude, r = m_router](const auto& rc) -> bool {
+            return exclude.count(rc.pubkey) == 0
+                and not r->routerProfiling().IsBadForPath(rc.pubkey);
+          });
+      if (not maybe)
+        return std::nullopt;
+      return GetHopsAlignedToForBuild(maybe->pubkey, m_Endpoint->SnodeBlacklist());
+    }
+
+    void
+    SparePaths::SessionStarted(const Address& remote, llarp_time_t now)
+    {
+      if (m_Pending.emplace(remote, PendingSession{now}).second)
+        m_RecentSessions.push_back(now);
+    }
+
+    void
+    SparePaths::SessionReady(const Address& remote, llarp_time_t now)
+    {
+      auto itr = m_Pending.find(remote);
+      if (itr == m_Pending.end())
+        return;
+      auto& latency = itr->second.spare ? m_SpareLatency : m_BuildLatency;
+      latency.sessions++;
+      latency.total += now - itr->second.startedAt;
+      m_Pending.erase(itr);
+    }
+
+    void
+    SparePaths::SessionFailed(const Address& remote)
+    {
+      m_Pending.erase(remote);
+    }
+
+    void
+    SparePaths::AddHints(const IntroSet& introset)
+    {
+      for (const auto& intro : introset.intros)
+      {
+        if (auto itr = std::find(m_Hints.begin(), m_Hints.end(), intro.router);
+            itr != m_Hints.end())
+          m_Hints.erase(itr);
+        m_Hints.push_front(intro.router);
+      }
+      while (m_Hints.size() > MaxHints)
+        m_Hints.pop_back();
+    }
+
+    std::optional<std::pair<path::Path_ptr, Introduction>>
+    SparePaths::Claim(const IntroSet& remote, llarp_time_t now)
+    {
+      path::Path_ptr chosen;
+      Introduction chosenIntro;
+      ForEachPath([&](const auto& path) {
+        if (not path->IsReady() or path->ExpiresSoon(now, path::intro_path_spread))
+          return;
+        for (const auto& intro : remote.intros)
+        {
+          if (intro.router != path->Endpoint() or intro.ExpiresSoon(now))
+            continue;
+          // prefer the introduction that lives the longest
+          if (chosen == nullptr or intro.expiresAt > chosenIntro.expiresAt)
+          {
+            chosen = path;
+            chosenIntro = intro;
+          }
+        }
+      });
+
+      if (const auto itr = m_Pending.find(remote.addressKeys.Addr()); itr != m_Pending.end())
+        itr->second.spare = chosen != nullptr;
+
+      if (chosen == nullptr)
+      {
+        m_Missed++;
+        return std::nullopt;
+      }
+      RemovePath(chosen);
+      m_Claimed++;
+      LogInfo(Name(), " handing spare ", chosen->ShortName(), " to ", remote.addressKeys.Addr());
+      return std::make_pair(chosen, chosenIntro);
+    }
+
+    util::StatusObject
+    SparePaths::Latency::ExtractStatus() const
+    {
+      return {
+          {"sessions", sessions},
+          {"avgTimeToFirstByte", sessions ? total.count() / sessions : 0}};
+    }
+
+    util::StatusObject
+    SparePaths::ExtractStatus() const
+    {
+      auto obj = path::Builder::ExtractStatus();
+      obj["maxPaths"] = uint64_t{m_MaxPaths};
+      obj["ready"] = uint64_t{AvailablePaths(path::ePathRoleAny)};
+      obj["recentSessions"] = uint64_t{m_RecentSessions.size()};
+      obj["claimed"] = m_Claimed;
+      obj["missed"] = m_Missed;
+      obj["withSpare"] = m_SpareLatency.ExtractStatus();
+      obj["withBuild"] = m_BuildLatency.ExtractStatus();
+      return obj;
+    }
+  }  // namespace service
+}  // namespace llarp
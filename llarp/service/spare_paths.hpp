@@ -0,0 +1,127 @@
+#pragma once
+
+#include <llarp/path/pathbuilder.hpp>
+#include <llarp/util/status.hpp>
+#include "address.hpp"
+#include "intro_set.hpp"
+
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
+namespace llarp
+{
+  namespace service
+  {
+    struct Endpoint;
+
+    /// pool of established client paths kept warm for outbound sessions we have not made yet.
+    /// a session can only talk to a remote over a path that ends on the router of one of the
+    /// remote's introductions, so new sessions claim a spare that ends on one of them and skip
+    /// the path build. spares end on routers remotes recently had introductions on when we know
+    /// any and on random routers otherwise, the pool grows and shrinks with how many new sessions
+    /// we have been making.
+    struct SparePaths : public path::Builder, public std::enable_shared_from_this<SparePaths>
+    {
+      /// how far back we look at new sessions when sizing the pool
+      static constexpr auto DemandWindow = 10min;
+      /// how many intro routers we remember to end spares on
+      static constexpr size_t MaxHints = 16;
+      /// forget about sessions that never became ready after this long
+      static constexpr auto SessionTimeout = 1min;
+
+      /// @param maxPaths the most spare paths we will ever keep, 0 disables the pool
+      SparePaths(Endpoint* parent, size_t maxPaths);
+
+      void
+      Tick(llarp_time_t now) override;
+
+      /// a new session to remote was asked for, counts towards demand and starts its time to
+      /// first byte clock
+      void
+      SessionStarted(const Address& remote, llarp_time_t now);
+
+      /// a session to remote is ready to send, stops its time to first byte clock
+      void
+      SessionReady(const Address& remote, llarp_time_t now);
+
+      /// the session to remote failed
+      void
+      SessionFailed(const Address& remote);
+
+      /// remember the routers of the introductions of a remote so we can end spares on them
+      void
+      AddHints(const IntroSet& introset);
+
+      /// take an established spare path that ends on one of the introductions of remote out of
+      /// the pool, returns the path and the introduction it lines up with
+      std::optional<std::pair<path::Path_ptr, Introduction>>
+      Claim(const IntroSet& remote, llarp_time_t now);
+
+      util::StatusObject
+      ExtractStatus() const;
+
+      path::PathSet_ptr
+      GetSelf() override
+      {
+        return shared_from_this();
+      }
+
+      std::weak_ptr<path::PathSet>
+      GetWeak() override
+      {
+        return weak_from_this();
+      }
+
+      std::string
+      Name() const override;
+
+      bool
+      ShouldBundleRC() const override
+      {
+        return false;
+      }
+
+      void
+      BlacklistSNode(const RouterID) override{};
+
+      void
+      SendPacketToRemote(const llarp_buffer_t&, ProtocolType) override{};
+
+      bool
+      ShouldBuildMore(llarp_time_t now) const override;
+
+      std::optional<std::vector<RouterContact_ptr>>
+      GetHopsForBuild() override;
+
+     private:
+      struct PendingSession
+      {
+        llarp_time_t startedAt;
+        bool spare = false;
+      };
+
+      struct Latency
+      {
+        uint64_t sessions = 0;
+        llarp_time_t total = 0s;
+
+        util::StatusObject
+        ExtractStatus() const;
+      };
+
+      Endpoint* const m_Endpoint;
+      const size_t m_MaxPaths;
+
+      std::deque<llarp_time_t> m_RecentSessions;
+      /// most recent first
+      std::deque<RouterID> m_Hints;
+      std::unordered_map<Address, PendingSession> m_Pending;
+
+      uint64_t m_Claimed = 0;
+      uint64_t m_Missed = 0;
+      Latency m_SpareLatency;
+      Latency m_BuildLatency;
+    };
+  }  // namespace service
+}  // namespace llarp
@@ -28,7 +28,7 @@ namespace tooling
       {
         i++;
 
-        result += llarp::RouterID(hop.rc.pubkey).ShortString();
+        result += llarp::RouterID(hop.rc->pubkey).ShortString();
         result += "]";
 
         if (i != hops.size())
@@ -1,7 +1,61 @@
 #include "bencode.hpp"
+#include <algorithm>
+#include <charconv>
 #include <cstdlib>
 #include <cinttypes>
 #include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace
+{
+  /// the value of the decimal number that is all of [begin, end), or nothing if that is empty,
+  /// longer than max_digits or has anything but digits in it.  this is the fast path for the
+  /// numbers every message is full of; anything odd goes to the libc parsing we had before so
+  /// that its quirks are kept.
+  std::optional<uint64_t>
+  parse_digits(const byte_t* begin, const byte_t* end, size_t max_digits)
+  {
+    if (begin == end or static_cast<size_t>(end - begin) > max_digits)
+      return std::nullopt;
+    uint64_t val = 0;
+    for (; begin != end; ++begin)
+    {
+      if (*begin < '0' or *begin > '9')
+        return std::nullopt;
+      val = val * 10 + (*begin - '0');
+    }
+    return val;
+  }
+
+  /// find delim within the first n bytes at buf's cursor
+  const byte_t*
+  find_within(const llarp_buffer_t* buf, char delim, size_t n)
+  {
+    return static_cast<const byte_t*>(
+        std::memchr(buf->cur, delim, std::min(n, buf->size_left())));
+  }
+
+  /// write prefix, the decimal digits of i and then suffix, or nothing at all if that does not
+  /// fit.  this formats straight into the buffer, which snprintf cannot do without a format
+  /// string parse and a terminator we then have to step back over.
+  bool
+  write_number(llarp_buffer_t* buff, std::string_view prefix, uint64_t i, std::string_view suffix)
+  {
+    char digits[20];
+    const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), i);
+    if (ec != std::errc{})
+      return false;
+    const size_t ndigits = end - digits;
+    if (buff->size_left() < prefix.size() + ndigits + suffix.size())
+      return false;
+    buff->cur = std::copy(prefix.begin(), prefix.end(), buff->cur);
+    buff->cur = std::copy(std::begin(digits), end, buff->cur);
+    buff->cur = std::copy(suffix.begin(), suffix.end(), buff->cur);
+    return true;
+  }
+}  // namespace
 
 bool
 bencode_read_integer(struct llarp_buffer_t* buffer, uint64_t* result)
@@ -10,9 +64,20 @@ bencode_read_integer(struct llarp_buffer_t* buffer, uint64_t* result)
   if (*buffer->cur != 'i')
     return false;
 
-  char numbuf[32];
-
   buffer->cur++;
+  // 19 digits always fit in 64 bits so we do not have to care about strtoull's saturation
+  if (const auto* delim = find_within(buffer, 'e', 20))
+  {
+    if (const auto val = parse_digits(buffer->cur, delim, 19))
+    {
+      if (result)
+        *result = *val;
+      buffer->cur = const_cast<byte_t*>(delim) + 1;
+      return true;
+    }
+  }
+
+  char numbuf[32];
 
   len = buffer->read_until('e', (byte_t*)numbuf, sizeof(numbuf) - 1);
   if (!len)
@@ -31,6 +96,24 @@ bencode_read_integer(struct llarp_buffer_t* buffer, uint64_t* result)
 bool
 bencode_read_string(llarp_buffer_t* buffer, llarp_buffer_t* result)
 {
+  if (const auto* delim = find_within(buffer, ':', 10))
+  {
+    if (const auto slen = parse_digits(buffer->cur, delim, 9))
+    {
+      const auto* str = delim + 1;
+      if (static_cast<size_t>(buffer->base + buffer->sz - str) < *slen)
+        return false;
+      if (result)
+      {
+        result->base = const_cast<byte_t*>(str);
+        result->cur = result->base;
+        result->sz = *slen;
+      }
+      buffer->cur = const_cast<byte_t*>(str) + *slen;
+      return true;
+    }
+  }
+
   char numbuf[10];
 
   size_t len = buffer->read_until(':', (byte_t*)numbuf, sizeof(numbuf) - 1);
@@ -66,7 +149,7 @@ bencode_read_string(llarp_buffer_t* buffer, llarp_buffer_t* result)
 bool
 bencode_write_bytestring(llarp_buffer_t* buff, const void* data, size_t sz)
 {
-  if (!buff->writef("%zu:", sz))
+  if (!write_number(buff, "", sz, ":"))
   {
     return false;
   }
@@ -76,14 +159,7 @@ bencode_write_bytestring(llarp_buffer_t* buff, const void* data, size_t sz)
 bool
 bencode_write_uint64(llarp_buffer_t* buff, uint64_t i)
 {
-  if (!buff->writef("i%" PRIu64, i))
-  {
-    return false;
-  }
-
-  static const char letter[1] = {'e'};
-  assert(std::distance(std::begin(letter), std::end(letter)) == 1);
-  return buff->write(std::begin(letter), std::end(letter));
+  return write_number(buff, "i", i, "e");
 }
 
 bool
@@ -161,3 +237,29 @@ bencode_end(llarp_buffer_t* buff)
   assert(std::distance(std::begin(letter), std::end(letter)) == 1);
   return buff->write(std::begin(letter), std::end(letter));
 }
+
+namespace llarp
+{
+  bool
+  BEncodeMaybeReadDictView(
+      const char* k,
+      byte_view_t& view,
+      size_t maxsz,
+      bool& read,
+      const llarp_buffer_t& key,
+      llarp_buffer_t* buf)
+  {
+    if (key.startswith(k))
+    {
+      llarp_buffer_t strbuf;
+      if (not bencode_read_string(buf, &strbuf) or strbuf.sz > maxsz)
+      {
+        llarp::LogWarn("failed to decode key ", k, " for entry in dict");
+        return false;
+      }
+      view = strbuf.view_all();
+      read = true;
+    }
+    return true;
+  }
+}  // namespace llarp
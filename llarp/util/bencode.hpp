@@ -103,6 +103,17 @@ namespace llarp
     return true;
   }
 
+  /// read the string value of key k in place: view points into what buf reads from, nothing is
+  /// copied, so it is only good for as long as that is. fails on values longer than maxsz.
+  bool
+  BEncodeMaybeReadDictView(
+      const char* k,
+      byte_view_t& view,
+      size_t maxsz,
+      bool& read,
+      const llarp_buffer_t& key,
+      llarp_buffer_t* buf);
+
   /// If the key matches, reads in the version and ensures that it equals the
   /// expected version
   template <typename Item_t>
@@ -332,6 +343,23 @@ namespace llarp
     }
   }
 
+  /// bencode t into pkt, which is made maxsz big, what t may take up at most, and then cut to what
+  /// was written.  pkt is empty if t took more.
+  template <typename T>
+  bool
+  BEncodeToSize(const T& t, std::vector<byte_t>& pkt, size_t maxsz)
+  {
+    pkt.resize(maxsz);
+    llarp_buffer_t buf{pkt};
+    if (not t.BEncode(&buf))
+    {
+      pkt.clear();
+      return false;
+    }
+    pkt.resize(buf.cur - buf.base);
+    return true;
+  }
+
   /// read entire file and decode its contents into t
   template <typename T>
   bool
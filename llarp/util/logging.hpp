@@ -130,3 +130,22 @@ namespace llarp
   LogError(T&&...) -> LogError<T...>;
 
 }  // namespace llarp
+
+// Trace and debug logging for per packet paths. Below the level the build compiles in (see
+// HOT_PATH_LOG_LEVEL in cmake, info for release builds) these are nothing at all: no level
+// check, no source location and none of the arguments get evaluated.
+#ifndef LOKINET_HOT_LOG_LEVEL
+#define LOKINET_HOT_LOG_LEVEL 0
+#endif
+
+#if LOKINET_HOT_LOG_LEVEL <= 0
+#define LogTraceHot(...) (::llarp::LogTrace{__VA_ARGS__})
+#else
+#define LogTraceHot(...) ((void)0)
+#endif
+
+#if LOKINET_HOT_LOG_LEVEL <= 1
+#define LogDebugHot(...) (::llarp::LogDebug{__VA_ARGS__})
+#else
+#define LogDebugHot(...) ((void)0)
+#endif
@@ -0,0 +1,93 @@
+#include "async_sink.hpp"
+
+#include <fmt/core.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+namespace llarp::logging
+{
+  AsyncSink::AsyncSink(std::shared_ptr<spdlog::sinks::sink> sink, size_t capacity)
+      : m_Sink{std::move(sink)}, m_Queue{capacity}, m_Thread{[this]() { run(); }}
+  {}
+
+  AsyncSink::~AsyncSink()
+  {
+    m_Stop = true;
+    m_Thread.join();
+  }
+
+  void
+  AsyncSink::log(const spdlog::details::log_msg& msg)
+  {
+    // copies the payload, formatting is left to the writer thread
+    if (m_Queue.tryPushBack(spdlog::details::log_msg_buffer{msg}) != thread::QueueReturn::Success)
+      m_Dropped++;
+  }
+
+  void
+  AsyncSink::flush()
+  {
+    m_FlushWanted = true;
+  }
+
+  void
+  AsyncSink::set_pattern(const std::string& pattern)
+  {
+    m_Sink->set_pattern(pattern);
+  }
+
+  void
+  AsyncSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter)
+  {
+    m_Sink->set_formatter(std::move(formatter));
+  }
+
+  void
+  AsyncSink::run()
+  {
+    uint64_t reported = 0;
+    while (true)
+    {
+      if (auto msg = m_Queue.popFrontWithTimeout(std::chrono::milliseconds{100}))
+      {
+        m_Sink->log(*msg);
+        continue;
+      }
+      // caught up, now is a good time to say what we lost and to flush
+      if (const uint64_t dropped = m_Dropped; dropped != reported)
+      {
+        const auto note = fmt::format(
+            "dropped {} log messages, logging could not keep up", dropped - reported);
+        m_Sink->log(spdlog::details::log_msg{"", spdlog::level::warn, note});
+        reported = dropped;
+      }
+      if (m_FlushWanted.exchange(false))
+        m_Sink->flush();
+      if (m_Stop)
+        break;
+    }
+    m_Sink->flush();
+  }
+
+  std::shared_ptr<spdlog::sinks::sink>
+  make_sink(log::Type type, const std::string& file)
+  {
+    if (type == log::Type::Print)
+    {
+      if (file == "stderr")
+        return std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+      return std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    }
+    if (type == log::Type::File)
+      return std::make_shared<spdlog::sinks::basic_file_sink_mt>(file);
+    return nullptr;
+  }
+
+  std::shared_ptr<spdlog::sinks::sink>
+  maybe_async(std::shared_ptr<spdlog::sinks::sink> sink, bool async)
+  {
+    if (not async or sink == nullptr)
+      return sink;
+    return std::make_shared<AsyncSink>(std::move(sink));
+  }
+}  // namespace llarp::logging
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <llarp/util/logging.hpp>
+#include <llarp/util/thread/queue.hpp>
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace llarp::logging
+{
+  // Sink that hands log messages to another sink on a thread of its own, so whoever logs (usually
+  // the event loop) never waits on the terminal or the disk.  Messages go through a fixed size
+  // lock free queue; when that is full they are dropped and counted rather than blocking, and the
+  // writer thread notes how many it lost once it catches up.  Flushing is also done by the writer
+  // thread once it drained the queue, the only call that waits for it is the destructor.
+  class AsyncSink : public spdlog::sinks::sink
+  {
+   public:
+    static constexpr size_t DefaultCapacity = 8192;
+
+    explicit AsyncSink(
+        std::shared_ptr<spdlog::sinks::sink> sink, size_t capacity = DefaultCapacity);
+
+    ~AsyncSink() override;
+
+    void
+    log(const spdlog::details::log_msg& msg) override;
+
+    void
+    flush() override;
+
+    void
+    set_pattern(const std::string& pattern) override;
+
+    void
+    set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+    // How many messages we dropped because the queue was full
+    uint64_t
+    dropped() const
+    {
+      return m_Dropped;
+    }
+
+   private:
+    void
+    run();
+
+    const std::shared_ptr<spdlog::sinks::sink> m_Sink;
+    thread::Queue<spdlog::details::log_msg_buffer> m_Queue;
+    std::atomic<uint64_t> m_Dropped = 0;
+    std::atomic<bool> m_FlushWanted = false;
+    std::atomic<bool> m_Stop = false;
+    std::thread m_Thread;
+  };
+
+  // Makes the sink oxen-logging would make for a print or file log type.  Returns nullptr for log
+  // types only oxen-logging can make (i.e. the system logger).
+  std::shared_ptr<spdlog::sinks::sink>
+  make_sink(log::Type type, const std::string& file);
+
+  // Wraps sink, whatever it writes to, in an AsyncSink if async is set and returns it as is
+  // otherwise.
+  std::shared_ptr<spdlog::sinks::sink>
+  maybe_async(std::shared_ptr<spdlog::sinks::sink> sink, bool async);
+
+}  // namespace llarp::logging
@@ -0,0 +1,197 @@
+#include "metrics.hpp"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace llarp::metrics
+{
+  Metric::Metric(std::string name, std::string help)
+      : m_Name{std::move(name)}, m_Help{std::move(help)}
+  {}
+
+  void
+  Metric::FormatHeader(std::string& out, std::string_view type) const
+  {
+    fmt::format_to(
+        std::back_inserter(out), "# HELP {0} {1}\n# TYPE {0} {2}\n", m_Name, m_Help, type);
+  }
+
+  uint64_t
+  Counter::Value() const
+  {
+    uint64_t total = 0;
+    for (const auto& shard : m_Shards)
+      total += shard.value.load(std::memory_order_relaxed);
+    return total;
+  }
+
+  void
+  Counter::Format(std::string& out) const
+  {
+    FormatHeader(out, "counter");
+    fmt::format_to(std::back_inserter(out), "{} {}\n", m_Name, Value());
+  }
+
+  void
+  Gauge::Format(std::string& out) const
+  {
+    FormatHeader(out, "gauge");
+    fmt::format_to(std::back_inserter(out), "{} {}\n", m_Name, Value());
+  }
+
+  uint64_t
+  Histogram::UpperBound(size_t bucket)
+  {
+    if (bucket < SubBuckets)
+      return bucket;
+    if (bucket >= OverflowBucket)
+      return std::numeric_limits<uint64_t>::max();
+    const size_t power = bucket / SubBuckets + SubBucketBits - 1;
+    const size_t sub = bucket % SubBuckets;
+    return ((SubBuckets + sub + 1) << (power - SubBucketBits)) - 1;
+  }
+
+  std::array<uint64_t, Histogram::Buckets>
+  Histogram::Merged() const
+  {
+    std::array<uint64_t, Buckets> merged{};
+    for (const auto& shard : m_Shards)
+    {
+      for (size_t idx = 0; idx < Buckets; ++idx)
+        merged[idx] += shard.buckets[idx].load(std::memory_order_relaxed);
+    }
+    return merged;
+  }
+
+  uint64_t
+  Histogram::Count() const
+  {
+    uint64_t total = 0;
+    for (const auto count : Merged())
+      total += count;
+    return total;
+  }
+
+  std::chrono::microseconds
+  Histogram::Sum() const
+  {
+    uint64_t total = 0;
+    for (const auto& shard : m_Shards)
+      total += shard.sum.load(std::memory_order_relaxed);
+    return std::chrono::microseconds{total};
+  }
+
+  std::chrono::microseconds
+  Histogram::Quantile(double q) const
+  {
+    const auto merged = Merged();
+    uint64_t count = 0;
+    for (const auto n : merged)
+      count += n;
+    if (count == 0)
+      return std::chrono::microseconds{0};
+    const auto target =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count)));
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < OverflowBucket; ++idx)
+    {
+      seen += merged[idx];
+      if (seen >= target)
+        return std::chrono::microseconds{UpperBound(idx)};
+    }
+    return std::chrono::microseconds{uint64_t{1} << MaxPower};
+  }
+
+  void
+  Histogram::Format(std::string& out) const
+  {
+    FormatHeader(out, "histogram");
+    const auto merged = Merged();
+    // the sub buckets are too fine for a scrape, so we only export the power of two boundaries
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < OverflowBucket; ++idx)
+    {
+      seen += merged[idx];
+      if (idx % SubBuckets != SubBuckets - 1)
+        continue;
+      fmt::format_to(
+          std::back_inserter(out),
+          "{}_bucket{{le=\"{}\"}} {}\n",
+          m_Name,
+          UpperBound(idx) / 1e6,
+          seen);
+    }
+    seen += merged[OverflowBucket];
+    const std::chrono::duration<double> sum = Sum();
+    fmt::format_to(
+        std::back_inserter(out),
+        "{0}_bucket{{le=\"+Inf\"}} {1}\n{0}_sum {2}\n{0}_count {1}\n",
+        m_Name,
+        seen,
+        sum.count());
+  }
+
+  template <typename T>
+  T&
+  Registry::Get(std::string_view name, std::string_view help)
+  {
+    std::lock_guard lock{m_Access};
+    auto itr = m_Metrics.find(name);
+    if (itr == m_Metrics.end())
+      itr = m_Metrics.emplace(name, std::make_unique<T>(std::string{name}, std::string{help}))
+                .first;
+    auto* metric = dynamic_cast<T*>(itr->second.get());
+    if (not metric)
+      throw std::logic_error{fmt::format("metric {} is already registered as another type", name)};
+    return *metric;
+  }
+
+  Counter&
+  Registry::GetCounter(std::string_view name, std::string_view help)
+  {
+    return Get<Counter>(name, help);
+  }
+
+  Gauge&
+  Registry::GetGauge(std::string_view name, std::string_view help)
+  {
+    return Get<Gauge>(name, help);
+  }
+
+  Histogram&
+  Registry::GetHistogram(std::string_view name, std::string_view help)
+  {
+    return Get<Histogram>(name, help);
+  }
+
+  std::string
+  Registry::Prometheus() const
+  {
+    std::string out;
+    std::lock_guard lock{m_Access};
+    for (const auto& [name, metric] : m_Metrics)
+      metric->Format(out);
+    m_LastScrape = std::chrono::steady_clock::now().time_since_epoch().count();
+    timers_enabled = true;
+    return out;
+  }
+
+  void
+  Registry::Tick(std::chrono::steady_clock::time_point now)
+  {
+    const std::chrono::steady_clock::time_point scraped{
+        std::chrono::steady_clock::duration{m_LastScrape.load()}};
+    if (timers_enabled and now - scraped >= ScrapeIdle)
+      timers_enabled = false;
+  }
+
+  Registry&
+  registry()
+  {
+    static Registry reg;
+    return reg;
+  }
+}  // namespace llarp::metrics
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace llarp::metrics
+{
+  /// how many ways counters and histograms are split, so that threads updating the same metric
+  /// do not fight over a cache line
+  inline constexpr size_t Shards = 16;
+
+  /// the shard the calling thread updates, threads are handed shards round robin
+  inline size_t
+  ThisShard()
+  {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t shard = next++ % Shards;
+    return shard;
+  }
+
+  /// base of everything in the registry
+  class Metric
+  {
+   public:
+    Metric(std::string name, std::string help);
+
+    virtual ~Metric() = default;
+
+    const std::string&
+    Name() const
+    {
+      return m_Name;
+    }
+
+    /// append this metric in the prometheus text exposition format
+    virtual void
+    Format(std::string& out) const = 0;
+
+   protected:
+    void
+    FormatHeader(std::string& out, std::string_view type) const;
+
+    const std::string m_Name;
+    const std::string m_Help;
+  };
+
+  /// a monotonically increasing count
+  class Counter : public Metric
+  {
+   public:
+    using Metric::Metric;
+
+    void
+    Add(uint64_t n = 1)
+    {
+      m_Shards[ThisShard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t
+    Value() const;
+
+    void
+    Format(std::string& out) const override;
+
+   private:
+    struct alignas(64) Shard
+    {
+      std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, Shards> m_Shards;
+  };
+
+  /// a value that goes up and down
+  class Gauge : public Metric
+  {
+   public:
+    using Metric::Metric;
+
+    void
+    Set(int64_t val)
+    {
+      m_Value.store(val, std::memory_order_relaxed);
+    }
+
+    void
+    Add(int64_t n)
+    {
+      m_Value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    int64_t
+    Value() const
+    {
+      return m_Value.load(std::memory_order_relaxed);
+    }
+
+    void
+    Format(std::string& out) const override;
+
+   private:
+    std::atomic<int64_t> m_Value{0};
+  };
+
+  /// a histogram of durations with log linear buckets, like an HDR histogram: every power of two
+  /// microseconds is split into SubBuckets linear buckets, so any recorded value is known to
+  /// within 25% no matter how large it is.
+  class Histogram : public Metric
+  {
+   public:
+    using Metric::Metric;
+
+    static constexpr size_t SubBucketBits = 2;
+    static constexpr size_t SubBuckets = 1 << SubBucketBits;
+    /// values from 2^MaxPower microseconds (about 36 minutes) up all go in the last bucket
+    static constexpr size_t MaxPower = 31;
+    static constexpr size_t OverflowBucket = SubBuckets * (MaxPower - SubBucketBits + 1);
+    static constexpr size_t Buckets = OverflowBucket + 1;
+
+    /// count val weight times, for values that stand in for weight samples
+    void
+    Observe(std::chrono::microseconds val, uint64_t weight = 1)
+    {
+      const auto usec = static_cast<uint64_t>(std::max<int64_t>(val.count(), 0));
+      auto& shard = m_Shards[ThisShard()];
+      shard.buckets[BucketFor(usec)].fetch_add(weight, std::memory_order_relaxed);
+      shard.sum.fetch_add(usec * weight, std::memory_order_relaxed);
+    }
+
+    template <typename Rep, typename Period>
+    void
+    Observe(std::chrono::duration<Rep, Period> val, uint64_t weight = 1)
+    {
+      Observe(std::chrono::duration_cast<std::chrono::microseconds>(val), weight);
+    }
+
+    uint64_t
+    Count() const;
+
+    std::chrono::microseconds
+    Sum() const;
+
+    /// the value at quantile q (0 to 1), to the precision of a bucket
+    std::chrono::microseconds
+    Quantile(double q) const;
+
+    void
+    Format(std::string& out) const override;
+
+    /// the bucket a value of usec microseconds is counted in
+    static size_t
+    BucketFor(uint64_t usec)
+    {
+      if (usec < SubBuckets)
+        return usec;
+      const size_t power = 63 - __builtin_clzll(usec);
+      if (power >= MaxPower)
+        return OverflowBucket;
+      const size_t sub = (usec >> (power - SubBucketBits)) & (SubBuckets - 1);
+      return SubBuckets * (power - SubBucketBits + 1) + sub;
+    }
+
+    /// the largest value in microseconds counted in bucket
+    static uint64_t
+    UpperBound(size_t bucket);
+
+   private:
+    std::array<uint64_t, Buckets>
+    Merged() const;
+
+    struct alignas(64) Shard
+    {
+      std::array<std::atomic<uint64_t>, Buckets> buckets{};
+      std::atomic<uint64_t> sum{0};
+    };
+    std::array<Shard, Shards> m_Shards;
+  };
+
+  /// set while the registry is being scraped, see Registry::Tick. timers measure nothing when
+  /// it is not, so the hot paths they sit on do not read the clock for nobody.
+  inline std::atomic<bool> timers_enabled{false};
+
+  /// records the time from construction to destruction in a histogram.
+  /// only one in SampleEvery timers on a thread reads the clock, it is counted SampleEvery times.
+  class Timer
+  {
+   public:
+    static constexpr uint64_t SampleEvery = 8;
+
+    explicit Timer(Histogram& hist) : m_Hist{hist}
+    {
+      if (timers_enabled.load(std::memory_order_relaxed) and Sampled())
+        m_Start = std::chrono::steady_clock::now();
+    }
+
+    ~Timer()
+    {
+      if (m_Start)
+        m_Hist.Observe(std::chrono::steady_clock::now() - *m_Start, SampleEvery);
+    }
+
+    Timer(const Timer&) = delete;
+    Timer&
+    operator=(const Timer&) = delete;
+
+    /// true for one in SampleEvery calls on this thread, for timings taken apart from a Timer
+    static bool
+    Sampled()
+    {
+      thread_local uint64_t count = 0;
+      return count++ % SampleEvery == 0;
+    }
+
+   private:
+    Histogram& m_Hist;
+    std::optional<std::chrono::steady_clock::time_point> m_Start;
+  };
+
+  /// holds every metric we have by name.  only making a metric takes a lock, so hot paths should
+  /// look their metrics up once (e.g. into a function local static) and hold on to the reference.
+  class Registry
+  {
+   public:
+    /// get the counter called name, making it if we do not have it yet.
+    /// throws std::logic_error if name is already taken by a different kind of metric.
+    Counter&
+    GetCounter(std::string_view name, std::string_view help);
+
+    Gauge&
+    GetGauge(std::string_view name, std::string_view help);
+
+    Histogram&
+    GetHistogram(std::string_view name, std::string_view help);
+
+    /// every metric in the prometheus text exposition format, turns timers on until we have not
+    /// been scraped for ScrapeIdle
+    std::string
+    Prometheus() const;
+
+    static constexpr auto ScrapeIdle = std::chrono::minutes{5};
+
+    /// turn timers off if nobody scraped us for ScrapeIdle, called from the router tick
+    void
+    Tick(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+   private:
+    template <typename T>
+    T&
+    Get(std::string_view name, std::string_view help);
+
+    mutable std::mutex m_Access;
+    mutable std::atomic<std::chrono::steady_clock::rep> m_LastScrape{0};
+    std::map<std::string, std::unique_ptr<Metric>, std::less<>> m_Metrics;
+  };
+
+  /// the process wide registry
+  Registry&
+  registry();
+}  // namespace llarp::metrics
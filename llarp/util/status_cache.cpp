@@ -0,0 +1,177 @@
+#include "status_cache.hpp"
+
+#include <algorithm>
+
+namespace llarp::util
+{
+  StatusCache::StatusCache(std::unordered_set<std::string> volatileFields)
+      : m_Volatile{std::move(volatileFields)}
+  {}
+
+  void
+  StatusCache::Add(std::string name, Generator gen, llarp_time_t maxAge)
+  {
+    m_Sections.push_back(Section{std::move(name), std::move(gen), maxAge});
+  }
+
+  bool
+  StatusCache::Same(const StatusObject& left, const StatusObject& right) const
+  {
+    if (m_Volatile.empty() or left.type() != right.type())
+      return left == right;
+    if (left.is_array())
+    {
+      return left.size() == right.size()
+          and std::equal(left.begin(), left.end(), right.begin(), [this](auto& l, auto& r) {
+                return Same(l, r);
+              });
+    }
+    if (not left.is_object())
+      return left == right;
+    const auto covered = [this](const StatusObject& obj, const StatusObject& other) {
+      for (const auto& [key, val] : obj.items())
+      {
+        if (not m_Volatile.count(key) and not other.contains(key))
+          return false;
+      }
+      return true;
+    };
+    if (not covered(left, right) or not covered(right, left))
+      return false;
+    for (const auto& [key, val] : left.items())
+    {
+      if (not m_Volatile.count(key) and not Same(val, right.at(key)))
+        return false;
+    }
+    return true;
+  }
+
+  void
+  StatusCache::Generate(Section& section, llarp_time_t now)
+  {
+    auto value = section.gen();
+    section.generatedAt = now;
+    if (value.is_object() and section.value.is_object())
+    {
+      const auto version = m_Version + 1;
+      bool changed = false;
+      for (const auto& [key, val] : value.items())
+      {
+        if (m_Volatile.count(key))
+          continue;
+        if (auto itr = section.value.find(key); itr != section.value.end() and Same(*itr, val))
+          continue;
+        section.fieldVersions[key] = version;
+        changed = true;
+      }
+      for (const auto& [key, val] : section.value.items())
+      {
+        if (not m_Volatile.count(key) and not value.contains(key))
+        {
+          section.fieldVersions[key] = version;
+          changed = true;
+        }
+      }
+      if (changed)
+        section.version = ++m_Version;
+    }
+    else if (not Same(value, section.value))
+    {
+      section.version = ++m_Version;
+      section.fieldVersions.clear();
+      if (value.is_object())
+      {
+        for (const auto& [key, val] : value.items())
+          section.fieldVersions[key] = section.version;
+      }
+    }
+    // the snapshot is the fresh one even if only volatile fields changed
+    section.value = std::move(value);
+  }
+
+  void
+  StatusCache::Refresh(llarp_time_t now, std::chrono::microseconds budget)
+  {
+    std::vector<Section*> due;
+    for (auto& section : m_Sections)
+    {
+      if (section.generatedAt and section.readAt > *section.generatedAt
+          and now >= *section.generatedAt + section.maxAge)
+        due.push_back(&section);
+    }
+    std::sort(due.begin(), due.end(), [](const auto* left, const auto* right) {
+      return left->generatedAt < right->generatedAt;
+    });
+    const auto started = std::chrono::steady_clock::now();
+    for (auto* section : due)
+    {
+      Generate(*section, now);
+      const auto spent = std::chrono::steady_clock::now() - started;
+      if (std::chrono::duration_cast<std::chrono::microseconds>(spent) >= budget)
+        break;
+    }
+  }
+
+  StatusCache::Section&
+  StatusCache::Read(Section& section, llarp_time_t now)
+  {
+    if (not section.generatedAt)
+      Generate(section, now);
+    section.readAt = now;
+    return section;
+  }
+
+  const StatusObject&
+  StatusCache::Get(std::string_view name, llarp_time_t now)
+  {
+    static const StatusObject none{};
+    for (auto& section : m_Sections)
+    {
+      if (section.name == name)
+        return Read(section, now).value;
+    }
+    return none;
+  }
+
+  StatusObject
+  StatusCache::Collect(llarp_time_t now)
+  {
+    StatusObject obj = StatusObject::object();
+    for (auto& section : m_Sections)
+      obj[section.name] = Read(section, now).value;
+    return obj;
+  }
+
+  StatusObject
+  StatusCache::ChangedSince(uint64_t since, llarp_time_t now)
+  {
+    StatusObject obj = StatusObject::object();
+    for (auto& section : m_Sections)
+    {
+      Read(section, now);
+      if (section.version <= since)
+        continue;
+      if (not section.value.is_object())
+      {
+        obj[section.name] = section.value;
+        continue;
+      }
+      auto& changed = obj[section.name] = StatusObject::object();
+      for (const auto& [key, version] : section.fieldVersions)
+      {
+        if (version <= since)
+          continue;
+        const auto itr = section.value.find(key);
+        changed[key] = itr == section.value.end() ? StatusObject{} : *itr;
+      }
+    }
+    return obj;
+  }
+
+  void
+  StatusCache::Invalidate()
+  {
+    for (auto& section : m_Sections)
+      section.generatedAt.reset();
+  }
+}  // namespace llarp::util
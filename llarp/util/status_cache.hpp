@@ -0,0 +1,98 @@
+#pragma once
+
+#include "status.hpp"
+#include "time.hpp"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace llarp::util
+{
+  /// keeps a snapshot of each section of a status object. reads are served from the snapshots,
+  /// sections that were read since they were last made are made again once they are older than
+  /// their interval by Refresh, which the router calls from its tick with a time budget so a
+  /// status poll never rebuilds anything on the spot but the first time.
+  ///
+  /// every top level field of a section carries the version it last changed at, which lets
+  /// subscribers be sent only the fields that changed since they last heard from us. fields we
+  /// are told are volatile, such as rates and timestamps, are left out when telling whether
+  /// something changed.
+  class StatusCache
+  {
+   public:
+    using Generator = std::function<StatusObject()>;
+
+    explicit StatusCache(std::unordered_set<std::string> volatileFields = {});
+
+    /// add a section made by gen, which is served for up to maxAge before gen is called again
+    void
+    Add(std::string name, Generator gen, llarp_time_t maxAge);
+
+    /// make the stale sections that were read since they were last made again, stalest first,
+    /// until budget is spent. makes at least one when any is due so every section gets its turn.
+    void
+    Refresh(
+        llarp_time_t now,
+        std::chrono::microseconds budget = std::chrono::microseconds::max());
+
+    /// the snapshot of the named section, made first if it never was.
+    /// returns a null object for sections we do not have.
+    const StatusObject&
+    Get(std::string_view name, llarp_time_t now);
+
+    /// every section as one object
+    StatusObject
+    Collect(llarp_time_t now);
+
+    /// per section, the top level fields that changed after version since, fields that went away
+    /// are null. sections that are not objects are given whole when they changed.
+    StatusObject
+    ChangedSince(uint64_t since, llarp_time_t now);
+
+    /// the version of the most recent change to any section
+    uint64_t
+    Version() const
+    {
+      return m_Version;
+    }
+
+    /// drop every snapshot so the next read makes it again
+    void
+    Invalidate();
+
+   private:
+    struct Section
+    {
+      std::string name;
+      Generator gen;
+      llarp_time_t maxAge;
+      std::optional<llarp_time_t> generatedAt;
+      /// when it was last read, it is only made again if that was after it was last made
+      llarp_time_t readAt = 0s;
+      StatusObject value;
+      uint64_t version = 0;
+      /// version each top level field last changed at, fields that went away included
+      std::map<std::string, uint64_t> fieldVersions;
+    };
+
+    Section&
+    Read(Section& section, llarp_time_t now);
+
+    void
+    Generate(Section& section, llarp_time_t now);
+
+    /// true if left and right only differ in volatile fields
+    bool
+    Same(const StatusObject& left, const StatusObject& right) const;
+
+    std::unordered_set<std::string> m_Volatile;
+    std::vector<Section> m_Sections;
+    uint64_t m_Version = 0;
+  };
+}  // namespace llarp::util
@@ -27,6 +27,11 @@ namespace llarp::vpn
     virtual bool
     WritePacket(net::IPPacket pkt) = 0;
 
+    /// write out anything WritePacket held back to write together with what came after it,
+    /// called once we have nothing more to write for now
+    virtual void
+    FlushWrites(){};
+
     /// get pollable fd for reading
     virtual int
     PollFD() const = 0;
@@ -8,11 +8,15 @@
 #include "common.hpp"
 #include <net/if.h>
 #include <linux/if_tun.h>
+#include <sys/uio.h>
 
 #include <cstring>
+#include <deque>
 #include <arpa/inet.h>
 #include <linux/rtnetlink.h>
+#include <llarp/net/ip_offload.hpp>
 #include <llarp/net/net.hpp>
+#include <llarp/util/logging.hpp>
 #include <llarp/util/str.hpp>
 #include <exception>
 
@@ -25,6 +29,8 @@
 
 namespace llarp::vpn
 {
+  static auto logcat = log::Cat("vpn");
+
   struct in6_ifreq
   {
     in6_addr addr;
@@ -35,10 +41,18 @@ namespace llarp::vpn
   class LinuxInterface : public NetworkInterface
   {
     const int m_fd;
+    /// the tun puts a vnet header in front of every packet and hands us and takes tcp super
+    /// packets, which we split up and join on our side of it
+    const bool m_Offload;
+    std::vector<byte_t> m_ReadBuf;
+    std::deque<net::IPPacket> m_ReadQueue;
+    net::TCPCoalescer m_Coalescer;
 
    public:
     LinuxInterface(InterfaceInfo info)
-        : NetworkInterface{std::move(info)}, m_fd{::open("/dev/net/tun", O_RDWR)}
+        : NetworkInterface{std::move(info)}
+        , m_fd{::open("/dev/net/tun", O_RDWR)}
+        , m_Offload{m_Info.offload}
 
     {
       if (m_fd == -1)
@@ -47,12 +61,23 @@ namespace llarp::vpn
       ifreq ifr{};
       in6_ifreq ifr6{};
       ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+      if (m_Offload)
+        ifr.ifr_flags |= IFF_VNET_HDR;
       std::copy_n(
           m_Info.ifname.c_str(),
           std::min(m_Info.ifname.size(), sizeof(ifr.ifr_name)),
           ifr.ifr_name);
       if (::ioctl(m_fd, TUNSETIFF, &ifr) == -1)
         throw std::runtime_error("cannot set interface name: " + std::string{strerror(errno)});
+      if (m_Offload)
+      {
+        m_ReadBuf.resize(sizeof(net::vnet_header) + net::MaxOffloadSize);
+        // without this the kernel still wants vnet headers, it just never sends us super packets
+        // or leaves checksums to us
+        if (::ioctl(m_fd, TUNSETOFFLOAD, TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN)
+            == -1)
+          log::warning(logcat, "cannot turn on tun offload: {}", strerror(errno));
+      }
       IOCTL control{AF_INET};
 
       control.ioctl(SIOCGIFFLAGS, &ifr);
@@ -106,6 +131,8 @@ namespace llarp::vpn
     net::IPPacket
     ReadNextPacket() override
     {
+      if (m_Offload)
+        return ReadNextOffloaded();
       std::vector<byte_t> pkt;
       pkt.resize(net::IPPacket::MaxSize);
       const auto sz = read(m_fd, pkt.data(), pkt.capacity());
@@ -125,11 +152,68 @@ namespace llarp::vpn
     bool
     WritePacket(net::IPPacket pkt) override
     {
+      if (m_Offload)
+        return WriteOffloaded(pkt);
       const auto sz = write(m_fd, pkt.data(), pkt.size());
       if (sz <= 0)
         return false;
       return sz == static_cast<ssize_t>(pkt.size());
     }
+
+    void
+    FlushWrites() override
+    {
+      if (m_Coalescer.empty())
+        return;
+      const auto buf = m_Coalescer.Flush();
+      if (write(m_fd, buf.data(), buf.size()) != static_cast<ssize_t>(buf.size()))
+        log::debug(logcat, "dropped coalesced write to {}: {}", m_Info.ifname, strerror(errno));
+    }
+
+   private:
+    net::IPPacket
+    ReadNextOffloaded()
+    {
+      while (m_ReadQueue.empty())
+      {
+        const auto sz = read(m_fd, m_ReadBuf.data(), m_ReadBuf.size());
+        if (sz < 0)
+        {
+          if (errno == EAGAIN or errno == EWOULDBLOCK)
+          {
+            errno = 0;
+            return net::IPPacket{};
+          }
+          throw std::error_code{errno, std::system_category()};
+        }
+        if (static_cast<size_t>(sz) < sizeof(net::vnet_header))
+          continue;
+        net::vnet_header hdr;
+        std::memcpy(&hdr, m_ReadBuf.data(), sizeof(hdr));
+        auto segments = net::SplitOffloaded(
+            hdr, byte_view_t{m_ReadBuf.data() + sizeof(hdr), sz - sizeof(hdr)});
+        if (segments.empty())
+          log::debug(logcat, "dropped offloaded packet we cannot split from {}", m_Info.ifname);
+        for (auto& seg : segments)
+          m_ReadQueue.push_back(std::move(seg));
+      }
+      auto pkt = std::move(m_ReadQueue.front());
+      m_ReadQueue.pop_front();
+      return pkt;
+    }
+
+    bool
+    WriteOffloaded(const net::IPPacket& pkt)
+    {
+      if (m_Coalescer.Append(pkt))
+        return true;
+      FlushWrites();
+      if (m_Coalescer.Append(pkt))
+        return true;
+      net::vnet_header hdr{};
+      iovec iov[2] = {{&hdr, sizeof(hdr)}, {const_cast<byte_t*>(pkt.data()), pkt.size()}};
+      return writev(m_fd, iov, 2) == static_cast<ssize_t>(sizeof(hdr) + pkt.size());
+    }
   };
 
   class LinuxRouteManager : public IRouteManager
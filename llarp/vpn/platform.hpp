@@ -35,6 +35,8 @@ namespace llarp::vpn
     unsigned int index;
     huint32_t dnsaddr;
     std::vector<InterfaceAddress> addrs;
+    /// have the platform split and join tcp bursts and checksum packets for us if it can
+    bool offload = false;
 
     /// get address number N
     inline net::ipaddr_t
@@ -10,14 +10,15 @@ namespace llarp
     {
       auto str_func = [](PathHopConfig* hop) {
         std::string s = "Hop: [";
-        s += RouterID(hop->rc.pubkey).ShortString();
+        s += RouterID(hop->rc->pubkey).ShortString();
         s += "] -> [";
         s += hop->upstream.ShortString();
         s += "]";
         return s;
       };
       py::class_<PathHopConfig>(mod, "PathHopConfig")
-          .def_readonly("rc", &PathHopConfig::rc)
+          .def_property_readonly(
+              "rc", [](const PathHopConfig& hop) -> const RouterContact& { return *hop.rc; })
           .def_readonly("upstreamRouter", &PathHopConfig::upstream)
           .def_readonly("txid", &PathHopConfig::txID)
           .def_readonly("rxid", &PathHopConfig::rxID)
@@ -0,0 +1,733 @@
+/// lokinet-bench: runs a small lokinet network of relays and clients inside this process, pushes
+/// traffic between the clients and reports throughput, latency, cpu time and memory use as json
+/// so runs on different commits can be compared.
+///
+/// scenarios:
+///   hs    ip packets between hidden services, each client sends to the next one
+///   exit  ip packets from every other client to the first client acting as an exit
+///   quic  bulk tcp transfers over quic tunnels, each client sends to the next one
+///   all   all of the above one after another on the same network
+
+#include <llarp.hpp>
+#include <llarp/config/config.hpp>
+#include <llarp/constants/files.hpp>
+#include <llarp/constants/version.hpp>
+#include <llarp/handlers/null.hpp>
+#include <llarp/net/ip_packet.hpp>
+#include <llarp/quic/transport_profile.hpp>
+#include <llarp/quic/tunnel.hpp>
+#include <llarp/router/abstractrouter.hpp>
+#include <llarp/service/context.hpp>
+#include <llarp/service/endpoint.hpp>
+#include <llarp/tooling/router_hive.hpp>
+#include <llarp/util/fs.hpp>
+#include <llarp/vpn/egres_packet_router.hpp>
+
+#include <CLI/App.hpp>
+#include <CLI/Formatter.hpp>
+#include <CLI/Config.hpp>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+  using Context_ptr = tooling::RouterHive::Context_ptr;
+  using bench_clock = std::chrono::steady_clock;
+
+  /// udp port the benchmark packets are addressed to on the receiving endpoint
+  constexpr uint16_t BenchPort = 9999;
+  constexpr auto BenchNetID = "bench";
+  /// [network]:type of the client acting as the exit
+  constexpr auto BenchExitType = "bench-exit";
+
+  /// the endpoint of the client acting as the exit. a real exit writes exit traffic to its tun,
+  /// which we cannot see from in here, so this one hands it to its packet router like any other
+  /// traffic instead
+  struct BenchExitEndpoint : public llarp::handlers::NullEndpoint
+  {
+    using NullEndpoint::NullEndpoint;
+
+    bool
+    HandleInboundPacket(
+        const llarp::service::ConvoTag tag,
+        const llarp_buffer_t& buf,
+        llarp::service::ProtocolType t,
+        uint64_t seqno) override
+    {
+      if (t == llarp::service::ProtocolType::Exit)
+        t = llarp::service::ProtocolType::TrafficV4;
+      return NullEndpoint::HandleInboundPacket(tag, buf, t, seqno);
+    }
+  };
+
+  struct Options
+  {
+    size_t relays = 10;
+    size_t clients = 4;
+    int hops = 4;
+    std::string scenario = "all";
+    int duration = 20;
+    int warmup = 120;
+    size_t packetSize = 1024;
+    size_t rate = 1000;
+    std::string quicProfile = "bulk";
+    uint16_t basePort = 31000;
+    std::string dataDir = "/tmp/lokinet-bench";
+    std::string output;
+    bool verbose = false;
+  };
+
+  /// run f on the event loop of a router and wait for what it returns
+  template <typename Func_t>
+  auto
+  OnLoop(const Context_ptr& ctx, Func_t f)
+  {
+    std::promise<decltype(f())> result;
+    ctx->loop->call([&result, &f]() { result.set_value(f()); });
+    return result.get_future().get();
+  }
+
+  /// only call on the loop of the router
+  llarp::service::Endpoint_ptr
+  DefaultEndpoint(const Context_ptr& ctx)
+  {
+    return ctx->router->hiddenServiceContext().GetDefault();
+  }
+
+  /// cpu time used by the whole process, that is every router of the network
+  std::chrono::duration<double>
+  ProcessCPUTime()
+  {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    const auto seconds = [](const timeval& tv) { return tv.tv_sec + tv.tv_usec / 1e6; };
+    return std::chrono::duration<double>{seconds(usage.ru_utime) + seconds(usage.ru_stime)};
+  }
+
+  /// resident set size in KiB
+  uint64_t
+  ResidentKiB()
+  {
+    std::ifstream statm{"/proc/self/statm"};
+    uint64_t size = 0, resident = 0;
+    if (statm >> size >> resident)
+      return resident * sysconf(_SC_PAGESIZE) / 1024;
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+  }
+
+  /// nearest rank percentile of sorted samples
+  double
+  Percentile(const std::vector<int64_t>& sorted, double p)
+  {
+    if (sorted.empty())
+      return 0;
+    const auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1] / 1e6;
+  }
+
+  std::shared_ptr<llarp::Config>
+  MakeConfig(
+      const Options& opts,
+      const fs::path& dir,
+      bool isRelay,
+      std::string nickname,
+      std::optional<uint16_t> port,
+      const std::optional<llarp::RouterContact>& seed)
+  {
+    fs::create_directories(dir / "nodedb");
+    auto conf = std::make_shared<llarp::Config>(dir);
+    if (not conf->Load(std::nullopt, isRelay))
+      throw std::runtime_error{fmt::format("failed to load config for {}", nickname)};
+    conf->router.m_dataDir = dir;
+    conf->router.m_netId = BenchNetID;
+    conf->router.m_nickname = std::move(nickname);
+    conf->router.m_blockBogons = false;
+    conf->network.m_endpointType = "null";
+    conf->network.m_enableProfiling = false;
+    conf->network.m_saveProfiles = false;
+    conf->network.m_Hops = opts.hops;
+    // every router is on the same ip
+    conf->paths.m_UniqueHopsNetmaskSize = 0;
+    conf->api.m_enableRPCServer = false;
+    conf->lokid.whitelistRouters = false;
+    conf->logging.m_logLevel = opts.verbose ? llarp::log::Level::info : llarp::log::Level::warn;
+    conf->bootstrap.files.clear();
+    conf->links.OutboundLinks = {llarp::SockAddr{127, 0, 0, 1}};
+    if (port)
+    {
+      const llarp::SockAddr addr{127, 0, 0, 1, llarp::huint16_t{*port}};
+      conf->links.InboundListenAddrs = {addr};
+      conf->links.PublicAddress = addr.getIP();
+      conf->links.PublicPort = llarp::net::port_t::from_host(*port);
+    }
+    if (seed)
+      conf->bootstrap.routers.insert(*seed);
+    else
+      conf->bootstrap.seednode = true;
+    return conf;
+  }
+
+  /// one sender pushing traffic to one receiver
+  struct Flow
+  {
+    size_t id;
+    Context_ptr from;
+    Context_ptr to;
+    llarp::service::Address remote;
+
+    uint64_t scheduled = 0;
+    std::atomic<uint64_t> sent = 0;
+
+    // updated on the loop of the receiving router
+    std::mutex mutex;
+    uint64_t received = 0;
+    uint64_t bytes = 0;
+    std::vector<int64_t> latencies;
+  };
+
+  struct Stamp
+  {
+    uint64_t flow;
+    uint64_t seqno;
+    int64_t sentAt;
+  };
+
+  /// accepts tcp connections on localhost and counts what they send
+  class TCPSink
+  {
+   public:
+    explicit TCPSink(uint16_t port)
+    {
+      m_FD = socket(AF_INET, SOCK_STREAM, 0);
+      const int one = 1;
+      setsockopt(m_FD, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      const llarp::SockAddr addr{127, 0, 0, 1, llarp::huint16_t{port}};
+      if (bind(m_FD, static_cast<const sockaddr*>(addr), addr.sockaddr_len()) != 0
+          or listen(m_FD, 16) != 0)
+      {
+        close(m_FD);
+        throw std::runtime_error{
+            fmt::format("cannot listen on {}: {}", addr.ToString(), strerror(errno))};
+      }
+      m_Thread = std::thread{[this]() { Run(); }};
+    }
+
+    ~TCPSink()
+    {
+      m_Stop = true;
+      m_Thread.join();
+      close(m_FD);
+    }
+
+    uint64_t
+    Bytes() const
+    {
+      return m_Bytes;
+    }
+
+   private:
+    void
+    Run()
+    {
+      std::vector<pollfd> fds{{m_FD, POLLIN, 0}};
+      std::vector<char> buf(64 * 1024);
+      while (not m_Stop)
+      {
+        if (poll(fds.data(), fds.size(), 100) <= 0)
+          continue;
+        for (size_t idx = fds.size(); idx-- > 1;)
+        {
+          if (not fds[idx].revents)
+            continue;
+          const auto n = read(fds[idx].fd, buf.data(), buf.size());
+          if (n > 0)
+          {
+            m_Bytes += n;
+            continue;
+          }
+          close(fds[idx].fd);
+          fds.erase(fds.begin() + idx);
+        }
+        if (fds[0].revents & POLLIN)
+        {
+          if (const int fd = accept(m_FD, nullptr, nullptr); fd >= 0)
+            fds.push_back({fd, POLLIN, 0});
+        }
+      }
+      for (size_t idx = 1; idx < fds.size(); ++idx)
+        close(fds[idx].fd);
+    }
+
+    int m_FD;
+    std::atomic<bool> m_Stop = false;
+    std::atomic<uint64_t> m_Bytes = 0;
+    std::thread m_Thread;
+  };
+
+  /// write to a tcp socket on localhost as fast as it takes it until the deadline
+  void
+  WriteUntil(llarp::SockAddr to, bench_clock::time_point until)
+  {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    const timeval timeout{0, 100'000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, static_cast<const sockaddr*>(to), to.sockaddr_len()) == 0)
+    {
+      std::vector<char> buf(64 * 1024, 'x');
+      while (bench_clock::now() < until)
+      {
+        const auto n = send(fd, buf.data(), buf.size(), MSG_NOSIGNAL);
+        if (n < 0 and errno != EAGAIN and errno != EWOULDBLOCK)
+          break;
+      }
+    }
+    close(fd);
+  }
+
+  class Bench
+  {
+   public:
+    explicit Bench(Options opts) : m_Opts{std::move(opts)}
+    {}
+
+    nlohmann::json
+    Run()
+    {
+      if (m_Opts.clients < 2)
+        throw std::invalid_argument{"need at least 2 clients"};
+      StartNetwork();
+      nlohmann::json results{
+          {"version", llarp::VERSION_FULL},
+          {"params",
+           {{"relays", m_Opts.relays},
+            {"clients", m_Opts.clients},
+            {"hops", m_Opts.hops},
+            {"duration", m_Opts.duration},
+            {"packetSize", m_Opts.packetSize},
+            {"rate", m_Opts.rate},
+            {"quicProfile", m_Opts.quicProfile}}},
+          {"readyAfter", m_ReadyAfter.count()},
+          {"rssKiBIdle", ResidentKiB()}};
+      if (m_Opts.scenario == "hs" or m_Opts.scenario == "all")
+        results["hs"] = RunPackets(llarp::service::ProtocolType::TrafficV4, RingFlows());
+      if (m_Opts.scenario == "exit" or m_Opts.scenario == "all")
+        results["exit"] = RunPackets(llarp::service::ProtocolType::Exit, ExitFlows());
+      if (m_Opts.scenario == "quic" or m_Opts.scenario == "all")
+        results["quic"] = RunQUIC(RingFlows());
+      m_Hive->StopRouters();
+      return results;
+    }
+
+   private:
+    bool
+    WantsExit() const
+    {
+      return m_Opts.scenario == "exit" or m_Opts.scenario == "all";
+    }
+
+    /// start the first relay on its own so it writes the rc everyone bootstraps from, then bring
+    /// up the whole network and wait for every client to have paths and a published introset
+    void
+    StartNetwork()
+    {
+      const fs::path root{m_Opts.dataDir};
+      fs::remove_all(root);
+      const auto relayDir = [&root](size_t idx) { return root / "relays" / std::to_string(idx); };
+      const auto relayPort = [this](size_t idx) { return uint16_t(m_Opts.basePort + idx); };
+
+      m_Hive = std::make_unique<tooling::RouterHive>();
+      m_Hive->AddRelay(MakeConfig(m_Opts, relayDir(0), true, "relay0", relayPort(0), {}));
+      m_Hive->StartRelays();
+      std::this_thread::sleep_for(2s);
+      m_Hive->StopRouters();
+
+      llarp::RouterContact seed;
+      if (not seed.Read(relayDir(0) / llarp::our_rc_filename))
+        throw std::runtime_error{"first relay did not write its rc"};
+
+      m_Hive = std::make_unique<tooling::RouterHive>();
+      for (size_t idx = 0; idx < m_Opts.relays; ++idx)
+      {
+        m_Hive->AddRelay(MakeConfig(
+            m_Opts,
+            relayDir(idx),
+            true,
+            fmt::format("relay{}", idx),
+            relayPort(idx),
+            idx ? std::make_optional(seed) : std::nullopt));
+      }
+      for (size_t idx = 0; idx < m_Opts.clients; ++idx)
+      {
+        auto conf = MakeConfig(
+            m_Opts,
+            root / "clients" / std::to_string(idx),
+            false,
+            fmt::format("client{}", idx),
+            std::nullopt,
+            seed);
+        conf->network.m_reachable = true;
+        if (idx == 0 and WantsExit())
+        {
+          conf->network.m_endpointType = BenchExitType;
+          conf->network.m_AllowExit = true;
+        }
+        m_Hive->AddClient(conf);
+      }
+      const auto started = bench_clock::now();
+      m_Hive->StartRelays();
+      std::this_thread::sleep_for(2s);
+      m_Hive->StartClients();
+
+      for (const auto& [id, ctx] : m_Hive->clients)
+        m_Clients.push_back(ctx);
+
+      const auto deadline = started + std::chrono::seconds{m_Opts.warmup};
+      while (bench_clock::now() < deadline)
+      {
+        const auto ready = std::count_if(m_Clients.begin(), m_Clients.end(), [](auto ctx) {
+          return OnLoop(ctx, [ctx]() { return DefaultEndpoint(ctx)->IsReady(); });
+        });
+        if (size_t(ready) == m_Clients.size())
+          break;
+        std::this_thread::sleep_for(500ms);
+      }
+      m_ReadyAfter = bench_clock::now() - started;
+      fmt::print(stderr, "network up after {:.1f}s\n", m_ReadyAfter.count());
+
+      for (const auto& ctx : m_Clients)
+      {
+        m_Addrs.push_back(OnLoop(ctx, [ctx]() {
+          auto ep = DefaultEndpoint(ctx);
+          ep->EgresPacketRouter()->AddUDPHandler(
+              llarp::huint16_t{BenchPort},
+              [this](auto, llarp::net::IPPacket pkt) { HandleBenchPacket(std::move(pkt)); });
+          return ep->GetIdentity().pub.Addr();
+        }));
+      }
+    }
+
+    /// every client sends to the next one
+    std::vector<std::shared_ptr<Flow>>
+    RingFlows() const
+    {
+      std::vector<std::shared_ptr<Flow>> flows;
+      for (size_t idx = 0; idx < m_Clients.size(); ++idx)
+      {
+        const auto to = (idx + 1) % m_Clients.size();
+        flows.emplace_back(new Flow{idx, m_Clients[idx], m_Clients[to], m_Addrs[to]});
+      }
+      return flows;
+    }
+
+    /// every other client sends to the first one
+    std::vector<std::shared_ptr<Flow>>
+    ExitFlows() const
+    {
+      std::vector<std::shared_ptr<Flow>> flows;
+      for (size_t idx = 1; idx < m_Clients.size(); ++idx)
+        flows.emplace_back(new Flow{idx - 1, m_Clients[idx], m_Clients[0], m_Addrs[0]});
+      return flows;
+    }
+
+    void
+    HandleBenchPacket(llarp::net::IPPacket pkt)
+    {
+      const auto now = bench_clock::now().time_since_epoch().count();
+      const auto data = pkt.L4Data();
+      Stamp stamp;
+      if (not data or data->second < sizeof(stamp))
+        return;
+      std::memcpy(&stamp, data->first, sizeof(stamp));
+
+      std::lock_guard lock{m_FlowsMutex};
+      if (stamp.flow >= m_Flows.size())
+        return;
+      auto& flow = *m_Flows[stamp.flow];
+      std::lock_guard flowLock{flow.mutex};
+      // anything sent before we started measuring only tells us the flow works
+      if (stamp.sentAt < m_MeasureFrom.time_since_epoch().count())
+      {
+        flow.received = std::max<uint64_t>(flow.received, 1);
+        return;
+      }
+      flow.received++;
+      flow.bytes += pkt.size();
+      flow.latencies.push_back(now - stamp.sentAt);
+    }
+
+    /// queue n packets on the loop of the sending router of flow
+    void
+    SendPackets(std::shared_ptr<Flow> flow, uint64_t n, llarp::service::ProtocolType proto)
+    {
+      flow->from->loop->call([this, flow, n, proto]() {
+        auto ep = DefaultEndpoint(flow->from);
+        std::vector<byte_t> body(std::max(m_Opts.packetSize, sizeof(Stamp)));
+        for (uint64_t i = 0; i < n; ++i)
+        {
+          const Stamp stamp{
+              flow->id, flow->sent++, bench_clock::now().time_since_epoch().count()};
+          std::memcpy(body.data(), &stamp, sizeof(stamp));
+          auto pkt = llarp::net::IPPacket::make_udp(
+              llarp::SockAddr{10, 0, 0, 1, llarp::huint16_t{BenchPort}},
+              llarp::SockAddr{10, 0, 0, 2, llarp::huint16_t{BenchPort}},
+              body);
+          ep->SendToOrQueue(flow->remote, pkt.ConstBuffer(), proto);
+        }
+      });
+    }
+
+    /// make sure every flow can deliver before we start measuring
+    size_t
+    WarmUp(llarp::service::ProtocolType proto)
+    {
+      for (auto& flow : m_Flows)
+        OnLoop(flow->from, [&flow]() {
+          DefaultEndpoint(flow->from)->MarkAddressOutbound(flow->remote);
+          return true;
+        });
+
+      const auto deadline = bench_clock::now() + std::chrono::seconds{m_Opts.warmup};
+      size_t ready = 0;
+      while (bench_clock::now() < deadline and ready < m_Flows.size())
+      {
+        ready = 0;
+        for (auto& flow : m_Flows)
+        {
+          std::lock_guard lock{flow->mutex};
+          if (flow->received)
+            ready++;
+          else
+            SendPackets(flow, 1, proto);
+        }
+        std::this_thread::sleep_for(100ms);
+      }
+      return ready;
+    }
+
+    nlohmann::json
+    RunPackets(llarp::service::ProtocolType proto, std::vector<std::shared_ptr<Flow>> flows)
+    {
+      {
+        std::lock_guard lock{m_FlowsMutex};
+        m_Flows = std::move(flows);
+        m_MeasureFrom = bench_clock::time_point::max();
+      }
+      const auto ready = WarmUp(proto);
+      // let whatever the warm up sent drain
+      std::this_thread::sleep_for(1s);
+
+      const auto cpuStart = ProcessCPUTime();
+      const auto start = bench_clock::now();
+      {
+        std::lock_guard lock{m_FlowsMutex};
+        m_MeasureFrom = start;
+      }
+      const auto sendUntil = start + std::chrono::seconds{m_Opts.duration};
+      for (auto now = start; now < sendUntil; now = bench_clock::now())
+      {
+        const std::chrono::duration<double> elapsed = now - start;
+        const auto target = static_cast<uint64_t>(elapsed.count() * m_Opts.rate);
+        for (auto& flow : m_Flows)
+        {
+          if (target > flow->scheduled)
+            SendPackets(flow, target - flow->scheduled, proto);
+          flow->scheduled = std::max(flow->scheduled, target);
+        }
+        std::this_thread::sleep_for(10ms);
+      }
+      // wait for stragglers
+      std::this_thread::sleep_for(2s);
+      const auto cpu = ProcessCPUTime() - cpuStart;
+      const std::chrono::duration<double> took = sendUntil - start;
+
+      std::lock_guard lock{m_FlowsMutex};
+      const auto numFlows = m_Flows.size();
+      uint64_t scheduled = 0, received = 0, bytes = 0;
+      std::vector<int64_t> latencies;
+      for (auto& flow : m_Flows)
+      {
+        std::lock_guard flowLock{flow->mutex};
+        scheduled += flow->scheduled;
+        received += flow->received;
+        bytes += flow->bytes;
+        latencies.insert(latencies.end(), flow->latencies.begin(), flow->latencies.end());
+      }
+      m_Flows.clear();
+      std::sort(latencies.begin(), latencies.end());
+
+      return {
+          {"flows", numFlows},
+          {"flowsReady", ready},
+          {"sent", scheduled},
+          {"received", received},
+          {"loss", scheduled ? 1. - double(received) / scheduled : 0.},
+          {"pps", received / took.count()},
+          {"mbps", bytes * 8 / took.count() / 1e6},
+          {"latencyMs",
+           {{"p50", Percentile(latencies, 0.5)},
+            {"p99", Percentile(latencies, 0.99)},
+            {"max", Percentile(latencies, 1)}}},
+          {"cpuSeconds", cpu.count()},
+          {"cpuPerPacketUs", received ? cpu.count() * 1e6 / received : 0.},
+          {"rssKiB", ResidentKiB()}};
+    }
+
+    nlohmann::json
+    RunQUIC(std::vector<std::shared_ptr<Flow>> flows)
+    {
+      const auto profile = llarp::quic::parse_transport_profile(m_Opts.quicProfile);
+      if (not profile)
+        throw std::invalid_argument{"unknown quic profile " + m_Opts.quicProfile};
+
+      // every receiver forwards its tunnel to its own sink
+      std::vector<std::unique_ptr<TCPSink>> sinks;
+      for (size_t idx = 0; idx < m_Clients.size(); ++idx)
+      {
+        const uint16_t port = m_Opts.basePort + m_Opts.relays + idx;
+        sinks.emplace_back(new TCPSink{port});
+        OnLoop(m_Clients[idx], [ctx = m_Clients[idx], port, profile]() {
+          const llarp::SockAddr to{127, 0, 0, 1, llarp::huint16_t{port}};
+          return DefaultEndpoint(ctx)->GetQUICTunnel()->listen(to, *profile);
+        });
+      }
+
+      size_t ready = 0;
+      std::vector<llarp::SockAddr> tunnels;
+      for (auto& flow : flows)
+      {
+        const uint16_t port = m_Opts.basePort + m_Opts.relays + (flow->id + 1) % m_Clients.size();
+        auto opened = std::make_shared<std::promise<bool>>();
+        tunnels.push_back(OnLoop(flow->from, [this, &flow, port, profile, opened]() {
+          auto* quic = DefaultEndpoint(flow->from)->GetQUICTunnel();
+          quic->open_timeout = std::chrono::seconds{m_Opts.warmup};
+          return quic
+              ->open(
+                  flow->remote.ToString(),
+                  port,
+                  [opened](bool success) { opened->set_value(success); },
+                  llarp::SockAddr{127, 0, 0, 1},
+                  *profile)
+              .first;
+        }));
+        if (opened->get_future().get())
+          ready++;
+      }
+
+      const auto bytesAtSinks = [&sinks]() {
+        uint64_t bytes = 0;
+        for (const auto& sink : sinks)
+          bytes += sink->Bytes();
+        return bytes;
+      };
+      const auto cpuStart = ProcessCPUTime();
+      const auto bytesStart = bytesAtSinks();
+      const auto start = bench_clock::now();
+      const auto until = start + std::chrono::seconds{m_Opts.duration};
+      std::vector<std::thread> writers;
+      for (const auto& tunnel : tunnels)
+        writers.emplace_back([tunnel, until]() { WriteUntil(tunnel, until); });
+      for (auto& writer : writers)
+        writer.join();
+      const auto bytes = bytesAtSinks() - bytesStart;
+      const std::chrono::duration<double> took = bench_clock::now() - start;
+      const auto cpu = ProcessCPUTime() - cpuStart;
+
+      return {
+          {"flows", flows.size()},
+          {"flowsReady", ready},
+          {"bytes", bytes},
+          {"mbps", bytes * 8 / took.count() / 1e6},
+          {"cpuSeconds", cpu.count()},
+          {"cpuPerMiBMs", bytes ? cpu.count() * 1e3 / (bytes / 1048576.) : 0.},
+          {"rssKiB", ResidentKiB()}};
+    }
+
+    const Options m_Opts;
+    std::unique_ptr<tooling::RouterHive> m_Hive;
+    std::vector<Context_ptr> m_Clients;
+    std::vector<llarp::service::Address> m_Addrs;
+    std::chrono::duration<double> m_ReadyAfter{};
+
+    std::mutex m_FlowsMutex;
+    std::vector<std::shared_ptr<Flow>> m_Flows;
+    bench_clock::time_point m_MeasureFrom = bench_clock::time_point::max();
+  };
+}  // namespace
+
+int
+main(int argc, char* argv[])
+{
+  CLI::App cli{"in process lokinet network benchmark", "lokinet-bench"};
+  Options opts;
+  cli.add_option("--relays", opts.relays, "Number of relays")->capture_default_str();
+  cli.add_option("--clients", opts.clients, "Number of clients")->capture_default_str();
+  cli.add_option("--hops", opts.hops, "Hops per path")->capture_default_str();
+  cli.add_option("--scenario", opts.scenario, "Traffic to push")
+      ->check(CLI::IsMember({"hs", "exit", "quic", "all"}))
+      ->capture_default_str();
+  cli.add_option("--duration", opts.duration, "Seconds to measure each scenario for")
+      ->capture_default_str();
+  cli.add_option("--warmup", opts.warmup, "Seconds to wait at most for paths and sessions")
+      ->capture_default_str();
+  cli.add_option("--packet-size", opts.packetSize, "Bytes of payload per packet")
+      ->capture_default_str();
+  cli.add_option("--rate", opts.rate, "Packets per second each sender sends")
+      ->capture_default_str();
+  cli.add_option("--quic-profile", opts.quicProfile, "Quic transport profile")
+      ->capture_default_str();
+  cli.add_option("--base-port", opts.basePort, "First localhost port to use")
+      ->capture_default_str();
+  cli.add_option("--data-dir", opts.dataDir, "Scratch directory, wiped on start")
+      ->capture_default_str();
+  cli.add_option("-o,--output", opts.output, "Write the json results here instead of stdout");
+  cli.add_flag("-v,--verbose", opts.verbose, "Log at info level");
+
+  try
+  {
+    cli.parse(argc, argv);
+  }
+  catch (const CLI::ParseError& e)
+  {
+    return cli.exit(e);
+  }
+
+  llarp::service::Context::AddEndpointType(
+      BenchExitType, [](llarp::AbstractRouter* r, llarp::service::Context* c) {
+        return std::make_shared<BenchExitEndpoint>(r, c);
+      });
+
+  try
+  {
+    const auto results = Bench{opts}.Run().dump(2);
+    if (opts.output.empty())
+      fmt::print("{}\n", results);
+    else
+      std::ofstream{opts.output} << results << "\n";
+  }
+  catch (const std::exception& e)
+  {
+    fmt::print(stderr, "lokinet-bench failed: {}\n", e.what());
+    return 1;
+  }
+  return 0;
+}
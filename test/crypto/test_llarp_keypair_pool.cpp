@@ -0,0 +1,129 @@
+#include "llarp_test.hpp"
+#include <llarp/crypto/crypto.hpp>
+#include <llarp/crypto/keypair_pool.hpp>
+#include <llarp/messages/relay_commit.hpp>
+#include <llarp/path/path.hpp>
+#include <llarp/path/pathbuilder.hpp>
+
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+
+#include <array>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+
+using KeyPoolTest = test::LlarpTest<>;
+
+static bool
+KeysAgree(const SecretKey& a, const SecretKey& b)
+{
+  auto crypto = CryptoManager::instance();
+  TunnelNonce nonce;
+  nonce.Randomize();
+  SharedSecret client, server;
+  return crypto->dh_client(client, b.toPublic(), a, nonce)
+      and crypto->dh_server(server, a.toPublic(), b, nonce) and client == server;
+}
+
+TEST_CASE_METHOD(KeyPoolTest, "EncryptionKeyPool hands out usable keys and refills", "[crypto]")
+{
+  auto pool = std::make_shared<EncryptionKeyPool>(8);
+  // nothing pregenerated yet, so we generate inline
+  const auto first = pool->Take();
+  REQUIRE(pool->size() == 0);
+
+  std::vector<EncryptionKeyPool::WorkFunc_t> jobs;
+  pool->Start([&jobs](auto job) { jobs.push_back(std::move(job)); });
+  REQUIRE(jobs.size() == 1);
+  jobs.back()();
+  jobs.clear();
+  REQUIRE(pool->size() == 8);
+
+  const auto second = pool->Take();
+  CHECK(first != second);
+  CHECK(KeysAgree(first, second));
+
+  // a refill is queued once we are down to half, and only once
+  for (int i = 0; i < 3; ++i)
+    pool->Take();
+  REQUIRE(pool->size() == 4);
+  REQUIRE(jobs.size() == 1);
+  pool->Take();
+  REQUIRE(jobs.size() == 1);
+  jobs.back()();
+  CHECK(pool->size() == 8);
+}
+
+static std::vector<RouterContact_ptr>
+MakeHops(size_t num)
+{
+  std::vector<RouterContact_ptr> hops;
+  for (size_t idx = 0; idx < num; ++idx)
+  {
+    RouterContact rc;
+    SecretKey enc;
+    CryptoManager::instance()->encryption_keygen(enc);
+    rc.enckey = seckey_topublic(enc);
+    rc.pubkey.Randomize();
+    hops.push_back(std::make_shared<const EncodedRouterContact>(std::move(rc)));
+  }
+  return hops;
+}
+
+TEST_CASE_METHOD(KeyPoolTest, "Path build key generation latency", "[.bench][crypto][path]")
+{
+  static constexpr size_t numHops = 4;
+  static constexpr size_t numBuilds = 500;
+  const auto hops = MakeHops(numHops);
+
+  auto run = [&](bool parallel, EncryptionKeyPool& keys) {
+    std::chrono::steady_clock::duration total{0};
+    for (size_t n = 0; n < numBuilds; ++n)
+    {
+      path::Path path{hops, std::weak_ptr<path::PathSet>{}, 0, "bench"};
+      LR_CommitMessage lrcm;
+      const auto started = std::chrono::steady_clock::now();
+      if (parallel)
+      {
+        std::array<bool, numHops> ok{};
+        std::vector<std::thread> workers;
+        for (size_t idx = 0; idx < numHops; ++idx)
+          workers.emplace_back(
+              [&, idx] { ok[idx] = path::GenerateHopKeys(path, idx, lrcm.frames[idx], keys); });
+        for (auto& worker : workers)
+          worker.join();
+        for (const bool hop_ok : ok)
+          REQUIRE(hop_ok);
+      }
+      else
+      {
+        for (size_t idx = 0; idx < numHops; ++idx)
+          REQUIRE(path::GenerateHopKeys(path, idx, lrcm.frames[idx], keys));
+      }
+      total += std::chrono::steady_clock::now() - started;
+      // keep the pool topped up between builds as the background refill would
+      if (keys.Capacity())
+        keys.Fill();
+    }
+    return std::chrono::duration<double, std::micro>(total).count() / numBuilds;
+  };
+
+  // an empty pool generates every key inline, like we used to
+  EncryptionKeyPool none{0};
+  EncryptionKeyPool pooled{};
+  pooled.Fill();
+
+  const auto serial = run(false, none);
+  const auto serialPooled = run(false, pooled);
+  const auto parallelPooled = run(true, pooled);
+  fmt::print(
+      "{}-hop path key generation: serial {:.1f}us, serial+pool {:.1f}us, parallel+pool "
+      "{:.1f}us (parallel includes thread startup)\n",
+      numHops,
+      serial,
+      serialPooled,
+      parallelPooled);
+}
@@ -0,0 +1,65 @@
+#include <llarp/crypto/signature_cache.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+static ShortHash
+HashOf(uint8_t n)
+{
+  ShortHash h;
+  h.Zero();
+  h[0] = n;
+  return h;
+}
+
+static Signature
+SigOf(uint8_t n)
+{
+  Signature sig;
+  sig.Zero();
+  sig[0] = n;
+  return sig;
+}
+
+TEST_CASE("SignatureCache hits only what was put", "[crypto]")
+{
+  SignatureCache cache{4};
+  REQUIRE_FALSE(cache.Has(HashOf(1), SigOf(1)));
+  REQUIRE(cache.Misses() == 1);
+
+  cache.Put(HashOf(1), SigOf(1));
+  REQUIRE(cache.Has(HashOf(1), SigOf(1)));
+  REQUIRE(cache.Hits() == 1);
+
+  // the same content with another signature is not what we verified
+  REQUIRE_FALSE(cache.Has(HashOf(1), SigOf(2)));
+  REQUIRE(cache.Misses() == 2);
+}
+
+TEST_CASE("SignatureCache evicts oldest first", "[crypto]")
+{
+  SignatureCache cache{4};
+  for (uint8_t n = 1; n <= 4; ++n)
+    cache.Put(HashOf(n), SigOf(n));
+  REQUIRE(cache.size() == 4);
+
+  // replacing an entry does not make it any younger or take another slot
+  cache.Put(HashOf(1), SigOf(9));
+  REQUIRE(cache.size() == 4);
+
+  cache.Put(HashOf(5), SigOf(5));
+  REQUIRE(cache.size() == 4);
+  REQUIRE_FALSE(cache.Has(HashOf(1), SigOf(9)));
+  for (uint8_t n = 2; n <= 5; ++n)
+    REQUIRE(cache.Has(HashOf(n), SigOf(n)));
+}
+
+TEST_CASE("SignatureCache counts failed verifies", "[crypto]")
+{
+  SignatureCache cache;
+  cache.Verified(std::chrono::microseconds{10}, true);
+  cache.Verified(std::chrono::microseconds{10}, false);
+  REQUIRE(cache.Failures() == 1);
+  REQUIRE(cache.size() == 0);
+}
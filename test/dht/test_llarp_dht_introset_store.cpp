@@ -0,0 +1,72 @@
+#include <llarp/dht/introset_store.hpp>
+#include <llarp/constants/path.hpp>
+#include <catch2/catch.hpp>
+
+using llarp::dht::IntroSetStore;
+using llarp::dht::Key_t;
+
+static llarp::service::EncryptedIntroSet
+MakeIntroSet(byte_t fill, llarp_time_t signedAt, size_t payloadSize = 128)
+{
+  llarp::service::EncryptedIntroSet introset;
+  introset.derivedSigningKey.Fill(fill);
+  introset.signedAt = signedAt;
+  introset.introsetPayload.resize(payloadSize);
+  return introset;
+}
+
+static Key_t
+LocationOf(byte_t fill)
+{
+  Key_t k;
+  k.Fill(fill);
+  return k;
+}
+
+TEST_CASE("IntroSetStore replaces only with newer introsets", "[dht][introset-store]")
+{
+  IntroSetStore store;
+  REQUIRE(store.PutNode(MakeIntroSet(1, 10s)));
+  REQUIRE(store.size() == 1);
+  REQUIRE(not store.PutNode(MakeIntroSet(1, 5s)));
+  REQUIRE(store.GetNode(LocationOf(1))->signedAt == 10s);
+  REQUIRE(store.PutNode(MakeIntroSet(1, 20s, 256)));
+  REQUIRE(store.size() == 1);
+  REQUIRE(store.GetNode(LocationOf(1))->signedAt == 20s);
+  REQUIRE(store.Bytes() == IntroSetStore::EntrySize(MakeIntroSet(1, 20s, 256)));
+}
+
+TEST_CASE("IntroSetStore expires by signed time", "[dht][introset-store]")
+{
+  IntroSetStore store;
+  store.PutNode(MakeIntroSet(1, 10s));
+  store.PutNode(MakeIntroSet(2, 20s));
+  // replacing must not let the stale heap entry expire the newer introset
+  store.PutNode(MakeIntroSet(2, 30s));
+
+  REQUIRE(store.ExpireStale(9s + llarp::path::default_lifetime) == 0);
+  REQUIRE(store.ExpireStale(20s + llarp::path::default_lifetime) == 1);
+  REQUIRE(not store.HasNode(LocationOf(1)));
+  REQUIRE(store.HasNode(LocationOf(2)));
+  REQUIRE(store.ExpireStale(30s + llarp::path::default_lifetime) == 1);
+  REQUIRE(store.size() == 0);
+  REQUIRE(store.Bytes() == 0);
+}
+
+TEST_CASE("IntroSetStore evicts soonest expiring introsets over cap", "[dht][introset-store]")
+{
+  IntroSetStore store;
+  const auto entrySize = IntroSetStore::EntrySize(MakeIntroSet(0, 0s));
+  store.SetMaxBytes(entrySize * 2);
+
+  REQUIRE(store.PutNode(MakeIntroSet(1, 20s)));
+  REQUIRE(store.PutNode(MakeIntroSet(2, 10s)));
+  REQUIRE(store.PutNode(MakeIntroSet(3, 30s)));
+  REQUIRE(store.size() == 2);
+  REQUIRE(not store.HasNode(LocationOf(2)));
+
+  // an introset older than everything we hold is dropped straight away
+  REQUIRE(not store.PutNode(MakeIntroSet(4, 5s)));
+  REQUIRE(store.size() == 2);
+  REQUIRE(store.Bytes() <= store.MaxBytes());
+}
@@ -0,0 +1,257 @@
+#include <catch2/catch.hpp>
+#include <llarp/dns/cache.hpp>
+#include <llarp/dns/dns.hpp>
+#include <llarp/dns/message.hpp>
+#include <llarp/dns/server.hpp>
+#include <llarp/config/config.hpp>
+#include <llarp/ev/ev.hpp>
+#include <llarp/net/net_int.hpp>
+
+#include <oxenc/endian.h>
+
+#include <string>
+#include <string_view>
+
+using llarp::dns::AnswerCache;
+using llarp::dns::Message;
+using llarp::dns::Question;
+
+// header + question for "a.loki." + answer name, type and class
+static constexpr size_t AnswerTTLOffset = 12 + (8 + 4) + (8 + 4);
+
+static Message
+MakeQuery(std::string name = "a.loki.", uint16_t id = 1)
+{
+  Message msg{Question{std::move(name), llarp::dns::qTypeA}};
+  msg.hdr_id = id;
+  msg.hdr_fields = llarp::dns::flags_RD;
+  return msg;
+}
+
+static llarp::OwnedBuffer
+MakeReply(const Message& query, llarp::dns::RR_TTL_t ttl)
+{
+  Message reply{query};
+  reply.AddINReply(llarp::huint128_t{0x0a000001}, false, ttl);
+  return reply.ToBuffer();
+}
+
+static uint32_t
+AnswerTTL(const llarp::OwnedBuffer& buf)
+{
+  REQUIRE(buf.sz >= AnswerTTLOffset + 4);
+  return oxenc::load_big_to_host<uint32_t>(buf.buf.get() + AnswerTTLOffset);
+}
+
+TEST_CASE("AnswerCache serves replies with aged ttls", "[dns][cache]")
+{
+  AnswerCache cache;
+  const auto query = MakeQuery();
+  REQUIRE(not cache.Get(query, 0s));
+  REQUIRE(cache.Put(query, MakeReply(query, 60), 0s));
+
+  // a later query with another id and name case gets our reply patched to match it
+  auto later = MakeQuery("A.Loki.", 0x1234);
+  auto hit = cache.Get(later, 20s);
+  REQUIRE(hit);
+  CHECK(not hit->stale);
+  CHECK(not hit->refresh);
+  CHECK(AnswerTTL(hit->reply) == 40);
+  const auto* data = reinterpret_cast<const char*>(hit->reply.buf.get());
+  CHECK(oxenc::load_big_to_host<uint16_t>(data) == 0x1234);
+  CHECK(std::string_view{data + 12, 7} == std::string_view{"\x01" "A" "\x04" "Loki", 7});
+
+  // within the last tenth of the ttl we are told to refresh, but only once
+  auto expiring = cache.Get(query, 55s);
+  REQUIRE(expiring);
+  CHECK(expiring->refresh);
+  CHECK(not cache.Get(query, 56s)->refresh);
+}
+
+TEST_CASE("AnswerCache serves stale positive answers only", "[dns][cache]")
+{
+  AnswerCache cache{16, 10s};
+  const auto query = MakeQuery();
+  REQUIRE(cache.Put(query, MakeReply(query, 5), 0s));
+
+  auto hit = cache.Get(query, 8s);
+  REQUIRE(hit);
+  CHECK(hit->stale);
+  CHECK(hit->refresh);
+  CHECK(AnswerTTL(hit->reply) == AnswerCache::StaleTTL);
+  CHECK(not cache.Get(query, 15s));
+
+  // nxdomain without an soa is cached for the default negative ttl and never served stale
+  const auto nxquery = MakeQuery("nope.loki.");
+  Message nx{nxquery};
+  nx.AddNXReply();
+  REQUIRE(cache.Put(nxquery, nx.ToBuffer(), 0s));
+  REQUIRE(cache.Get(nxquery, 1s));
+  CHECK(not cache.Get(nxquery, std::chrono::seconds{AnswerCache::DefaultNegativeTTL}));
+}
+
+TEST_CASE("AnswerCache rejects uncacheable replies and evicts least recently used", "[dns][cache]")
+{
+  AnswerCache cache{2};
+  const auto query = MakeQuery();
+  Message fail{query};
+  fail.AddServFail();
+  CHECK(not cache.Put(query, fail.ToBuffer(), 0s));
+  CHECK(not cache.Put(query, MakeReply(query, 0), 0s));
+
+  const auto a = MakeQuery("a.loki."), b = MakeQuery("b.loki."), c = MakeQuery("c.loki.");
+  REQUIRE(cache.Put(a, MakeReply(a, 60), 0s));
+  REQUIRE(cache.Put(b, MakeReply(b, 60), 0s));
+  REQUIRE(cache.Get(a, 1s));
+  REQUIRE(cache.Put(c, MakeReply(c, 60), 1s));
+  CHECK(cache.size() == 2);
+  CHECK(cache.Get(a, 2s));
+  CHECK(not cache.Get(b, 2s));
+  CHECK(cache.Get(c, 2s));
+}
+
+TEST_CASE("AnswerCache keeps replies apart by dnssec and edns options", "[dns][cache]")
+{
+  AnswerCache cache;
+  const auto plain = MakeQuery();
+  auto checking = MakeQuery();
+  checking.hdr_fields |= llarp::dns::flags_CD;
+  auto edns = MakeQuery();
+  edns.edns = Message::EDNS{1232, false};
+  auto dnssec = MakeQuery();
+  dnssec.edns = Message::EDNS{1232, true};
+  auto small = MakeQuery();
+  small.edns = Message::EDNS{512, false};
+
+  REQUIRE(cache.Put(plain, MakeReply(plain, 60), 0s));
+  CHECK(cache.Get(plain, 1s));
+  CHECK(not cache.Get(checking, 1s));
+  CHECK(not cache.Get(edns, 1s));
+  CHECK(not cache.Get(dnssec, 1s));
+
+  REQUIRE(cache.Put(edns, MakeReply(edns, 60), 0s));
+  REQUIRE(cache.Put(dnssec, MakeReply(dnssec, 60), 0s));
+  CHECK(cache.size() == 3);
+  CHECK(not cache.Get(small, 1s));
+  // sizes in the same bucket share replies
+  auto bigger = MakeQuery();
+  bigger.edns = Message::EDNS{1400, false};
+  CHECK(cache.Get(bigger, 1s));
+}
+
+namespace
+{
+  /// answers every query itself, like the tun endpoint does for .loki
+  struct CountingResolver : public llarp::dns::Resolver_Base
+  {
+    bool cacheable;
+    int hooked = 0;
+
+    explicit CountingResolver(bool cacheable) : cacheable{cacheable}
+    {}
+
+    int
+    Rank() const override
+    {
+      return 0;
+    }
+
+    std::string_view
+    ResolverName() const override
+    {
+      return "counting";
+    }
+
+    bool
+    AnswersCacheable() const override
+    {
+      return cacheable;
+    }
+
+    bool
+    MaybeHookDNS(
+        std::shared_ptr<llarp::dns::PacketSource_Base> source,
+        const Message& query,
+        const llarp::SockAddr& to,
+        const llarp::SockAddr& from) override
+    {
+      ++hooked;
+      source->SendTo(from, to, MakeReply(query, 60));
+      return true;
+    }
+  };
+
+  struct CountingSource : public llarp::dns::PacketSource_Base
+  {
+    mutable int replies = 0;
+
+    bool
+    WouldLoop(const llarp::SockAddr&, const llarp::SockAddr&) const override
+    {
+      return false;
+    }
+
+    void
+    SendTo(const llarp::SockAddr&, const llarp::SockAddr&, llarp::OwnedBuffer) const override
+    {
+      ++replies;
+    }
+
+    void
+    Stop() override
+    {}
+
+    std::optional<llarp::SockAddr>
+    BoundOn() const override
+    {
+      return std::nullopt;
+    }
+  };
+
+  /// feed the same query to a server with only the given resolver twice, returns how many times
+  /// the resolver was asked
+  int
+  ResolveTwice(bool cacheable)
+  {
+    auto loop = llarp::EventLoop::create();
+    auto server = std::make_shared<llarp::dns::Server>(loop, llarp::DnsConfig{}, 0);
+    auto resolver = std::make_shared<CountingResolver>(cacheable);
+    server->AddResolver(std::weak_ptr<llarp::dns::Resolver_Base>{resolver});
+    auto source = std::make_shared<CountingSource>();
+    const llarp::SockAddr to{"127.0.0.1:53"}, from{"127.0.0.1:1053"};
+    for (int idx = 0; idx < 2; ++idx)
+      REQUIRE(server->MaybeHandlePacket(source, to, from, MakeQuery().ToBuffer()));
+    CHECK(source->replies == 2);
+    return resolver->hooked;
+  }
+}  // namespace
+
+TEST_CASE("Answers lokinet makes up itself are not cached", "[dns][cache]")
+{
+  CHECK(ResolveTwice(true) == 1);
+  CHECK(ResolveTwice(false) == 2);
+}
+
+TEST_CASE("Queries are decoded with their edns options", "[dns]")
+{
+  // header with one question and one additional record, question for "a.loki." type A class IN,
+  // then an opt record: root name, type 41, udp size 4096, dnssec ok, no options
+  std::string wire{
+      "\x00\x01\x01\x00\x00\x01\x00\x00\x00\x00\x00\x01"
+      "\x01"
+      "a\x04loki\x00\x00\x01\x00\x01"
+      "\x00\x00\x29\x10\x00\x00\x00\x80\x00\x00\x00",
+      12 + 12 + 11};
+  auto msg = llarp::dns::MaybeParseDNSMessage(llarp_buffer_t{wire.data(), wire.size()});
+  REQUIRE(msg);
+  REQUIRE(msg->edns);
+  CHECK(msg->edns->udpSize == 4096);
+  CHECK(msg->edns->dnssecOK);
+
+  // without the opt record
+  wire.resize(24);
+  wire[11] = 0;
+  msg = llarp::dns::MaybeParseDNSMessage(llarp_buffer_t{wire.data(), wire.size()});
+  REQUIRE(msg);
+  CHECK(not msg->edns);
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+#include <llarp/ev/loop_profiler.hpp>
+
+#include <thread>
+
+using namespace llarp;
+
+namespace
+{
+  void
+  QuickSite(LoopProfiler& profiler, CallSite site = CallSite::current())
+  {
+    profiler.Run(site, []() {});
+  }
+}  // namespace
+
+TEST_CASE("LoopProfiler does nothing until enabled", "[ev]")
+{
+  LoopProfiler profiler;
+  bool ran = false;
+  profiler.Run(CallSite::current(), [&]() { ran = true; });
+  REQUIRE(ran);
+  REQUIRE(profiler.TopN(10)["sites"] == 0);
+}
+
+TEST_CASE("LoopProfiler ranks sites by time spent", "[ev]")
+{
+  LoopProfiler profiler;
+  profiler.Enable(1s);
+
+  auto slow = []() { std::this_thread::sleep_for(5ms); };
+  for (int i = 0; i < 3; ++i)
+    profiler.Run(CallSite::current(), slow);
+  // the same wrapper called from two places is two sites
+  for (int i = 0; i < 50; ++i)
+    QuickSite(profiler);
+  for (int i = 0; i < 50; ++i)
+    QuickSite(profiler);
+
+  const auto profile = profiler.TopN(1);
+  REQUIRE(profile["enabled"] == true);
+  REQUIRE(profile["sites"] == 3);
+  REQUIRE(profile["top"].size() == 1);
+  const auto& top = profile["top"][0];
+  REQUIRE(top["calls"] == 3);
+  REQUIRE(top["stalls"] == 0);
+  REQUIRE(top["maxUs"].get<int64_t>() >= 5000);
+  REQUIRE(top["p99Us"].get<int64_t>() >= 4095);
+  // named after where it was handed over
+  const auto name = top["site"].get<std::string>();
+  REQUIRE(name.find("test_llarp_ev_loop_profiler.cpp:") != std::string::npos);
+
+  profiler.Reset();
+  REQUIRE(profiler.TopN(10)["sites"] == 0);
+}
+
+TEST_CASE("LoopProfiler counts stalls", "[ev]")
+{
+  LoopProfiler profiler;
+  profiler.Enable(1ms);
+  const auto site = CallSite::current();
+  profiler.Record(site, 2ms);
+  profiler.Record(site, 10us);
+  const auto top = profiler.TopN(10)["top"];
+  REQUIRE(top.size() == 1);
+  REQUIRE(top[0]["calls"] == 2);
+  REQUIRE(top[0]["stalls"] == 1);
+  REQUIRE(top[0]["site"] == LoopProfiler::SiteName(site));
+}
@@ -0,0 +1,334 @@
+#include "llarp_test.hpp"
+#include <llarp/iwp/handshake_guard.hpp>
+#include <llarp/iwp/session.hpp>
+
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+using iwp::HandshakeGuard;
+
+using HandshakeTest = test::LlarpTest<>;
+
+namespace
+{
+  struct Initiator
+  {
+    SecretKey identity;
+    SecretKey onion;
+
+    Initiator()
+    {
+      CryptoManager::instance()->identity_keygen(identity);
+      CryptoManager::instance()->encryption_keygen(onion);
+    }
+
+    /// make an intro to a responder the way an outbound session does, encrypted to introKey
+    ILinkSession::Packet_t
+    MakeIntro(
+        const TunnelNonce& N,
+        const SharedSecret& introKey,
+        std::optional<iwp::HandshakeCookie> cookie = std::nullopt) const
+    {
+      const size_t cookieSize = cookie ? cookie->size() : 0;
+      ILinkSession::Packet_t pkt(iwp::Introduction::SIZE + iwp::PacketOverhead + cookieSize);
+      auto itr = pkt.data() + iwp::PacketOverhead;
+      itr = std::copy_n(identity.toPublic().data(), PubKey::SIZE, itr);
+      itr = std::copy_n(onion.toPublic().data(), PubKey::SIZE, itr);
+      itr = std::copy_n(N.data(), N.size(), itr);
+      Signature Z;
+      CryptoManager::instance()->sign(
+          Z,
+          identity,
+          llarp_buffer_t{
+              pkt.data() + iwp::PacketOverhead, iwp::Introduction::SIZE - Signature::SIZE});
+      itr = std::copy_n(Z.data(), Z.size(), itr);
+      if (cookie)
+        std::copy_n(cookie->data(), cookieSize, itr);
+      CryptoManager::instance()->randbytes(pkt.data() + HMACSIZE, TUNNONCESIZE);
+      iwp::EncryptPacket(pkt, introKey);
+      return pkt;
+    }
+  };
+
+  struct Responder
+  {
+    SecretKey identity;
+    SecretKey transport;
+    SharedSecret introKey;
+
+    Responder()
+    {
+      CryptoManager::instance()->identity_keygen(identity);
+      CryptoManager::instance()->encryption_keygen(transport);
+      CryptoManager::instance()->shorthash(introKey, llarp_buffer_t(identity.toPublic()));
+    }
+  };
+
+  SockAddr
+  Source(uint32_t idx, uint16_t port = 1090)
+  {
+    return SockAddr{10, uint8_t(idx >> 16), uint8_t(idx >> 8), uint8_t(idx), huint16_t{port}};
+  }
+}  // namespace
+
+TEST_CASE_METHOD(HandshakeTest, "Intros are verified and keyed outside of a session", "[iwp]")
+{
+  const Initiator initiator;
+  const Responder responder;
+  TunnelNonce N;
+  N.Randomize();
+
+  auto pkt = initiator.MakeIntro(N, responder.introKey);
+  REQUIRE(iwp::DecryptPacket(pkt, responder.introKey));
+  const auto intro = iwp::Session::VerifyIntro(pkt, responder.transport);
+  REQUIRE(intro);
+  CHECK(intro->ident == initiator.identity.toPublic());
+  CHECK(intro->onionKey == initiator.onion.toPublic());
+
+  // both ends end up with the same session key
+  SharedSecret clientKey;
+  REQUIRE(CryptoManager::instance()->transport_dh_client(
+      clientKey, responder.transport.toPublic(), initiator.onion, N));
+  CHECK(intro->sessionKey == clientKey);
+
+  // anything touched in transit fails
+  pkt[iwp::PacketOverhead + PubKey::SIZE] ^= 1;
+  CHECK_FALSE(iwp::Session::VerifyIntro(pkt, responder.transport));
+}
+
+TEST_CASE_METHOD(HandshakeTest, "HandshakeGuard demands cookies when busy", "[iwp]")
+{
+  using Verdict = HandshakeGuard::Verdict;
+  HandshakeGuard guard;
+  const auto now = 1h;
+  guard.Decay(now);
+  const auto from = Source(1);
+  const auto busy = HandshakeGuard::CookieThreshold;
+
+  CHECK(guard.Admit(from, std::nullopt, 0, now) == Verdict::Accept);
+  CHECK(guard.Admit(from, std::nullopt, busy, now) == Verdict::SendCookie);
+
+  // a cookie only works from the address we sent it to
+  const auto cookie = guard.MakeCookie(from);
+  CHECK(guard.Admit(from, cookie, busy, now) == Verdict::Accept);
+  CHECK(guard.Admit(Source(2), cookie, busy, now) == Verdict::SendCookie);
+  CHECK(guard.Admit(from, cookie, HandshakeGuard::MaxInFlight, now) == Verdict::Drop);
+
+  // and outlives one rotation of the secret but not two
+  guard.Decay(now + HandshakeGuard::CookieInterval);
+  CHECK(guard.CheckCookie(from, cookie));
+  guard.Decay(now + HandshakeGuard::CookieInterval * 2);
+  CHECK_FALSE(guard.CheckCookie(from, cookie));
+}
+
+TEST_CASE_METHOD(HandshakeTest, "HandshakeGuard rate limits intros per source ip", "[iwp]")
+{
+  using Verdict = HandshakeGuard::Verdict;
+  HandshakeGuard guard;
+  const auto now = 1h;
+  for (size_t i = 0; i < HandshakeGuard::MaxIntrosPerSource; ++i)
+    REQUIRE(guard.Admit(Source(1, 1000 + i), std::nullopt, 0, now) == Verdict::Accept);
+  CHECK(guard.Admit(Source(1, 2000), std::nullopt, 0, now) == Verdict::Drop);
+  CHECK(guard.Admit(Source(2), std::nullopt, 0, now) == Verdict::Accept);
+
+  guard.Decay(now + HandshakeGuard::RateInterval);
+  CHECK(guard.Admit(Source(1, 2000), std::nullopt, 0, now + HandshakeGuard::RateInterval)
+        == Verdict::Accept);
+  CHECK(guard.ExtractStatus()["rateLimited"] == 1);
+}
+
+namespace
+{
+  using bench_clock = std::chrono::steady_clock;
+
+  /// stands in for the worker pool of a router
+  class WorkerPool
+  {
+   public:
+    explicit WorkerPool(size_t n)
+    {
+      for (size_t i = 0; i < n; ++i)
+        m_Threads.emplace_back([this]() { Run(); });
+    }
+
+    ~WorkerPool()
+    {
+      {
+        std::lock_guard lock{m_Mutex};
+        m_Stop = true;
+      }
+      m_Cond.notify_all();
+      for (auto& thread : m_Threads)
+        thread.join();
+    }
+
+    void
+    Queue(std::function<void()> job)
+    {
+      {
+        std::lock_guard lock{m_Mutex};
+        m_Jobs.push_back(std::move(job));
+      }
+      m_Cond.notify_one();
+    }
+
+   private:
+    void
+    Run()
+    {
+      std::unique_lock lock{m_Mutex};
+      while (true)
+      {
+        m_Cond.wait(lock, [this]() { return m_Stop or not m_Jobs.empty(); });
+        if (m_Jobs.empty())
+          return;
+        auto job = std::move(m_Jobs.front());
+        m_Jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+      }
+    }
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Cond;
+    std::deque<std::function<void()>> m_Jobs;
+    bool m_Stop = false;
+    std::vector<std::thread> m_Threads;
+  };
+
+  struct FloodResult
+  {
+    double handshakesPerSecond;
+    std::chrono::duration<double, std::milli> maxStall;
+    std::chrono::duration<double, std::milli> totalLoopTime;
+  };
+
+  void
+  PrintFlood(std::string_view name, const FloodResult& result)
+  {
+    fmt::print(
+        "{}: {:.0f} handshakes/s, event loop busy {:.1f}ms in total, longest stall {:.2f}ms\n",
+        name,
+        result.handshakesPerSecond,
+        result.totalLoopTime.count(),
+        result.maxStall.count());
+  }
+}  // namespace
+
+TEST_CASE_METHOD(HandshakeTest, "Inbound handshake flood", "[.bench][iwp]")
+{
+  static constexpr size_t intros = 4000;
+  // how many packets the event loop reads off the socket in one go
+  static constexpr size_t batch = 64;
+
+  const Responder responder;
+  std::vector<std::pair<SockAddr, ILinkSession::Packet_t>> flood;
+  for (uint32_t idx = 0; idx < intros; ++idx)
+  {
+    const Initiator initiator;
+    TunnelNonce N;
+    N.Randomize();
+    flood.emplace_back(Source(idx), initiator.MakeIntro(N, responder.introKey));
+  }
+
+  // what we used to do: verify and key exchange right on the event loop
+  const auto inlineResult = [&]() {
+    FloodResult result{};
+    const auto start = bench_clock::now();
+    for (size_t idx = 0; idx < flood.size(); idx += batch)
+    {
+      const auto batchStart = bench_clock::now();
+      for (size_t i = idx; i < std::min(idx + batch, flood.size()); ++i)
+      {
+        auto pkt = flood[i].second;
+        REQUIRE(iwp::DecryptPacket(pkt, responder.introKey));
+        REQUIRE(iwp::Session::VerifyIntro(pkt, responder.transport));
+      }
+      result.maxStall = std::max<decltype(result.maxStall)>(
+          result.maxStall, bench_clock::now() - batchStart);
+    }
+    const std::chrono::duration<double> took = bench_clock::now() - start;
+    result.totalLoopTime = took;
+    result.handshakesPerSecond = flood.size() / took.count();
+    return result;
+  }();
+  PrintFlood("verified on the event loop", inlineResult);
+
+  // guarded and verified on the worker pool, with the event loop only decrypting and admitting
+  const auto pooledResult = [&]() {
+    FloodResult result{};
+    HandshakeGuard guard;
+    std::atomic<size_t> verified = 0;
+    const auto start = bench_clock::now();
+    {
+      WorkerPool pool{std::max(2u, std::thread::hardware_concurrency()) - 1};
+      for (size_t idx = 0; idx < flood.size(); idx += batch)
+      {
+        const auto batchStart = bench_clock::now();
+        for (size_t i = idx; i < std::min(idx + batch, flood.size()); ++i)
+        {
+          auto pkt = flood[i].second;
+          REQUIRE(iwp::DecryptPacket(pkt, responder.introKey));
+          const auto verdict = guard.Admit(flood[i].first, std::nullopt, 0, 1h);
+          REQUIRE(verdict == HandshakeGuard::Verdict::Accept);
+          pool.Queue([&responder, &verified, pkt = std::move(pkt)]() {
+            if (iwp::Session::VerifyIntro(pkt, responder.transport))
+              verified++;
+          });
+        }
+        const std::chrono::duration<double, std::milli> took = bench_clock::now() - batchStart;
+        result.maxStall = std::max(result.maxStall, took);
+        result.totalLoopTime += took;
+      }
+    }
+    const std::chrono::duration<double> took = bench_clock::now() - start;
+    REQUIRE(verified == flood.size());
+    result.handshakesPerSecond = flood.size() / took.count();
+    return result;
+  }();
+  PrintFlood("verified on the worker pool", pooledResult);
+
+  // spoofed intros while busy only ever cost us a cookie
+  const auto spoofedResult = [&]() {
+    FloodResult result{};
+    HandshakeGuard guard;
+    const auto start = bench_clock::now();
+    for (size_t idx = 0; idx < flood.size(); idx += batch)
+    {
+      const auto batchStart = bench_clock::now();
+      for (size_t i = idx; i < std::min(idx + batch, flood.size()); ++i)
+      {
+        auto pkt = flood[i].second;
+        REQUIRE(iwp::DecryptPacket(pkt, responder.introKey));
+        const auto verdict =
+            guard.Admit(flood[i].first, std::nullopt, HandshakeGuard::CookieThreshold, 1h);
+        REQUIRE(verdict == HandshakeGuard::Verdict::SendCookie);
+        const auto cookie = guard.MakeCookie(flood[i].first);
+        ILinkSession::Packet_t reply(cookie.size() + iwp::PacketOverhead);
+        std::copy_n(cookie.data(), cookie.size(), reply.data() + iwp::PacketOverhead);
+        iwp::EncryptPacket(reply, responder.introKey);
+      }
+      result.maxStall = std::max<decltype(result.maxStall)>(
+          result.maxStall, bench_clock::now() - batchStart);
+    }
+    const std::chrono::duration<double> took = bench_clock::now() - start;
+    result.totalLoopTime = took;
+    result.handshakesPerSecond = flood.size() / took.count();
+    return result;
+  }();
+  PrintFlood("spoofed intros answered with cookies", spoofedResult);
+
+  CHECK(pooledResult.maxStall < inlineResult.maxStall);
+  CHECK(spoofedResult.totalLoopTime < inlineResult.totalLoopTime);
+}
@@ -77,7 +77,7 @@ namespace mocks
     }
 
     std::shared_ptr<llarp::UDPHandle>
-    make_udp(UDPReceiveFunc recv) override
+    make_udp(UDPReceiveFunc recv, llarp::CallSite = llarp::CallSite::current()) override
     {
       return std::make_shared<MockUDPHandle>(this, recv);
     }
@@ -0,0 +1,367 @@
+#include <llarp/net/ip_offload.hpp>
+#include <llarp/net/ip_packet.hpp>
+
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+#include <oxenc/endian.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string_view>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace llarp;
+
+namespace
+{
+  /// the checksum one 16 bit word at a time, as ipchksum used to do it
+  uint16_t
+  ReferenceChecksum(const byte_t* buf, size_t sz, uint32_t sum = 0)
+  {
+    for (; sz > 1; buf += 2, sz -= 2)
+    {
+      uint16_t word;
+      std::memcpy(&word, buf, sizeof(word));
+      sum += word;
+    }
+    if (sz != 0)
+    {
+      uint16_t x = 0;
+      *(byte_t*)&x = *buf;
+      sum += x;
+    }
+    sum = (sum & 0xFFff) + (sum >> 16);
+    sum += sum >> 16;
+    return uint16_t((~sum) & 0xFFff);
+  }
+
+  /// the pseudo header a tcp checksum covers, followed by the tcp segment
+  std::vector<byte_t>
+  PseudoAndSegment(const byte_t* ip, size_t sz)
+  {
+    const bool v6 = (ip[0] >> 4) == 6;
+    const size_t iphlen = v6 ? 40 : (ip[0] & 0x0F) * 4;
+    const size_t l4len = sz - iphlen;
+    std::vector<byte_t> buf;
+    buf.insert(buf.end(), ip + (v6 ? 8 : 12), ip + (v6 ? 40 : 20));
+    buf.insert(buf.end(), {0, 0, byte_t(l4len >> 8), byte_t(l4len), 0, 6});
+    buf.insert(buf.end(), ip + iphlen, ip + sz);
+    return buf;
+  }
+
+  /// what a segment left for the kernel to checksum has in its checksum field: the folded sum of
+  /// its pseudo header, not inverted
+  uint16_t
+  PseudoHeaderSeed(const byte_t* ip, size_t sz)
+  {
+    const bool v6 = (ip[0] >> 4) == 6;
+    const size_t iphlen = v6 ? 40 : (ip[0] & 0x0F) * 4;
+    auto buf = PseudoAndSegment(ip, sz);
+    buf.resize(buf.size() - (sz - iphlen));
+    return uint16_t(~ReferenceChecksum(buf.data(), buf.size()));
+  }
+
+  bool
+  ChecksumsOK(const byte_t* ip, size_t sz)
+  {
+    const bool v6 = (ip[0] >> 4) == 6;
+    if (not v6 and ReferenceChecksum(ip, (ip[0] & 0x0F) * 4) != 0)
+      return false;
+    const auto buf = PseudoAndSegment(ip, sz);
+    return ReferenceChecksum(buf.data(), buf.size()) == 0;
+  }
+
+  constexpr size_t TCPHeaderLen = 32;
+
+  /// a tcp segment from 10.0.0.1:1234 to 10.0.0.2:80, or fd00::1 to fd00::2, with a timestamp
+  /// option and a payload of byte values following on from seq
+  std::vector<byte_t>
+  MakeTCP(bool v6, uint32_t seq, size_t payload, uint8_t flags = 0x10, uint16_t id = 0)
+  {
+    const size_t iphlen = v6 ? 40 : 20;
+    std::vector<byte_t> pkt(iphlen + TCPHeaderLen + payload);
+    byte_t* ip = pkt.data();
+    if (v6)
+    {
+      ip[0] = 0x60;
+      oxenc::write_host_as_big<uint16_t>(pkt.size() - iphlen, ip + 4);
+      ip[6] = 6;
+      ip[7] = 64;
+      ip[8] = ip[24] = 0xfd;
+      ip[23] = 1;
+      ip[39] = 2;
+    }
+    else
+    {
+      ip[0] = 0x45;
+      oxenc::write_host_as_big<uint16_t>(pkt.size(), ip + 2);
+      oxenc::write_host_as_big<uint16_t>(id, ip + 4);
+      ip[6] = 0x40;
+      ip[8] = 64;
+      ip[9] = 6;
+      ip[12] = ip[16] = 10;
+      ip[15] = 1;
+      ip[19] = 2;
+      const auto check = ReferenceChecksum(ip, iphlen);
+      std::memcpy(ip + 10, &check, sizeof(check));
+    }
+    byte_t* tcp = ip + iphlen;
+    oxenc::write_host_as_big<uint16_t>(1234, tcp);
+    oxenc::write_host_as_big<uint16_t>(80, tcp + 2);
+    oxenc::write_host_as_big<uint32_t>(seq, tcp + 4);
+    oxenc::write_host_as_big<uint32_t>(1, tcp + 8);
+    tcp[12] = (TCPHeaderLen / 4) << 4;
+    tcp[13] = flags;
+    oxenc::write_host_as_big<uint16_t>(0xFFff, tcp + 14);
+    const byte_t options[12] = {1, 1, 8, 10, 0, 0, 0, 42, 0, 0, 0, 7};
+    std::copy_n(options, sizeof(options), tcp + 20);
+    for (size_t idx = 0; idx < payload; ++idx)
+      tcp[TCPHeaderLen + idx] = byte_t(seq + idx);
+
+    const auto buf = PseudoAndSegment(ip, pkt.size());
+    const auto check = ReferenceChecksum(buf.data(), buf.size());
+    std::memcpy(tcp + 16, &check, sizeof(check));
+    return pkt;
+  }
+
+  net::vnet_header
+  GSOHeader(bool v6, uint16_t gso_size)
+  {
+    net::vnet_header hdr{};
+    hdr.flags = net::vnet_header::NeedsChecksum;
+    hdr.gso_type = v6 ? net::vnet_header::GSOTCPv6 : net::vnet_header::GSOTCPv4;
+    hdr.gso_size = gso_size;
+    hdr.hdr_len = (v6 ? 40 : 20) + TCPHeaderLen;
+    hdr.csum_start = v6 ? 40 : 20;
+    hdr.csum_offset = 16;
+    return hdr;
+  }
+
+  byte_view_t
+  View(const std::vector<byte_t>& buf)
+  {
+    return byte_view_t{buf.data(), buf.size()};
+  }
+}  // namespace
+
+TEST_CASE("ipchksum matches a sum of 16 bit words", "[net]")
+{
+  std::mt19937 rng{42};
+  std::vector<byte_t> data(65535 + 4);
+  for (auto& b : data)
+    b = byte_t(rng());
+
+  for (size_t sz = 0; sz < 300; ++sz)
+    for (size_t off = 0; off < 4; ++off)
+      for (uint32_t seed : {0u, 0xFFffu, 0x1234'5678u})
+        REQUIRE(
+            net::ipchksum(data.data() + off, sz, seed)
+            == ReferenceChecksum(data.data() + off, sz, seed));
+
+  for (size_t sz : {1499, 1500, 9000, 65535})
+    REQUIRE(net::ipchksum(data.data() + 1, sz) == ReferenceChecksum(data.data() + 1, sz));
+
+  // every carry there is
+  std::fill(data.begin(), data.end(), 0xFF);
+  REQUIRE(net::ipchksum(data.data(), 65535) == ReferenceChecksum(data.data(), 65535));
+  REQUIRE(net::ipchksum(data.data(), 0) == 0xFFff);
+}
+
+TEST_CASE("Offloaded tcp super packets split into checksummed segments", "[net]")
+{
+  const bool v6 = GENERATE(false, true);
+  constexpr uint32_t seq = 0xFFff'F000;  // wraps partway through
+  constexpr size_t payload = 20'000;
+  const size_t iphlen = v6 ? 40 : 20;
+  // what linux asks for with a 1500 byte mtu on ipv4, which is as big as fits in a lokinet frame;
+  // with ipv6 headers we have to cut segments smaller than the kernel asked for
+  constexpr uint16_t gso_size = 1448;
+  const size_t mss = std::min<size_t>(gso_size, net::IPPacket::MaxSize - iphlen - TCPHeaderLen);
+  const auto super = MakeTCP(v6, seq, payload, 0x18, 7);
+
+  const auto segments = net::SplitOffloaded(GSOHeader(v6, gso_size), View(super));
+  REQUIRE(segments.size() == (payload + mss - 1) / mss);
+  std::vector<byte_t> joined;
+  for (size_t idx = 0; idx < segments.size(); ++idx)
+  {
+    const auto& seg = segments[idx];
+    const bool last = idx + 1 == segments.size();
+    const byte_t* tcp = seg.data() + iphlen;
+    REQUIRE(seg.size() <= net::IPPacket::MaxSize);
+    REQUIRE(seg.size() - iphlen - TCPHeaderLen == (last ? payload % mss : mss));
+    REQUIRE(oxenc::load_big_to_host<uint32_t>(tcp + 4) == uint32_t(seq + idx * mss));
+    REQUIRE(tcp[13] == (last ? 0x18 : 0x10));
+    if (not v6)
+      REQUIRE(oxenc::load_big_to_host<uint16_t>(seg.data() + 4) == 7 + idx);
+    REQUIRE(ChecksumsOK(seg.data(), seg.size()));
+    joined.insert(joined.end(), tcp + TCPHeaderLen, seg.data() + seg.size());
+  }
+  REQUIRE(std::equal(joined.begin(), joined.end(), super.end() - payload));
+
+  // as with a jumbo mtu
+  for (const auto& seg : net::SplitOffloaded(GSOHeader(v6, 9000), View(super)))
+  {
+    REQUIRE(seg.size() <= net::IPPacket::MaxSize);
+    REQUIRE(ChecksumsOK(seg.data(), seg.size()));
+  }
+
+  // the gso type has to agree with the packet
+  REQUIRE(net::SplitOffloaded(GSOHeader(not v6, gso_size), View(super)).empty());
+}
+
+TEST_CASE("Checksums the kernel leaves to us get finished", "[net]")
+{
+  const bool v6 = GENERATE(false, true);
+  auto pkt = MakeTCP(v6, 1000, 999);
+  const size_t iphlen = v6 ? 40 : 20;
+
+  // what the kernel leaves in the checksum field is the folded pseudo header sum
+  std::vector<byte_t> pseudo = PseudoAndSegment(pkt.data(), pkt.size());
+  pseudo.resize(pseudo.size() - (pkt.size() - iphlen));
+  const uint16_t partial = ~ReferenceChecksum(pseudo.data(), pseudo.size());
+  std::memcpy(pkt.data() + iphlen + 16, &partial, sizeof(partial));
+  REQUIRE_FALSE(ChecksumsOK(pkt.data(), pkt.size()));
+
+  auto hdr = GSOHeader(v6, 0);
+  hdr.gso_type = net::vnet_header::GSONone;
+  const auto finished = net::SplitOffloaded(hdr, View(pkt));
+  REQUIRE(finished.size() == 1);
+  REQUIRE(ChecksumsOK(finished[0].data(), finished[0].size()));
+}
+
+TEST_CASE("Coalesced segments split back into the same segments", "[net]")
+{
+  const bool v6 = GENERATE(false, true);
+  const auto super = MakeTCP(v6, 1, 30'000, 0x18, 100);
+  const auto segments = net::SplitOffloaded(GSOHeader(v6, 1400), View(super));
+
+  net::TCPCoalescer coalescer;
+  for (const auto& seg : segments)
+    REQUIRE(coalescer.Append(seg));
+  const auto written = coalescer.Flush();
+  REQUIRE(coalescer.empty());
+
+  net::vnet_header hdr;
+  std::memcpy(&hdr, written.data(), sizeof(hdr));
+  REQUIRE(hdr.gso_type == GSOHeader(v6, 0).gso_type);
+  REQUIRE(hdr.gso_size == 1400);
+  REQUIRE(hdr.flags == net::vnet_header::NeedsChecksum);
+  const byte_view_t joined{written.data() + sizeof(hdr), written.size() - sizeof(hdr)};
+  REQUIRE(joined.size() == super.size());
+  // the kernel finishes the checksum from the pseudo header sum it finds there
+  uint16_t seed;
+  std::memcpy(&seed, joined.data() + (v6 ? 40 : 20) + 16, sizeof(seed));
+  REQUIRE(seed == PseudoHeaderSeed(joined.data(), joined.size()));
+
+  const auto again = net::SplitOffloaded(hdr, joined);
+  REQUIRE(again.size() == segments.size());
+  for (size_t idx = 0; idx < segments.size(); ++idx)
+    REQUIRE(again[idx].view() == segments[idx].view());
+}
+
+TEST_CASE("Coalescing only joins a burst of one flow in order", "[net]")
+{
+  const bool v6 = GENERATE(false, true);
+  net::TCPCoalescer coalescer;
+  REQUIRE(coalescer.Append(net::IPPacket{MakeTCP(v6, 0, 1000, 0x10, 1)}));
+
+  // out of order, or from another flow
+  REQUIRE_FALSE(coalescer.Append(net::IPPacket{MakeTCP(v6, 2000, 1000, 0x10, 2)}));
+  auto other = MakeTCP(v6, 1000, 1000, 0x10, 2);
+  other[(v6 ? 40 : 20) + 1] = 81;
+  REQUIRE_FALSE(coalescer.Append(net::IPPacket{View(other)}));
+  // not plain data, or bigger than the first segment
+  REQUIRE_FALSE(coalescer.Append(net::IPPacket{MakeTCP(v6, 1000, 1000, 0x11, 2)}));
+  REQUIRE_FALSE(coalescer.Append(net::IPPacket{MakeTCP(v6, 1000, 0, 0x10, 2)}));
+  REQUIRE_FALSE(coalescer.Append(net::IPPacket{MakeTCP(v6, 1000, 1001, 0x10, 2)}));
+
+  // a short segment ends the burst
+  REQUIRE(coalescer.Append(net::IPPacket{MakeTCP(v6, 1000, 500, 0x10, 2)}));
+  REQUIRE_FALSE(coalescer.Append(net::IPPacket{MakeTCP(v6, 1500, 500, 0x10, 3)}));
+
+  // a lone segment goes out as it is
+  coalescer.Flush();
+  const auto lone = MakeTCP(v6, 1500, 500, 0x10, 3);
+  REQUIRE(coalescer.Append(net::IPPacket{View(lone)}));
+  const auto written = coalescer.Flush();
+  REQUIRE(std::all_of(written.begin(), written.begin() + sizeof(net::vnet_header), [](auto b) {
+    return b == 0;
+  }));
+  REQUIRE(std::equal(written.begin() + sizeof(net::vnet_header), written.end(), lone.begin()));
+}
+
+#ifndef _WIN32
+TEST_CASE("Bulk tcp through a tun with and without offload", "[.bench][net]")
+{
+  // we cannot make a tun here, so a seqpacket socketpair stands in for it: it costs a syscall and
+  // a copy per packet each way, like a tun does, but none of the kernel's own tcp work is counted
+  static constexpr size_t total = 512 * 1024 * 1024;
+  static constexpr size_t mss = 1448;
+  int fds[2];
+  REQUIRE(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+  for (int fd : fds)
+  {
+    int bufsize = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+  }
+
+  const auto super = MakeTCP(false, 0, 44 * mss, 0x18);
+  const auto hdr = GSOHeader(false, mss);
+  const auto segments = net::SplitOffloaded(hdr, View(super));
+  std::vector<byte_t> buf(sizeof(net::vnet_header) + net::MaxOffloadSize);
+
+  const auto run = [](std::string_view name, auto&& burst) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t sent = 0; sent < total; sent += 44 * mss)
+      burst();
+    const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+    fmt::print("{:<44} {:>6.2f} Gbit/s\n", name, total * 8 / took.count() / 1e9);
+  };
+
+  run("read, one packet per mtu", [&]() {
+    for (const auto& seg : segments)
+    {
+      REQUIRE(write(fds[1], seg.data(), seg.size()) > 0);
+      std::vector<byte_t> pkt(net::IPPacket::MaxSize);
+      pkt.resize(read(fds[0], pkt.data(), pkt.size()));
+      net::IPPacket{std::move(pkt)};
+    }
+  });
+  run("read, gso super packet split by us", [&]() {
+    iovec iov[2] = {
+        {const_cast<net::vnet_header*>(&hdr), sizeof(hdr)},
+        {const_cast<byte_t*>(super.data()), super.size()}};
+    REQUIRE(writev(fds[1], iov, 2) > 0);
+    const auto sz = read(fds[0], buf.data(), buf.size());
+    net::vnet_header got;
+    std::memcpy(&got, buf.data(), sizeof(got));
+    net::SplitOffloaded(got, byte_view_t{buf.data() + sizeof(got), size_t(sz) - sizeof(got)});
+  });
+  run("write, one packet per mtu", [&]() {
+    for (const auto& seg : segments)
+    {
+      REQUIRE(write(fds[0], seg.data(), seg.size()) > 0);
+      REQUIRE(read(fds[1], buf.data(), buf.size()) > 0);
+    }
+  });
+  run("write, coalesced by us", [&]() {
+    net::TCPCoalescer coalescer;
+    for (const auto& seg : segments)
+      coalescer.Append(seg);
+    const auto out = coalescer.Flush();
+    REQUIRE(write(fds[0], out.data(), out.size()) > 0);
+    REQUIRE(read(fds[1], buf.data(), buf.size()) > 0);
+  });
+
+  close(fds[0]);
+  close(fds[1]);
+}
+#endif
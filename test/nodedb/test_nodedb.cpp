@@ -1,9 +1,23 @@
 #include <catch2/catch.hpp>
 
 #include <llarp/config/config.hpp>
+#include <llarp/dht/bucket.hpp>
+#include <llarp/dht/node.hpp>
+#include <llarp/path/path.hpp>
 #include <llarp/router_contact.hpp>
 #include <llarp/nodedb.hpp>
 
+#include <fmt/core.h>
+
+#include <fstream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 using llarp_nodedb = llarp::NodeDB;
 
 TEST_CASE("FindClosestTo returns correct number of elements", "[nodedb][dht]")
@@ -65,3 +79,241 @@ TEST_CASE("FindClosestTo returns properly ordered set", "[nodedb][dht]")
   REQUIRE(c.pubkey == results[0].pubkey);
   REQUIRE(b.pubkey == results[1].pubkey);
 }
+
+TEST_CASE("FindClosestTo shares the rc the nodedb holds", "[nodedb][dht]")
+{
+  llarp_nodedb nodeDB;
+  REQUIRE_FALSE(nodeDB.FindClosestTo(llarp::dht::Key_t{}));
+
+  for (byte_t idx = 1; idx <= 3; ++idx)
+  {
+    llarp::RouterContact rc;
+    rc.pubkey[0] = idx;
+    nodeDB.Put(rc);
+  }
+  llarp::dht::Key_t key;
+  key[0] = 3;
+  const auto closest = nodeDB.FindClosestTo(key);
+  REQUIRE(closest);
+  REQUIRE(closest->pubkey[0] == 3);
+  REQUIRE(closest == nodeDB.Get(closest->pubkey));
+}
+
+TEST_CASE("Get and GetRandom share the rc the nodedb holds", "[nodedb]")
+{
+  llarp_nodedb nodeDB;
+  llarp::RouterContact rc;
+  rc.pubkey[0] = 1;
+  rc.SetNick("shared");
+  nodeDB.Put(rc);
+
+  const auto got = nodeDB.Get(rc.pubkey);
+  REQUIRE(got);
+  REQUIRE(got == nodeDB.GetRandom([](const auto&) { return true; }));
+  REQUIRE(got->Nick() == "shared");
+  REQUIRE(not nodeDB.Get(llarp::RouterID{}));
+
+  // a handle stays valid after the nodedb replaces its entry
+  llarp::RouterContact newer = rc;
+  newer.last_updated = rc.last_updated + std::chrono::seconds{1};
+  newer.SetNick("newer");
+  nodeDB.Put(newer);
+  REQUIRE(got->Nick() == "shared");
+  REQUIRE(nodeDB.Get(rc.pubkey)->Nick() == "newer");
+}
+
+/// every entry shows up exactly once in the map and in both indexes
+static void
+RequireIndexed(llarp_nodedb& nodeDB, const std::set<llarp::RouterID>& want)
+{
+  std::set<llarp::RouterID> inMap, byInsertion, byExpiry;
+  nodeDB.VisitAll([&](const auto& rc) { inMap.emplace(rc.pubkey); });
+  size_t visited = 0;
+  nodeDB.VisitInsertedBefore(
+      [&](const auto& rc) {
+        byInsertion.emplace(rc.pubkey);
+        visited++;
+      },
+      llarp_time_t::max());
+  REQUIRE(visited == byInsertion.size());
+  visited = 0;
+  nodeDB.RemoveExpired(llarp_time_t::max(), [&](const auto& rc) {
+    byExpiry.emplace(rc.pubkey);
+    visited++;
+    return true;
+  });
+  REQUIRE(visited == byExpiry.size());
+
+  REQUIRE(nodeDB.NumLoaded() == want.size());
+  REQUIRE(inMap == want);
+  REQUIRE(byInsertion == want);
+  REQUIRE(byExpiry == want);
+}
+
+static llarp::RouterContact
+MakeRC(uint8_t id, llarp_time_t updated)
+{
+  llarp::RouterContact rc;
+  rc.pubkey[0] = id;
+  rc.last_updated = updated;
+  return rc;
+}
+
+TEST_CASE("NodeDB indexes agree with its entries", "[nodedb]")
+{
+  using namespace std::literals;
+  llarp_nodedb nodeDB;
+  const auto a = MakeRC(1, 1000s), b = MakeRC(2, 2000s), c = MakeRC(3, 3000s);
+
+  SECTION("after inserts")
+  {
+    nodeDB.Put(a);
+    nodeDB.Put(b);
+    nodeDB.Put(c);
+    RequireIndexed(nodeDB, {a.pubkey, b.pubkey, c.pubkey});
+  }
+
+  SECTION("after updates")
+  {
+    nodeDB.Put(a);
+    nodeDB.Put(b);
+    // so that the update is not inserted in the same millisecond
+    std::this_thread::sleep_for(2ms);
+    nodeDB.Put(MakeRC(1, 5000s));
+    RequireIndexed(nodeDB, {a.pubkey, b.pubkey});
+    // an older rc does not replace what we have
+    nodeDB.PutIfNewer(a);
+    RequireIndexed(nodeDB, {a.pubkey, b.pubkey});
+
+    // the updated entry expires when its new rc does and counts as inserted last
+    std::vector<llarp::RouterID> order;
+    nodeDB.VisitInsertedBefore(
+        [&](const auto& rc) { order.emplace_back(rc.pubkey); }, llarp_time_t::max());
+    REQUIRE(order.back() == a.pubkey);
+    nodeDB.RemoveExpired(a.ExpiresAt(), [](const auto&) { return false; });
+    RequireIndexed(nodeDB, {a.pubkey, b.pubkey});
+    nodeDB.RemoveExpired(b.ExpiresAt(), [](const auto&) { return false; });
+    RequireIndexed(nodeDB, {a.pubkey});
+  }
+
+  SECTION("after removes")
+  {
+    nodeDB.Put(a);
+    nodeDB.Put(b);
+    nodeDB.Put(c);
+    nodeDB.Remove(b.pubkey);
+    RequireIndexed(nodeDB, {a.pubkey, c.pubkey});
+    nodeDB.RemoveIf([&](const auto& rc) { return rc.pubkey == a.pubkey; });
+    RequireIndexed(nodeDB, {c.pubkey});
+    nodeDB.RemoveMany({c.pubkey}, [](const auto&) { return true; });
+    RequireIndexed(nodeDB, {c.pubkey});
+    nodeDB.RemoveStaleRCs({}, llarp_time_t::max());
+    RequireIndexed(nodeDB, {});
+  }
+}
+
+/// an rc about the size of a relay's, with an address and the signed dict version 1 rcs keep
+static llarp::RouterContact
+MakeRelayRC(size_t idx)
+{
+  llarp::RouterContact rc;
+  rc.pubkey.Randomize();
+  rc.enckey.Randomize();
+  rc.SetNick(fmt::format("relay-{}", idx));
+  auto& ai = rc.addrs.emplace_back();
+  ai.dialect = "iwp";
+  ai.pubkey.Randomize();
+  ai.port = 1090;
+  rc.version = 1;
+  rc.signed_bt_dict.assign(400, 'x');
+  return rc;
+}
+
+TEST_CASE("Dht nodes and path hops hold the nodedb's rcs", "[nodedb]")
+{
+  llarp_nodedb nodeDB;
+  std::vector<llarp::RouterContact_ptr> rcs;
+  for (size_t idx = 0; idx < 4; ++idx)
+  {
+    const auto rc = MakeRelayRC(idx);
+    nodeDB.Put(rc);
+    rcs.push_back(nodeDB.Get(rc.pubkey));
+  }
+
+  llarp::dht::Bucket<llarp::dht::RCNode> nodes{llarp::dht::Key_t{}, llarp::randint};
+  for (const auto& rc : rcs)
+    nodes.PutNode(rc);
+  llarp::path::Path path{rcs, std::weak_ptr<llarp::path::PathSet>{}, 0, "shared"};
+
+  for (size_t idx = 0; idx < rcs.size(); ++idx)
+  {
+    REQUIRE(nodes.nodes.at(llarp::dht::Key_t{rcs[idx]->pubkey}).rc == rcs[idx]);
+    REQUIRE(path.hops[idx].rc == rcs[idx]);
+    // the nodedb, the dht node, the path hop and us
+    REQUIRE(rcs[idx].use_count() == 4);
+  }
+}
+
+#ifdef __linux__
+static size_t
+ResidentBytes()
+{
+  std::ifstream statm{"/proc/self/statm"};
+  size_t total = 0, resident = 0;
+  statm >> total >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+TEST_CASE("Memory held for rcs by dht nodes and path hops", "[.bench][nodedb]")
+{
+  static constexpr size_t numRCs = 5'000;
+  static constexpr size_t numHops = 4;
+  // how many paths go through each rc, as on a client keeping many endpoints' paths around
+  static constexpr size_t pathsPerRC = 4;
+
+  const auto before = ResidentBytes();
+  llarp_nodedb nodeDB;
+  for (size_t idx = 0; idx < numRCs; ++idx)
+    nodeDB.Put(MakeRelayRC(idx));
+  std::vector<llarp::RouterContact_ptr> rcs;
+  nodeDB.VisitAll([&](const auto& rc) { rcs.push_back(nodeDB.Get(rc.pubkey)); });
+  const auto loaded = ResidentBytes();
+
+  struct Holders
+  {
+    llarp::dht::Bucket<llarp::dht::RCNode> nodes{llarp::dht::Key_t{}, llarp::randint};
+    std::vector<std::unique_ptr<llarp::path::Path>> paths;
+  };
+  // the dht nodes and the paths through every rc, holding the nodedb's rcs or copies of them.
+  // both sets of holders are kept around so the second does not reuse what the first freed.
+  const auto hold = [&](Holders& holders, bool share) {
+    const auto start = ResidentBytes();
+    const auto get = [share](const llarp::RouterContact_ptr& rc) {
+      return share ? rc : std::make_shared<const llarp::RouterContact>(*rc);
+    };
+    for (const auto& rc : rcs)
+      holders.nodes.PutNode(llarp::dht::RCNode{get(rc)});
+    for (size_t n = 0; n < pathsPerRC * numRCs / numHops; ++n)
+    {
+      std::vector<llarp::RouterContact_ptr> hops;
+      for (size_t hop = 0; hop < numHops; ++hop)
+        hops.push_back(get(rcs[(n * numHops + hop) % numRCs]));
+      holders.paths.push_back(std::make_unique<llarp::path::Path>(
+          hops, std::weak_ptr<llarp::path::PathSet>{}, 0, "bench"));
+    }
+    return ResidentBytes() - start;
+  };
+  Holders sharing, copying;
+  const auto shared = hold(sharing, true);
+  for (const auto& rc : rcs)
+    REQUIRE(rc.use_count() == 3 + pathsPerRC);
+  const auto copied = hold(copying, false);
+  for (const auto& rc : rcs)
+    REQUIRE(rc.use_count() == 3 + pathsPerRC);
+
+  const auto mib = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+  fmt::print("{} rcs in the nodedb:                 {:>7.2f} MiB\n", numRCs, mib(loaded - before));
+  fmt::print("dht nodes and {} paths, sharing them: {:>7.2f} MiB\n", pathsPerRC, mib(shared));
+  fmt::print("dht nodes and {} paths, copying them: {:>7.2f} MiB\n", pathsPerRC, mib(copied));
+}
+#endif
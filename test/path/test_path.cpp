@@ -1,4 +1,5 @@
 #include <llarp/path/path.hpp>
+#include <llarp/path/pathset.hpp>
 #include <catch2/catch.hpp>
 
 using Path_t   = llarp::path::Path;
@@ -37,3 +38,22 @@ TEST_CASE("UniqueEndpointSet_t has unique endpoints", "[path]")
       set.emplace(MakePath({'d', 'c', 'b', 'a'})).second;
   REQUIRE(inserted_second);
 }
+
+TEST_CASE("Paths we have not measured yet are weighed as the median path", "[path]")
+{
+  std::vector<Path_ptr> paths{
+      MakePath({'a', 'b'}), MakePath({'c', 'd'}), MakePath({'e', 'f'}), MakePath({'g', 'h'})};
+  using Scores = std::vector<llarp_time_t>;
+  using llarp::path::PathSet;
+
+  // nothing to go by, every path weighs the same
+  REQUIRE(PathSet::WeighingScores(paths) == Scores{0s, 0s, 0s, 0s});
+
+  for (int i = 0; i < 64; ++i)
+  {
+    paths[0]->metrics.AddRTT(100ms);
+    paths[1]->metrics.AddRTT(300ms);
+    paths[2]->metrics.AddRTT(200ms);
+  }
+  REQUIRE(PathSet::WeighingScores(paths) == Scores{100ms, 300ms, 200ms, 200ms});
+}
@@ -0,0 +1,63 @@
+#include <llarp/path/path_metrics.hpp>
+
+#include <catch2/catch.hpp>
+
+using llarp::path::PathMetrics;
+
+TEST_CASE("PathMetrics smooths round trips and jitter", "[path]")
+{
+  PathMetrics metrics;
+  CHECK(metrics.Score() == 0s);
+
+  metrics.AddRTT(100ms);
+  CHECK(metrics.RTT() == 100ms);
+  CHECK(metrics.Jitter() == 50ms);
+
+  // a steady path converges on its rtt with the jitter falling away
+  for (int i = 0; i < 64; ++i)
+    metrics.AddRTT(100ms);
+  CHECK(metrics.RTT() == 100ms);
+  CHECK(metrics.Jitter() == 0ms);
+  CHECK(metrics.Score() == 100ms);
+
+  // a single outlier moves the average by an eighth of the difference
+  metrics.AddRTT(900ms);
+  CHECK(metrics.RTT() == 200ms);
+  CHECK(metrics.Jitter() == 200ms);
+  CHECK(metrics.Score() == 600ms);
+}
+
+TEST_CASE("PathMetrics scores lossy paths worse", "[path]")
+{
+  PathMetrics clean, lossy;
+  for (int i = 0; i < 8; ++i)
+  {
+    clean.AddRTT(100ms);
+    clean.AddDelivered();
+    lossy.AddRTT(100ms);
+    if (i % 2)
+      lossy.AddLost();
+    else
+      lossy.AddDelivered();
+  }
+  CHECK(clean.Loss() == 0);
+  CHECK(lossy.Loss() > 0.1);
+  CHECK(lossy.Score() > clean.Score());
+
+  // loss never makes a score infinite
+  for (int i = 0; i < 1000; ++i)
+    lossy.AddLost();
+  CHECK(lossy.Score() <= lossy.RTT() * 20 + lossy.Jitter() * 40);
+}
+
+TEST_CASE("PathMetrics tracks throughput", "[path]")
+{
+  PathMetrics metrics;
+  for (int i = 0; i < 128; ++i)
+    metrics.AddTraffic(1000, 500, 100ms);
+  CHECK(metrics.TXRate() == Approx(10000));
+  CHECK(metrics.RXRate() == Approx(5000));
+  // an empty interval tells us nothing
+  metrics.AddTraffic(1000, 1000, 0s);
+  CHECK(metrics.TXRate() == Approx(10000));
+}
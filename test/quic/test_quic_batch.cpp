@@ -0,0 +1,127 @@
+#include <llarp/quic/batch.hpp>
+#include <llarp/net/ip_packet.hpp>
+#include <llarp/service/protocol.hpp>
+#include <catch2/catch.hpp>
+
+#include <ngtcp2/ngtcp2.h>
+
+#include <array>
+#include <limits>
+#include <vector>
+
+using namespace llarp::quic;
+using batch::bstring_view;
+
+static std::vector<std::byte>
+MakePacket(size_t size, uint8_t fill)
+{
+  return std::vector<std::byte>(size, std::byte{fill});
+}
+
+TEST_CASE("quic batched frame records round trip", "[quic][batch]")
+{
+  const std::array<std::vector<std::byte>, 3> pkts{
+      MakePacket(1, 1), MakePacket(300, 2), MakePacket(1100, 3)};
+
+  std::vector<std::byte> frame;
+  for (size_t i = 0; i < pkts.size(); ++i)
+  {
+    const auto pos = frame.size();
+    frame.resize(pos + batch::record_size(pkts[i].size()));
+    const bstring_view pkt{pkts[i].data(), pkts[i].size()};
+    REQUIRE(
+        batch::write_record(&frame[pos], pkt, static_cast<uint8_t>(i))
+        == batch::record_size(pkt.size()));
+  }
+
+  size_t n = 0;
+  REQUIRE(batch::for_each_packet(
+      bstring_view{frame.data(), frame.size()}, [&](uint8_t ecn, bstring_view pkt) {
+        REQUIRE(n < pkts.size());
+        CHECK(ecn == n);
+        CHECK(pkt == bstring_view{pkts[n].data(), pkts[n].size()});
+        ++n;
+      }));
+  REQUIRE(n == pkts.size());
+}
+
+TEST_CASE("quic batched frames with bad records are dropped whole", "[quic][batch]")
+{
+  const auto pkt = MakePacket(100, 7);
+  std::vector<std::byte> frame(batch::record_size(pkt.size()) * 2);
+  batch::write_record(frame.data(), bstring_view{pkt.data(), pkt.size()}, 0);
+  batch::write_record(
+      &frame[batch::record_size(pkt.size())], bstring_view{pkt.data(), pkt.size()}, 0);
+
+  size_t delivered = 0;
+  auto count = [&](uint8_t, bstring_view) { ++delivered; };
+
+  // truncated second record
+  REQUIRE(not batch::for_each_packet(bstring_view{frame.data(), frame.size() - 1}, count));
+  // trailing bytes too short to be a record header
+  frame.push_back(std::byte{0});
+  REQUIRE(not batch::for_each_packet(bstring_view{frame.data(), frame.size()}, count));
+  // zero sized record
+  frame.push_back(std::byte{0});
+  frame.push_back(std::byte{0});
+  REQUIRE(not batch::for_each_packet(bstring_view{frame.data(), frame.size()}, count));
+  REQUIRE(delivered == 0);
+}
+
+TEST_CASE("quic batched frames to a hidden service share big packets", "[quic][batch]")
+{
+  // a header like Endpoint::write_packet_header writes
+  const std::array<std::byte, 4> header{};
+  const bstring_view hdr{header.data(), header.size()};
+  batch::frame<llarp::service::MAX_PROTOCOL_PAYLOAD_SIZE> frame;
+
+  // two packets that would each take up over half of an IP packet sized frame
+  const auto big = MakePacket(800, 1);
+  const bstring_view pkt{big.data(), big.size()};
+  REQUIRE(hdr.size() + 2 * batch::record_size(pkt.size()) > llarp::net::IPPacket::MaxSize);
+
+  REQUIRE(frame.start(hdr, llarp::net::IPPacket::MaxSize));
+  REQUIRE(frame.fits(pkt.size()));
+  frame.add(pkt, 0);
+  CHECK(not frame.fits(pkt.size()));
+
+  REQUIRE(frame.start(hdr, llarp::service::MAX_PROTOCOL_PAYLOAD_SIZE));
+  frame.add(pkt, 0);
+  REQUIRE(frame.fits(pkt.size()));
+  frame.add(pkt, 1);
+  REQUIRE(frame.count() == 2);
+  CHECK(frame.view().size() == hdr.size() + 2 * batch::record_size(pkt.size()));
+
+  // a full size quic packet still leaves room for acks and other small packets
+  const auto full = MakePacket(NGTCP2_MAX_UDP_PAYLOAD_SIZE, 2);
+  REQUIRE(frame.start(hdr, llarp::service::MAX_PROTOCOL_PAYLOAD_SIZE));
+  frame.add(bstring_view{full.data(), full.size()}, 0);
+  CHECK(frame.fits(llarp::net::IPPacket::MaxSize - NGTCP2_MAX_UDP_PAYLOAD_SIZE));
+
+  size_t n = 0;
+  REQUIRE(batch::for_each_packet(frame.records(), [&n](uint8_t, bstring_view) { ++n; }));
+  CHECK(n == 1);
+}
+
+TEST_CASE("the biggest quic batched frame fits in a ProtocolFrame", "[quic][batch]")
+{
+  // every field of the message at its biggest
+  llarp::service::ProtocolMessage msg;
+  msg.proto = llarp::service::ProtocolType{std::numeric_limits<uint64_t>::max()};
+  msg.payload.resize(llarp::service::MAX_PROTOCOL_PAYLOAD_SIZE);
+  msg.introReply.router.Randomize();
+  msg.introReply.pathID.Randomize();
+  msg.introReply.latency = llarp_time_t::max();
+  msg.introReply.expiresAt = llarp_time_t::max();
+  msg.introReply.version = std::numeric_limits<uint64_t>::max();
+  // the keys of the sender are written out whatever they are, only the vanity can be left out
+  msg.sender.vanity.Randomize();
+  msg.tag.Randomize();
+  msg.seqno = std::numeric_limits<uint64_t>::max();
+  msg.version = std::numeric_limits<uint64_t>::max();
+
+  std::array<llarp::byte_t, llarp::service::MAX_PROTOCOL_MESSAGE_SIZE> tmp;
+  llarp_buffer_t buf{tmp};
+  REQUIRE(msg.BEncode(&buf));
+  CHECK(size_t(buf.cur - buf.base) <= llarp::service::MAX_PROTOCOL_FRAME_DATA_SIZE);
+}
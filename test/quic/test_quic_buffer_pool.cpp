@@ -0,0 +1,39 @@
+#include <llarp/quic/buffer_pool.hpp>
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using llarp::quic::BufferPool;
+using llarp::quic::stream_buffer;
+
+TEST_CASE("quic buffer pool reuses released slabs", "[quic][buffer-pool]")
+{
+  auto pool = std::make_shared<BufferPool>();
+
+  // move 4MiB through a handful of slabs in flight at a time, like a tunnel does
+  std::vector<stream_buffer> inflight;
+  for (size_t i = 0; i < 4 * 1024 * 1024 / BufferPool::SLAB_SIZE; ++i)
+  {
+    inflight.push_back(pool->own(pool->acquire()));
+    pool->count_read(BufferPool::SLAB_SIZE);
+    if (inflight.size() == 4)
+      inflight.clear();
+  }
+  inflight.clear();
+
+  const auto status = pool->ExtractStatus();
+  REQUIRE(status["slabAllocations"] == 4);
+  REQUIRE(status["idleSlabs"] == 4);
+  REQUIRE(status["allocationsPerMiB"].get<double>() == Approx(1.0));
+}
+
+TEST_CASE("quic buffer pool caps its idle slabs", "[quic][buffer-pool]")
+{
+  auto pool = std::make_shared<BufferPool>();
+  std::vector<std::byte*> slabs;
+  for (size_t i = 0; i < BufferPool::MAX_IDLE + 10; ++i)
+    slabs.push_back(pool->acquire());
+  for (auto* slab : slabs)
+    pool->release(slab);
+  REQUIRE(pool->ExtractStatus()["idleSlabs"] == BufferPool::MAX_IDLE);
+}
@@ -0,0 +1,21 @@
+#include <llarp/quic/transport_profile.hpp>
+#include <catch2/catch.hpp>
+
+using namespace llarp::quic;
+
+TEST_CASE("quic transport profile names round trip", "[quic][transport-profile]")
+{
+  for (auto profile :
+       {TransportProfile::standard, TransportProfile::interactive, TransportProfile::bulk})
+    REQUIRE(parse_transport_profile(to_string(profile)) == profile);
+  REQUIRE(parse_transport_profile("") == TransportProfile::standard);
+  REQUIRE(not parse_transport_profile("fast"));
+}
+
+TEST_CASE("quic interactive profile allows more streams", "[quic][transport-profile]")
+{
+  const auto& standard = transport_settings(TransportProfile::standard);
+  const auto& interactive = transport_settings(TransportProfile::interactive);
+  REQUIRE(interactive.stream_limit > standard.stream_limit);
+  REQUIRE(interactive.max_stream_window >= standard.max_stream_window);
+}
@@ -0,0 +1,139 @@
+#include <llarp/service/auth.hpp>
+#include <llarp/service/protocol.hpp>
+#include <llarp/util/fs.hpp>
+
+#include <catch2/catch.hpp>
+#include "llarp_test.hpp"
+#include "mocks/mock_context.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace llarp;
+using service::AuthResultCode;
+
+namespace
+{
+  /// "hashes" are the token with a prefix, and we count how many of them we were asked to check
+  struct CountingHashCrypto : public sodium::CryptoLibSodium
+  {
+    size_t checks = 0;
+
+    bool
+    check_passwd_hash(std::string pwhash, std::string challenge) override
+    {
+      ++checks;
+      return pwhash == "hash-" + challenge;
+    }
+  };
+
+  /// a router that is never started and runs every job it is given right away
+  struct InlineRouter : public mocks::MockRouter
+  {
+    using mocks::MockRouter::MockRouter;
+
+    void
+    QueueWork(std::function<void(void)> func) override
+    {
+      func();
+    }
+
+    void
+    QueueDiskIO(std::function<void(void)> func) override
+    {
+      func();
+    }
+  };
+
+  struct FileAuthTest : public test::LlarpTest<CountingHashCrypto>
+  {
+    mocks::Network net{{{"mock0", IPRange::FromIPv4(1, 1, 1, 1, 32)}}, false};
+    std::shared_ptr<InlineRouter> router = std::make_shared<InlineRouter>(net, nullptr);
+    const fs::path file = fs::temp_directory_path() / "lokinet-test-auth-hashes.txt";
+    int writes = 0;
+    std::shared_ptr<service::IAuthPolicy> policy;
+
+    FileAuthTest()
+    {
+      WriteUsers({});
+      policy =
+          service::MakeFileAuthPolicy(router.get(), {file}, service::AuthFileType::eAuthFileHashes);
+    }
+
+    ~FileAuthTest()
+    {
+      fs::remove(file);
+    }
+
+    /// replace the file with a hash for each user, making sure it looks modified
+    void
+    WriteUsers(const std::vector<std::string>& users)
+    {
+      {
+        fs::ofstream f{file};
+        f << "# users allowed in\n";
+        for (const auto& user : users)
+          f << "hash-" << user << "\n";
+      }
+      fs::last_write_time(file, fs::file_time_type::clock::now() + std::chrono::seconds{++writes});
+    }
+
+    AuthResultCode
+    Check(std::string token)
+    {
+      auto msg = std::make_shared<service::ProtocolMessage>();
+      msg->proto = service::ProtocolType::Auth;
+      msg->tag.Randomize();
+      msg->payload.assign(token.begin(), token.end());
+      std::optional<service::AuthResult> result;
+      policy->AuthenticateAsync(msg, [&result](service::AuthResult r) { result = r; });
+      REQUIRE(result);
+      return result->code;
+    }
+  };
+}  // namespace
+
+TEST_CASE_METHOD(FileAuthTest, "File auth remembers tokens that matched a hash", "[auth]")
+{
+  WriteUsers({"alice", "bob", "carol"});
+  CHECK(Check("alice") == AuthResultCode::eAuthAccepted);
+  m_crypto.checks = 0;
+  CHECK(Check("alice") == AuthResultCode::eAuthAccepted);
+  CHECK(m_crypto.checks == 0);
+}
+
+TEST_CASE_METHOD(FileAuthTest, "File auth forgets remembered tokens on reload", "[auth]")
+{
+  WriteUsers({"alice", "bob"});
+  REQUIRE(Check("alice") == AuthResultCode::eAuthAccepted);
+  WriteUsers({"bob"});
+  CHECK(Check("alice") == AuthResultCode::eAuthRejected);
+  CHECK(Check("bob") == AuthResultCode::eAuthAccepted);
+}
+
+TEST_CASE_METHOD(FileAuthTest, "File auth finds a match among many hashes", "[auth]")
+{
+  std::vector<std::string> users;
+  for (int idx = 0; idx < 37; ++idx)
+    users.push_back("user" + std::to_string(idx));
+  WriteUsers(users);
+  CHECK(Check(users.back()) == AuthResultCode::eAuthAccepted);
+  CHECK(Check(users.front()) == AuthResultCode::eAuthAccepted);
+
+  m_crypto.checks = 0;
+  CHECK(Check("user37") == AuthResultCode::eAuthRejected);
+  CHECK(m_crypto.checks == users.size());
+}
+
+TEST_CASE_METHOD(FileAuthTest, "File auth does not remember rejected tokens", "[auth]")
+{
+  WriteUsers({"alice", "bob"});
+  CHECK(Check("mallory") == AuthResultCode::eAuthRejected);
+  m_crypto.checks = 0;
+  CHECK(Check("mallory") == AuthResultCode::eAuthRejected);
+  CHECK(m_crypto.checks == 2);
+
+  WriteUsers({"alice", "bob", "mallory"});
+  CHECK(Check("mallory") == AuthResultCode::eAuthAccepted);
+}
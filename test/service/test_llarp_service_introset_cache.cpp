@@ -0,0 +1,67 @@
+#include <llarp/service/introset_cache.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+using service::IntroSetCache;
+
+namespace
+{
+  service::IntroSet
+  MakeIntroSet(llarp_time_t signedAt, std::vector<llarp_time_t> expiries)
+  {
+    service::IntroSet introset;
+    introset.timestampSignedAt = signedAt;
+    for (const auto expiresAt : expiries)
+    {
+      service::Introduction intro;
+      intro.expiresAt = expiresAt;
+      introset.intros.push_back(intro);
+    }
+    return introset;
+  }
+}  // namespace
+
+TEST_CASE("IntroSetCache serves stale introsets and refreshes them ahead of expiry", "[service]")
+{
+  IntroSetCache cache;
+  const service::Address remote;
+  const auto signedAt = 1h;
+
+  CHECK_FALSE(cache.Get(remote, signedAt));
+
+  REQUIRE(cache.StartLookup(remote, signedAt));
+  cache.RequestSent(remote);
+  cache.RequestSent(remote);
+  // everyone else waits on the lookup already under way
+  CHECK_FALSE(cache.StartLookup(remote, signedAt));
+  cache.HandleResult(remote, std::nullopt, signedAt);
+  CHECK_FALSE(cache.StartLookup(remote, signedAt));
+  cache.HandleResult(remote, MakeIntroSet(signedAt, {signedAt + 8min, signedAt + 18min}), signedAt);
+  CHECK(cache.Get(remote, signedAt));
+  CHECK(cache.IsFresh(remote, signedAt));
+  CHECK(cache.NeedRefresh(signedAt).empty());
+
+  // once an intro gets close to expiring we want a new one but keep serving the old
+  const auto later = signedAt + 4min;
+  REQUIRE(cache.NeedRefresh(later) == std::vector<service::Address>{remote});
+  CHECK(cache.Get(remote, later + 10min));
+
+  REQUIRE(cache.StartLookup(remote, later));
+  cache.RequestSent(remote);
+  CHECK(cache.NeedRefresh(later).empty());
+  cache.HandleResult(remote, MakeIntroSet(later, {later + 10min, later + 20min}), later);
+  CHECK(cache.NeedRefresh(later + 2min).empty());
+
+  const auto status = cache.ExtractStatus();
+  CHECK(status["refreshes"] == 1);
+  CHECK(status["minRefreshLead"] == std::chrono::milliseconds{4min}.count());
+  CHECK(status["lookups"] == 2);
+  CHECK(status["lookupsDeduped"] == 2);
+
+  // older introsets never replace newer ones and expired ones are dropped
+  cache.HandleResult(remote, MakeIntroSet(signedAt, {later + 30min}), later);
+  CHECK_FALSE(cache.Get(remote, later + 21min));
+  cache.Decay(later + 21min);
+  CHECK(cache.Size() == 0);
+}
@@ -0,0 +1,207 @@
+#include <llarp/service/multipath.hpp>
+
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+
+#include <optional>
+#include <queue>
+#include <random>
+#include <vector>
+
+using llarp::service::LaneScheduler;
+using ReorderBuffer = llarp::service::ReorderBuffer<uint64_t>;
+
+TEST_CASE("LaneScheduler interleaves lanes in proportion to their weights", "[service][multipath]")
+{
+  LaneScheduler lanes;
+  const std::vector<double> weights{3, 1};
+  std::vector<size_t> picked;
+  for (int i = 0; i < 8; ++i)
+    picked.push_back(lanes.Next(weights));
+  CHECK(picked == std::vector<size_t>{0, 0, 1, 0, 0, 0, 1, 0});
+}
+
+TEST_CASE("ReorderBuffer only holds back traffic once it saw reordering", "[service][multipath]")
+{
+  ReorderBuffer reorder{100ms};
+  std::vector<uint64_t> got;
+  const auto visit = [&got](uint64_t val) { got.push_back(val); };
+
+  // a gap on an in order flow is taken as loss
+  reorder.Put(1, 1, 0s, visit);
+  reorder.Put(3, 3, 0s, visit);
+  CHECK(got == std::vector<uint64_t>{1, 3});
+  CHECK(reorder.Skipped() == 1);
+
+  // the late message gets through and from now on gaps are waited on
+  reorder.Put(2, 2, 1s, visit);
+  CHECK(reorder.Late() == 1);
+  reorder.Put(5, 5, 1s, visit);
+  reorder.Put(6, 6, 1s, visit);
+  CHECK(reorder.Held() == 2);
+  reorder.Put(4, 4, 1050ms, visit);
+  CHECK(got == std::vector<uint64_t>{1, 3, 2, 4, 5, 6});
+
+  // but never for longer than the max delay
+  reorder.Put(8, 8, 2s, visit);
+  reorder.Flush(2099ms, visit);
+  CHECK(reorder.Held() == 1);
+  reorder.Flush(2100ms, visit);
+  CHECK(reorder.Empty());
+  CHECK(got.back() == 8);
+  CHECK(reorder.Skipped() == 2);
+}
+
+TEST_CASE("InboundReorder puts a conversation back in order across pumps", "[service][multipath]")
+{
+  llarp::service::InboundReorder<int, int, uint64_t> inbound{100ms};
+  std::vector<uint64_t> got;
+  const auto visit = [&got](uint64_t val) { got.push_back(val); };
+  const auto keep = [](int) { return true; };
+  // each pump hands over what arrived since the last one, then flushes
+  const auto pump = [&](llarp_time_t now, std::vector<std::pair<int, uint64_t>> arrived) {
+    for (const auto& [lane, seqno] : arrived)
+      inbound.Put(1, lane, seqno, seqno, now, visit);
+    return inbound.Flush(now, visit, keep);
+  };
+
+  // one path, nothing is held
+  REQUIRE_FALSE(pump(0s, {{1, 0}, {1, 1}}));
+  // a second path, and the first message it was late with is let through as it is
+  REQUIRE_FALSE(pump(10ms, {{2, 3}}));
+  REQUIRE_FALSE(pump(20ms, {{1, 2}}));
+  CHECK(got == std::vector<uint64_t>{0, 1, 3, 2});
+  CHECK(inbound.Late() == 1);
+
+  // from now on a message a pump late still goes out in order
+  got.clear();
+  REQUIRE(pump(30ms, {{2, 5}}));
+  CHECK(got.empty());
+  REQUIRE_FALSE(pump(40ms, {{1, 4}}));
+  CHECK(got == std::vector<uint64_t>{4, 5});
+
+  // and what never comes is given up on after the delay
+  REQUIRE(pump(50ms, {{2, 7}}));
+  REQUIRE(pump(149ms, {}));
+  REQUIRE_FALSE(pump(150ms, {}));
+  CHECK(got.back() == 7);
+  CHECK(inbound.Skipped() == 1);
+}
+
+namespace
+{
+  /// a path in the simulation. a session keeps at most a window of frames in flight on it, so
+  /// what it can carry is bounded by its round trip
+  struct SimLane
+  {
+    llarp_time_t rtt;
+    llarp_time_t jitter;
+    size_t inflight = 0;
+  };
+
+  struct SimEvent
+  {
+    llarp_time_t at;
+    bool arrival;
+    uint64_t seqno;
+    size_t lane;
+
+    bool
+    operator>(const SimEvent& other) const
+    {
+      return at > other.at;
+    }
+  };
+
+  struct SimResult
+  {
+    llarp_time_t took;
+    size_t maxHeld;
+  };
+
+  /// send a number of frames over the first numLanes lanes and time how long it takes until the
+  /// receiving end has all of them in order
+  SimResult
+  Simulate(std::vector<SimLane> lanes, size_t numLanes, uint64_t frames)
+  {
+    constexpr size_t Window = 32;
+    lanes.resize(numLanes);
+    std::vector<double> weights;
+    for (const auto& lane : lanes)
+      weights.push_back(1. / lane.rtt.count());
+
+    std::mt19937_64 rng{numLanes};
+    LaneScheduler scheduler;
+    // hold for as long as it takes, nothing is lost in here
+    ReorderBuffer reorder{ReorderBuffer::ReorderWindow};
+    std::priority_queue<SimEvent, std::vector<SimEvent>, std::greater<SimEvent>> events;
+
+    llarp_time_t now = 0s;
+    uint64_t nextSeqno = 0, delivered = 0;
+    std::optional<size_t> blockedOn;
+    size_t maxHeld = 0;
+    const auto send = [&]() {
+      while (nextSeqno < frames)
+      {
+        // head of line, the frame waits for room on the lane it was scheduled on
+        const auto idx = blockedOn ? *blockedOn : scheduler.Next(weights);
+        auto& lane = lanes[idx];
+        blockedOn = std::nullopt;
+        if (lane.inflight >= Window)
+        {
+          blockedOn = idx;
+          return;
+        }
+        lane.inflight++;
+        const auto jitter = llarp_time_t{rng() % (lane.jitter.count() + 1)};
+        events.push(SimEvent{now + lane.rtt / 2 + jitter, true, nextSeqno++, idx});
+        events.push(SimEvent{now + lane.rtt + jitter, false, 0, idx});
+      }
+    };
+    const auto visit = [&delivered](uint64_t) { delivered++; };
+
+    send();
+    while (delivered < frames and not events.empty())
+    {
+      const auto ev = events.top();
+      events.pop();
+      now = ev.at;
+      if (ev.arrival)
+      {
+        reorder.Put(ev.seqno, ev.seqno, now, visit);
+        maxHeld = std::max(maxHeld, reorder.Held());
+      }
+      else
+      {
+        lanes[ev.lane].inflight--;
+        send();
+      }
+    }
+    REQUIRE(delivered == frames);
+    return {now, maxHeld};
+  }
+}  // namespace
+
+TEST_CASE("Multipath striping throughput simulation", "[.bench][service][multipath]")
+{
+  static constexpr uint64_t frames = 20000;
+  static constexpr size_t frameSize = 1024;
+  const std::vector<SimLane> lanes{{80ms, 10ms}, {120ms, 20ms}, {200ms, 30ms}, {300ms, 40ms}};
+
+  std::vector<double> goodput;
+  for (size_t numLanes = 1; numLanes <= lanes.size(); ++numLanes)
+  {
+    const auto result = Simulate(lanes, numLanes, frames);
+    const auto seconds = std::chrono::duration<double>(result.took).count();
+    goodput.push_back(frames * frameSize / seconds / 1024);
+    fmt::print(
+        "{} lane(s): {:.0f} KiB/s in order goodput ({:.2f}x), at most {} frames held for "
+        "reordering\n",
+        numLanes,
+        goodput.back(),
+        goodput.back() / goodput.front(),
+        result.maxHeld);
+  }
+  REQUIRE(goodput[1] > goodput[0] * 1.5);
+  REQUIRE(goodput.back() > goodput[1]);
+}
@@ -0,0 +1,180 @@
+#include <llarp/handlers/null.hpp>
+#include <llarp/path/path.hpp>
+#include <llarp/service/outbound_context.hpp>
+#include <llarp/service/spare_paths.hpp>
+
+#include <catch2/catch.hpp>
+#include "llarp_test.hpp"
+#include "mocks/mock_context.hpp"
+
+using namespace llarp;
+using service::SparePaths;
+
+namespace
+{
+  /// a router that is never started with an endpoint on it that the pool hangs off of
+  struct SparePathsTest : public test::LlarpTest<>
+  {
+    mocks::Network net{{{"mock0", IPRange::FromIPv4(1, 1, 1, 1, 32)}}, false};
+    std::shared_ptr<mocks::MockRouter> router = std::make_shared<mocks::MockRouter>(net, nullptr);
+    std::shared_ptr<handlers::NullEndpoint> endpoint =
+        std::make_shared<handlers::NullEndpoint>(router.get(), nullptr);
+
+    std::shared_ptr<SparePaths>
+    MakePool(size_t maxPaths)
+    {
+      return std::make_shared<SparePaths>(endpoint.get(), maxPaths);
+    }
+  };
+
+  RouterContact_ptr
+  MakeHop(char name)
+  {
+    RouterContact rc;
+    rc.pubkey.Fill(name);
+    return std::make_shared<const EncodedRouterContact>(std::move(rc));
+  }
+
+  /// an established path through hops ending on the last of them that was built at builtAt
+  path::Path_ptr
+  MakeSpare(const std::shared_ptr<SparePaths>& pool, std::vector<char> hops, llarp_time_t builtAt)
+  {
+    std::vector<RouterContact_ptr> rcs;
+    for (const auto hop : hops)
+      rcs.push_back(MakeHop(hop));
+    auto path = std::make_shared<path::Path>(rcs, pool->GetWeak(), path::ePathRoleAny, "spare");
+    path->EnterState(path::ePathBuilding, builtAt);
+    path->EnterState(path::ePathEstablished, builtAt);
+    path->intro.latency = 50ms;
+    pool->AddPath(path);
+    return path;
+  }
+
+  service::Introduction
+  MakeIntro(char router, llarp_time_t expiresAt)
+  {
+    service::Introduction intro;
+    intro.router.Fill(router);
+    intro.expiresAt = expiresAt;
+    return intro;
+  }
+
+  service::Address
+  MakeAddress(byte_t fill)
+  {
+    service::Address addr;
+    addr.Fill(fill);
+    return addr;
+  }
+}  // namespace
+
+TEST_CASE_METHOD(SparePathsTest, "SparePaths grows the pool with new sessions", "[service]")
+{
+  auto pool = MakePool(3);
+  const auto now = time_now_ms();
+
+  // one spare even when nothing happens
+  pool->Tick(now);
+  CHECK(pool->numDesiredPaths == 1);
+
+  // about one for every two new sessions, but never more than we were told
+  for (byte_t idx = 1; idx <= 4; ++idx)
+    pool->SessionStarted(MakeAddress(idx), now);
+  pool->Tick(now);
+  CHECK(pool->numDesiredPaths == 2);
+  for (byte_t idx = 5; idx <= 12; ++idx)
+    pool->SessionStarted(MakeAddress(idx), now);
+  pool->Tick(now);
+  CHECK(pool->numDesiredPaths == 3);
+
+  // the same remote again is not a new session
+  pool->SessionStarted(MakeAddress(1), now);
+  CHECK(pool->ExtractStatus()["recentSessions"] == 12);
+
+  // and demand falls off once the sessions are old enough
+  pool->Tick(now + SparePaths::DemandWindow + 1s);
+  CHECK(pool->numDesiredPaths == 1);
+  CHECK(pool->ExtractStatus()["recentSessions"] == 0);
+
+  // a disabled pool wants nothing at all
+  auto disabled = MakePool(0);
+  disabled->SessionStarted(MakeAddress(1), now);
+  disabled->Tick(now);
+  CHECK(disabled->numDesiredPaths == 0);
+}
+
+TEST_CASE_METHOD(
+    SparePathsTest, "SparePaths hands a spare to the session it lines up with", "[service]")
+{
+  auto pool = MakePool(2);
+  const auto now = time_now_ms();
+  const auto remote = MakeAddress(1);
+
+  auto spare = MakeSpare(pool, {'a', 'b', 'c', 'd'}, now);
+  MakeSpare(pool, {'e', 'f', 'g', 'h'}, now);
+
+  service::IntroSet introset;
+  introset.intros.push_back(MakeIntro('x', now + 10min));
+  // nothing ends on their intro router
+  pool->SessionStarted(remote, now);
+  CHECK_FALSE(pool->Claim(introset, now));
+
+  // the longest lived of their intros on the router a spare ends on is picked
+  introset.intros.push_back(MakeIntro('d', now + 5min));
+  introset.intros.push_back(MakeIntro('d', now + 15min));
+  auto claimed = pool->Claim(introset, now);
+  REQUIRE(claimed);
+  CHECK(claimed->first == spare);
+  CHECK(claimed->second.expiresAt == now + 15min);
+  CHECK(pool->GetPathByRouter(spare->Endpoint()) == nullptr);
+
+  auto status = pool->ExtractStatus();
+  CHECK(status["claimed"] == 1);
+  CHECK(status["missed"] == 1);
+
+  // the session takes it over as its own
+  auto ctx = std::make_shared<service::OutboundContext>(introset, endpoint.get());
+  ctx->AdoptPath(claimed->first, claimed->second);
+  CHECK(claimed->first->m_PathSet.lock() == ctx->GetSelf());
+  CHECK(ctx->GetPathByRouter(spare->Endpoint()) == spare);
+
+  // and its time to first byte counts as one made on a spare
+  pool->SessionReady(remote, now + 100ms);
+  status = pool->ExtractStatus();
+  CHECK(status["withSpare"]["sessions"] == 1);
+  CHECK(status["withSpare"]["avgTimeToFirstByte"] == 100);
+  CHECK(status["withBuild"]["sessions"] == 0);
+}
+
+TEST_CASE_METHOD(
+    SparePathsTest, "SparePaths does not hand out what is about to expire", "[service]")
+{
+  auto pool = MakePool(2);
+  const auto now = time_now_ms();
+
+  service::IntroSet introset;
+  SECTION("spares that expire soon")
+  {
+    MakeSpare(pool, {'a', 'b', 'c', 'd'}, now - (path::default_lifetime - 1min));
+    introset.intros.push_back(MakeIntro('d', now + 10min));
+    CHECK_FALSE(pool->Claim(introset, now));
+  }
+
+  SECTION("intros that expire soon")
+  {
+    MakeSpare(pool, {'a', 'b', 'c', 'd'}, now);
+    introset.intros.push_back(MakeIntro('d', now + 10s));
+    CHECK_FALSE(pool->Claim(introset, now));
+  }
+
+  SECTION("sessions that never got ready")
+  {
+    const auto remote = MakeAddress(1);
+    pool->SessionStarted(remote, now);
+    pool->Tick(now + SparePaths::SessionTimeout + 1s);
+    pool->SessionReady(remote, now + SparePaths::SessionTimeout + 2s);
+    const auto status = pool->ExtractStatus();
+    CHECK(status["withSpare"]["sessions"] == 0);
+    CHECK(status["withBuild"]["sessions"] == 0);
+  }
+}
@@ -5,6 +5,12 @@
 #include <llarp/crypto/crypto_libsodium.hpp>
 #include <llarp/messages/relay_commit.hpp>
 #include <catch2/catch.hpp>
+#include <fmt/core.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 using namespace ::llarp;
 
@@ -53,3 +59,70 @@ TEST_CASE_METHOD(FrameTest, "Frame crypto")
   REQUIRE(otherRecord.BDecode(buf));
   REQUIRE(otherRecord == record);
 }
+
+TEST_CASE_METHOD(FrameTest, "LRCM crypto throughput", "[.bench][crypto][path]")
+{
+  // what a relay does on a worker for every LRCM: decrypt its frame, decode its record and derive
+  // the path key from it
+  static constexpr size_t distinct = 256;
+  static constexpr size_t perThread = 20'000;
+  auto crypto = CryptoManager::instance();
+
+  std::vector<EncryptedFrame> frames;
+  for (size_t idx = 0; idx < distinct; ++idx)
+  {
+    SecretKey commkey;
+    crypto->encryption_keygen(commkey);
+    LRCR record{};
+    record.commkey = commkey.toPublic();
+    record.nextHop.Randomize();
+    record.tunnelNonce.Randomize();
+    record.rxid.Randomize();
+    record.txid.Randomize();
+
+    auto& f = frames.emplace_back();
+    auto buf = f.Buffer();
+    buf->cur = buf->base + EncryptedFrameOverheadSize;
+    REQUIRE(record.BEncode(buf));
+    buf->cur = buf->base + EncryptedFrameOverheadSize;
+    REQUIRE(f.EncryptInPlace(alice, bob.toPublic()));
+  }
+
+  const auto work = [&](size_t idx) {
+    EncryptedFrame f = frames[idx % distinct];
+    if (not f.DecryptInPlace(bob))
+      return false;
+    auto buf = f.Buffer();
+    buf->cur = buf->base + EncryptedFrameOverheadSize;
+    LRCR record;
+    SharedSecret pathKey;
+    ShortHash nonceXOR;
+    return record.BDecode(buf)
+        and crypto->dh_server(pathKey, record.commkey, bob, record.tunnelNonce)
+        and crypto->shorthash(nonceXOR, llarp_buffer_t{pathKey});
+  };
+
+  const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t threads : {size_t{1}, cores})
+  {
+    std::atomic<size_t> failed{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+      workers.emplace_back([&, t]() {
+        for (size_t idx = 0; idx < perThread; ++idx)
+          if (not work(t * perThread + idx))
+            failed++;
+      });
+    for (auto& worker : workers)
+      worker.join();
+    const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+    REQUIRE(failed == 0);
+    const double total = threads * perThread / took.count();
+    fmt::print(
+        "{:>2} threads: {:>9.0f} LRCM/s, {:>8.0f} LRCM/s per thread\n",
+        threads,
+        total,
+        total / threads);
+  }
+}
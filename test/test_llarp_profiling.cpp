@@ -0,0 +1,186 @@
+#include <llarp/profiling.hpp>
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using llarp::Profiling;
+using llarp::RouterID;
+
+static RouterID
+MakeRouterID(uint16_t n)
+{
+  RouterID r;
+  r[0] = n & 0xff;
+  r[1] = n >> 8;
+  return r;
+}
+
+static void
+MakeBadForPath(Profiling& prof, const RouterID& r)
+{
+  for (int i = 0; i < 10; ++i)
+    prof.MarkHopFail(r);
+}
+
+TEST_CASE("Profiling persists changes through the append log", "[profiling]")
+{
+  const auto fpath = fs::temp_directory_path() / "lokinet-test-profiles.dat";
+  auto logpath = fpath;
+  logpath += ".log";
+  fs::remove(fpath);
+  fs::remove(logpath);
+
+  const auto a = MakeRouterID(1), b = MakeRouterID(2), c = MakeRouterID(3);
+  {
+    Profiling prof;
+    MakeBadForPath(prof, a);
+    MakeBadForPath(prof, b);
+    // no snapshot yet, so this writes one
+    REQUIRE(prof.Save(fpath));
+    REQUIRE(not fs::exists(logpath));
+
+    MakeBadForPath(prof, c);
+    prof.ClearProfile(a);
+    // only the changes above are appended
+    REQUIRE(prof.Save(fpath));
+    REQUIRE(fs::exists(logpath));
+  }
+
+  Profiling loaded;
+  REQUIRE(loaded.Load(fpath));
+  CHECK(not loaded.IsBadForPath(a));
+  CHECK(loaded.IsBadForPath(b));
+  CHECK(loaded.IsBadForPath(c));
+
+  fs::remove(fpath);
+  fs::remove(logpath);
+}
+
+TEST_CASE("Profiling keeps what is appended after a torn log record", "[profiling]")
+{
+  const auto fpath = fs::temp_directory_path() / "lokinet-test-torn-profiles.dat";
+  auto logpath = fpath, newpath = fpath;
+  logpath += ".log";
+  newpath += ".new";
+  fs::remove(fpath);
+  fs::remove(logpath);
+
+  const auto a = MakeRouterID(1), b = MakeRouterID(2), c = MakeRouterID(3);
+  {
+    Profiling prof;
+    MakeBadForPath(prof, a);
+    REQUIRE(prof.Save(fpath));
+    MakeBadForPath(prof, b);
+    REQUIRE(prof.Save(fpath));
+  }
+  // a save cut short, both in the log and in a compaction that never got to replace the snapshot
+  {
+    fs::ofstream out{logpath, std::ios::binary | std::ios::app};
+    out << "d32:";
+  }
+  {
+    fs::ofstream out{newpath, std::ios::binary};
+    out << "garbage";
+  }
+  {
+    Profiling prof;
+    REQUIRE(prof.Load(fpath));
+    CHECK(prof.IsBadForPath(a));
+    CHECK(prof.IsBadForPath(b));
+    CHECK(not fs::exists(newpath));
+    MakeBadForPath(prof, c);
+    REQUIRE(prof.Save(fpath));
+  }
+
+  Profiling loaded;
+  REQUIRE(loaded.Load(fpath));
+  CHECK(loaded.IsBadForPath(a));
+  CHECK(loaded.IsBadForPath(b));
+  CHECK(loaded.IsBadForPath(c));
+
+  fs::remove(fpath);
+  fs::remove(logpath);
+}
+
+TEST_CASE("Profiling publishes queued changes on tick", "[profiling]")
+{
+  Profiling prof;
+  const auto a = MakeRouterID(1), b = MakeRouterID(17);
+
+  // a and b share a shard
+  MakeBadForPath(prof, a);
+  MakeBadForPath(prof, b);
+  CHECK(not prof.IsBadForPath(a));
+  prof.Tick();
+  CHECK(prof.IsBadForPath(a));
+  CHECK(prof.IsBadForPath(b));
+
+  // changes apply in the order they were made
+  prof.ClearProfile(a);
+  MakeBadForPath(prof, a);
+  prof.ClearProfile(b);
+  prof.Tick();
+  CHECK(prof.IsBadForPath(a));
+  CHECK(not prof.IsBadForPath(b));
+}
+
+TEST_CASE("Profiling hop selection throughput under concurrent updates", "[.bench][profiling]")
+{
+  static constexpr uint16_t numRouters = 2000;
+  static constexpr auto duration = 2s;
+
+  Profiling prof;
+  std::vector<RouterID> routers;
+  for (uint16_t n = 0; n < numRouters; ++n)
+    routers.push_back(MakeRouterID(n));
+
+  std::atomic_bool done{false};
+  std::atomic<uint64_t> updates{0};
+  std::vector<std::thread> writers;
+  for (size_t t = 0; t < 2; ++t)
+  {
+    writers.emplace_back([&, t] {
+      size_t idx = t;
+      while (not done)
+      {
+        const auto& r = routers[idx++ % routers.size()];
+        if (idx % 3)
+          prof.MarkConnectSuccess(r);
+        else
+          prof.MarkHopFail(r);
+        ++updates;
+      }
+    });
+  }
+
+  uint64_t checks = 0, bad = 0;
+  const auto started = std::chrono::steady_clock::now();
+  auto nextTick = started;
+  while (std::chrono::steady_clock::now() - started < duration)
+  {
+    // publish like the router tick does
+    if (const auto now = std::chrono::steady_clock::now(); now >= nextTick)
+    {
+      prof.Tick();
+      nextTick = now + 250ms;
+    }
+    for (const auto& r : routers)
+      bad += prof.IsBadForPath(r);
+    checks += routers.size();
+  }
+  done = true;
+  for (auto& writer : writers)
+    writer.join();
+
+  const auto secs = std::chrono::duration<double>(duration).count();
+  fmt::print(
+      "hop checks/s: {:.0f}, concurrent profile updates/s: {:.0f}, bad: {}\n",
+      checks / secs,
+      updates / secs,
+      bad);
+  REQUIRE(checks > 0);
+}
@@ -6,6 +6,8 @@
 #include <llarp/net/net_int.hpp>
 #include <llarp/util/time.hpp>
 
+#include <thread>
+
 namespace
 {
   llarp::sodium::CryptoLibSodium crypto;
@@ -123,4 +125,100 @@ TEST_CASE("RouterContact Decode Mixed Versions", "[RC][RouterContact]")
     REQUIRE(rc_vec[i] == rc_vec_out[i]);
 }
 
+static RouterContact
+MakeSignedRC(uint8_t version)
+{
+  RouterContact rc;
+  rc.version = version;
+  SecretKey sign, encr;
+  cmanager.instance()->identity_keygen(sign);
+  cmanager.instance()->encryption_keygen(encr);
+  rc.enckey = encr.toPublic();
+  rc.pubkey = sign.toPublic();
+  REQUIRE(rc.Sign(sign));
+  return rc;
+}
+
+static uint64_t
+VerifyStat(const char* name)
+{
+  return RouterContact::ExtractVerifyStats()[name].get<uint64_t>();
+}
+
+TEST_CASE("RouterContact signatures that verified are remembered", "[RC][signature]")
+{
+  const auto version = GENERATE(0, 1);
+  auto rc = MakeSignedRC(version);
+
+  const auto hits = VerifyStat("hits");
+  const auto misses = VerifyStat("misses");
+  REQUIRE(rc.VerifySignature());
+  REQUIRE(VerifyStat("misses") == misses + 1);
+  REQUIRE(rc.VerifySignature());
+  REQUIRE(VerifyStat("hits") == hits + 1);
+}
+
+TEST_CASE("RouterContact bad signatures are never remembered", "[RC][signature]")
+{
+  const auto version = GENERATE(0, 1);
+  auto rc = MakeSignedRC(version);
+  rc.signature[0] ^= 1;
+
+  const auto hits = VerifyStat("hits");
+  const auto failures = VerifyStat("failures");
+  REQUIRE_FALSE(rc.VerifySignature());
+  REQUIRE_FALSE(rc.VerifySignature());
+  REQUIRE(VerifyStat("failures") == failures + 2);
+  REQUIRE(VerifyStat("hits") == hits);
+}
+
+TEST_CASE("EncodedRouterContact writes out what it was encoded to", "[RC][RouterContact]")
+{
+  const auto version = GENERATE(0, 1);
+  const auto rc = MakeSignedRC(version);
+  std::array<byte_t, 5000> plain;
+  llarp_buffer_t plainbuf(plain);
+  REQUIRE(rc.BEncode(&plainbuf));
+  const byte_view_t encoded{plain.data(), static_cast<size_t>(plainbuf.cur - plainbuf.base)};
+
+  const EncodedRouterContact shared{rc};
+  REQUIRE(shared == rc);
+  REQUIRE(byte_view_t{shared.Encoded().data(), shared.Encoded().size()} == encoded);
+
+  // one made from the bytes it was decoded from writes exactly those
+  const EncodedRouterContact decoded{rc, encoded};
+  std::array<byte_t, 5000> out;
+  llarp_buffer_t outbuf(out);
+  REQUIRE(decoded.BEncode(&outbuf));
+  REQUIRE(byte_view_t{out.data(), static_cast<size_t>(outbuf.cur - outbuf.base)} == encoded);
+
+  outbuf.cur = outbuf.base;
+  outbuf.sz = encoded.size() - 1;
+  REQUIRE_FALSE(decoded.BEncode(&outbuf));
+}
+
+TEST_CASE("RouterContact VerifySignatures checks a batch across workers", "[RC][signature]")
+{
+  // more than one job's worth, with bad signatures in different jobs
+  std::vector<RouterContact> rcs;
+  for (size_t idx = 0; idx < 70; ++idx)
+    rcs.push_back(MakeSignedRC(idx % 2));
+  for (size_t bad : {3, 40, 69})
+    rcs[bad].signature[0] ^= 1;
+
+  std::vector<std::thread> workers;
+  const auto results = RouterContact::VerifySignatures(
+      rcs, [&workers](std::function<void()> job) { workers.emplace_back(std::move(job)); });
+  for (auto& worker : workers)
+    worker.join();
+  REQUIRE(workers.size() > 1);
+
+  REQUIRE(results.size() == rcs.size());
+  for (size_t idx = 0; idx < rcs.size(); ++idx)
+    REQUIRE(results[idx] == (idx != 3 and idx != 40 and idx != 69));
+
+  // without workers it all happens inline, with the same answers
+  REQUIRE(RouterContact::VerifySignatures(rcs, nullptr) == results);
+}
+
 } // namespace llarp
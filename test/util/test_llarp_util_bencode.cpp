@@ -1,8 +1,23 @@
+#include "llarp_test.hpp"
+
+#include <llarp/messages/discard.hpp>
+#include <llarp/messages/relay.hpp>
+#include <llarp/messages/relay_commit.hpp>
+#include <llarp/messages/relay_status.hpp>
+#include <llarp/router_contact.hpp>
+#include <llarp/service/protocol.hpp>
 #include <llarp/util/bencode.h>
 #include <llarp/util/bencode.hpp>
 
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -83,6 +98,7 @@ std::vector<TestReadString> testReadStr{
     {{two, colon, f, z}, true, "fz"},
     {{two, colon, f, z, f, f}, true, "fz"},
     {{zero, colon}, true, ""},
+    {{one, zero, colon, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k'}, true, "abcdefghij"},
     // failure cases
     {{two, colon, f}, false, ""},
     {{two, f}, false, ""},
@@ -375,3 +391,223 @@ TEST_CASE("Read dict to empty buffer", "[bencode]")
   REQUIRE_FALSE(
       llarp::bencode_read_dict([](llarp_buffer_t*, llarp_buffer_t*) { return true; }, &buf));
 }
+
+/// read a link message the way the link message parser does, which reads the type itself
+static bool
+DecodeLinkMessage(llarp::ILinkMessage& msg, llarp_buffer_t& buf)
+{
+  return llarp::bencode_read_dict(
+      [&msg](llarp_buffer_t* val, llarp_buffer_t* key) {
+        if (key == nullptr)
+          return true;
+        if (key->startswith("a"))
+          return bencode_discard(val);
+        return msg.DecodeKey(*key, val);
+      },
+      &buf);
+}
+
+static llarp::RelayUpstreamMessage
+MakeRelay()
+{
+  llarp::RelayUpstreamMessage relay;
+  relay.pathid.Randomize();
+  // about what a relay carries for one full ip packet
+  relay.X = decltype(relay.X){1500};
+  relay.X.Randomize();
+  relay.Y.Randomize();
+  return relay;
+}
+
+TEST_CASE("Relay messages are read in place and written to size", "[bencode]")
+{
+  using namespace llarp;
+  const auto relay = MakeRelay();
+  std::array<byte_t, MAX_LINK_MSG_SIZE> tmp;
+  llarp_buffer_t buf{tmp};
+  REQUIRE(relay.BEncode(&buf));
+  const size_t encoded = buf.cur - buf.base;
+
+  // written straight into the buffer that is queued, and cut to size
+  std::vector<byte_t> pkt;
+  REQUIRE(BEncodeToSize(relay, pkt, relay.MaxEncodedSize()));
+  REQUIRE(pkt.size() == encoded);
+  REQUIRE(std::equal(tmp.begin(), tmp.begin() + encoded, pkt.begin()));
+  // and nothing is left of it when it does not fit
+  REQUIRE_FALSE(BEncodeToSize(relay, pkt, relay.X.size()));
+  REQUIRE(pkt.empty());
+
+  // x is where it is in the buffer we read, not a copy
+  RelayUpstreamMessage msg;
+  llarp_buffer_t in{tmp.data(), encoded};
+  REQUIRE(DecodeLinkMessage(msg, in));
+  REQUIRE(msg.XView.data() > tmp.data());
+  REQUIRE(msg.XView.data() + msg.XView.size() < tmp.data() + encoded);
+  REQUIRE(msg.XView == byte_view_t{relay.X.data(), relay.X.size()});
+  REQUIRE(msg.X.size() == 0);
+  REQUIRE(msg.Y == relay.Y);
+  REQUIRE(msg.pathid == relay.pathid);
+  msg.Clear();
+  REQUIRE(msg.XView.empty());
+}
+
+TEST_CASE("Link messages fit in what they set aside to be encoded into", "[bencode]")
+{
+  using namespace llarp;
+  std::vector<byte_t> pkt;
+  LR_CommitMessage commit;
+  for (auto& frame : commit.frames)
+    frame.Randomize();
+  REQUIRE(BEncodeToSize(commit, pkt, commit.MaxEncodedSize()));
+  REQUIRE(pkt.size() > commit.MaxEncodedSize() - 128);
+
+  LR_StatusMessage status;
+  status.pathid.Randomize();
+  status.status = std::numeric_limits<uint64_t>::max();
+  REQUIRE(BEncodeToSize(status, pkt, status.MaxEncodedSize()));
+
+  const DiscardMessage discard;
+  REQUIRE(BEncodeToSize(discard, pkt, discard.MaxEncodedSize()));
+}
+
+template <typename Encode, typename Decode>
+static void
+BenchCodec(std::string_view name, Encode&& encode, Decode&& decode)
+{
+  static constexpr size_t rounds = 200'000;
+  std::array<byte_t, MAX_LINK_MSG_SIZE> tmp;
+
+  auto start = std::chrono::steady_clock::now();
+  size_t encoded = 0;
+  for (size_t n = 0; n < rounds; ++n)
+  {
+    llarp_buffer_t buf{tmp};
+    REQUIRE(encode(buf));
+    encoded = buf.cur - buf.base;
+  }
+  const std::chrono::duration<double, std::nano> encodeTook =
+      std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < rounds; ++n)
+  {
+    llarp_buffer_t buf{tmp.data(), encoded};
+    REQUIRE(decode(buf));
+  }
+  const std::chrono::duration<double, std::nano> decodeTook =
+      std::chrono::steady_clock::now() - start;
+
+  fmt::print(
+      "{:<22} {:>5} bytes  encode {:>7.1f} ns  decode {:>7.1f} ns\n",
+      name,
+      encoded,
+      encodeTook.count() / rounds,
+      decodeTook.count() / rounds);
+}
+
+using BencodeBench = llarp::test::LlarpTest<>;
+
+TEST_CASE_METHOD(BencodeBench, "Cost of encoding and decoding messages", "[.bench][bencode]")
+{
+  using namespace llarp;
+
+  const auto relay = MakeRelay();
+  BenchCodec(
+      "RelayUpstreamMessage",
+      [&relay](auto& buf) { return relay.BEncode(&buf); },
+      [](auto& buf) {
+        RelayUpstreamMessage msg;
+        return DecodeLinkMessage(msg, buf);
+      });
+
+  service::ProtocolFrame frame;
+  frame.D = service::ProtocolFrame::Encrypted_t{1024};
+  frame.D.Randomize();
+  frame.F.Randomize();
+  frame.N.Randomize();
+  frame.T.Randomize();
+  frame.Z.Randomize();
+  BenchCodec(
+      "ProtocolFrame",
+      [&frame](auto& buf) { return frame.BEncode(&buf); },
+      [](auto& buf) {
+        service::ProtocolFrame msg;
+        return bencode_decode_dict(msg, &buf);
+      });
+
+  SecretKey identity;
+  CryptoManager::instance()->identity_keygen(identity);
+  RouterContact rc;
+  rc.version = 1;
+  rc.enckey.Randomize();
+  rc.SetNick("bench");
+  auto& ai = rc.addrs.emplace_back();
+  ai.dialect = "iwp";
+  ai.pubkey.Randomize();
+  ai.port = 1090;
+  REQUIRE(rc.Sign(identity));
+  BenchCodec(
+      "RouterContact",
+      [&rc](auto& buf) { return rc.BEncode(&buf); },
+      [](auto& buf) {
+        RouterContact other;
+        return other.BDecode(&buf);
+      });
+}
+
+TEST_CASE_METHOD(
+    BencodeBench, "Cost of copying relay payloads in and out of messages", "[.bench][bencode]")
+{
+  using namespace llarp;
+  static constexpr size_t rounds = 200'000;
+  const auto relay = MakeRelay();
+
+  const auto time = [](auto&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < rounds; ++n)
+      REQUIRE(f());
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    return took.count() / rounds;
+  };
+
+  // what queueing a message did before: encode on the stack, then copy out what was written
+  const auto viaTemporary = time([&relay]() {
+    std::array<byte_t, MAX_LINK_MSG_SIZE> tmp;
+    llarp_buffer_t buf{tmp};
+    if (not relay.BEncode(&buf))
+      return false;
+    std::vector<byte_t> queued(buf.cur - buf.base);
+    std::copy_n(tmp.data(), queued.size(), queued.data());
+    return not queued.empty();
+  });
+  const auto direct = time([&relay]() {
+    std::vector<byte_t> queued;
+    return BEncodeToSize(relay, queued, relay.MaxEncodedSize());
+  });
+  fmt::print("encode  via a temporary {:>7.1f} ns  in place {:>7.1f} ns\n", viaTemporary, direct);
+
+  std::vector<byte_t> encoded;
+  REQUIRE(BEncodeToSize(relay, encoded, relay.MaxEncodedSize()));
+  // what reading one did before: x copied into the message's own buffer
+  const auto copied = time([&encoded]() {
+    RelayUpstreamMessage msg;
+    llarp_buffer_t buf{encoded};
+    return bencode_read_dict(
+        [&msg](llarp_buffer_t* val, llarp_buffer_t* key) {
+          if (key == nullptr)
+            return true;
+          if (key->startswith("a"))
+            return bencode_discard(val);
+          if (key->startswith("x"))
+            return msg.X.BDecode(val);
+          return msg.DecodeKey(*key, val);
+        },
+        &buf);
+  });
+  const auto inPlace = time([&encoded]() {
+    RelayUpstreamMessage msg;
+    llarp_buffer_t buf{encoded};
+    return DecodeLinkMessage(msg, buf);
+  });
+  fmt::print("decode  copying x       {:>7.1f} ns  in place {:>7.1f} ns\n", copied, inPlace);
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+#include <llarp/util/logging.hpp>
+#include <llarp/util/logging/async_sink.hpp>
+
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+
+namespace
+{
+  /// remembers every message it is given, optionally taking its time about it
+  struct CollectingSink : public spdlog::sinks::base_sink<std::mutex>
+  {
+    std::vector<std::string> messages;
+    std::chrono::microseconds delay{0};
+
+   protected:
+    void
+    sink_it_(const spdlog::details::log_msg& msg) override
+    {
+      if (delay.count())
+        std::this_thread::sleep_for(delay);
+      messages.emplace_back(msg.payload.data(), msg.payload.size());
+    }
+
+    void
+    flush_() override
+    {}
+  };
+
+  spdlog::details::log_msg
+  MakeMessage(std::string_view text)
+  {
+    return spdlog::details::log_msg{"test", spdlog::level::info, text};
+  }
+}  // namespace
+
+TEST_CASE("AsyncSink hands messages over in order", "[logging]")
+{
+  auto collector = std::make_shared<CollectingSink>();
+  {
+    logging::AsyncSink sink{collector, 128};
+    for (int i = 0; i < 100; ++i)
+      sink.log(MakeMessage(std::to_string(i)));
+    REQUIRE(sink.dropped() == 0);
+  }
+  // the destructor drains the queue before it returns
+  REQUIRE(collector->messages.size() == 100);
+  for (int i = 0; i < 100; ++i)
+    REQUIRE(collector->messages[i] == std::to_string(i));
+}
+
+TEST_CASE("AsyncSink drops rather than blocks when full", "[logging]")
+{
+  auto collector = std::make_shared<CollectingSink>();
+  collector->delay = std::chrono::milliseconds{1};
+  uint64_t dropped;
+  {
+    logging::AsyncSink sink{collector, 8};
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; ++i)
+      sink.log(MakeMessage(std::to_string(i)));
+    // a blocking sink would take at least a second to get through that
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds{500});
+    dropped = sink.dropped();
+    REQUIRE(dropped > 0);
+  }
+  // everything we did not drop made it through, plus the note about what we did drop
+  REQUIRE(collector->messages.size() == 1000 - dropped + 1);
+  REQUIRE(collector->messages.back().find("dropped") != std::string::npos);
+}
+
+TEST_CASE("maybe_async wraps whatever sink it is given", "[logging]")
+{
+  REQUIRE(logging::make_sink(log::Type::Print, "stdout"));
+  REQUIRE_FALSE(logging::make_sink(log::Type::System, "lokinet"));
+
+  auto collector = std::make_shared<CollectingSink>();
+  REQUIRE(logging::maybe_async(collector, false) == collector);
+  REQUIRE_FALSE(logging::maybe_async(nullptr, true));
+  {
+    auto async = logging::maybe_async(collector, true);
+    REQUIRE(std::dynamic_pointer_cast<logging::AsyncSink>(async));
+    async->log(MakeMessage("hello"));
+  }
+  REQUIRE(collector->messages == std::vector<std::string>{"hello"});
+}
+
+namespace
+{
+  static auto logcat = log::Cat("bench");
+
+  /// stand in for the per packet work of a hot path, so there is something to compare against
+  uint64_t
+  PacketWork(const std::vector<byte_t>& pkt)
+  {
+    uint64_t h = 14695981039346656037ULL;
+    for (const auto b : pkt)
+      h = (h ^ b) * 1099511628211ULL;
+    return h;
+  }
+}  // namespace
+
+TEST_CASE("Per packet cost of logging", "[.bench][logging]")
+{
+  static constexpr size_t packets = 200'000;
+  const std::vector<byte_t> pkt(1400, 0x42);
+  const auto logfile = std::filesystem::temp_directory_path() / "lokinet-bench-logging.log";
+
+  const auto run = [&](std::string_view name, auto&& perPacket) {
+    uint64_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < packets; ++idx)
+    {
+      sink += PacketWork(pkt);
+      perPacket(idx);
+    }
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    fmt::print("{:<40} {:>8.1f} ns/packet ({})\n", name, took.count() / packets, sink & 1);
+  };
+
+  log::clear_sinks();
+  log::add_sink(std::make_shared<spdlog::sinks::null_sink_mt>());
+  log::reset_level(log::Level::info);
+
+  run("no log statement (hot path elided)", [](size_t) {});
+  run("LogTraceHot at level info", [](size_t idx) { LogTraceHot("packet ", idx); });
+  run("trace filtered at runtime", [](size_t idx) { log::trace(logcat, "packet {}", idx); });
+
+  log::clear_sinks();
+  log::add_sink(std::make_shared<spdlog::sinks::basic_file_sink_mt>(logfile.string(), true));
+  run("info to a file, synchronous", [](size_t idx) { log::info(logcat, "packet {}", idx); });
+
+  log::clear_sinks();
+  {
+    auto async = std::make_shared<logging::AsyncSink>(
+        std::make_shared<spdlog::sinks::basic_file_sink_mt>(logfile.string(), true));
+    log::add_sink(async);
+    run("info to a file, async sink", [](size_t idx) { log::info(logcat, "packet {}", idx); });
+    fmt::print("async sink dropped {} of {} messages\n", async->dropped(), packets);
+    log::clear_sinks();
+  }
+
+  log::reset_level(log::Level::off);
+  std::filesystem::remove(logfile);
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch.hpp>
+#include <llarp/util/metrics.hpp>
+
+#include <fmt/core.h>
+
+#include <thread>
+#include <vector>
+
+using namespace llarp;
+using namespace std::chrono_literals;
+
+TEST_CASE("Histogram buckets bound what they hold", "[metrics]")
+{
+  using metrics::Histogram;
+  for (uint64_t usec : {0, 1, 3, 4, 5, 7, 8, 9, 100, 1'000, 12'345, 1'000'000, 1'234'567'890})
+  {
+    const auto bucket = Histogram::BucketFor(usec);
+    REQUIRE(usec <= Histogram::UpperBound(bucket));
+    if (bucket > 0)
+      REQUIRE(usec > Histogram::UpperBound(bucket - 1));
+    // within a quarter of the value
+    REQUIRE(Histogram::UpperBound(bucket) - usec <= usec / 4);
+  }
+  REQUIRE(Histogram::BucketFor(uint64_t{1} << 40) == Histogram::OverflowBucket);
+}
+
+TEST_CASE("Histogram quantiles", "[metrics]")
+{
+  metrics::Histogram hist{"test_seconds", "test"};
+  REQUIRE(hist.Quantile(0.5) == 0us);
+  for (int i = 0; i < 90; ++i)
+    hist.Observe(100us);
+  for (int i = 0; i < 10; ++i)
+    hist.Observe(10ms);
+  REQUIRE(hist.Count() == 100);
+  REQUIRE(hist.Sum() == 90 * 100us + 10 * 10ms);
+
+  const auto median = hist.Quantile(0.5);
+  REQUIRE(median >= 100us);
+  REQUIRE(median <= 125us);
+  const auto p99 = hist.Quantile(0.99);
+  REQUIRE(p99 >= 10ms);
+  REQUIRE(p99 <= 12500us);
+}
+
+TEST_CASE("Counters add up across threads", "[metrics]")
+{
+  metrics::Counter counter{"test_total", "test"};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t)
+    threads.emplace_back([&counter]() {
+      for (int i = 0; i < 10'000; ++i)
+        counter.Add();
+    });
+  for (auto& thread : threads)
+    thread.join();
+  REQUIRE(counter.Value() == 80'000);
+}
+
+TEST_CASE("Registry hands out one metric per name", "[metrics]")
+{
+  metrics::Registry registry;
+  auto& counter = registry.GetCounter("test_things_total", "things");
+  REQUIRE(&counter == &registry.GetCounter("test_things_total", "things"));
+  REQUIRE_THROWS_AS(registry.GetGauge("test_things_total", "things"), std::logic_error);
+
+  counter.Add(3);
+  registry.GetGauge("test_level", "level").Set(-2);
+  registry.GetHistogram("test_wait_seconds", "wait").Observe(2ms);
+
+  const auto text = registry.Prometheus();
+  REQUIRE(
+      text.find("# TYPE test_things_total counter\ntest_things_total 3\n") != std::string::npos);
+  REQUIRE(text.find("# TYPE test_level gauge\ntest_level -2\n") != std::string::npos);
+  REQUIRE(text.find("# TYPE test_wait_seconds histogram\n") != std::string::npos);
+  REQUIRE(text.find("test_wait_seconds_bucket{le=\"+Inf\"} 1\n") != std::string::npos);
+  REQUIRE(text.find("test_wait_seconds_count 1\n") != std::string::npos);
+}
+
+TEST_CASE("Timers measure only while we are scraped", "[metrics]")
+{
+  metrics::Registry registry;
+  auto& hist = registry.GetHistogram("test_timer_seconds", "timer");
+  const auto time = [&hist](size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      metrics::Timer timer{hist};
+  };
+
+  metrics::timers_enabled = false;
+  time(100);
+  REQUIRE(hist.Count() == 0);
+
+  // one in every SampleEvery reads the clock and stands in for the rest
+  registry.Prometheus();
+  REQUIRE(metrics::timers_enabled);
+  time(metrics::Timer::SampleEvery * 4);
+  REQUIRE(hist.Count() == metrics::Timer::SampleEvery * 4);
+
+  const auto now = std::chrono::steady_clock::now();
+  registry.Tick(now);
+  REQUIRE(metrics::timers_enabled);
+  registry.Tick(now + metrics::Registry::ScrapeIdle);
+  REQUIRE_FALSE(metrics::timers_enabled);
+  time(100);
+  REQUIRE(hist.Count() == metrics::Timer::SampleEvery * 4);
+}
+
+TEST_CASE("Cost of updating metrics", "[.bench][metrics]")
+{
+  static constexpr size_t updates = 10'000'000;
+  metrics::Counter counter{"bench_total", "bench"};
+  metrics::Histogram hist{"bench_seconds", "bench"};
+
+  const auto run = [](std::string_view name, size_t threads, auto&& update) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+      workers.emplace_back([&update, threads]() {
+        for (size_t i = 0; i < updates / threads; ++i)
+          update(i);
+      });
+    for (auto& worker : workers)
+      worker.join();
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+    fmt::print("{:<40} {} threads {:>6.2f} ns/update\n", name, threads, took.count() / updates);
+  };
+
+  const bool enabled = metrics::timers_enabled;
+  for (size_t threads : {1, 4})
+  {
+    run("counter add", threads, [&counter](size_t) { counter.Add(); });
+    run("histogram observe", threads, [&hist](size_t i) {
+      hist.Observe(std::chrono::microseconds{i & 0xffff});
+    });
+    metrics::timers_enabled = false;
+    run("timer while not scraped", threads, [&hist](size_t) { metrics::Timer timer{hist}; });
+    metrics::timers_enabled = true;
+    run("timer while scraped (sampled)", threads, [&hist](size_t) {
+      metrics::Timer timer{hist};
+    });
+  }
+  metrics::timers_enabled = enabled;
+}
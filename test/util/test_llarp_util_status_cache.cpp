@@ -0,0 +1,118 @@
+#include <catch2/catch.hpp>
+#include <llarp/util/status_cache.hpp>
+
+using namespace llarp;
+
+TEST_CASE("StatusCache makes sections again only on refresh", "[status]")
+{
+  util::StatusCache cache;
+  int calls = 0;
+  int value = 1;
+  cache.Add(
+      "counter",
+      [&]() {
+        calls++;
+        return util::StatusObject{{"value", value}};
+      },
+      1s);
+
+  // the first read has nothing to serve and makes it
+  REQUIRE(cache.Get("counter", 10s)["value"] == 1);
+  REQUIRE(calls == 1);
+
+  value = 2;
+  // still fresh, refresh leaves it be
+  cache.Refresh(10s + 500ms);
+  REQUIRE(cache.Get("counter", 10s + 500ms)["value"] == 1);
+  REQUIRE(calls == 1);
+
+  // reads never make it again on the spot, refresh does
+  REQUIRE(cache.Get("counter", 11s)["value"] == 1);
+  cache.Refresh(11s);
+  REQUIRE(calls == 2);
+
+  // nobody read it since, so it is not made again
+  cache.Refresh(13s);
+  REQUIRE(calls == 2);
+  REQUIRE(cache.Get("counter", 13s)["value"] == 2);
+
+  cache.Invalidate();
+  REQUIRE(cache.Collect(13s)["counter"]["value"] == 2);
+  REQUIRE(calls == 3);
+
+  REQUIRE(cache.Get("bogus", 13s).is_null());
+}
+
+TEST_CASE("StatusCache refreshes within its budget", "[status]")
+{
+  util::StatusCache cache;
+  std::vector<std::string> made;
+  for (const auto name : {"a", "b", "c"})
+  {
+    cache.Add(
+        name,
+        [&made, name]() {
+          made.emplace_back(name);
+          return util::StatusObject{{"name", name}};
+        },
+        1s);
+  }
+  cache.Get("b", 0s);
+  cache.Get("a", 100ms);
+  cache.Get("c", 200ms);
+  made.clear();
+  cache.Collect(2s);
+
+  // no budget, one section per refresh, stalest first
+  cache.Refresh(2s, 0us);
+  REQUIRE(made == std::vector<std::string>{"b"});
+  cache.Refresh(2s, 0us);
+  cache.Refresh(2s, 0us);
+  REQUIRE(made == std::vector<std::string>{"b", "a", "c"});
+  cache.Refresh(2s, 0us);
+  REQUIRE(made.size() == 3);
+}
+
+TEST_CASE("StatusCache reports only changed fields", "[status]")
+{
+  util::StatusCache cache{{"txRate", "lastSeen"}};
+  int a = 0;
+  int b = 0;
+  int rate = 0;
+  bool extra = true;
+  cache.Add(
+      "section",
+      [&]() {
+        util::StatusObject obj{
+            {"a", a}, {"b", util::StatusObject{{"b", b}, {"txRate", rate}}}, {"lastSeen", rate}};
+        if (extra)
+          obj["extra"] = true;
+        return obj;
+      },
+      0s);
+  cache.Add("other", [&]() { return util::StatusObject{{"a", a}}; }, 0s);
+
+  const auto all = cache.ChangedSince(0, 1s);
+  REQUIRE(all.size() == 2);
+  REQUIRE(all.at("section").size() == 4);
+  const auto first = cache.Version();
+  REQUIRE(cache.ChangedSince(first, 1500ms).empty());
+
+  // rates and timestamps alone are not a change, but the snapshot has them
+  rate = 100;
+  cache.Refresh(2s);
+  REQUIRE(cache.Version() == first);
+  REQUIRE(cache.Get("section", 2500ms)["b"]["txRate"] == 100);
+
+  // a change is reported as the fields that changed, and fields that went away as null
+  b = 1;
+  extra = false;
+  cache.Refresh(3s);
+  REQUIRE(cache.Version() > first);
+  const auto changed = cache.ChangedSince(first, 3s);
+  REQUIRE(changed.size() == 1);
+  const auto& section = changed.at("section");
+  REQUIRE(section.size() == 2);
+  REQUIRE(section.at("b").at("b") == 1);
+  REQUIRE(section.at("extra").is_null());
+}